@@ -5,69 +5,282 @@ LoRaWAN Payload Decoder for Vision Master E290 - SF₆ Monitor
 Python implementation for local testing and debugging.
 
 Usage:
-    python3 lorawan_decoder.py 09FA157C0B72157C002A
+    python3 lorawan_decoder.py 002A09FA157C0B72157C
+    python3 lorawan_decoder.py 0103001E000509FA157C0B72157C0200010001000003 3   (batched, FPort 3)
+    python3 lorawan_decoder.py 07020100050401002A09FA157C0B72157C 10            (command ack, FPort 10)
+
+User Mapping frames (FPort 4) have a layout defined on the device; use the
+decoder it generates at /lorawan/payload/decoder.js.
 """
 
 import sys
 import struct
 
 
+# Fixed formats on FPort 1 (src/payload_codec.cpp), told apart by length and
+# constant bytes. Register scaling: density kg/m³ x100, pressures kPa x10
+# (= bar x1000), temperature K x10. Raw Modbus frames are byte-identical to
+# Adeunis frames and decode as such.
+FORMAT_ADEUNIS = "adeunis_modbus_sf6"
+FORMAT_CAYENNE = "cayenne_lpp"
+FORMAT_CUSTOM = "custom"
+FORMAT_VISTRON = "vistron_lora_mod_con"
+
+
+def _register_values(density_raw, pressure_20c_raw, temperature_raw, pressure_var_raw):
+    """Scaled values of the four SF6 input registers."""
+    return {
+        "sf6_density": round(density_raw / 100.0, 2),
+        "sf6_density_unit": "kg/m³",
+        "sf6_pressure_20c": round(pressure_20c_raw / 10.0, 1),
+        "sf6_pressure_20c_unit": "kPa",
+        "sf6_temperature_k": round(temperature_raw / 10.0, 1),
+        "sf6_temperature_k_unit": "K",
+        "sf6_temperature_c": round(temperature_raw / 10.0 - 273.15, 2),
+        "sf6_temperature_c_unit": "°C",
+        "sf6_pressure_var": round(pressure_var_raw / 10.0, 1),
+        "sf6_pressure_var_unit": "kPa",
+        "raw_values": {
+            "sf6_density_raw": density_raw,
+            "sf6_pressure_20c_raw": pressure_20c_raw,
+            "sf6_temperature_raw": temperature_raw,
+            "sf6_pressure_var_raw": pressure_var_raw,
+        }
+    }
+
+
 def decode_payload(hex_string):
     """
-    Decode LoRaWAN payload from hex string.
+    Decode a FPort 1 payload from hex string.
+
+    Formats (all multi-byte integers big-endian):
+      10 bytes  Adeunis Modbus SF6 / Raw Modbus: uplink counter, density,
+                pressure @20C, temperature, pressure variance (uint16 each)
+      12 bytes  Cayenne LPP: ch1 temperature (0x67, 0.1 °C), ch2 pressure
+                (0x02, 0.01 bar), ch3 density (0x02, 0.01 kg/m³)
+      13 bytes  Custom: 0xFF, temperature °C, pressure bar, density kg/m³
+                (float32 little-endian)
+      16 bytes  Vistron LoRa Mod Con frame type 3: 8-byte header with uplink
+                counter at bytes 3-4, then density, pressure @20C, temperature,
+                absolute pressure (uint16 each)
 
     Args:
-        hex_string: Hex string of payload (e.g., "09FA157C0B72157C002A")
+        hex_string: Hex string of payload (e.g., "002A09FA157C0B72157C")
 
     Returns:
-        Dictionary with decoded values
+        Dictionary with decoded values, or {"error": ...}
     """
     # Remove spaces and convert to bytes
     hex_string = hex_string.replace(" ", "").replace("0x", "")
 
-    if len(hex_string) != 20:  # 10 bytes = 20 hex characters
-        return {"error": f"Invalid payload length: expected 20 hex characters (10 bytes), got {len(hex_string)}"}
+    try:
+        payload = bytes.fromhex(hex_string)
+    except ValueError as e:
+        return {"error": f"Invalid hex string: {e}"}
+
+    if len(payload) == 10:
+        counter, density, pressure, temperature, pressure_var = struct.unpack('>HHHHH', payload)
+        decoded = {"format": FORMAT_ADEUNIS}
+        decoded.update(_register_values(density, pressure, temperature, pressure_var))
+        decoded["uplink_counter"] = counter
+        return decoded
+
+    if len(payload) == 12 and payload[0:2] == b"\x01\x67" and payload[4:6] == b"\x02\x02" \
+            and payload[8:10] == b"\x03\x02":
+        temperature_dc, = struct.unpack('>h', payload[2:4])
+        pressure_cbar, = struct.unpack('>h', payload[6:8])
+        density_raw, = struct.unpack('>h', payload[10:12])
+        return {
+            "format": FORMAT_CAYENNE,
+            "sf6_density": round(density_raw / 100.0, 2),
+            "sf6_density_unit": "kg/m³",
+            "sf6_pressure_20c": float(pressure_cbar),  # 0.01 bar = 1 kPa
+            "sf6_pressure_20c_unit": "kPa",
+            "sf6_temperature_c": round(temperature_dc / 10.0, 1),
+            "sf6_temperature_c_unit": "°C",
+        }
+
+    if len(payload) == 13 and payload[0] == 0xFF:
+        temperature_c, pressure_bar, density = struct.unpack('<fff', payload[1:13])
+        return {
+            "format": FORMAT_CUSTOM,
+            "sf6_density": round(density, 2),
+            "sf6_density_unit": "kg/m³",
+            "sf6_pressure_20c": round(pressure_bar * 100.0, 1),
+            "sf6_pressure_20c_unit": "kPa",
+            "sf6_temperature_c": round(temperature_c, 2),
+            "sf6_temperature_c_unit": "°C",
+        }
+
+    if len(payload) == 16 and payload[0] == 0x03 and payload[7] == 0x08:
+        counter, = struct.unpack('>H', payload[3:5])
+        density, pressure, temperature, pressure_abs = struct.unpack('>HHHH', payload[8:16])
+        decoded = {"format": FORMAT_VISTRON, "error_code": payload[2]}
+        # Absolute pressure carries the pressure variance register
+        decoded.update(_register_values(density, pressure, temperature, pressure_abs))
+        decoded["uplink_counter"] = counter
+        return decoded
+
+    return {"error": f"Unknown FPort 1 payload: {len(payload)} bytes ({hex_string[:8].upper()}...)"}
+
 
+def read_zigzag_varint(payload, pos):
+    """Read one zig-zag varint starting at pos. Returns (value, next_pos)."""
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(payload):
+            raise ValueError(f"Truncated varint at byte {pos}")
+        b = payload[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            break
+    # Zig-zag: 0,1,2,3,... -> 0,-1,1,-2,...
+    return (value >> 1) ^ -(value & 1), pos
+
+
+def decode_batched_payload(hex_string):
+    """
+    Decode a batched delta payload (FPort 3) from hex string.
+
+    Layout: version(1) count(1) interval_s(2) newest_age_s(2) oldest sample (4 x uint16),
+    then per further sample and field a zig-zag varint delta to the previous sample.
+
+    Returns:
+        Dictionary with sample list (oldest first)
+    """
+    hex_string = hex_string.replace(" ", "").replace("0x", "")
     try:
         payload = bytes.fromhex(hex_string)
     except ValueError as e:
         return {"error": f"Invalid hex string: {e}"}
 
-    # Decode payload (big-endian uint16 values)
-    sf6_density_raw = struct.unpack('>H', payload[0:2])[0]
-    sf6_pressure_20c_raw = struct.unpack('>H', payload[2:4])[0]
-    sf6_temperature_raw = struct.unpack('>H', payload[4:6])[0]
-    sf6_pressure_var_raw = struct.unpack('>H', payload[6:8])[0]
-    modbus_counter = struct.unpack('>H', payload[8:10])[0]
+    if len(payload) < 14:
+        return {"error": f"Invalid batched payload length: expected at least 14 bytes, got {len(payload)}"}
+    if payload[0] != 0x01:
+        return {"error": f"Unsupported batched format version: {payload[0]}"}
+
+    count = payload[1]
+    interval_s, newest_age_s = struct.unpack('>HH', payload[2:6])
+    raw = list(struct.unpack('>HHHH', payload[6:14]))
+
+    samples = []
+    pos = 14
+    try:
+        for n in range(count):
+            if n > 0:
+                for f in range(4):
+                    delta, pos = read_zigzag_varint(payload, pos)
+                    raw[f] += delta
+            samples.append({
+                "age_s": newest_age_s + (count - 1 - n) * interval_s,
+                "sf6_density": round(raw[0] / 100.0, 2),
+                "sf6_pressure_20c": round(raw[1] / 10.0, 1),
+                "sf6_temperature_k": round(raw[2] / 10.0, 1),
+                "sf6_temperature_c": round(raw[2] / 10.0 - 273.15, 2),
+                "sf6_pressure_var": round(raw[3] / 10.0, 1),
+            })
+    except ValueError as e:
+        return {"error": str(e)}
 
-    # Apply scaling
-    sf6_density = sf6_density_raw / 100.0           # kg/m³
-    sf6_pressure_20c = sf6_pressure_20c_raw / 10.0  # kPa
-    sf6_temperature_k = sf6_temperature_raw / 10.0  # K
-    sf6_temperature_c = sf6_temperature_k - 273.15  # °C
-    sf6_pressure_var = sf6_pressure_var_raw / 10.0  # kPa
+    if pos != len(payload):
+        return {"error": f"Trailing bytes after {count} samples"}
 
     return {
-        "sf6_density": round(sf6_density, 2),
-        "sf6_density_unit": "kg/m³",
-        "sf6_pressure_20c": round(sf6_pressure_20c, 1),
-        "sf6_pressure_20c_unit": "kPa",
-        "sf6_temperature_k": round(sf6_temperature_k, 1),
-        "sf6_temperature_k_unit": "K",
-        "sf6_temperature_c": round(sf6_temperature_c, 2),
-        "sf6_temperature_c_unit": "°C",
-        "sf6_pressure_var": round(sf6_pressure_var, 1),
-        "sf6_pressure_var_unit": "kPa",
-        "modbus_counter": modbus_counter,
-        "raw_values": {
-            "sf6_density_raw": sf6_density_raw,
-            "sf6_pressure_20c_raw": sf6_pressure_20c_raw,
-            "sf6_temperature_raw": sf6_temperature_raw,
-            "sf6_pressure_var_raw": sf6_pressure_var_raw,
-        }
+        "sample_count": count,
+        "sample_interval_s": interval_s,
+        "samples": samples,
     }
 
 
+COMMAND_NAMES = {
+    0x01: "set_interval",
+    0x02: "set_payload_format",
+    0x03: "set_profile_enabled",
+    0x04: "set_sf6_values",
+    0x05: "request_uplink",
+}
+COMMAND_STATUS = ["ok", "unknown_command", "invalid_argument", "truncated", "rejected"]
+
+
+def decode_command_ack(hex_string):
+    """
+    Decode a command acknowledgement uplink (FPort 10) from hex string.
+
+    Layout: downlink_fcnt(1) count(1) count x [command, status] fport(1) payload
+
+    Returns:
+        Dictionary with the command results, the original FPort and the
+        decoded original payload under "data"
+    """
+    hex_string = hex_string.replace(" ", "").replace("0x", "")
+    try:
+        payload = bytes.fromhex(hex_string)
+    except ValueError as e:
+        return {"error": f"Invalid hex string: {e}"}
+
+    if len(payload) < 3:
+        return {"error": f"Invalid command ack length: {len(payload)}"}
+    count = payload[1]
+    end = 2 + count * 2
+    if len(payload) < end + 1:
+        return {"error": f"Command ack truncated: {count} results in {len(payload)} bytes"}
+
+    results = []
+    for i in range(2, end, 2):
+        status = payload[i + 1]
+        results.append({
+            "command": COMMAND_NAMES.get(payload[i], payload[i]),
+            "status": COMMAND_STATUS[status] if status < len(COMMAND_STATUS) else status,
+        })
+
+    fport = payload[end]
+    inner = payload[end + 1:].hex().upper()
+    data = decode_batched_payload(inner) if fport == 3 else decode_payload(inner)
+
+    return {
+        "downlink_fcnt": payload[0],
+        "results": results,
+        "fport": fport,
+        "data": data,
+    }
+
+
+def print_command_ack(decoded):
+    """Pretty print a command acknowledgement and the payload it carries."""
+    if "error" in decoded:
+        print(f"❌ Error: {decoded['error']}")
+        return
+
+    print("\n" + "="*60)
+    print(f"📨 Command Acknowledgement - downlink FCnt {decoded['downlink_fcnt']} (low byte)")
+    print("="*60)
+    for r in decoded["results"]:
+        print(f"   {r['command']:<22} {r['status']}")
+
+    if decoded["fport"] == 3:
+        print_batched(decoded["data"])
+    else:
+        print_decoded(decoded["data"])
+
+
+def print_batched(decoded):
+    """Pretty print decoded batched payload."""
+    if "error" in decoded:
+        print(f"❌ Error: {decoded['error']}")
+        return
+
+    print("\n" + "="*60)
+    print(f"📡 Batched Delta Payload - {decoded['sample_count']} samples, {decoded['sample_interval_s']} s apart")
+    print("="*60)
+    print(f"   {'Age (s)':>8} {'Density':>9} {'P@20°C':>8} {'Temp K':>8} {'P var':>8}")
+    for s in decoded["samples"]:
+        print(f"   {s['age_s']:>8} {s['sf6_density']:>9} {s['sf6_pressure_20c']:>8} {s['sf6_temperature_k']:>8} {s['sf6_pressure_var']:>8}")
+    print("="*60 + "\n")
+
+
 def print_decoded(decoded):
     """Pretty print decoded payload."""
     if "error" in decoded:
@@ -75,34 +288,159 @@ def print_decoded(decoded):
         return
 
     print("\n" + "="*60)
-    print("📡 LoRaWAN Payload Decoder - Vision Master E290")
+    print(f"📡 LoRaWAN Payload Decoder - Vision Master E290 ({decoded['format']})")
     print("="*60)
     print(f"\n🌡️  SF₆ Sensor Data:")
     print(f"   Density:           {decoded['sf6_density']} {decoded['sf6_density_unit']}")
     print(f"   Pressure @20°C:    {decoded['sf6_pressure_20c']} {decoded['sf6_pressure_20c_unit']}")
-    print(f"   Temperature:       {decoded['sf6_temperature_k']} {decoded['sf6_temperature_k_unit']} ({decoded['sf6_temperature_c']} {decoded['sf6_temperature_c_unit']})")
-    print(f"   Pressure Variance: {decoded['sf6_pressure_var']} {decoded['sf6_pressure_var_unit']}")
-    print(f"\n📊 Modbus Counter:    {decoded['modbus_counter']}")
-    print(f"\n🔢 Raw Values:")
-    print(f"   Density:           {decoded['raw_values']['sf6_density_raw']} (0x{decoded['raw_values']['sf6_density_raw']:04X})")
-    print(f"   Pressure @20°C:    {decoded['raw_values']['sf6_pressure_20c_raw']} (0x{decoded['raw_values']['sf6_pressure_20c_raw']:04X})")
-    print(f"   Temperature:       {decoded['raw_values']['sf6_temperature_raw']} (0x{decoded['raw_values']['sf6_temperature_raw']:04X})")
-    print(f"   Pressure Variance: {decoded['raw_values']['sf6_pressure_var_raw']} (0x{decoded['raw_values']['sf6_pressure_var_raw']:04X})")
+    if "sf6_temperature_k" in decoded:
+        print(f"   Temperature:       {decoded['sf6_temperature_k']} {decoded['sf6_temperature_k_unit']} ({decoded['sf6_temperature_c']} {decoded['sf6_temperature_c_unit']})")
+    else:
+        print(f"   Temperature:       {decoded['sf6_temperature_c']} {decoded['sf6_temperature_c_unit']}")
+    if "sf6_pressure_var" in decoded:
+        print(f"   Pressure Variance: {decoded['sf6_pressure_var']} {decoded['sf6_pressure_var_unit']}")
+    if "uplink_counter" in decoded:
+        print(f"\n📊 Uplink Counter:    {decoded['uplink_counter']}")
+    if "raw_values" in decoded:
+        print(f"\n🔢 Raw Values:")
+        print(f"   Density:           {decoded['raw_values']['sf6_density_raw']} (0x{decoded['raw_values']['sf6_density_raw']:04X})")
+        print(f"   Pressure @20°C:    {decoded['raw_values']['sf6_pressure_20c_raw']} (0x{decoded['raw_values']['sf6_pressure_20c_raw']:04X})")
+        print(f"   Temperature:       {decoded['raw_values']['sf6_temperature_raw']} (0x{decoded['raw_values']['sf6_temperature_raw']:04X})")
+        print(f"   Pressure Variance: {decoded['raw_values']['sf6_pressure_var_raw']} (0x{decoded['raw_values']['sf6_pressure_var_raw']:04X})")
     print("="*60 + "\n")
 
 
+# ============================================================================
+# GOLDEN VECTORS AND SELF-TEST
+# ============================================================================
+# Frames produced by the firmware encoders (src/payload_codec.cpp) for fixed
+# register sets. The same vectors are checked on the device
+# (LORAWAN_CODEC_SELFTEST in config.h), by the host test test/test_payload_codec
+# and in lorawan_decoder.js, so a layout or scaling change on either side fails
+# a check instead of decoding silently wrong values. They come from
+# test/golden_vectors.json: edit that and run tools/golden_vectors.py.
+#
+# (density, pressure@20C, temperature, pressure var, uplink count):
+#     Adeunis / Raw Modbus, Cayenne LPP, Custom, Vistron
+# BEGIN GOLDEN VECTORS (generated by tools/golden_vectors.py from test/golden_vectors.json - do not edit)
+GOLDEN_VECTORS = [
+    ((2554, 5500, 2930, 5500, 42),
+     "002A09FA157C0B72157C", "016700C602020226030209FA", "FFCDCC9E410000B040EC51CC41", "030000002A00000809FA157C0B72157C"),
+    ((0, 0, 2150, 0, 0),
+     "00000000000008660000", "0167FDBB0202000003020000", "FF9A9968C20000000000000000", "03000000000000080000000008660000"),
+    ((6000, 11000, 3600, 11000, 65535),
+     "FFFF17702AF80E102AF8", "016703640202044C03021770", "FF33B3AD420000304100007042", "030000FFFF00000817702AF80E102AF8"),
+    ((3350, 1030, 2931, 57, 65543),
+     "00070D1604060B730039", "016700C70202006703020D16", "FF9A999F410AD7833F00000642", "03000000070000080D1604060B730039"),
+    ((1030, 1030, 2700, 1, 1000),
+     "03E8040604060A8C0001", "0167FFE10202006703020406", "FF9A9949C00AD7833FCDCC2441", "03000003E8000008040604060A8C0001"),
+    ((5374, 7662, 2788, 8291, 54067),
+     "D33314FE1DEE0AE42063", "01670038020202FE030214FE", "FFCDCCB4401B2FF540C3F55642", "030000D33300000814FE1DEE0AE42063"),
+    ((352, 1472, 2498, 2292, 64072),
+     "FA48016005C009C208F4", "0167FF170202009303020160", "FFCDCCBAC17F6ABC3FAE476140", "030000FA48000008016005C009C208F4"),
+    ((4144, 710, 3190, 1550, 1062),
+     "0426103002C60C76060E", "016701CA0202004703021030", "FF666637428FC2353F8FC22542", "0300000426000008103002C60C76060E"),
+]
+
+# Batched frame (FPort 3): samples 30 s apart, newest 7 s old
+GOLDEN_BATCHED = ("0105001E000709FA157C0B72157C020001000100000300F0010000B302003EB317",
+                  [(2554, 5500, 2930, 5500), (2555, 5500, 2929, 5500), (2554, 5500, 2929, 5498),
+                   (2554, 5620, 2929, 5498), (2400, 5620, 2960, 4000)])
+# END GOLDEN VECTORS
+
+
+def _check(failures, condition, message):
+    if not condition:
+        failures.append(message)
+
+
+def self_test(fuzz_rounds=20000, seed=35):
+    """Check the golden vectors and fuzz the decoders. Returns a list of failures."""
+    import random
+
+    failures = []
+    for (density, pressure, temperature, pressure_var, count), *frames in GOLDEN_VECTORS:
+        regs = {"sf6_density_raw": density, "sf6_pressure_20c_raw": pressure,
+                "sf6_temperature_raw": temperature, "sf6_pressure_var_raw": pressure_var}
+        adeunis, cayenne, custom, vistron = frames
+
+        d = decode_payload(adeunis)
+        _check(failures, d.get("format") == FORMAT_ADEUNIS and d.get("raw_values") == regs
+               and d.get("uplink_counter") == count & 0xFFFF, f"Adeunis {adeunis}: {d}")
+
+        d = decode_payload(vistron)
+        _check(failures, d.get("format") == FORMAT_VISTRON and d.get("raw_values") == regs
+               and d.get("uplink_counter") == count & 0xFFFF, f"Vistron {vistron}: {d}")
+
+        # Cayenne: 0.1 °C truncated toward zero, whole kPa, density unchanged
+        d = decode_payload(cayenne)
+        temperature_dc = int((temperature * 10 - 27315) / 10)
+        _check(failures, d.get("format") == FORMAT_CAYENNE
+               and d.get("sf6_temperature_c") == round(temperature_dc / 10.0, 1)
+               and d.get("sf6_pressure_20c") == pressure // 10
+               and d.get("sf6_density") == round(density / 100.0, 2), f"Cayenne {cayenne}: {d}")
+
+        # Custom: float32 physical values
+        d = decode_payload(custom)
+        _check(failures, d.get("format") == FORMAT_CUSTOM
+               and abs(d.get("sf6_temperature_c", 1e9) - (temperature / 10.0 - 273.15)) < 0.01
+               and abs(d.get("sf6_pressure_20c", 1e9) - pressure / 10.0) < 0.1
+               and abs(d.get("sf6_density", 1e9) - density / 100.0) < 0.01, f"Custom {custom}: {d}")
+
+        # Any truncated or extended frame must be rejected, not decoded
+        for frame in frames:
+            for bad in (frame[:-2], frame + "00"):
+                _check(failures, "error" in decode_payload(bad), f"Accepted malformed frame {bad}")
+
+    hex_frame, samples = GOLDEN_BATCHED
+    d = decode_batched_payload(hex_frame)
+    decoded = [(round(s["sf6_density"] * 100), round(s["sf6_pressure_20c"] * 10),
+                round(s["sf6_temperature_k"] * 10), round(s["sf6_pressure_var"] * 10))
+               for s in d.get("samples", [])]
+    _check(failures, decoded == samples, f"Batched {hex_frame}: {decoded}")
+
+    # Fuzz: random frames on every port must return a result or an error, never raise
+    rng = random.Random(seed)
+    for _ in range(fuzz_rounds):
+        frame = bytes(rng.getrandbits(8) for _ in range(rng.randint(0, 40))).hex()
+        for decoder in (decode_payload, decode_batched_payload, decode_command_ack):
+            try:
+                decoder(frame)
+            except Exception as e:  # noqa: BLE001 - any exception is a failure here
+                failures.append(f"{decoder.__name__}({frame}) raised {e!r}")
+
+    return failures
+
+
 if __name__ == "__main__":
+    if len(sys.argv) > 1 and sys.argv[1] == "--self-test":
+        failures = self_test()
+        for f in failures:
+            print(f"❌ {f}")
+        print(f"{len(GOLDEN_VECTORS) * 4 + 1} golden frames, fuzzing: "
+              + ("all checks passed" if not failures else f"{len(failures)} failure(s)"))
+        sys.exit(1 if failures else 0)
+
     # Test with example payload if no arguments
     if len(sys.argv) < 2:
-        print("Usage: python3 lorawan_decoder.py <hex_payload>")
-        print("\nExample: python3 lorawan_decoder.py 09FA157C0B72157C002A")
+        print("Usage: python3 lorawan_decoder.py <hex_payload> [fport]")
+        print("\nExample: python3 lorawan_decoder.py 002A09FA157C0B72157C")
         print("\nRunning with example payload...\n")
-        hex_payload = "09FA157C0B72157C002A"
+        hex_payload = "002A09FA157C0B72157C"
     else:
         hex_payload = sys.argv[1]
 
-    decoded = decode_payload(hex_payload)
-    print_decoded(decoded)
+    fport = int(sys.argv[2]) if len(sys.argv) > 2 else 1
+
+    if fport == 3:
+        decoded = decode_batched_payload(hex_payload)
+        print_batched(decoded)
+    elif fport == 10:
+        decoded = decode_command_ack(hex_payload)
+        print_command_ack(decoded)
+    else:
+        decoded = decode_payload(hex_payload)
+        print_decoded(decoded)
 
     # If successful, also print JSON format
     if "error" not in decoded:
@@ -0,0 +1,263 @@
+#include "airtime_ledger.h"
+#include <math.h>
+#include <string.h>
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+AirtimeLedger::AirtimeLedger() :
+    bucket_start(0),
+    bucket_index(0),
+    started(false) {
+
+    memset(bands, 0, sizeof(bands));
+    memset(band_in_use, 0, sizeof(band_in_use));
+    memset(profile_windows, 0, sizeof(profile_windows));
+    memset(profile_total_ms, 0, sizeof(profile_total_ms));
+    memset(profile_frames, 0, sizeof(profile_frames));
+}
+
+// ============================================================================
+// TIME-ON-AIR
+// ============================================================================
+
+uint32_t AirtimeLedger::timeOnAirMs(uint8_t sf, uint32_t bandwidth_hz, size_t phy_len) {
+    const int preamble = 8;
+    const int cr = 1;           // Coding rate 4/5
+    const int crc = 1;          // Uplinks carry a payload CRC
+    const int implicit_hdr = 0;
+
+    double t_sym = (double)(1UL << sf) * 1000.0 / (double)bandwidth_hz;  // ms
+    int low_dr_opt = (t_sym > 16.0) ? 1 : 0;  // Mandatory for SF11/SF12 at 125 kHz
+
+    double num = 8.0 * phy_len - 4.0 * sf + 28 + 16 * crc - 20 * implicit_hdr;
+    double den = 4.0 * (sf - 2 * low_dr_opt);
+    double payload_symbols = 8 + fmax(ceil(num / den) * (cr + 4), 0.0);
+
+    double t_preamble = (preamble + 4.25) * t_sym;
+    return (uint32_t)ceil(t_preamble + payload_symbols * t_sym);
+}
+
+uint32_t AirtimeLedger::uplinkTimeOnAirMs(LoRaRegion region, uint8_t datarate, size_t app_payload_len) {
+    size_t phy_len = app_payload_len + LORAWAN_FRAME_OVERHEAD;
+
+    const RegionDataRate& dr = LoRaRegions::get(region).datarates[LoRaRegions::usableDatarate(region, datarate)];
+    if (dr.sf == 0) {
+        // FSK 50 kbps - preamble(5) + sync(3) + length(1) + payload + CRC(2)
+        return (uint32_t)(((phy_len + 11) * 8 * 1000 + 49999) / 50000);
+    }
+    return timeOnAirMs(dr.sf, dr.bw_khz * 1000UL, phy_len);
+}
+
+uint32_t AirtimeLedger::joinTimeOnAirMs(LoRaRegion region, uint8_t datarate) {
+    // Join requests go out on LoRa rates only
+    const RegionPlan& plan = LoRaRegions::get(region);
+    uint8_t dr_index = LoRaRegions::usableDatarate(region, datarate);
+    while (dr_index > 0 && plan.datarates[dr_index].sf == 0) dr_index--;
+    const RegionDataRate& dr = plan.datarates[dr_index];
+    return timeOnAirMs(dr.sf, dr.bw_khz * 1000UL, LORAWAN_JOIN_REQUEST_LEN);
+}
+
+// ============================================================================
+// SLIDING WINDOW
+// ============================================================================
+
+void AirtimeLedger::addToWindow(Window& w, uint16_t index, uint32_t ms) {
+    uint32_t room = 0xFFFF - w.buckets[index];
+    if (ms > room) ms = room;  // A bucket holds at most one minute of airtime anyway
+    w.buckets[index] += ms;
+    w.sum += ms;
+}
+
+void AirtimeLedger::expireBucket(Window& w, uint16_t index) {
+    w.sum -= w.buckets[index];
+    w.buckets[index] = 0;
+}
+
+void AirtimeLedger::advance(unsigned long now) {
+    if (!started) {
+        bucket_start = now;
+        started = true;
+        return;
+    }
+
+    long elapsed = (long)(now - bucket_start);
+    if (elapsed < (long)AIRTIME_BUCKET_MS) {
+        return;  // Same bucket, or a time from before the current bucket
+    }
+
+    unsigned long steps = (unsigned long)elapsed / AIRTIME_BUCKET_MS;
+    bucket_start += steps * AIRTIME_BUCKET_MS;
+
+    // Past a full window everything has expired; no need to walk more buckets
+    if (steps > AIRTIME_BUCKET_COUNT) {
+        steps = AIRTIME_BUCKET_COUNT;
+    }
+
+    for (unsigned long s = 0; s < steps; s++) {
+        bucket_index = (bucket_index + 1) % AIRTIME_BUCKET_COUNT;
+        for (int b = 0; b < DUTY_CYCLE_BAND_COUNT; b++) {
+            expireBucket(bands[b], bucket_index);
+        }
+        for (int p = 0; p < MAX_LORA_PROFILES; p++) {
+            expireBucket(profile_windows[p], bucket_index);
+        }
+    }
+}
+
+unsigned long AirtimeLedger::expiredSteps(unsigned long now) const {
+    // Buckets advance() would expire at `now`, without doing it
+    if (!started) return 0;
+    long elapsed = (long)(now - bucket_start);
+    if (elapsed < (long)AIRTIME_BUCKET_MS) return 0;
+    unsigned long steps = (unsigned long)elapsed / AIRTIME_BUCKET_MS;
+    return steps > AIRTIME_BUCKET_COUNT ? AIRTIME_BUCKET_COUNT : steps;
+}
+
+uint32_t AirtimeLedger::windowSum(const Window& w, unsigned long now) const {
+    unsigned long steps = expiredSteps(now);
+    if (steps >= AIRTIME_BUCKET_COUNT) return 0;
+
+    uint32_t sum = w.sum;
+    for (unsigned long s = 1; s <= steps; s++) {
+        sum -= w.buckets[(bucket_index + s) % AIRTIME_BUCKET_COUNT];
+    }
+    return sum;
+}
+
+void AirtimeLedger::record(unsigned long now, uint8_t profile, LoRaRegion region, uint32_t freq_khz, uint32_t toa_ms) {
+    advance(now);
+
+    int band = LoRaRegions::findBand(region, freq_khz);
+    if (band < 0) {
+        band = LoRaRegions::get(region).default_band;  // Unknown frequency: charge the default band
+    }
+
+    addToWindow(bands[band], bucket_index, toa_ms);
+    band_in_use[band] = true;
+
+    if (profile < MAX_LORA_PROFILES) {
+        addToWindow(profile_windows[profile], bucket_index, toa_ms);
+        profile_total_ms[profile] += toa_ms;
+        profile_frames[profile]++;
+    }
+}
+
+// ============================================================================
+// BUDGET QUERIES
+// ============================================================================
+
+unsigned long AirtimeLedger::bandWaitMs(unsigned long now, int band, uint32_t toa_ms) const {
+    uint32_t budget = getSubBandBudgetMs(band);
+    if (DUTY_CYCLE_BANDS[band].duty_permille == 0) {
+        return 0;  // No duty-cycle limit (dwell time is bounded by the payload size instead)
+    }
+    if (toa_ms > budget) {
+        return (unsigned long)-1;  // Never fits
+    }
+
+    uint32_t used = windowSum(bands[band], now);
+    if (used + toa_ms <= budget) {
+        return 0;
+    }
+
+    // Walk the buckets still in the window from oldest to newest until enough
+    // airtime has expired (the first `steps` have expired by `now` already)
+    uint32_t need = used + toa_ms - budget;
+    uint32_t freed = 0;
+    for (uint16_t j = (uint16_t)expiredSteps(now); j < AIRTIME_BUCKET_COUNT; j++) {
+        uint16_t idx = (bucket_index + 1 + j) % AIRTIME_BUCKET_COUNT;
+        freed += bands[band].buckets[idx];
+        if (freed >= need) {
+            unsigned long expires_at = bucket_start + (unsigned long)(j + 1) * AIRTIME_BUCKET_MS;
+            return expires_at - now;
+        }
+    }
+    return AIRTIME_WINDOW_MS;
+}
+
+unsigned long AirtimeLedger::waitTimeMs(unsigned long now, LoRaRegion region, uint32_t toa_ms) const {
+    // RadioLib picks the channel, so every sub-band carrying uplinks must have room
+    const RegionPlan& plan = LoRaRegions::get(region);
+    unsigned long wait = 0;
+    for (int b = plan.first_band; b < plan.first_band + plan.band_count; b++) {
+        if (!band_in_use[b] && b != plan.default_band) continue;
+        unsigned long w = bandWaitMs(now, b, toa_ms);
+        if (w > wait) wait = w;
+    }
+    return wait;
+}
+
+bool AirtimeLedger::canTransmit(unsigned long now, LoRaRegion region, uint32_t toa_ms) const {
+    return waitTimeMs(now, region, toa_ms) == 0;
+}
+
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+uint32_t AirtimeLedger::getSubBandUsedMs(unsigned long now, int band) const {
+    if (band < 0 || band >= DUTY_CYCLE_BAND_COUNT) return 0;
+    return windowSum(bands[band], now);
+}
+
+uint32_t AirtimeLedger::getSubBandBudgetMs(int band) const {
+    if (band < 0 || band >= DUTY_CYCLE_BAND_COUNT) return 0;
+    return (uint32_t)(AIRTIME_WINDOW_MS / 1000UL * DUTY_CYCLE_BANDS[band].duty_permille);
+}
+
+bool AirtimeLedger::isSubBandInUse(int band) const {
+    if (band < 0 || band >= DUTY_CYCLE_BAND_COUNT) return false;
+    return band_in_use[band];
+}
+
+uint32_t AirtimeLedger::getProfileUsedMs(unsigned long now, uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) return 0;
+    return windowSum(profile_windows[profile], now);
+}
+
+uint32_t AirtimeLedger::getProfileTotalMs(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) return 0;
+    return profile_total_ms[profile];
+}
+
+uint32_t AirtimeLedger::getProfileFrames(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) return 0;
+    return profile_frames[profile];
+}
+
+// ============================================================================
+// DEEP SLEEP RETENTION
+// ============================================================================
+
+void AirtimeLedger::retain(unsigned long now, AirtimeRetained& out) const {
+    static_assert(DUTY_CYCLE_BAND_COUNT <= 8, "band_in_use is one bit per band");
+
+    memset(&out, 0, sizeof(out));
+    for (int b = 0; b < DUTY_CYCLE_BAND_COUNT; b++) {
+        memcpy(out.buckets[b], bands[b].buckets, sizeof(out.buckets[b]));
+        if (band_in_use[b]) out.band_in_use |= 1 << b;
+    }
+    out.bucket_age_ms = started ? now - bucket_start : 0;
+    out.bucket_index = bucket_index;
+    out.started = started;
+}
+
+void AirtimeLedger::resume(const AirtimeRetained& in, unsigned long saved_at) {
+    for (int b = 0; b < DUTY_CYCLE_BAND_COUNT; b++) {
+        Window& w = bands[b];
+        memcpy(w.buckets, in.buckets[b], sizeof(w.buckets));
+        w.sum = 0;
+        for (int i = 0; i < (int)AIRTIME_BUCKET_COUNT; i++) {
+            w.sum += w.buckets[i];
+        }
+        band_in_use[b] = in.band_in_use & (1 << b);
+    }
+    memset(profile_windows, 0, sizeof(profile_windows));
+
+    // The buckets that aged out during the sleep expire on the next advance()
+    bucket_start = saved_at - in.bucket_age_ms;
+    bucket_index = in.bucket_index % AIRTIME_BUCKET_COUNT;
+    started = in.started;
+}
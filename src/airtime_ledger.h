@@ -0,0 +1,101 @@
+#ifndef AIRTIME_LEDGER_H
+#define AIRTIME_LEDGER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "lora_region.h"
+
+// ============================================================================
+// AIRTIME LEDGER (DUTY-CYCLE ACCOUNTING)
+// ============================================================================
+// Tracks time-on-air per regulatory sub-band and per profile over a sliding
+// one-hour window. All profiles share one radio, so the device-wide budget is
+// what counts legally - RadioLib only enforces duty cycle per LoRaWANNode.
+// Sub-bands, limits and data rates come from the profile's region
+// (lora_region.h); bands without a duty-cycle limit are tracked but never block.
+//
+// Time is passed in by the caller (millis()), so the ledger has no Arduino
+// dependencies. The sub-band windows survive deep sleep in RTC memory
+// (AirtimeRetained), so a wake does not reset the duty-cycle budget.
+
+// Sliding window: regulatory duty cycle is averaged over one hour.
+// One extra bucket keeps the window conservative (covers 60-61 minutes).
+#define AIRTIME_WINDOW_MS      3600000UL
+#define AIRTIME_BUCKET_MS      60000UL
+#define AIRTIME_BUCKET_COUNT   ((AIRTIME_WINDOW_MS / AIRTIME_BUCKET_MS) + 1)
+
+// LoRaWAN overhead added to FRMPayload: MHDR(1) + FHDR(7) + FPort(1) + MIC(4)
+#define LORAWAN_FRAME_OVERHEAD 13
+// Join-request PHYPayload: MHDR(1) + JoinEUI(8) + DevEUI(8) + DevNonce(2) + MIC(4)
+#define LORAWAN_JOIN_REQUEST_LEN 23
+
+// Sub-band windows kept over deep sleep (plain data for RTC memory); the
+// per-profile statistics start over at wake
+struct AirtimeRetained {
+    uint16_t buckets[DUTY_CYCLE_BAND_COUNT][AIRTIME_BUCKET_COUNT];
+    uint32_t bucket_age_ms;     // Age of the current bucket at the save
+    uint16_t bucket_index;
+    uint8_t band_in_use;        // Bit per band
+    bool started;
+};
+
+class AirtimeLedger {
+public:
+    AirtimeLedger();
+
+    // Time-on-air calculation (Semtech AN1200.13, explicit header, CRC on, CR 4/5)
+    static uint32_t timeOnAirMs(uint8_t sf, uint32_t bandwidth_hz, size_t phy_len);
+    static uint32_t uplinkTimeOnAirMs(LoRaRegion region, uint8_t datarate, size_t app_payload_len);
+    static uint32_t joinTimeOnAirMs(LoRaRegion region, uint8_t datarate);
+
+    // Accounting (frequency 0 or outside the region: charged to its default band)
+    void record(unsigned long now, uint8_t profile, LoRaRegion region, uint32_t freq_khz, uint32_t toa_ms);
+
+    // Queries never change the ledger: buckets that expired by `now` are left
+    // out of the result, and a `now` older than the current bucket (read by
+    // another task before the last record()) counts as the current bucket.
+
+    // Budget queries (checks the region's default band and every band of the
+    // region that has carried uplinks so far)
+    bool canTransmit(unsigned long now, LoRaRegion region, uint32_t toa_ms) const;
+    unsigned long waitTimeMs(unsigned long now, LoRaRegion region, uint32_t toa_ms) const;  // 0 = can transmit now
+
+    // Statistics
+    uint32_t getSubBandUsedMs(unsigned long now, int band) const;
+    uint32_t getSubBandBudgetMs(int band) const;  // 0 = no duty-cycle limit
+    bool isSubBandInUse(int band) const;
+    uint32_t getProfileUsedMs(unsigned long now, uint8_t profile) const;
+    uint32_t getProfileTotalMs(uint8_t profile) const;
+    uint32_t getProfileFrames(uint8_t profile) const;
+
+    // Deep sleep: save at `now`; resume with the save time in the current clock
+    void retain(unsigned long now, AirtimeRetained& out) const;
+    void resume(const AirtimeRetained& in, unsigned long saved_at);
+
+private:
+    // Per-minute buckets; `sum` is the running total of all buckets
+    struct Window {
+        uint16_t buckets[AIRTIME_BUCKET_COUNT];
+        uint32_t sum;
+    };
+
+    Window bands[DUTY_CYCLE_BAND_COUNT];
+    bool band_in_use[DUTY_CYCLE_BAND_COUNT];
+    Window profile_windows[MAX_LORA_PROFILES];
+    uint32_t profile_total_ms[MAX_LORA_PROFILES];
+    uint32_t profile_frames[MAX_LORA_PROFILES];
+
+    unsigned long bucket_start;  // Start time of the current bucket
+    uint16_t bucket_index;       // Index of the current bucket
+    bool started;
+
+    void advance(unsigned long now);
+    unsigned long expiredSteps(unsigned long now) const;
+    uint32_t windowSum(const Window& w, unsigned long now) const;
+    static void addToWindow(Window& w, uint16_t index, uint32_t ms);
+    static void expireBucket(Window& w, uint16_t index);
+    unsigned long bandWaitMs(unsigned long now, int band, uint32_t toa_ms) const;
+};
+
+#endif // AIRTIME_LEDGER_H
@@ -0,0 +1,459 @@
+#include "api_json.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// ARENA
+// ============================================================================
+// Each block starts with its requested size. Only the newest block can grow
+// in place or give its space back; anything else handed back stays used
+// until reset(). ArduinoJson allocates a few variant pools and one block per
+// string, so a part of a response fits in a few KB.
+
+static const size_t ARENA_ALIGN = 8;
+static const size_t ARENA_HEADER = 8;   // Holds the size_t block size, keeps data aligned
+
+static size_t arenaAlign(size_t n) {
+    return (n + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+ApiArena::ApiArena(uint8_t* buffer, size_t size) :
+    buf(buffer),
+    cap(size),
+    used(0),
+    peak(0),
+    last(size),
+    live(0),
+    failures(0) {
+}
+
+void* ApiArena::allocate(size_t size) {
+    size_t need = ARENA_HEADER + arenaAlign(size);
+    if (need > cap - used) {
+        failures++;
+        return nullptr;
+    }
+    size_t offset = used;
+    memcpy(buf + offset, &size, sizeof(size));
+    last = offset;
+    used += need;
+    if (used > peak) peak = used;
+    live++;
+    return buf + offset + ARENA_HEADER;
+}
+
+void ApiArena::deallocate(void* ptr) {
+    if (!ptr) return;
+    if (live > 0) live--;
+    size_t offset = (uint8_t*)ptr - buf - ARENA_HEADER;
+    if (offset == last) {
+        used = offset;
+        last = cap;
+    }
+}
+
+void* ApiArena::reallocate(void* ptr, size_t new_size) {
+    if (!ptr) return allocate(new_size);
+
+    size_t offset = (uint8_t*)ptr - buf - ARENA_HEADER;
+    size_t old_size;
+    memcpy(&old_size, buf + offset, sizeof(old_size));
+
+    if (offset == last) {
+        // Newest block: grow or shrink where it is
+        size_t need = ARENA_HEADER + arenaAlign(new_size);
+        if (need > cap - offset) {
+            failures++;
+            return nullptr;   // The old block stays valid
+        }
+        memcpy(buf + offset, &new_size, sizeof(new_size));
+        used = offset + need;
+        if (used > peak) peak = used;
+        return ptr;
+    }
+
+    if (new_size <= old_size) {
+        memcpy(buf + offset, &new_size, sizeof(new_size));
+        return ptr;
+    }
+
+    void* moved = allocate(new_size);
+    if (!moved) return nullptr;
+    memcpy(moved, ptr, old_size);
+    live--;   // The old block is abandoned until reset()
+    return moved;
+}
+
+bool ApiArena::reset() {
+    if (live > 0) return false;
+    used = 0;
+    last = cap;
+    return true;
+}
+
+// ============================================================================
+// STREAMED OUTPUT
+// ============================================================================
+
+namespace {
+
+// Passes on the first `limit` bytes (a serialized object without its closing brace)
+class PrefixWriter : public ApiWriter {
+public:
+    PrefixWriter(ApiWriter& out, size_t limit) : out(out), left(limit) {}
+
+    size_t write(uint8_t c) override {
+        if (left == 0) return 1;
+        left--;
+        return out.write(c);
+    }
+
+    size_t write(const uint8_t* data, size_t len) override {
+        size_t n = len < left ? len : left;
+        if (n > 0) out.write(data, n);
+        left -= n;
+        return len;
+    }
+
+private:
+    ApiWriter& out;
+    size_t left;
+};
+
+} // namespace
+
+ApiJsonOutput::ApiJsonOutput(ApiWriter& out, ApiArena& arena) :
+    out(out),
+    arena(arena),
+    doc(&arena),
+    state(STATE_HEAD),
+    truncated(false),
+    head_members(false),
+    items(0),
+    bytes(0) {
+
+    arena.reset();
+}
+
+JsonObject ApiJsonOutput::head() {
+    if (state != STATE_HEAD) return JsonObject();
+    return doc.to<JsonObject>();
+}
+
+void ApiJsonOutput::openArray(const char* name) {
+    if (state != STATE_HEAD) return;
+    writeHead();
+    if (head_members) writeRaw(",");
+    writeRaw("\"");
+    writeRaw(name);
+    writeRaw("\":[");
+    state = STATE_ARRAY;
+}
+
+JsonObject ApiJsonOutput::item() {
+    if (state == STATE_ITEM) {
+        writeItem();
+    } else if (state != STATE_ARRAY) {
+        return JsonObject();
+    }
+    state = STATE_ITEM;
+    return doc.to<JsonObject>();
+}
+
+bool ApiJsonOutput::end() {
+    switch (state) {
+        case STATE_HEAD:
+            writeHead();
+            if (truncated) writeRaw(head_members ? ",\"truncated\":true" : "\"truncated\":true");
+            writeRaw("}");
+            break;
+        case STATE_ITEM:
+            writeItem();
+            // fall through
+        case STATE_ARRAY:
+            writeRaw("]");
+            if (truncated) writeRaw(",\"truncated\":true");
+            writeRaw("}");
+            break;
+        case STATE_DONE:
+            break;
+    }
+    state = STATE_DONE;
+    return !truncated;
+}
+
+void ApiJsonOutput::writeRaw(const char* text) {
+    size_t len = strlen(text);
+    out.write((const uint8_t*)text, len);
+    bytes += len;
+}
+
+void ApiJsonOutput::writeHead() {
+    if (doc.overflowed()) truncated = true;
+    JsonObject root = doc.as<JsonObject>();
+    if (root.isNull() || root.size() == 0) {
+        writeRaw("{");
+        head_members = false;
+    } else {
+        size_t len = measureJson(doc);
+        PrefixWriter prefix(out, len - 1);
+        serializeJson(doc, prefix);
+        bytes += len - 1;
+        head_members = true;
+    }
+    release();
+}
+
+void ApiJsonOutput::writeItem() {
+    if (doc.overflowed()) truncated = true;
+    if (items > 0) writeRaw(",");
+    bytes += serializeJson(doc, out);
+    items++;
+    release();
+}
+
+void ApiJsonOutput::release() {
+    doc.clear();
+    arena.reset();
+}
+
+// ============================================================================
+// SERIALIZERS
+// ============================================================================
+// Units are in the key name where there is one; register values are decoded
+// the same way as on the web pages.
+
+void apiRegisters(JsonObject out, const HoldingRegisters& holding, const InputRegisters& input) {
+    JsonObject h = out["holding"].to<JsonObject>();
+    h["sequential_counter"] = holding.sequential_counter;
+    h["random_number"] = holding.random_number;
+    h["uptime_s"] = holding.uptime_seconds;
+    h["free_heap_kb"] = ((uint32_t)holding.free_heap_kb_high << 16) | holding.free_heap_kb_low;
+    h["min_heap_kb"] = holding.min_heap_kb;
+    h["cpu_freq_mhz"] = holding.cpu_freq_mhz;
+    h["task_count"] = holding.task_count;
+    h["temperature_c"] = holding.temperature_x10 / 10.0;
+    h["cpu_cores"] = holding.cpu_cores;
+    h["wifi_enabled"] = holding.wifi_enabled != 0;
+    h["wifi_clients"] = holding.wifi_clients;
+
+    JsonObject in = out["input"].to<JsonObject>();
+    in["sf6_density_kg_m3"] = input.sf6_density / 100.0;
+    in["sf6_pressure_20c_kpa"] = input.sf6_pressure_20c / 10.0;
+    in["sf6_temperature_k"] = input.sf6_temperature / 10.0;
+    in["sf6_pressure_var_kpa"] = input.sf6_pressure_var / 10.0;
+    in["slave_id"] = input.slave_id;
+    in["serial"] = ((uint32_t)input.serial_hi << 16) | input.serial_lo;
+    char version[10];
+    snprintf(version, sizeof(version), "%d.%02d", input.sw_release / 100, input.sw_release % 100);
+    in["sw_release"] = version;
+    in["quartz_freq_hz"] = input.quartz_freq / 100.0;
+
+    // Words as read over Modbus (index = register address; 32-bit values low
+    // word first, which is the little-endian struct layout)
+    const size_t holding_words = offsetof(HoldingRegisters, wifi_clients) / 2 + 1;
+    const size_t input_words = sizeof(InputRegisters) / 2;
+    uint16_t words[holding_words > input_words ? holding_words : input_words];
+
+    memcpy(words, &holding, holding_words * 2);
+    JsonArray raw = out["holding_raw"].to<JsonArray>();
+    for (size_t i = 0; i < holding_words; i++) {
+        raw.add(words[i]);
+    }
+
+    memcpy(words, &input, input_words * 2);
+    raw = out["input_raw"].to<JsonArray>();
+    for (size_t i = 0; i < input_words; i++) {
+        raw.add(words[i]);
+    }
+}
+
+void apiStats(JsonObject out, const ApiSystemStats& system, const ModbusStats& modbus, const WebPageStats& web) {
+    char firmware[8];
+    snprintf(firmware, sizeof(firmware), "%d.%02d", FIRMWARE_VERSION / 100, FIRMWARE_VERSION % 100);
+    out["firmware"] = firmware;
+    out["uptime_s"] = system.uptime_s;
+    out["temperature_c"] = system.temperature_c;
+
+    JsonObject mem = out["memory"].to<JsonObject>();
+    mem["free_heap"] = system.free_heap;
+    mem["min_free_heap"] = system.min_free_heap;
+    mem["largest_free_block"] = system.largest_free_block;
+
+    JsonObject wifi = out["wifi"].to<JsonObject>();
+    wifi["ap_clients"] = system.wifi_ap_clients;
+    wifi["client_connected"] = system.wifi_client_connected;
+
+    JsonObject mb = out["modbus"].to<JsonObject>();
+    mb["requests"] = modbus.request_count;
+    mb["reads"] = modbus.read_count;
+    mb["writes"] = modbus.write_count;
+    mb["errors"] = modbus.error_count;
+
+    JsonObject w = out["web"].to<JsonObject>();
+    w["streamed"] = WEB_STREAM_PAGES;
+    w["pages"] = web.pages;
+    w["last_uri"] = web.pages ? web.last_uri : "";
+    w["last_bytes"] = web.last_bytes;
+    w["max_bytes"] = web.max_bytes;
+    w["last_chunks"] = web.last_chunks;
+    w["last_heap"] = web.last_heap;
+    w["max_heap"] = web.max_heap;
+    w["last_first_byte_us"] = web.last_first_byte_us;
+    w["max_first_byte_us"] = web.max_first_byte_us;
+    w["last_total_us"] = web.last_total_us;
+    w["api_arena_peak"] = system.api_arena_peak;
+    w["api_arena_failures"] = system.api_arena_failures;
+
+    JsonObject log = out["log"].to<JsonObject>();
+    log["written"] = system.log_written;
+    log["dropped"] = system.log_dropped;
+}
+
+void apiLoRaWANStatus(JsonObject out, const ApiLoRaWANStatus& status, const AirtimeLedger& airtime, unsigned long now) {
+    out["now_ms"] = now;
+    out["joined"] = status.joined;
+    if (status.joined) {
+        char addr[9];
+        snprintf(addr, sizeof(addr), "%08lX", (unsigned long)status.dev_addr);
+        out["dev_addr"] = addr;
+    }
+    out["uplinks"] = status.uplinks;
+    out["downlinks"] = status.downlinks;
+    if (LORAWAN_CLASS_C) {
+        out["class_c_downlinks"] = status.class_c_downlinks;
+    }
+    out["last_rssi"] = status.last_rssi;
+    out["active_profile"] = status.active_profile;
+    out["auto_rotation"] = status.auto_rotation;
+    out["enabled_profiles"] = status.enabled_profiles;
+
+    // Duty-cycle usage over the last hour (budget 0 = no limit)
+    JsonArray bands = out["airtime"].to<JsonArray>();
+    for (int b = 0; b < DUTY_CYCLE_BAND_COUNT; b++) {
+        if (!airtime.isSubBandInUse(b)) continue;
+        JsonObject band = bands.add<JsonObject>();
+        band["band"] = DUTY_CYCLE_BANDS[b].name;
+        band["used_ms"] = airtime.getSubBandUsedMs(now, b);
+        band["budget_ms"] = airtime.getSubBandBudgetMs(b);
+    }
+}
+
+void apiLoRaWANProfile(JsonObject out, uint8_t index, const ApiProfileRuntime& runtime,
+                       const ApiLoRaWANSources& src, unsigned long now) {
+    const LoRaProfile* prof = runtime.profile;
+    out["index"] = index;
+    if (prof) {
+        out["name"] = prof->name;
+        out["region"] = prof->region < REGION_COUNT ? LORA_REGION_NAMES[prof->region] : "?";
+    }
+    out["datarate"] = runtime.datarate;
+    out["interval_s"] = runtime.interval_s;
+    out["next_airtime_ms"] = runtime.next_airtime_ms;
+
+    // Uplink schedule (negative next_in_ms = overdue)
+    JsonObject sched = out["schedule"].to<JsonObject>();
+    bool scheduled = src.scheduler.isScheduled(index);
+    sched["scheduled"] = scheduled;
+    if (scheduled) {
+        sched["next_in_ms"] = (long)(src.scheduler.getDeadline(index) - now);
+    }
+    const ScheduleStats& st = src.scheduler.getStats(index);
+    sched["sent"] = st.sent;
+    sched["missed"] = st.missed;
+    sched["last_lateness_ms"] = st.last_lateness;
+    sched["max_lateness_ms"] = st.max_lateness;
+    sched["avg_lateness_ms"] = st.sent ? st.total_lateness / st.sent : 0;
+    sched["min_interval_ms"] = st.min_interval;
+    sched["max_interval_ms"] = st.max_interval;
+
+    JsonObject air = out["airtime"].to<JsonObject>();
+    air["last_hour_ms"] = src.airtime.getProfileUsedMs(now, index);
+    air["total_ms"] = src.airtime.getProfileTotalMs(index);
+    air["frames"] = src.airtime.getProfileFrames(index);
+
+    // Last LINK_HISTORY_SIZE uplinks
+    LinkSummary ls = src.links.summarize(index);
+    JsonObject link = out["link"].to<JsonObject>();
+    link["samples"] = ls.samples;
+    link["downlinks"] = ls.downlinks;
+    if (ls.downlinks > 0) {
+        link["avg_rssi"] = ls.avg_rssi;
+        link["avg_snr"] = ls.avg_snr;
+        link["min_snr"] = ls.min_snr;
+    }
+    if (ls.last_margin != LINK_MARGIN_NONE) {
+        link["margin_db"] = ls.last_margin;
+        link["gateways"] = ls.last_gateways;
+    }
+    link["silent_uplinks"] = src.links.getUplinksSinceDownlink(index);
+
+    const JoinStats& js = src.joins.getStats(index);
+    JsonObject join = out["join"].to<JsonObject>();
+    join["attempts"] = js.attempts;
+    join["failures"] = js.failures;
+    join["successes"] = js.successes;
+    join["consecutive_failures"] = js.consecutive_failures;
+    if (js.successes > 0) {
+        join["last_latency_ms"] = js.last_latency_ms;
+        join["max_latency_ms"] = js.max_latency_ms;
+        join["avg_latency_ms"] = (uint32_t)(js.total_latency_ms / js.successes);
+    }
+    long retry_in = (long)(js.next_attempt - now);
+    if (js.consecutive_failures > 0 && retry_in > 0) {
+        join["retry_in_ms"] = retry_in;
+    }
+
+    // Confirmed uplinks (ratio over completed messages, null before the first)
+    const DeliveryStats& ds = src.delivery.getStats(index);
+    JsonObject conf = out["confirmed"].to<JsonObject>();
+    if (prof) {
+        conf["mode"] = prof->confirm < CONFIRM_MODE_COUNT ? CONFIRM_MODE_NAMES[prof->confirm] : "?";
+    }
+    conf["messages"] = ds.messages;
+    conf["delivered"] = ds.delivered;
+    conf["first_try"] = ds.first_try;
+    conf["lost"] = ds.lost;
+    conf["retries"] = ds.retries;
+    int ratio = src.delivery.deliveryRatio(index);
+    if (ratio >= 0) {
+        conf["ratio_pct"] = ratio;
+    } else {
+        conf["ratio_pct"] = nullptr;
+    }
+    if (ds.delivered > 0) {
+        conf["last_ack_ms"] = ds.last_ack_ms;
+        conf["max_ack_ms"] = ds.max_ack_ms;
+        conf["avg_ack_ms"] = (uint32_t)(ds.total_ack_ms / ds.delivered);
+    }
+    conf["ack_pending"] = runtime.ack_pending;
+    if (src.delivery.isPending(index)) {
+        conf["transmissions"] = src.delivery.getTransmissions(index);
+        long ack_retry_in = (long)(src.delivery.getRetryAt(index) - now);
+        if (ack_retry_in > 0) conf["retry_in_ms"] = ack_retry_in;
+    }
+}
+
+void apiProfile(JsonObject out, uint8_t index, const LoRaProfile& profile, bool active) {
+    char dev_eui[17], join_eui[17];
+    snprintf(dev_eui, sizeof(dev_eui), "%016llX", (unsigned long long)profile.devEUI);
+    snprintf(join_eui, sizeof(join_eui), "%016llX", (unsigned long long)profile.joinEUI);
+
+    out["index"] = index;
+    out["name"] = profile.name;
+    out["enabled"] = profile.enabled;
+    out["active"] = active;
+    out["activation"] = profile.abp ? "ABP" : "OTAA";
+    out["dev_eui"] = dev_eui;
+    out["join_eui"] = join_eui;
+    if (profile.abp) {
+        char addr[9];
+        snprintf(addr, sizeof(addr), "%08lX", (unsigned long)profile.devAddr);
+        out["dev_addr"] = addr;
+    }
+    out["region"] = profile.region < REGION_COUNT ? LORA_REGION_NAMES[profile.region] : "?";
+    out["payload_type"] = (int)profile.payload_type;
+    out["payload_format"] = profile.payload_type < PAYLOAD_TYPE_COUNT ? PAYLOAD_TYPE_NAMES[profile.payload_type] : "?";
+    out["confirm"] = profile.confirm < CONFIRM_MODE_COUNT ? CONFIRM_MODE_NAMES[profile.confirm] : "?";
+}
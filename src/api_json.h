@@ -0,0 +1,158 @@
+#ifndef API_JSON_H
+#define API_JSON_H
+
+#include <ArduinoJson.h>
+#include "config.h"
+#include "modbus_registers.h"
+#include "web_page_stats.h"
+#include "airtime_ledger.h"
+#include "uplink_scheduler.h"
+#include "link_quality.h"
+#include "join_backoff.h"
+#include "delivery_tracker.h"
+
+// ============================================================================
+// JSON API SERIALIZERS (/api/v1)
+// ============================================================================
+// The api*() functions fill an ArduinoJson object from the values passed in
+// (no globals, time as a parameter), so they run the same on the host.
+//
+// Documents never touch the heap: ApiArena hands ArduinoJson memory from a
+// fixed buffer, and ApiJsonOutput writes a response as one object whose
+// array elements are filled and serialized one at a time. The arena only
+// has to hold one element (one profile), whatever MAX_LORA_PROFILES is.
+
+// Memory for ArduinoJson documents from a fixed buffer (bump allocation)
+class ApiArena : public ArduinoJson::Allocator {
+public:
+    ApiArena(uint8_t* buffer, size_t size);
+
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr) override;
+    void* reallocate(void* ptr, size_t new_size) override;
+
+    // Start over at the beginning of the buffer; refused (false) while a
+    // document still holds a block
+    bool reset();
+
+    size_t getUsed() const { return used; }
+    size_t getPeak() const { return peak; }
+    uint32_t getFailures() const { return failures; }
+
+private:
+    uint8_t* buf;
+    size_t cap;
+    size_t used;
+    size_t peak;
+    size_t last;       // Offset of the newest block (grows in place), or cap
+    uint16_t live;     // Blocks not yet handed back
+    uint32_t failures;
+};
+
+// Output for serializeJson() (the response stream, or a string on the host)
+class ApiWriter {
+public:
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* data, size_t len) = 0;
+
+protected:
+    ~ApiWriter() {}
+};
+
+// One JSON object: the members filled into head(), then optionally one
+// array (openArray()) whose elements come from item(). Each part is
+// serialized and its memory released before the next one is filled.
+// If a part did not fit in the arena, what fit is sent and the object
+// ends with "truncated":true.
+class ApiJsonOutput {
+public:
+    ApiJsonOutput(ApiWriter& out, ApiArena& arena);
+
+    JsonObject head();
+    void openArray(const char* name);
+    JsonObject item();            // Writes the previous element first
+    bool end();                   // false: something was truncated
+
+    size_t getBytes() const { return bytes; }
+
+private:
+    enum State : uint8_t { STATE_HEAD, STATE_ARRAY, STATE_ITEM, STATE_DONE };
+
+    ApiWriter& out;
+    ApiArena& arena;
+    JsonDocument doc;
+    State state;
+    bool truncated;
+    bool head_members;            // Head written with at least one member
+    uint16_t items;
+    size_t bytes;
+
+    void writeRaw(const char* text);
+    void writeHead();             // Without the closing brace
+    void writeItem();
+    void release();
+};
+
+// ---- Inputs gathered by the web server ----
+
+struct ApiSystemStats {
+    uint32_t uptime_s;
+    uint32_t free_heap;
+    uint32_t min_free_heap;
+    uint32_t largest_free_block;   // Internal RAM
+    float temperature_c;
+    uint8_t wifi_ap_clients;
+    bool wifi_client_connected;
+    uint32_t log_written;
+    uint32_t log_dropped;
+    uint32_t api_arena_peak;       // Of API_ARENA_SIZE since boot
+    uint32_t api_arena_failures;   // Allocations refused (truncated responses)
+};
+
+struct ApiLoRaWANStatus {
+    bool joined;
+    uint32_t dev_addr;
+    uint32_t uplinks;
+    uint32_t downlinks;
+    uint32_t class_c_downlinks;
+    int16_t last_rssi;
+    uint8_t active_profile;
+    bool auto_rotation;
+    uint8_t enabled_profiles;
+};
+
+// Per-profile values only the LoRaWAN handler knows
+struct ApiProfileRuntime {
+    const LoRaProfile* profile;
+    uint8_t datarate;
+    uint16_t interval_s;
+    uint32_t next_airtime_ms;      // Time-on-air of the next uplink
+    bool ack_pending;
+};
+
+struct ApiLoRaWANSources {
+    const AirtimeLedger& airtime;
+    const UplinkScheduler& scheduler;
+    const LinkQualityHistory& links;
+    const JoinBackoff& joins;
+    const DeliveryTracker& delivery;
+};
+
+// ---- Serializers ----
+
+// /api/v1/registers: decoded holding and input registers plus the raw words
+void apiRegisters(JsonObject out, const HoldingRegisters& holding, const InputRegisters& input);
+
+// /api/v1/stats: system, Modbus and web server counters
+void apiStats(JsonObject out, const ApiSystemStats& system, const ModbusStats& modbus, const WebPageStats& web);
+
+// /api/v1/lorawan: network status and airtime per sub-band (head) ...
+void apiLoRaWANStatus(JsonObject out, const ApiLoRaWANStatus& status, const AirtimeLedger& airtime, unsigned long now);
+// ... and one element per enabled profile: schedule, airtime, link, joins, confirmed uplinks
+void apiLoRaWANProfile(JsonObject out, uint8_t index, const ApiProfileRuntime& runtime,
+                       const ApiLoRaWANSources& src, unsigned long now);
+
+// /api/v1/profiles: one element per profile (keys are never included)
+void apiProfile(JsonObject out, uint8_t index, const LoRaProfile& profile, bool active);
+
+#endif // API_JSON_H
@@ -1,4 +1,5 @@
 #include "auth_manager.h"
+#include "logger.h"
 #include "mbedtls/base64.h"
 
 // Global instance
@@ -31,12 +32,12 @@ void AuthManager::begin() {
 
 bool AuthManager::checkAuthentication(httpd_req_t* req) {
     if (debug_auth_enabled) {
-        Serial.printf(">>> Auth check: enabled=%d, user=%s\n", auth_enabled, username);
+        LOG_I(LOG_AUTH, "Auth check: enabled=%d, user=%s", auth_enabled, username);
     }
 
     if (!auth_enabled) {
         if (debug_auth_enabled) {
-            Serial.println(">>> Auth disabled, allowing access");
+            LOG_I(LOG_AUTH, "Auth disabled, allowing access");
         }
         return true;  // Auth disabled, allow access
     }
@@ -45,7 +46,7 @@ bool AuthManager::checkAuthentication(httpd_req_t* req) {
     size_t auth_len = httpd_req_get_hdr_value_len(req, "Authorization");
     if (auth_len == 0) {
         if (debug_auth_enabled) {
-            Serial.println(">>> No Authorization header, requesting credentials");
+            LOG_I(LOG_AUTH, "No Authorization header, requesting credentials");
         }
         return false;
     }
@@ -67,7 +68,7 @@ bool AuthManager::checkAuthentication(httpd_req_t* req) {
     // Parse Basic authentication header
     if (!authValue.startsWith("Basic ")) {
         if (debug_auth_enabled) {
-            Serial.println(">>> Invalid auth type (not Basic)");
+            LOG_I(LOG_AUTH, "Invalid auth type (not Basic)");
         }
         return false;
     }
@@ -85,7 +86,7 @@ bool AuthManager::checkAuthentication(httpd_req_t* req) {
 
     if (ret != 0) {
         if (debug_auth_enabled) {
-            Serial.printf(">>> Base64 decode failed: %d\n", ret);
+            LOG_I(LOG_AUTH, "Base64 decode failed: %d", ret);
         }
         return false;
     }
@@ -96,7 +97,7 @@ bool AuthManager::checkAuthentication(httpd_req_t* req) {
     int colonIndex = decodedCredentials.indexOf(':');
     if (colonIndex == -1) {
         if (debug_auth_enabled) {
-            Serial.println(">>> Invalid credentials format (no colon)");
+            LOG_I(LOG_AUTH, "Invalid credentials format (no colon)");
         }
         return false;
     }
@@ -107,14 +108,14 @@ bool AuthManager::checkAuthentication(httpd_req_t* req) {
     // Compare credentials
     if (providedUsername.equals(username) && providedPassword.equals(password)) {
         if (debug_auth_enabled) {
-            Serial.println(">>> Auth successful");
+            LOG_I(LOG_AUTH, "Auth successful");
         }
         return true;
     } else {
         if (debug_auth_enabled) {
-            Serial.println(">>> Auth failed - incorrect credentials");
-            Serial.printf(">>> Provided username: %s, expected: %s\n",
-                         providedUsername.c_str(), username);
+            LOG_I(LOG_AUTH, "Auth failed - incorrect credentials");
+            LOG_I(LOG_AUTH, "Provided username: %s, expected: %s",
+                providedUsername.c_str(), username);
         }
         return false;
     }
@@ -0,0 +1,63 @@
+#include "boot_timeline.h"
+
+// Global instance
+BootTimeline bootTimeline;
+
+static const char* const BOOT_EVENT_NAMES[BOOT_EVENT_COUNT] = {
+    "Display ready",
+    "Modbus RTU ready",
+    "Network up",
+    "HTTPS server started",
+    "HTTPS ready",
+    "LoRaWAN ready",
+    "Setup done",
+    "First Modbus response",
+    "First LoRaWAN uplink",
+    "Startup uplinks done"
+};
+
+BootTimeline::BootTimeline() :
+    summary_printed(false) {
+
+    memset(times, 0, sizeof(times));
+    memset(marked, 0, sizeof(marked));
+}
+
+void BootTimeline::mark(BootEvent event, unsigned long now) {
+    if (event >= BOOT_EVENT_COUNT || marked[event]) return;
+
+    marked[event] = true;
+    times[event] = now;
+    if (summary_printed) {
+        Serial.printf(">>> Boot timeline: %s at %lu ms\n", BOOT_EVENT_NAMES[event], now);
+    }
+
+    // HTTPS is reachable once the server runs and an interface is up, in either order
+    if ((event == BOOT_NETWORK_UP || event == BOOT_HTTPS_STARTED) &&
+        marked[BOOT_NETWORK_UP] && marked[BOOT_HTTPS_STARTED]) {
+        mark(BOOT_HTTPS_READY, now);
+    }
+}
+
+bool BootTimeline::reached(BootEvent event) const {
+    return event < BOOT_EVENT_COUNT && marked[event];
+}
+
+unsigned long BootTimeline::at(BootEvent event) const {
+    return reached(event) ? times[event] : 0;
+}
+
+void BootTimeline::print() {
+    Serial.println("\n========================================");
+    Serial.println("Boot Timeline");
+    Serial.println("========================================");
+    for (int i = 0; i < BOOT_EVENT_COUNT; i++) {
+        if (marked[i]) {
+            Serial.printf("  %-24s %6lu ms\n", BOOT_EVENT_NAMES[i], times[i]);
+        } else {
+            Serial.printf("  %-24s pending\n", BOOT_EVENT_NAMES[i]);
+        }
+    }
+    Serial.println("========================================\n");
+    summary_printed = true;
+}
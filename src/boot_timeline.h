@@ -0,0 +1,55 @@
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// BOOT TIMELINE
+// ============================================================================
+// Milestones from power-on (millis() at the first occurrence of each event).
+// setup() only starts the subsystems; Modbus and HTTPS start answering once
+// loop() runs, and the LoRaWAN startup uplinks go out from the scheduler after
+// that. The two figures that matter to a Modbus master or a browser are
+// "first Modbus response" and "HTTPS ready" (server started and a network
+// interface up, whichever comes last).
+//
+// Events reached during setup() are printed as one summary at its end; later
+// ones are logged as they happen.
+
+enum BootEvent : uint8_t {
+    BOOT_DISPLAY_READY = 0,
+    BOOT_MODBUS_READY,           // RTU slave configured (answers from the first loop())
+    BOOT_NETWORK_UP,             // WiFi AP started or client connected
+    BOOT_HTTPS_STARTED,          // HTTPS server listening
+    BOOT_HTTPS_READY,            // Both of the above
+    BOOT_LORAWAN_READY,          // Radio, profiles and sessions loaded; uplinks scheduled
+    BOOT_SETUP_DONE,
+    BOOT_FIRST_MODBUS_RESPONSE,
+    BOOT_FIRST_UPLINK,
+    BOOT_STARTUP_UPLINKS_DONE,
+    BOOT_EVENT_COUNT
+};
+
+class BootTimeline {
+public:
+    BootTimeline();
+
+    // Records the first occurrence only
+    void mark(BootEvent event, unsigned long now);
+    bool reached(BootEvent event) const;
+    unsigned long at(BootEvent event) const;
+
+    // Summary of the events reached so far (called at the end of setup());
+    // events after it are logged one by one
+    void print();
+
+private:
+    unsigned long times[BOOT_EVENT_COUNT];
+    bool marked[BOOT_EVENT_COUNT];
+    bool summary_printed;
+};
+
+// Global instance
+extern BootTimeline bootTimeline;
+
+#endif // BOOT_TIMELINE_H
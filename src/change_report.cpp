@@ -0,0 +1,110 @@
+#include "change_report.h"
+#include <string.h>
+
+const ReportField REPORT_FIELDS[BATCH_FIELD_COUNT] = {
+    { "Density",      LORAWAN_DEADBAND_DENSITY,      LORAWAN_LOW_ALARM_DENSITY },
+    { "Pressure@20C", LORAWAN_DEADBAND_PRESSURE,     LORAWAN_LOW_ALARM_PRESSURE },
+    { "Temperature",  LORAWAN_DEADBAND_TEMPERATURE,  0 },
+    { "Pressure var", LORAWAN_DEADBAND_PRESSURE_VAR, 0 }
+};
+
+ChangeReporter::ChangeReporter() {
+    memset(last_values, 0, sizeof(last_values));
+    memset(last_time, 0, sizeof(last_time));
+    memset(has_report, 0, sizeof(has_report));
+    memset(pending, 0, sizeof(pending));
+    memset(stats, 0, sizeof(stats));
+}
+
+void ChangeReporter::reported(uint8_t profile, const uint16_t* values, unsigned long now) {
+    if (profile >= MAX_LORA_PROFILES) return;
+    memcpy(last_values[profile], values, sizeof(last_values[profile]));
+    last_time[profile] = now;
+    has_report[profile] = true;
+    pending[profile] = REPORT_NONE;
+}
+
+ReportTrigger ChangeReporter::check(uint8_t profile, const uint16_t* values, unsigned long now) const {
+    if (profile >= MAX_LORA_PROFILES || !has_report[profile] || pending[profile] != REPORT_NONE) {
+        return REPORT_NONE;
+    }
+    bool rate_limited = now - last_time[profile] < LORAWAN_REPORT_MIN_INTERVAL_MS;
+    ReportTrigger trigger = REPORT_NONE;
+    triggeringField(last_values[profile], values, rate_limited, &trigger);
+    return trigger;
+}
+
+void ChangeReporter::requested(uint8_t profile, ReportTrigger trigger, const uint16_t* values) {
+    if (profile >= MAX_LORA_PROFILES || trigger == REPORT_NONE) return;
+
+    ReportTrigger ignored;
+    int field = triggeringField(last_values[profile], values, false, &ignored);
+    ReportStats& st = stats[profile];
+    if (trigger == REPORT_THRESHOLD) {
+        st.threshold_reports++;
+    } else {
+        st.deadband_reports++;
+    }
+    st.last_field = field < 0 ? 0 : (uint8_t)field;
+    pending[profile] = trigger;
+}
+
+bool ChangeReporter::isPending(uint8_t profile) const {
+    return getPending(profile) != REPORT_NONE;
+}
+
+ReportTrigger ChangeReporter::getPending(uint8_t profile) const {
+    return profile < MAX_LORA_PROFILES ? pending[profile] : REPORT_NONE;
+}
+
+void ChangeReporter::cancel(uint8_t profile) {
+    if (profile >= MAX_LORA_PROFILES) return;
+    pending[profile] = REPORT_NONE;
+}
+
+const ReportStats& ChangeReporter::getStats(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) profile = 0;
+    return stats[profile];
+}
+
+uint32_t ChangeReporter::getTotalReports() const {
+    uint32_t total = 0;
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        total += stats[i].deadband_reports + stats[i].threshold_reports;
+    }
+    return total;
+}
+
+bool ChangeReporter::inAlarm(const uint16_t* values) {
+    for (int f = 0; f < BATCH_FIELD_COUNT; f++) {
+        if (REPORT_FIELDS[f].low_alarm != 0 && values[f] < REPORT_FIELDS[f].low_alarm) return true;
+    }
+    return false;
+}
+
+int ChangeReporter::triggeringField(const uint16_t* reported, const uint16_t* values,
+                                    bool rate_limited, ReportTrigger* trigger) {
+    int deadband_field = -1;
+    for (int f = 0; f < BATCH_FIELD_COUNT; f++) {
+        const ReportField& rf = REPORT_FIELDS[f];
+
+        // Alarm state flips: below the level, back only above level + deadband
+        if (rf.low_alarm != 0) {
+            bool was_alarm = reported[f] < rf.low_alarm;
+            bool is_alarm = was_alarm ? values[f] < (uint32_t)rf.low_alarm + rf.deadband
+                                      : values[f] < rf.low_alarm;
+            if (is_alarm != was_alarm) {
+                *trigger = REPORT_THRESHOLD;
+                return f;
+            }
+        }
+
+        if (rf.deadband != 0 && deadband_field < 0 && !rate_limited) {
+            uint16_t delta = values[f] > reported[f] ? values[f] - reported[f] : reported[f] - values[f];
+            if (delta >= rf.deadband) deadband_field = f;
+        }
+    }
+
+    if (deadband_field >= 0) *trigger = REPORT_DEADBAND;
+    return deadband_field;
+}
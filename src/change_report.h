@@ -0,0 +1,80 @@
+#ifndef CHANGE_REPORT_H
+#define CHANGE_REPORT_H
+
+#include <stdint.h>
+#include "config.h"
+#include "sample_batch.h"
+
+// ============================================================================
+// REPORT ON CHANGE (DEADBANDS AND ALARM THRESHOLDS)
+// ============================================================================
+// Remembers, per profile, the input register values its last uplink carried and
+// asks for an extra uplink when the current values have moved far enough:
+//   Deadband   |value - reported| >= deadband, once LORAWAN_REPORT_MIN_INTERVAL_MS
+//              has passed since the profile's last uplink
+//   Threshold  value drops below the field's low-alarm level, or recovers to
+//              level + deadband (hysteresis). Not rate limited: alarms go out on
+//              the next free slot.
+// The regular period of the profile is the heartbeat (maximum reporting
+// interval). Fields use raw register units (see REPORT_FIELDS).
+//
+// Time is passed in by the caller (millis()), so the module has no Arduino
+// dependencies.
+
+enum ReportTrigger : uint8_t {
+    REPORT_NONE = 0,
+    REPORT_DEADBAND,
+    REPORT_THRESHOLD
+};
+
+struct ReportField {
+    const char* name;
+    uint16_t deadband;    // 0: changes of this field never trigger
+    uint16_t low_alarm;   // 0: no threshold
+};
+
+// Same field order as BatchSample: density, pressure@20C, temperature, pressure var
+extern const ReportField REPORT_FIELDS[BATCH_FIELD_COUNT];
+
+struct ReportStats {
+    uint32_t deadband_reports;    // Extra uplinks requested for a deadband
+    uint32_t threshold_reports;   // ... for a threshold crossing
+    uint8_t last_field;           // Field that caused the last request
+};
+
+class ChangeReporter {
+public:
+    ChangeReporter();
+
+    // An uplink of the profile carried these values
+    void reported(uint8_t profile, const uint16_t* values, unsigned long now);
+
+    // Should the profile send an extra uplink for `values`? Nothing triggers
+    // before the first report (no reference) or while a request is pending.
+    ReportTrigger check(uint8_t profile, const uint16_t* values, unsigned long now) const;
+    // Extra uplink requested; pending until the next reported()
+    void requested(uint8_t profile, ReportTrigger trigger, const uint16_t* values);
+    bool isPending(uint8_t profile) const;
+    ReportTrigger getPending(uint8_t profile) const;
+    // Profile left the schedule: the request was dropped with it
+    void cancel(uint8_t profile);
+
+    const ReportStats& getStats(uint8_t profile) const;
+    uint32_t getTotalReports() const;
+
+    // Any field below its low-alarm level (no hysteresis)
+    static bool inAlarm(const uint16_t* values);
+
+private:
+    uint16_t last_values[MAX_LORA_PROFILES][BATCH_FIELD_COUNT];
+    unsigned long last_time[MAX_LORA_PROFILES];
+    bool has_report[MAX_LORA_PROFILES];
+    ReportTrigger pending[MAX_LORA_PROFILES];
+    ReportStats stats[MAX_LORA_PROFILES];
+
+    // First field that triggers, or -1
+    static int triggeringField(const uint16_t* reported, const uint16_t* values,
+                               bool rate_limited, ReportTrigger* trigger);
+};
+
+#endif // CHANGE_REPORT_H
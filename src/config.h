@@ -24,6 +24,15 @@
 // Dark mode: false = Light mode, true = Dark mode
 #define WEB_DARK_MODE true
 
+// Pages are sent in chunks from a fixed buffer as they are rendered (html_stream.h);
+// false = render the whole page into one String first (for comparing heap and latency on /stats)
+#define WEB_STREAM_PAGES true
+#define WEB_CHUNK_SIZE   1024      // Bytes per chunk (one TLS record)
+
+// JSON API (/api/v1, api_json.h): ArduinoJson memory for one part of a response
+// (the head or one array element), from a static buffer instead of the heap
+#define API_ARENA_SIZE   4096
+
 // ============================================================================
 // DISPLAY CONFIGURATION
 // ============================================================================
@@ -55,7 +64,91 @@
 #define LORA_BUSY   13   // BUSY
 
 #define LORAWAN_ENABLED true
-#define MAX_LORA_PROFILES 4
+#define MAX_LORA_PROFILES 64              // Virtual end devices (profile index must fit in uint8_t, < 0xFE)
+#define LORAWAN_NODE_POOL_SIZE 8          // LoRaWANNode contexts kept in RAM (least recently used is evicted)
+#define LORAWAN_PROFILES_PER_PAGE 8       // Profiles per page on /lorawan/profiles
+#define LORAWAN_DEVEUI_INDEX_SIZE 128     // DevEUI hash slots (power of two, >= 2 x MAX_LORA_PROFILES)
+
+// Uplink timing
+#define LORAWAN_UPLINK_INTERVAL_MS 300000UL  // Per-profile uplink period (5 minutes)
+#define LORAWAN_STAGGER_MS         60000UL   // Gap between any two uplinks (1 minute), shortened when the profiles would not fit
+#define LORAWAN_STAGGER_FILL_PCT   80        // Share of the shortest period the gaps may fill (rest absorbs delays)
+#define LORAWAN_JOIN_BACKOFF_MIN_MS 15000UL   // First retry after a failed join (doubles per failure, jittered)
+#define LORAWAN_JOIN_BACKOFF_MAX_MS 3600000UL // Retry delay cap; the join duty cycle may hold longer
+#define LORAWAN_DEFAULT_DATARATE   5         // DR5 = SF7BW125 in every supported region (used for airtime estimates)
+
+// Adaptive data rate
+#define LORAWAN_ADR_ENABLED        true      // Accept LinkADRReq from the network server
+#define LORAWAN_ADR_BACKOFF_LIMIT  16        // Unanswered uplinks before the first DR step down
+#define LORAWAN_ADR_BACKOFF_DELAY  8         // Unanswered uplinks between further DR steps
+#define LORAWAN_LINK_CHECK_EVERY   8         // Piggyback a LinkCheckReq every Nth uplink per profile
+
+// Report on change: extra uplinks when an input register moves, heartbeat otherwise
+#define LORAWAN_REPORT_ON_CHANGE       false     // Deadband/threshold-triggered uplinks (change_report.h)
+#define LORAWAN_REPORT_MIN_INTERVAL_MS 60000UL   // Deadband reports at most this often per profile
+#define LORAWAN_REPORT_MAX_INTERVAL_MS 3600000UL // Default uplink period (heartbeat) when reporting on change
+#define LORAWAN_DEADBAND_DENSITY       100       // 1.00 kg/m3 (register units, 0 = never triggers)
+#define LORAWAN_DEADBAND_PRESSURE      200       // 20.0 kPa
+#define LORAWAN_DEADBAND_TEMPERATURE   50        // 5.0 K
+#define LORAWAN_DEADBAND_PRESSURE_VAR  0         // Mirrors pressure@20C
+#define LORAWAN_LOW_ALARM_DENSITY      2000      // 20.00 kg/m3 (0 = no threshold); clears at alarm + deadband
+#define LORAWAN_LOW_ALARM_PRESSURE     4500      // 450.0 kPa
+
+// Confirmed uplinks (per profile: none, alarm frames or all; delivery_tracker.h)
+#define LORAWAN_DEFAULT_CONFIRM        CONFIRM_ALARMS  // Mode of newly generated profiles
+#define LORAWAN_CONFIRM_MAX_RETRIES    3         // Retransmissions before a confirmed frame counts as lost
+#define LORAWAN_CONFIRM_RETRY_MIN_MS   30000UL   // First retry after 15-30 s, doubling per retry
+#define LORAWAN_CONFIRM_RETRY_MAX_MS   600000UL  // Backoff cap (10 minutes)
+
+// Device class
+#define LORAWAN_CLASS_C            false     // Listen on RX2 between uplinks (mains power; set Class C on the network server too)
+
+// Frame history: every uplink, downlink and join request, queried on /lorawan/frames
+#define LORAWAN_FRAME_HISTORY_SIZE     1024  // Records kept in PSRAM (~92 KB)
+#define LORAWAN_FRAME_HISTORY_FALLBACK 64    // Records in internal RAM when there is no PSRAM
+#define LORAWAN_FRAME_PAYLOAD_MAX      64    // Payload bytes kept per record (longer frames are cut)
+#define LORAWAN_FRAME_PAGE_MAX         50    // Records per query page
+
+// Diagnostics
+#define LORAWAN_PAYLOAD_BREAKDOWN  false     // Print every uplink field by field (slow; debugging only)
+#define LORAWAN_CODEC_SELFTEST     false     // Check encoders against the decoder golden vectors at boot
+
+// Regional channel plans (per profile; tables in lora_region.cpp)
+enum LoRaRegion : uint8_t {
+    REGION_EU868 = 0,
+    REGION_AS923_1 = 1,      // AS923 923.2/923.4 MHz (e.g. Japan, Singapore, Thailand)
+    REGION_AS923_2 = 2,      // 921.4/921.6 MHz (e.g. Indonesia, Vietnam)
+    REGION_AS923_3 = 3,      // 916.6/916.8 MHz (e.g. Philippines)
+    REGION_AS923_4 = 4,      // 917.3/917.5 MHz (Israel)
+    REGION_AU915 = 5,        // 915-928 MHz, 8-channel sub-band LORAWAN_AU915_SUBBAND
+    REGION_COUNT
+};
+
+const char* const LORA_REGION_NAMES[] = {
+    "EU868",
+    "AS923-1",
+    "AS923-2",
+    "AS923-3",
+    "AS923-4",
+    "AU915"
+};
+
+#define LORAWAN_DEFAULT_REGION     REGION_EU868  // Region of newly generated profiles
+#define LORAWAN_AU915_SUBBAND      2         // 8-channel sub-band 1-8 (TTN and most AU915 networks: 2)
+
+// Which uplinks of a profile are sent confirmed (acknowledged, retransmitted)
+enum ConfirmMode : uint8_t {
+    CONFIRM_NONE = 0,        // Unconfirmed only (records saved before confirmed uplinks existed)
+    CONFIRM_ALARMS = 1,      // Frames with a register below its low-alarm level or an alarm change
+    CONFIRM_ALL = 2,
+    CONFIRM_MODE_COUNT
+};
+
+const char* const CONFIRM_MODE_NAMES[] = {
+    "Unconfirmed",
+    "Alarm frames",
+    "All frames"
+};
 
 // LoRaWAN Payload Types
 enum PayloadType {
@@ -63,7 +156,10 @@ enum PayloadType {
     PAYLOAD_CAYENNE_LPP = 1,          // Cayenne LPP format (variable length)
     PAYLOAD_RAW_MODBUS = 2,           // Raw Modbus registers (10 bytes)
     PAYLOAD_CUSTOM = 3,               // Custom user-defined format (13 bytes)
-    PAYLOAD_VISTRON_LORA_MOD_CON = 4  // Vistron LoRa Mod Con format (16 bytes)
+    PAYLOAD_VISTRON_LORA_MOD_CON = 4, // Vistron LoRa Mod Con format (16 bytes)
+    PAYLOAD_BATCHED_DELTA = 5,        // Multi-sample delta-compressed SF6 format (variable)
+    PAYLOAD_USER_MAP = 6,             // Register layout defined on the web interface (payload_map.h)
+    PAYLOAD_TYPE_COUNT                // Layouts and encoders: payload_codec.cpp
 };
 
 // Payload type names for display
@@ -72,9 +168,20 @@ const char* const PAYLOAD_TYPE_NAMES[] = {
     "Cayenne LPP",
     "Raw Modbus Registers",
     "Custom",
-    "Vistron Lora Mod Con"
+    "Vistron Lora Mod Con",
+    "Batched Delta SF6",
+    "User Mapping"
 };
 
+// Batched delta payload: sample buffer shared by all profiles
+#define LORAWAN_BATCH_SAMPLE_MS    30000UL  // Sample interval (10 samples per 5-minute uplink)
+#define LORAWAN_BATCH_BUFFER_SIZE  64       // Samples kept in RAM (32 minutes at 30 s)
+#define LORAWAN_BATCH_FPORT        3        // Batched frames use their own FPort
+#define LORAWAN_BATCH_FOPTS_RESERVE 15      // Leave room for piggybacked MAC commands
+
+// User payload mapping: one layout for every profile that selects it
+#define LORAWAN_MAP_FPORT          4        // Mapped frames use their own FPort
+
 // LoRaWAN Profile Structure
 struct LoRaProfile {
     char name[33];           // Profile name (32 chars + null)
@@ -84,12 +191,92 @@ struct LoRaProfile {
     uint8_t nwkKey[16];      // 128-bit NwkKey (MSB)
     bool enabled;            // Profile enabled/disabled
     PayloadType payload_type; // Payload format for this profile
+    // Fields below were added after the raw NVS struct (LEGACY_PROFILE_SIZE)
+    bool abp;                // Activation: false = OTAA join, true = ABP (no join traffic)
+    LoRaRegion region;       // Channel plan (fits the padding after `abp`)
+    ConfirmMode confirm;     // Confirmed uplinks (padding as well)
+    uint32_t devAddr;        // ABP device address
+    uint8_t nwkSKey[16];     // ABP network session key (LoRaWAN 1.0.x NwkSKey, MSB)
+    uint8_t appSKey[16];     // ABP application session key (MSB)
 };
 
 // ============================================================================
 // WIFI CONFIGURATION
 // ============================================================================
 const unsigned long WIFI_TIMEOUT_MS = 20 * 60 * 1000;  // 20 minutes
+const unsigned long WIFI_CONNECT_TIMEOUT_MS = 10 * 1000;  // Boot-time client connect before falling back to AP
+
+// ============================================================================
+// POWER MANAGEMENT
+// ============================================================================
+// Battery operation: sleep between uplinks once the service window after a
+// cold boot is over (power_manager.h). WiFi, HTTPS and Modbus are available
+// during the service window only.
+enum PowerMode : uint8_t {
+    POWER_ALWAYS_ON = 0,     // Mains power: never sleeps
+    POWER_LIGHT_SLEEP = 1,   // RAM kept; wakes for uplinks and batch samples
+    POWER_DEEP_SLEEP = 2     // Restarts at every wake; LoRaWAN state kept in RTC memory
+};
+
+const char* const POWER_MODE_NAMES[] = {
+    "Always on",
+    "Light sleep",
+    "Deep sleep"
+};
+
+#define POWER_MODE                POWER_ALWAYS_ON
+const unsigned long POWER_SERVICE_WINDOW_MS = 10 * 60 * 1000;  // Awake with WiFi after a cold boot
+#define POWER_MIN_SLEEP_MS        2000UL    // Shorter idle periods are spent awake
+
+// Energy estimate: board-level current per state (uA); measure your hardware
+#define POWER_SUPPLY_MV           3700      // Battery voltage (Li-ion nominal)
+#define POWER_BATTERY_MAH         3000      // Capacity for the battery life estimate
+#define POWER_ACTIVE_UA           45000     // ESP32-S3 running, WiFi off, radio idle
+#define POWER_WIFI_UA             80000     // On top of active while WiFi is on
+#define POWER_TX_UA               60000     // On top of active: SX1262 TX at +14..16 dBm
+#define POWER_RX_UA               5000      // On top of active: SX1262 RX
+#define POWER_RX_WINDOW_MS        50        // Radio listening per receive window (longer at SF12)
+#define POWER_LIGHT_SLEEP_UA      1500      // Light sleep, radio asleep (regulator and e-ink idle included)
+#define POWER_DEEP_SLEEP_UA       150       // Deep sleep, radio asleep
+
+// ============================================================================
+// LOGGING
+// ============================================================================
+// Deferred logging (logger.h): records are queued in binary form and printed
+// by a background task. Levels: 0=none, 1=error, 2=warn, 3=info, 4=debug, 5=verbose
+enum LogModule : uint8_t {
+    LOG_SYSTEM = 0,
+    LOG_LORAWAN,
+    LOG_CODEC,
+    LOG_SESSION,
+    LOG_MODBUS,
+    LOG_AUTH,
+    LOG_DISPLAY,
+    LOG_WEB,
+    LOG_MODULE_COUNT
+};
+
+const char* const LOG_MODULE_NAMES[] = {
+    "System",
+    "LoRaWAN",
+    "Codec",
+    "Session",
+    "Modbus",
+    "Auth",
+    "Display",
+    "Web"
+};
+
+#define LOG_COMPILE_LEVEL         4         // Calls above this level are not compiled in
+#define LOG_DEFAULT_LEVEL         3         // Runtime level of every module until changed on /logs
+#define LOG_RING_RECORDS          64        // Records waiting to be printed (power of two)
+#define LOG_RECORD_SIZE           128       // Bytes per record: header, format pointer, arguments
+#define LOG_LINE_MAX              256       // Formatted line (longer lines are cut)
+#define LOG_WEB_BUFFER            4096      // Recent lines kept for /logs
+#define LOG_MAX_SINKS             4         // Serial, /logs and addSink() outputs
+#define LOG_DRAIN_MS              20        // Drain task poll interval
+#define LOG_TASK_PRIORITY         1         // Below the web server and WiFi tasks
+#define LOG_TASK_STACK            4096
 
 // ============================================================================
 // OTA UPDATE CONFIGURATION
@@ -0,0 +1,87 @@
+#include "delivery_tracker.h"
+#include <string.h>
+
+DeliveryTracker::DeliveryTracker() {
+    memset(outstanding, 0, sizeof(outstanding));
+    memset(stats, 0, sizeof(stats));
+}
+
+void DeliveryTracker::sent(uint8_t profile, unsigned long now) {
+    if (profile >= MAX_LORA_PROFILES) return;
+    Outstanding& o = outstanding[profile];
+    if (o.pending) {
+        stats[profile].retries++;
+    } else {
+        stats[profile].messages++;
+        o.pending = true;
+        o.first_sent = now;
+        o.transmissions = 0;
+    }
+    if (o.transmissions < 0xFF) o.transmissions++;
+}
+
+void DeliveryTracker::acknowledged(uint8_t profile, unsigned long now) {
+    if (profile >= MAX_LORA_PROFILES || !outstanding[profile].pending) return;
+    Outstanding& o = outstanding[profile];
+    DeliveryStats& st = stats[profile];
+
+    st.delivered++;
+    if (o.transmissions == 1) st.first_try++;
+    st.last_ack_ms = now - o.first_sent;
+    if (st.last_ack_ms > st.max_ack_ms) st.max_ack_ms = st.last_ack_ms;
+    st.total_ack_ms += st.last_ack_ms;
+    o.pending = false;
+}
+
+bool DeliveryTracker::unacknowledged(uint8_t profile, unsigned long now, uint32_t random) {
+    if (profile >= MAX_LORA_PROFILES || !outstanding[profile].pending) return false;
+    Outstanding& o = outstanding[profile];
+
+    if (o.transmissions > LORAWAN_CONFIRM_MAX_RETRIES) {
+        stats[profile].lost++;
+        o.pending = false;
+        return false;
+    }
+
+    // Exponential backoff, jitter over the upper half: [delay / 2, delay)
+    uint32_t delay = LORAWAN_CONFIRM_RETRY_MIN_MS;
+    for (uint8_t i = 1; i < o.transmissions && delay < LORAWAN_CONFIRM_RETRY_MAX_MS; i++) {
+        delay *= 2;
+    }
+    if (delay > LORAWAN_CONFIRM_RETRY_MAX_MS) delay = LORAWAN_CONFIRM_RETRY_MAX_MS;
+    delay = delay / 2 + random % (delay / 2);
+
+    o.retry_at = now + delay;
+    return true;
+}
+
+void DeliveryTracker::cancel(uint8_t profile) {
+    if (profile >= MAX_LORA_PROFILES) return;
+    outstanding[profile].pending = false;
+}
+
+bool DeliveryTracker::isPending(uint8_t profile) const {
+    return profile < MAX_LORA_PROFILES && outstanding[profile].pending;
+}
+
+uint8_t DeliveryTracker::getTransmissions(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES || !outstanding[profile].pending) return 0;
+    return outstanding[profile].transmissions;
+}
+
+unsigned long DeliveryTracker::getRetryAt(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) return 0;
+    return outstanding[profile].retry_at;
+}
+
+const DeliveryStats& DeliveryTracker::getStats(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) profile = 0;
+    return stats[profile];
+}
+
+int DeliveryTracker::deliveryRatio(uint8_t profile) const {
+    const DeliveryStats& st = getStats(profile);
+    uint32_t completed = st.delivered + st.lost;
+    if (completed == 0) return -1;
+    return (int)((uint64_t)st.delivered * 100 / completed);
+}
@@ -0,0 +1,71 @@
+#ifndef DELIVERY_TRACKER_H
+#define DELIVERY_TRACKER_H
+
+#include <stdint.h>
+#include "config.h"
+
+// ============================================================================
+// CONFIRMED UPLINK DELIVERY (PER PROFILE)
+// ============================================================================
+// Retransmission state and delivery statistics of confirmed uplinks. A profile
+// has at most one confirmed message outstanding. Without an ACK it is
+// retransmitted after an exponential backoff (LORAWAN_CONFIRM_RETRY_MIN_MS
+// doubling up to LORAWAN_CONFIRM_RETRY_MAX_MS, jitter over the upper half of
+// the delay) until LORAWAN_CONFIRM_MAX_RETRIES retransmissions went
+// unanswered; the message then counts as lost.
+//
+// Every transmission is a new frame (new FCnt) carrying the current values, so
+// a retransmission never reports stale data. The profile's regular uplink is
+// sent confirmed too while a message is outstanding and counts as a
+// retransmission if it comes first.
+//
+// ACK latency is measured from the first transmission of a message to its ACK
+// and includes the retransmissions. Time and randomness are passed in by the
+// caller, so the module has no Arduino dependencies.
+
+struct DeliveryStats {
+    uint32_t messages;        // Confirmed messages (first transmissions)
+    uint32_t delivered;       // Acknowledged, on any transmission
+    uint32_t first_try;       // Acknowledged on the first transmission
+    uint32_t lost;            // No ACK after all retransmissions
+    uint32_t retries;         // Retransmissions sent
+    uint32_t last_ack_ms;     // First transmission -> ACK of the last delivered message
+    uint32_t max_ack_ms;
+    uint64_t total_ack_ms;
+};
+
+class DeliveryTracker {
+public:
+    DeliveryTracker();
+
+    // A confirmed frame went on air (first transmission or retransmission)
+    void sent(uint8_t profile, unsigned long now);
+    // Outcome of that frame. Without an ACK the retransmission time is set
+    // (getRetryAt) and true returned; false means the message is lost.
+    // `random` is any uniformly distributed value (jitter).
+    void acknowledged(uint8_t profile, unsigned long now);
+    bool unacknowledged(uint8_t profile, unsigned long now, uint32_t random);
+    // Profile disabled or credentials changed: drop the message, not counted
+    void cancel(uint8_t profile);
+
+    bool isPending(uint8_t profile) const;        // Message waiting for an ACK
+    uint8_t getTransmissions(uint8_t profile) const;  // Of the outstanding message
+    unsigned long getRetryAt(uint8_t profile) const;
+    const DeliveryStats& getStats(uint8_t profile) const;
+
+    // Delivered / (delivered + lost) in percent, -1 before any message completed
+    int deliveryRatio(uint8_t profile) const;
+
+private:
+    struct Outstanding {
+        unsigned long first_sent;
+        unsigned long retry_at;
+        uint8_t transmissions;
+        bool pending;
+    };
+
+    Outstanding outstanding[MAX_LORA_PROFILES];
+    DeliveryStats stats[MAX_LORA_PROFILES];
+};
+
+#endif // DELIVERY_TRACKER_H
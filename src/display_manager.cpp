@@ -1,6 +1,7 @@
 #include "display_manager.h"
 #include "modbus_handler.h"  // For register structures
 #include "lorawan_handler.h"  // For LoRaWANHandler
+#include "logger.h"
 #include <WiFi.h>
 
 // Dark mode color definitions
@@ -339,18 +340,18 @@ void DisplayManager::update(
         display.update();  // Partial refresh (fast, no flicker)
     }
 
-    // Debug output
-    Serial.println("Display updated - SF6 sensors with text labels");
-    Serial.printf("  Density: %.2f kg/m3 (reg=%d)\n", input.sf6_density/100.0, input.sf6_density);
-    Serial.printf("  Pressure: %.1f kPa (reg=%d)\n", input.sf6_pressure_20c/10.0, input.sf6_pressure_20c);
-    Serial.printf("  Temperature: %.1fC (reg=%d)\n", temp_celsius, input.sf6_temperature);
-    Serial.printf("  Pressure Var: %.1f kPa (reg=%d)\n", input.sf6_pressure_var/10.0, input.sf6_pressure_var);
+    // Debug output (register details at debug level)
+    LOG_I(LOG_DISPLAY, "Display updated - SF6 sensors with text labels");
+    LOG_D(LOG_DISPLAY, "  Density: %.2f kg/m3 (reg=%d)", input.sf6_density/100.0, input.sf6_density);
+    LOG_D(LOG_DISPLAY, "  Pressure: %.1f kPa (reg=%d)", input.sf6_pressure_20c/10.0, input.sf6_pressure_20c);
+    LOG_D(LOG_DISPLAY, "  Temperature: %.1fC (reg=%d)", temp_celsius, input.sf6_temperature);
+    LOG_D(LOG_DISPLAY, "  Pressure Var: %.1f kPa (reg=%d)", input.sf6_pressure_var/10.0, input.sf6_pressure_var);
     if (wifi_client_connected) {
-        Serial.printf("  WiFi: Client Mode - SSID: %s, IP: %s\n", WiFi.SSID().c_str(), WiFi.localIP().toString().c_str());
+        LOG_D(LOG_DISPLAY, "  WiFi: Client Mode - SSID: %s, IP: %s", WiFi.SSID().c_str(), WiFi.localIP().toString().c_str());
     } else {
-        Serial.printf("  WiFi: %s (%d clients)\n", holding.wifi_enabled ? "AP Mode" : "OFF", holding.wifi_clients);
+        LOG_D(LOG_DISPLAY, "  WiFi: %s (%d clients)", holding.wifi_enabled ? "AP Mode" : "OFF", holding.wifi_clients);
     }
-    Serial.printf("  Slave ID: %d, Counter: %d, Uptime: %d\n", modbus_slave_id, holding.sequential_counter, holding.uptime_seconds);
+    LOG_D(LOG_DISPLAY, "  Slave ID: %d, Counter: %d, Uptime: %d", modbus_slave_id, holding.sequential_counter, holding.uptime_seconds);
 }
 
 void DisplayManager::showWiFiCredentials(const char* ssid, const char* password) {
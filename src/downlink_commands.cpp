@@ -0,0 +1,120 @@
+#include "downlink_commands.h"
+#include "lorawan_handler.h"
+#include "sf6_emulator.h"
+#include "logger.h"
+
+// ============================================================================
+// COMMAND ACTIONS (one profile each)
+// ============================================================================
+
+static uint8_t setInterval(uint8_t index, uint16_t seconds) {
+    return lorawanHandler.setUplinkInterval(index, seconds) ? CMD_STATUS_OK : CMD_STATUS_REJECTED;
+}
+
+static uint8_t setPayloadFormat(uint8_t index, uint16_t format) {
+    return lorawanHandler.setPayloadType(index, (PayloadType)format) ? CMD_STATUS_OK : CMD_STATUS_REJECTED;
+}
+
+static uint8_t requestUplink(uint8_t index, uint16_t) {
+    return lorawanHandler.requestUplink(index) ? CMD_STATUS_OK : CMD_STATUS_REJECTED;
+}
+
+static uint16_t readU16(const uint8_t* p) {
+    return ((uint16_t)p[0] << 8) | p[1];
+}
+
+// ============================================================================
+// FRAME PROCESSING
+// ============================================================================
+
+size_t DownlinkCommands::process(uint8_t profile, const uint8_t* data, size_t len,
+                                 uint8_t downlink_fcnt, uint8_t* ack) {
+    LOG_I(LOG_LORAWAN, "Downlink command frame for profile %d (%u bytes)", profile, (unsigned)len);
+
+    ack[0] = downlink_fcnt;
+    ack[1] = 0;
+    size_t ack_len = 2;
+
+    size_t pos = 0;
+    while (pos < len && ack[1] < LORAWAN_CMD_MAX_RESULTS) {
+        uint8_t cmd = data[pos++];
+        size_t consumed = 0;
+        uint8_t status = apply(profile, cmd, data + pos, len - pos, &consumed);
+
+        LOG_I(LOG_LORAWAN, "    Command 0x%02X -> status %d", cmd, status);
+        ack[ack_len++] = cmd;
+        ack[ack_len++] = status;
+        ack[1]++;
+
+        // Argument length is only known for valid command ids
+        if (status == CMD_STATUS_UNKNOWN || status == CMD_STATUS_TRUNCATED) break;
+        pos += consumed;
+    }
+
+    if (pos < len && ack[1] == LORAWAN_CMD_MAX_RESULTS) {
+        LOG_W(LOG_LORAWAN, "More than %d commands in one frame, rest ignored", LORAWAN_CMD_MAX_RESULTS);
+    }
+    return ack_len;
+}
+
+uint8_t DownlinkCommands::apply(uint8_t profile, uint8_t cmd, const uint8_t* args, size_t args_len, size_t* consumed) {
+    switch (cmd) {
+        case CMD_SET_INTERVAL: {
+            *consumed = 3;
+            if (args_len < 3) return CMD_STATUS_TRUNCATED;
+            uint16_t seconds = readU16(args + 1);
+            if (seconds < CMD_MIN_INTERVAL_S) return CMD_STATUS_INVALID_ARG;
+            return forEachTarget(profile, args[0], setInterval, seconds);
+        }
+
+        case CMD_SET_PAYLOAD_FORMAT:
+            *consumed = 2;
+            if (args_len < 2) return CMD_STATUS_TRUNCATED;
+            if (args[1] >= PAYLOAD_TYPE_COUNT) return CMD_STATUS_INVALID_ARG;
+            return forEachTarget(profile, args[0], setPayloadFormat, args[1]);
+
+        case CMD_SET_PROFILE_ENABLED:
+            *consumed = 2;
+            if (args_len < 2) return CMD_STATUS_TRUNCATED;
+            if (args[0] >= MAX_LORA_PROFILES || args[1] > 1) return CMD_STATUS_INVALID_ARG;
+            return lorawanHandler.setProfileEnabled(args[0], args[1] == 1) ? CMD_STATUS_OK : CMD_STATUS_REJECTED;
+
+        case CMD_SET_SF6_VALUES: {
+            *consumed = 6;
+            if (args_len < 6) return CMD_STATUS_TRUNCATED;
+            // Same register scaling and limits as the web form
+            uint16_t density = readU16(args);
+            uint16_t pressure = readU16(args + 2);
+            uint16_t temperature = readU16(args + 4);
+            if (density > 6000 || pressure > 11000 || temperature < 2150 || temperature > 3600) {
+                return CMD_STATUS_INVALID_ARG;
+            }
+            sf6Emulator.setValues(density / 100.0f, pressure / 10.0f, temperature / 10.0f);
+            return CMD_STATUS_OK;
+        }
+
+        case CMD_REQUEST_UPLINK:
+            *consumed = 1;
+            if (args_len < 1) return CMD_STATUS_TRUNCATED;
+            return forEachTarget(profile, args[0], requestUplink, 0);
+
+        default:
+            return CMD_STATUS_UNKNOWN;
+    }
+}
+
+uint8_t DownlinkCommands::forEachTarget(uint8_t profile, uint8_t target,
+                                        uint8_t (*fn)(uint8_t index, uint16_t arg), uint16_t arg) {
+    if (target == CMD_TARGET_SELF) target = profile;
+    if (target != CMD_TARGET_ALL) {
+        if (target >= MAX_LORA_PROFILES) return CMD_STATUS_INVALID_ARG;
+        return fn(target, arg);
+    }
+
+    // All profiles: OK if it applied to at least one
+    uint8_t status = CMD_STATUS_REJECTED;
+    for (uint8_t i = 0; i < MAX_LORA_PROFILES; i++) {
+        if (fn(i, arg) == CMD_STATUS_OK) status = CMD_STATUS_OK;
+    }
+    return status;
+}
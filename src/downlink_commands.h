@@ -0,0 +1,63 @@
+#ifndef DOWNLINK_COMMANDS_H
+#define DOWNLINK_COMMANDS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// DOWNLINK COMMAND PROTOCOL (FPORT 10)
+// ============================================================================
+// A command downlink holds one or more commands back to back:
+//   [cmd id][arguments] [cmd id][arguments] ...
+// All multi-byte values are big-endian. Commands take effect immediately
+// (no reboot) and persist where the setting is stored in NVS.
+//
+//   0x01 SET_INTERVAL        [target][seconds u16]      Uplink period, 60-65535 s
+//   0x02 SET_PAYLOAD_FORMAT  [target][format]           PayloadType 0-6
+//   0x03 SET_PROFILE_ENABLED [profile][0|1]             Enable/disable a profile
+//   0x04 SET_SF6_VALUES      [density u16][pressure u16][temperature u16]
+//                            Register scaling: kg/m3 x100, kPa x10, K x10
+//   0x05 REQUEST_UPLINK      [target]                   One extra uplink ASAP
+//
+// target: profile index 0..MAX_LORA_PROFILES-1, 0xFE = the receiving profile,
+//         0xFF = all profiles
+//
+// The result of every command is acknowledged in the receiving profile's next
+// uplink. That uplink is sent on FPort 10 instead of its usual port:
+//   [downlink FCnt & 0xFF][N][cmd id, status] x N [original FPort][original payload]
+
+#define LORAWAN_CMD_FPORT          10
+#define LORAWAN_CMD_MAX_RESULTS    8
+#define LORAWAN_CMD_ACK_MAX        (2 + 2 * LORAWAN_CMD_MAX_RESULTS)
+
+#define CMD_SET_INTERVAL           0x01
+#define CMD_SET_PAYLOAD_FORMAT     0x02
+#define CMD_SET_PROFILE_ENABLED    0x03
+#define CMD_SET_SF6_VALUES         0x04
+#define CMD_REQUEST_UPLINK         0x05
+
+#define CMD_TARGET_SELF            0xFE
+#define CMD_TARGET_ALL             0xFF
+
+#define CMD_STATUS_OK              0x00
+#define CMD_STATUS_UNKNOWN         0x01  // Unknown command id (rest of the frame is skipped)
+#define CMD_STATUS_INVALID_ARG     0x02  // Argument out of range
+#define CMD_STATUS_TRUNCATED       0x03  // Frame ended inside the arguments
+#define CMD_STATUS_REJECTED        0x04  // Valid but not allowed in the current state
+
+#define CMD_MIN_INTERVAL_S         60
+
+class DownlinkCommands {
+public:
+    // Parse and apply a command frame received by `profile`. Writes the
+    // acknowledgement block to `ack` (at least LORAWAN_CMD_ACK_MAX bytes) and
+    // returns its length.
+    static size_t process(uint8_t profile, const uint8_t* data, size_t len,
+                          uint8_t downlink_fcnt, uint8_t* ack);
+
+private:
+    static uint8_t apply(uint8_t profile, uint8_t cmd, const uint8_t* args, size_t args_len, size_t* consumed);
+    static uint8_t forEachTarget(uint8_t profile, uint8_t target, uint8_t (*fn)(uint8_t index, uint16_t arg), uint16_t arg);
+};
+
+#endif // DOWNLINK_COMMANDS_H
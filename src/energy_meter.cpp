@@ -0,0 +1,93 @@
+#include "energy_meter.h"
+#include <string.h>
+
+const char* const ENERGY_STATE_NAMES[ENERGY_STATE_COUNT] = {
+    "Active",
+    "WiFi",
+    "Radio TX",
+    "Radio RX",
+    "Light sleep",
+    "Deep sleep"
+};
+
+EnergyMeter::EnergyMeter() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+uint32_t EnergyMeter::currentUa(EnergyState state) {
+    switch (state) {
+        case ENERGY_ACTIVE:      return POWER_ACTIVE_UA;
+        case ENERGY_WIFI:        return POWER_WIFI_UA;
+        case ENERGY_TX:          return POWER_TX_UA;
+        case ENERGY_RX:          return POWER_RX_UA;
+        case ENERGY_LIGHT_SLEEP: return POWER_LIGHT_SLEEP_UA;
+        case ENERGY_DEEP_SLEEP:  return POWER_DEEP_SLEEP_UA;
+        default:                 return 0;
+    }
+}
+
+uint32_t EnergyMeter::toMicrojoules(uint64_t charge_nc) {
+    // nC x mV = pJ
+    return (uint32_t)(charge_nc * POWER_SUPPLY_MV / 1000000ULL);
+}
+
+void EnergyMeter::add(EnergyState state, uint32_t ms) {
+    if (state >= ENERGY_STATE_COUNT || ms == 0) return;
+
+    uint64_t charge = (uint64_t)ms * currentUa(state);
+    stats.charge_nc[state] += charge;
+    stats.time_ms[state] += ms;
+    stats.account_nc += charge;
+}
+
+void EnergyMeter::uplinkSent() {
+    stats.uplinks++;
+    stats.uplinks_nc += stats.account_nc;
+    stats.last_uplink_uj = toMicrojoules(stats.account_nc);
+    stats.account_nc = 0;
+}
+
+uint32_t EnergyMeter::lastUplinkUj() const {
+    return stats.last_uplink_uj;
+}
+
+uint32_t EnergyMeter::averageUplinkUj() const {
+    if (stats.uplinks == 0) return 0;
+    return toMicrojoules(stats.uplinks_nc / stats.uplinks);
+}
+
+uint64_t EnergyMeter::elapsedMs() const {
+    return stats.time_ms[ENERGY_ACTIVE] + stats.time_ms[ENERGY_LIGHT_SLEEP] + stats.time_ms[ENERGY_DEEP_SLEEP];
+}
+
+uint32_t EnergyMeter::averageCurrentUa() const {
+    uint64_t elapsed = elapsedMs();
+    if (elapsed == 0) return 0;
+
+    uint64_t total = 0;
+    for (int i = 0; i < ENERGY_STATE_COUNT; i++) {
+        total += stats.charge_nc[i];
+    }
+    return (uint32_t)(total / elapsed);
+}
+
+uint32_t EnergyMeter::batteryLifeHours() const {
+    uint32_t current = averageCurrentUa();
+    if (current == 0) return 0;
+    return (uint32_t)((uint64_t)POWER_BATTERY_MAH * 1000 / current);
+}
+
+uint32_t EnergyMeter::sleepPermille() const {
+    uint64_t elapsed = elapsedMs();
+    if (elapsed == 0) return 0;
+    uint64_t asleep = stats.time_ms[ENERGY_LIGHT_SLEEP] + stats.time_ms[ENERGY_DEEP_SLEEP];
+    return (uint32_t)(asleep * 1000 / elapsed);
+}
+
+const EnergyStats& EnergyMeter::getStats() const {
+    return stats;
+}
+
+void EnergyMeter::restore(const EnergyStats& saved) {
+    stats = saved;
+}
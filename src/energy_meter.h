@@ -0,0 +1,70 @@
+#ifndef ENERGY_METER_H
+#define ENERGY_METER_H
+
+#include <stdint.h>
+#include "config.h"
+
+// ============================================================================
+// ENERGY ESTIMATE
+// ============================================================================
+// Charge drawn by the board, estimated from the time spent in each state and
+// the currents configured in config.h (POWER_*_UA). Nothing is measured
+// electrically; the figures are as good as the currents entered for the
+// hardware. WiFi, TX and RX are counted on top of the running MCU.
+//
+// Every uplink closes an account: its energy is the charge drawn since the
+// previous uplink (awake time, radio, sleep in between) at POWER_SUPPLY_MV,
+// i.e. what one uplink costs the battery including the idle time around it.
+//
+// Charge is kept in nC (uA x ms). The statistics are plain data so they can
+// be kept in RTC memory over deep sleep. Time is passed in by the caller, so
+// the module has no Arduino dependencies.
+
+enum EnergyState : uint8_t {
+    ENERGY_ACTIVE = 0,
+    ENERGY_WIFI,
+    ENERGY_TX,
+    ENERGY_RX,
+    ENERGY_LIGHT_SLEEP,
+    ENERGY_DEEP_SLEEP,
+    ENERGY_STATE_COUNT
+};
+
+extern const char* const ENERGY_STATE_NAMES[ENERGY_STATE_COUNT];
+
+struct EnergyStats {
+    uint64_t charge_nc[ENERGY_STATE_COUNT];   // Since cold boot
+    uint64_t time_ms[ENERGY_STATE_COUNT];
+    uint64_t account_nc;       // Drawn since the last uplink (open account)
+    uint64_t uplinks_nc;       // All closed accounts
+    uint32_t uplinks;
+    uint32_t last_uplink_uj;   // Energy of the last closed account
+};
+
+class EnergyMeter {
+public:
+    EnergyMeter();
+
+    // `ms` spent in a state
+    void add(EnergyState state, uint32_t ms);
+    // Uplink sent: closes the open account
+    void uplinkSent();
+
+    uint32_t lastUplinkUj() const;
+    uint32_t averageUplinkUj() const;       // 0 before the first uplink
+    uint32_t averageCurrentUa() const;      // Total charge over elapsed time (awake + asleep)
+    uint32_t batteryLifeHours() const;      // POWER_BATTERY_MAH at the average current, 0 = unknown
+    uint64_t elapsedMs() const;             // Awake + light sleep + deep sleep
+    uint32_t sleepPermille() const;         // Share of elapsed time asleep
+
+    const EnergyStats& getStats() const;
+    void restore(const EnergyStats& stats);  // After deep sleep
+
+    static uint32_t currentUa(EnergyState state);
+    static uint32_t toMicrojoules(uint64_t charge_nc);
+
+private:
+    EnergyStats stats;
+};
+
+#endif // ENERGY_METER_H
@@ -0,0 +1,76 @@
+#include "frame_history.h"
+#include <string.h>
+
+const char* const FRAME_DIRECTION_NAMES[FRAME_DIRECTION_COUNT] = { "up", "down", "join" };
+
+FrameHistory::FrameHistory() :
+    ring(nullptr),
+    capacity(0),
+    next_seq(1) {
+}
+
+void FrameHistory::begin(FrameRecord* storage, uint16_t size) {
+    ring = storage;
+    capacity = storage ? size : 0;
+    next_seq = 1;
+}
+
+bool FrameHistory::isActive() const {
+    return capacity > 0;
+}
+
+uint16_t FrameHistory::getCapacity() const {
+    return capacity;
+}
+
+uint16_t FrameHistory::getCount() const {
+    uint32_t total = next_seq - 1;
+    return total < capacity ? (uint16_t)total : capacity;
+}
+
+uint32_t FrameHistory::getTotal() const {
+    return next_seq - 1;
+}
+
+void FrameHistory::record(FrameRecord& rec, const uint8_t* payload, size_t len) {
+    if (capacity == 0) return;
+
+    rec.seq = next_seq++;
+    rec.len = len > 0xFF ? 0xFF : (uint8_t)len;
+    size_t stored = len < sizeof(rec.payload) ? len : sizeof(rec.payload);
+    if (stored > 0) memcpy(rec.payload, payload, stored);
+
+    FrameRecord& slot = ring[(rec.seq - 1) % capacity];
+    // Only the used part of the payload is copied; the rest of the slot is stale
+    memcpy(&slot, &rec, offsetof(FrameRecord, payload) + stored);
+}
+
+size_t FrameHistory::query(const FrameQuery& q, FrameRecord* out, size_t max, uint32_t* next_cursor) const {
+    *next_cursor = 0;
+    if (capacity == 0 || max == 0) return 0;
+
+    // Sequences [oldest, next_seq) are in the ring; the cursor is an exclusive upper bound
+    uint32_t oldest = next_seq > capacity ? next_seq - capacity : 1;
+    uint32_t seq = (q.cursor == 0 || q.cursor > next_seq) ? next_seq : q.cursor;
+
+    size_t n = 0;
+    while (seq > oldest) {
+        seq--;
+        const FrameRecord& rec = ring[(seq - 1) % capacity];
+
+        if (q.has_range) {
+            if (before(q.to, rec.time)) continue;
+            if (before(rec.time, q.from)) break;   // Older records are earlier still
+        }
+        if (q.profile != FRAME_PROFILE_ANY && rec.profile != q.profile) continue;
+
+        if (n == max) {
+            *next_cursor = seq + 1;
+            break;
+        }
+        size_t stored = rec.len < sizeof(rec.payload) ? rec.len : sizeof(rec.payload);
+        memcpy(&out[n], &rec, offsetof(FrameRecord, payload) + stored);
+        n++;
+    }
+    return n;
+}
@@ -0,0 +1,88 @@
+#ifndef FRAME_HISTORY_H
+#define FRAME_HISTORY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+// ============================================================================
+// FRAME HISTORY (ALL PROFILES)
+// ============================================================================
+// Fixed-size ring of every uplink, downlink and join request with what Serial
+// used to be the only record of: time, profile, FCnt, FPort, data rate,
+// payload, time-on-air, RSSI/SNR and the RadioLib result code.
+//
+// Records are numbered by a sequence that only grows (record `seq` lives in
+// slot (seq - 1) % capacity), so a query cursor stays valid while new frames
+// push old ones out. Queries run newest first, filtered by profile and time
+// range, and return at most one page plus the cursor of the next page.
+//
+// Storage is supplied by the caller (PSRAM when available); the module does no
+// allocation and no locking, and time is passed in (millis()).
+
+#define FRAME_PROFILE_ANY    0xFF   // Query filter: every profile
+#define FRAME_FLAG_RADIO     0x01   // rssi/snr are valid (received frames)
+#define FRAME_FLAG_CLASS_C   0x02   // Downlink received between uplinks
+#define FRAME_FLAG_CONFIRMED 0x04   // Confirmed uplink
+#define FRAME_FLAG_ACKED     0x08   // Confirmed uplink acknowledged in RX1/RX2
+
+enum FrameDirection : uint8_t {
+    FRAME_UPLINK = 0,
+    FRAME_DOWNLINK,
+    FRAME_JOIN,
+    FRAME_DIRECTION_COUNT
+};
+
+extern const char* const FRAME_DIRECTION_NAMES[FRAME_DIRECTION_COUNT];
+
+struct FrameRecord {
+    uint32_t seq;
+    unsigned long time;     // millis()
+    uint32_t fcnt;
+    int16_t result;         // RadioLib state (uplink: >= 0 sent, 1/2 answered in RX1/RX2)
+    int16_t rssi;           // dBm, FRAME_FLAG_RADIO
+    int8_t snr;             // dB (rounded), FRAME_FLAG_RADIO
+    uint8_t profile;
+    uint8_t direction;      // FrameDirection
+    uint8_t flags;
+    uint8_t fport;
+    uint8_t datarate;
+    uint16_t toa_ms;        // Time-on-air (0 when nothing was sent)
+    uint8_t len;            // Frame payload length
+    uint8_t payload[LORAWAN_FRAME_PAYLOAD_MAX];  // First min(len, max) bytes
+};
+
+struct FrameQuery {
+    uint8_t profile;        // FRAME_PROFILE_ANY or a profile index
+    bool has_range;
+    unsigned long from;     // Inclusive millis() bounds, if has_range
+    unsigned long to;
+    uint32_t cursor;        // 0: start at the newest record
+};
+
+class FrameHistory {
+public:
+    FrameHistory();
+
+    void begin(FrameRecord* storage, uint16_t capacity);
+    bool isActive() const;
+    uint16_t getCapacity() const;
+    uint16_t getCount() const;       // Records currently held
+    uint32_t getTotal() const;       // Records since boot
+
+    // Copies `record` in and assigns its sequence; payload beyond the record size is cut
+    void record(FrameRecord& record, const uint8_t* payload, size_t len);
+
+    // Up to `max` matching records, newest first. `next_cursor` is 0 when there
+    // are no more, otherwise the value to pass as FrameQuery::cursor.
+    size_t query(const FrameQuery& q, FrameRecord* out, size_t max, uint32_t* next_cursor) const;
+
+private:
+    FrameRecord* ring;
+    uint16_t capacity;
+    uint32_t next_seq;
+
+    static bool before(unsigned long a, unsigned long b) { return (long)(a - b) < 0; }
+};
+
+#endif // FRAME_HISTORY_H
@@ -0,0 +1,173 @@
+#include "html_stream.h"
+#include "logger.h"
+#include <esp_heap_caps.h>
+
+WebPageStats HtmlStream::stats = {};
+
+// ============================================================================
+// CONSTRUCTOR / DESTRUCTOR
+// ============================================================================
+
+HtmlStream::HtmlStream(httpd_req_t* req, const char* type) :
+    req(req),
+    used(0),
+    failed(false),
+    ended(false),
+    first_byte_us(0),
+    bytes(0),
+    chunks(0) {
+
+    start_us = micros();
+    // Internal RAM and PSRAM: a long page String may be placed in either
+    heap_start = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    heap_min = heap_start;
+    httpd_resp_set_type(req, type);
+}
+
+HtmlStream::~HtmlStream() {
+    // A handler that returned early still completes the response
+    if (!ended) end();
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+HtmlStream& HtmlStream::operator+=(const char* text) {
+    if (text) write(text, strlen(text));
+    return *this;
+}
+
+HtmlStream& HtmlStream::operator+=(const String& text) {
+    write(text.c_str(), text.length());
+    return *this;
+}
+
+HtmlStream& HtmlStream::operator+=(char c) {
+    write(&c, 1);
+    return *this;
+}
+
+void HtmlStream::write(const char* data, size_t len) {
+    if (failed || ended) return;
+    bytes += len;
+
+    if (!WEB_STREAM_PAGES) {
+        page.concat(data, len);
+        return;
+    }
+
+    while (len > 0) {
+        size_t room = sizeof(buf) - used;
+        size_t n = len < room ? len : room;
+        memcpy(buf + used, data, n);
+        used += n;
+        data += n;
+        len -= n;
+        if (used == sizeof(buf)) {
+            flush();
+            if (failed) return;
+        }
+    }
+}
+
+void HtmlStream::printf(const char* fmt, ...) {
+    if (failed || ended) return;
+
+    va_list args;
+    va_start(args, fmt);
+    va_list retry;
+    va_copy(retry, args);
+
+    // Straight into the chunk buffer when it fits
+    size_t room = sizeof(buf) - used;
+    int n = vsnprintf(buf + used, room, fmt, args);
+    va_end(args);
+
+    if (n < 0) {
+        // Encoding error: nothing was added
+    } else if (WEB_STREAM_PAGES && (size_t)n < room) {
+        used += n;
+        bytes += n;
+    } else if (WEB_STREAM_PAGES && (size_t)n < sizeof(buf)) {
+        // Send what is buffered and format again at the start
+        flush();
+        if (!failed) {
+            vsnprintf(buf, sizeof(buf), fmt, retry);
+            used = n;
+            bytes += n;
+        }
+    } else if (!WEB_STREAM_PAGES && (size_t)n < sizeof(buf)) {
+        write(buf, n);
+    } else {
+        char* text = (char*)malloc(n + 1);
+        if (text) {
+            vsnprintf(text, n + 1, fmt, retry);
+            write(text, n);
+            free(text);
+        }
+    }
+    va_end(retry);
+}
+
+void HtmlStream::flush() {
+    if (used == 0 || failed) return;
+    sampleHeap();
+    if (chunks == 0) first_byte_us = micros() - start_us;
+    if (httpd_resp_send_chunk(req, buf, used) != ESP_OK) {
+        failed = true;
+    }
+    chunks++;
+    used = 0;
+}
+
+void HtmlStream::sampleHeap() {
+    uint32_t free_now = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    if (free_now < heap_min) heap_min = free_now;
+}
+
+esp_err_t HtmlStream::end() {
+    if (ended) return failed ? ESP_FAIL : ESP_OK;
+
+    if (WEB_STREAM_PAGES) {
+        flush();
+        if (!failed && httpd_resp_send_chunk(req, NULL, 0) != ESP_OK) {
+            failed = true;
+        }
+    } else {
+        // The whole page is in RAM now: that is the peak
+        sampleHeap();
+        first_byte_us = micros() - start_us;
+        if (httpd_resp_send(req, page.c_str(), page.length()) != ESP_OK) {
+            failed = true;
+        }
+        chunks = 1;
+        page = String();
+    }
+    ended = true;
+
+    // Statistics for /stats (the server runs one handler at a time)
+    uint32_t heap_used = heap_start > heap_min ? heap_start - heap_min : 0;
+    uint32_t total_us = micros() - start_us;
+    stats.pages++;
+    stats.last_heap = heap_used;
+    if (heap_used > stats.max_heap) stats.max_heap = heap_used;
+    stats.last_first_byte_us = first_byte_us;
+    if (first_byte_us > stats.max_first_byte_us) stats.max_first_byte_us = first_byte_us;
+    stats.last_total_us = total_us;
+    stats.last_bytes = bytes;
+    if (bytes > stats.max_bytes) stats.max_bytes = bytes;
+    stats.last_chunks = chunks;
+    strncpy(stats.last_uri, req->uri, sizeof(stats.last_uri) - 1);
+    stats.last_uri[sizeof(stats.last_uri) - 1] = '\0';
+
+    LOG_D(LOG_WEB, "Page %s: %lu bytes in %u chunk(s), first byte %lu us, total %lu us, heap %lu bytes%s",
+        req->uri, (unsigned long)bytes, (unsigned)chunks, (unsigned long)first_byte_us,
+        (unsigned long)total_us, (unsigned long)heap_used, failed ? " (send failed)" : "");
+
+    return failed ? ESP_FAIL : ESP_OK;
+}
+
+const WebPageStats& HtmlStream::getStats() {
+    return stats;
+}
@@ -0,0 +1,63 @@
+#ifndef HTML_STREAM_H
+#define HTML_STREAM_H
+
+#include <Arduino.h>
+#include <esp_http_server.h>
+#include "config.h"
+#include "web_page_stats.h"
+
+// ============================================================================
+// HTML STREAM (CHUNKED PAGE OUTPUT)
+// ============================================================================
+// Page handlers append to an HtmlStream instead of one String holding the
+// whole page. Text collects in a WEB_CHUNK_SIZE buffer on the handler's stack
+// and goes out with httpd_resp_send_chunk() each time the buffer fills, so
+// the browser gets the header while the rest is still being rendered and the
+// heap never holds more than one chunk of the page. end() sends the last
+// chunk and finishes the response.
+//
+// With WEB_STREAM_PAGES false the page is rendered into a String and sent in
+// one piece as before, so both can be compared on /stats (time to first byte
+// and heap used while rendering, per page).
+//
+// Once a send fails (browser gone) the rest of the page is discarded and
+// end() returns ESP_FAIL, which makes the server close the connection.
+
+class HtmlStream {
+public:
+    explicit HtmlStream(httpd_req_t* req, const char* type = "text/html");
+    ~HtmlStream();
+
+    HtmlStream& operator+=(const char* text);
+    HtmlStream& operator+=(const String& text);
+    HtmlStream& operator+=(char c);
+
+    void write(const char* data, size_t len);
+    void printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    // Sends what is left and the terminating chunk
+    esp_err_t end();
+
+    static const WebPageStats& getStats();
+
+private:
+    httpd_req_t* req;
+    char buf[WEB_CHUNK_SIZE];
+    size_t used;
+    String page;                 // Whole page (WEB_STREAM_PAGES false only)
+    bool failed;
+    bool ended;
+    uint32_t start_us;
+    uint32_t first_byte_us;
+    uint32_t heap_start;
+    uint32_t heap_min;
+    uint32_t bytes;
+    uint16_t chunks;
+
+    void flush();
+    void sampleHeap();
+
+    static WebPageStats stats;
+};
+
+#endif // HTML_STREAM_H
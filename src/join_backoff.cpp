@@ -0,0 +1,103 @@
+#include "join_backoff.h"
+#include <string.h>
+
+JoinBackoff::JoinBackoff() {
+    memset(stats, 0, sizeof(stats));
+}
+
+void JoinBackoff::attemptStarted(uint8_t profile, unsigned long now) {
+    if (profile >= MAX_LORA_PROFILES) return;
+    JoinStats& st = stats[profile];
+    if (!st.in_sequence) {
+        st.in_sequence = true;
+        st.sequence_start = now;
+    }
+    st.attempts++;
+}
+
+void JoinBackoff::recordSuccess(uint8_t profile, unsigned long now) {
+    if (profile >= MAX_LORA_PROFILES) return;
+    JoinStats& st = stats[profile];
+    st.successes++;
+    st.consecutive_failures = 0;
+    st.next_attempt = now;
+    st.last_delay_ms = 0;
+    if (st.in_sequence) {
+        st.last_latency_ms = now - st.sequence_start;
+        if (st.last_latency_ms > st.max_latency_ms) st.max_latency_ms = st.last_latency_ms;
+        st.total_latency_ms += st.last_latency_ms;
+        st.in_sequence = false;
+    }
+}
+
+uint32_t JoinBackoff::recordFailure(uint8_t profile, unsigned long now, uint32_t toa_ms, uint32_t random) {
+    if (profile >= MAX_LORA_PROFILES) return 0;
+    JoinStats& st = stats[profile];
+    st.failures++;
+    if (st.consecutive_failures < 0xFFFF) st.consecutive_failures++;
+
+    // Exponential backoff, jitter over the upper half: [delay / 2, delay)
+    uint32_t delay = LORAWAN_JOIN_BACKOFF_MIN_MS;
+    for (uint16_t i = 1; i < st.consecutive_failures && delay < LORAWAN_JOIN_BACKOFF_MAX_MS; i++) {
+        delay *= 2;
+    }
+    if (delay > LORAWAN_JOIN_BACKOFF_MAX_MS) delay = LORAWAN_JOIN_BACKOFF_MAX_MS;
+    delay = delay / 2 + random % (delay / 2);
+
+    uint32_t gap = dutyCycleGapMs(st.in_sequence ? now - st.sequence_start : 0, toa_ms);
+    if (delay < gap) delay = gap;
+
+    st.last_delay_ms = delay;
+    st.next_attempt = now + delay;
+    return delay;
+}
+
+void JoinBackoff::reset(uint8_t profile) {
+    if (profile >= MAX_LORA_PROFILES) return;
+    JoinStats& st = stats[profile];
+    st.consecutive_failures = 0;
+    st.in_sequence = false;
+    st.last_delay_ms = 0;
+    st.next_attempt = 0;
+}
+
+bool JoinBackoff::canAttempt(uint8_t profile, unsigned long now) const {
+    if (profile >= MAX_LORA_PROFILES) return false;
+    const JoinStats& st = stats[profile];
+    return st.consecutive_failures == 0 || (long)(now - st.next_attempt) >= 0;
+}
+
+unsigned long JoinBackoff::getNextAttempt(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) return 0;
+    return stats[profile].next_attempt;
+}
+
+void JoinBackoff::retain(unsigned long now, JoinRetained& out) const {
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        out.consecutive_failures[i] = stats[i].consecutive_failures;
+        out.sequence_start_in[i] = (int32_t)(stats[i].sequence_start - now);
+        out.next_attempt_in[i] = (int32_t)(stats[i].next_attempt - now);
+        out.in_sequence[i] = stats[i].in_sequence;
+    }
+}
+
+void JoinBackoff::resume(const JoinRetained& in, unsigned long saved_at) {
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        stats[i].consecutive_failures = in.consecutive_failures[i];
+        stats[i].sequence_start = saved_at + in.sequence_start_in[i];
+        stats[i].next_attempt = saved_at + in.next_attempt_in[i];
+        stats[i].in_sequence = in.in_sequence[i];
+    }
+}
+
+const JoinStats& JoinBackoff::getStats(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) profile = 0;
+    return stats[profile];
+}
+
+uint32_t JoinBackoff::dutyCycleGapMs(unsigned long sequence_age, uint32_t toa_ms) {
+    // Off-time so that this request alone stays within the duty cycle
+    if (sequence_age < JOIN_DUTY_PHASE1_MS) return toa_ms * 100;     // 1%
+    if (sequence_age < JOIN_DUTY_PHASE2_MS) return toa_ms * 1000;    // 0.1%
+    return toa_ms * 10000;                                           // 0.01%
+}
@@ -0,0 +1,82 @@
+#ifndef JOIN_BACKOFF_H
+#define JOIN_BACKOFF_H
+
+#include <stdint.h>
+#include "config.h"
+
+// ============================================================================
+// JOIN BACKOFF (PER PROFILE)
+// ============================================================================
+// Retry timing and statistics of OTAA joins, one state per profile (each
+// profile is its own end device to the network server).
+//
+// After a failed join the next attempt is delayed by an exponential backoff
+// (LORAWAN_JOIN_BACKOFF_MIN_MS doubling up to LORAWAN_JOIN_BACKOFF_MAX_MS) with
+// random jitter over the upper half of the delay, so a fleet powered up at the
+// same moment spreads its retries instead of hitting the gateways in lockstep.
+//
+// The delay is never shorter than the LoRaWAN join-request duty cycle
+// (LoRaWAN 1.0.3 section 7, retransmissions back-off), applied per attempt and
+// counted from the first attempt of the current join sequence:
+//   first hour         1%     (36 s of join airtime per hour)
+//   hours 1-11         0.1%   (36 s over 10 hours)
+//   after 11 hours     0.01%  (8.7 s per 24 hours)
+//
+// Time and randomness are passed in by the caller, so the module has no
+// Arduino dependencies.
+
+#define JOIN_DUTY_PHASE1_MS   3600000UL    // 1 hour
+#define JOIN_DUTY_PHASE2_MS   39600000UL   // 11 hours
+
+struct JoinStats {
+    uint32_t attempts;              // Join requests transmitted
+    uint32_t failures;
+    uint32_t successes;
+    uint16_t consecutive_failures;  // Since the last success (drives the backoff)
+    unsigned long sequence_start;   // millis() of the first attempt of the running sequence
+    bool in_sequence;
+    unsigned long next_attempt;     // millis() before which no join request is sent
+    uint32_t last_delay_ms;
+    uint32_t last_latency_ms;       // First attempt -> Join-Accept of the last sequence
+    uint32_t max_latency_ms;
+    uint64_t total_latency_ms;
+};
+
+// Retry state kept over deep sleep (plain data for RTC memory): enough to
+// continue the backoff and the join duty cycle; the statistics start over
+struct JoinRetained {
+    uint16_t consecutive_failures[MAX_LORA_PROFILES];
+    int32_t sequence_start_in[MAX_LORA_PROFILES];   // ms relative to the save
+    int32_t next_attempt_in[MAX_LORA_PROFILES];
+    bool in_sequence[MAX_LORA_PROFILES];
+};
+
+class JoinBackoff {
+public:
+    JoinBackoff();
+
+    // A join request is about to go on air (opens a sequence on the first attempt)
+    void attemptStarted(uint8_t profile, unsigned long now);
+    // Outcome of that request. `toa_ms` is the join request's time on air,
+    // `random` any uniformly distributed value (jitter).
+    void recordSuccess(uint8_t profile, unsigned long now);
+    uint32_t recordFailure(uint8_t profile, unsigned long now, uint32_t toa_ms, uint32_t random);
+    // New credentials: the profile is a different device now
+    void reset(uint8_t profile);
+
+    bool canAttempt(uint8_t profile, unsigned long now) const;
+    unsigned long getNextAttempt(uint8_t profile) const;
+    const JoinStats& getStats(uint8_t profile) const;
+
+    // Deep sleep: save at `now`; resume with the save time in the current clock
+    void retain(unsigned long now, JoinRetained& out) const;
+    void resume(const JoinRetained& in, unsigned long saved_at);
+
+    // Minimum gap after a join request of `toa_ms`, `sequence_age` ms into the sequence
+    static uint32_t dutyCycleGapMs(unsigned long sequence_age, uint32_t toa_ms);
+
+private:
+    JoinStats stats[MAX_LORA_PROFILES];
+};
+
+#endif // JOIN_BACKOFF_H
@@ -0,0 +1,80 @@
+#include "link_quality.h"
+#include <string.h>
+
+LinkQualityHistory::LinkQualityHistory() {
+    memset(history, 0, sizeof(history));
+    memset(head, 0, sizeof(head));
+    memset(count, 0, sizeof(count));
+    memset(since_downlink, 0, sizeof(since_downlink));
+}
+
+void LinkQualityHistory::record(uint8_t profile, const LinkSample& sample) {
+    if (profile >= MAX_LORA_PROFILES) return;
+
+    history[profile][head[profile]] = sample;
+    head[profile] = (head[profile] + 1) % LINK_HISTORY_SIZE;
+    if (count[profile] < LINK_HISTORY_SIZE) count[profile]++;
+
+    if (sample.has_downlink) {
+        since_downlink[profile] = 0;
+    } else if (since_downlink[profile] < 0xFFFF) {
+        since_downlink[profile]++;
+    }
+}
+
+void LinkQualityHistory::clear(uint8_t profile) {
+    if (profile >= MAX_LORA_PROFILES) return;
+    head[profile] = 0;
+    count[profile] = 0;
+    since_downlink[profile] = 0;
+}
+
+uint8_t LinkQualityHistory::getCount(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) return 0;
+    return count[profile];
+}
+
+const LinkSample* LinkQualityHistory::getSample(uint8_t profile, uint8_t age) const {
+    if (profile >= MAX_LORA_PROFILES || age >= count[profile]) return nullptr;
+    uint8_t pos = (head[profile] + LINK_HISTORY_SIZE - 1 - age) % LINK_HISTORY_SIZE;
+    return &history[profile][pos];
+}
+
+LinkSummary LinkQualityHistory::summarize(uint8_t profile) const {
+    LinkSummary s;
+    memset(&s, 0, sizeof(s));
+    s.last_margin = LINK_MARGIN_NONE;
+    if (profile >= MAX_LORA_PROFILES) return s;
+
+    s.samples = count[profile];
+    int32_t rssi_sum = 0;
+    int32_t snr_sum = 0;
+    bool margin_found = false;
+
+    // Newest first so the first LinkCheckAns found is the latest one
+    for (uint8_t age = 0; age < count[profile]; age++) {
+        const LinkSample* ls = getSample(profile, age);
+        if (!margin_found && ls->margin != LINK_MARGIN_NONE) {
+            s.last_margin = ls->margin;
+            s.last_gateways = ls->gateways;
+            margin_found = true;
+        }
+        if (!ls->has_downlink) continue;
+
+        if (s.downlinks == 0 || ls->snr < s.min_snr) s.min_snr = ls->snr;
+        rssi_sum += ls->rssi;
+        snr_sum += ls->snr;
+        s.downlinks++;
+    }
+
+    if (s.downlinks > 0) {
+        s.avg_rssi = rssi_sum / s.downlinks;
+        s.avg_snr = (float)snr_sum / s.downlinks;
+    }
+    return s;
+}
+
+uint16_t LinkQualityHistory::getUplinksSinceDownlink(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) return 0;
+    return since_downlink[profile];
+}
@@ -0,0 +1,60 @@
+#ifndef LINK_QUALITY_H
+#define LINK_QUALITY_H
+
+#include <stdint.h>
+#include "config.h"
+
+// ============================================================================
+// LINK QUALITY HISTORY (PER PROFILE)
+// ============================================================================
+// Keeps the last LINK_HISTORY_SIZE uplinks of every profile: data rate and TX
+// power used, plus downlink RSSI/SNR and LinkCheckAns margin when the network
+// answered. Also counts uplinks since the last downlink, which drives the
+// device-side ADR backoff in LoRaWANHandler.
+
+#define LINK_HISTORY_SIZE 16
+#define LINK_MARGIN_NONE  0xFF   // No LinkCheckAns for this uplink
+
+struct LinkSample {
+    unsigned long time;   // millis() of the uplink
+    int16_t rssi;         // Downlink RSSI (dBm), valid if has_downlink
+    int8_t snr;           // Downlink SNR (dB, rounded), valid if has_downlink
+    uint8_t datarate;     // Uplink data rate (DR index of the profile's region)
+    int8_t power;         // Uplink TX power (dBm)
+    uint8_t margin;       // LinkCheckAns demodulation margin (dB) or LINK_MARGIN_NONE
+    uint8_t gateways;     // LinkCheckAns gateway count
+    bool has_downlink;
+};
+
+struct LinkSummary {
+    uint8_t samples;          // Uplinks in history
+    uint8_t downlinks;        // Of which answered by a downlink
+    int16_t avg_rssi;
+    float avg_snr;
+    int8_t min_snr;
+    uint8_t last_margin;      // Most recent LinkCheckAns margin or LINK_MARGIN_NONE
+    uint8_t last_gateways;
+};
+
+class LinkQualityHistory {
+public:
+    LinkQualityHistory();
+
+    void record(uint8_t profile, const LinkSample& sample);
+    void clear(uint8_t profile);
+
+    uint8_t getCount(uint8_t profile) const;
+    const LinkSample* getSample(uint8_t profile, uint8_t age) const;  // 0 = newest
+    LinkSummary summarize(uint8_t profile) const;
+
+    // Uplinks in a row without any downlink (resets on every downlink)
+    uint16_t getUplinksSinceDownlink(uint8_t profile) const;
+
+private:
+    LinkSample history[MAX_LORA_PROFILES][LINK_HISTORY_SIZE];
+    uint8_t head[MAX_LORA_PROFILES];     // Next write position
+    uint8_t count[MAX_LORA_PROFILES];
+    uint16_t since_downlink[MAX_LORA_PROFILES];
+};
+
+#endif // LINK_QUALITY_H
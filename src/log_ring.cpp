@@ -0,0 +1,276 @@
+#include "log_ring.h"
+#include <stdio.h>
+
+// ============================================================================
+// ARGUMENT PACKING
+// ============================================================================
+// Every argument is a type tag followed by its value (unaligned). Strings and
+// byte dumps carry a length byte; what does not fit is cut and the record is
+// marked truncated. A value that does not fit at all is left out, and
+// format() prints "?" for the conversions it has no argument for.
+
+void LogPacker::putValue(uint8_t tag, const void* value, size_t len) {
+    if (used + 1 + len > cap) {
+        cut = true;
+        used = cap;   // Later arguments are dropped too: they would land in the wrong conversion
+        return;
+    }
+    buf[used++] = tag;
+    memcpy(buf + used, value, len);
+    used += len;
+}
+
+void LogPacker::putBytes(uint8_t tag, const void* data, size_t len) {
+    if (used + 2 > cap) {
+        cut = true;
+        used = cap;
+        return;
+    }
+    size_t room = cap - used - 2;
+    if (len > room) {
+        len = room;
+        cut = true;
+    }
+    if (len > 255) {
+        len = 255;
+        cut = true;
+    }
+    buf[used++] = tag;
+    buf[used++] = (uint8_t)len;
+    memcpy(buf + used, data, len);
+    used += len;
+}
+
+// ============================================================================
+// RING
+// ============================================================================
+// Slot i holds seq == pos when free for the writer of ring position pos and
+// seq == pos + 1 once that writer has published it. The reader hands it back
+// with seq == pos + LOG_RING_RECORDS (free for the next lap).
+
+LogRing::LogRing() : write_pos(0), read_pos(0), dropped(0) {
+    for (uint32_t i = 0; i < LOG_RING_RECORDS; i++) {
+        slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+LogRecord* LogRing::claim() {
+    uint32_t pos = write_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        LogRecord& slot = slots[pos & (LOG_RING_RECORDS - 1)];
+        int32_t diff = (int32_t)(slot.seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                return &slot;
+            }
+            // pos was reloaded by the failed exchange
+        } else if (diff < 0) {
+            // The reader has not freed this slot yet: ring full
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            pos = write_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void LogRing::publish(LogRecord* rec) {
+    uint32_t pos = rec->seq.load(std::memory_order_relaxed);
+    rec->seq.store(pos + 1, std::memory_order_release);
+}
+
+const LogRecord* LogRing::peek() {
+    LogRecord& slot = slots[read_pos & (LOG_RING_RECORDS - 1)];
+    // Not yet published (empty, or a writer is still filling it)
+    if (slot.seq.load(std::memory_order_acquire) != read_pos + 1) return nullptr;
+    return &slot;
+}
+
+void LogRing::release() {
+    LogRecord& slot = slots[read_pos & (LOG_RING_RECORDS - 1)];
+    slot.seq.store(read_pos + LOG_RING_RECORDS, std::memory_order_release);
+    read_pos++;
+}
+
+uint32_t LogRing::getDropped() const {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+uint32_t LogRing::getWritten() const {
+    return write_pos.load(std::memory_order_relaxed);
+}
+
+// ============================================================================
+// FORMATTING
+// ============================================================================
+// Walks the format string and prints each conversion with snprintf from the
+// next stored argument. Length modifiers in the format are ignored: the
+// stored type decides (%d of a uint64_t prints correctly), and a value of
+// another kind is converted (%d of a double prints its integer part).
+
+namespace {
+
+struct ArgReader {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    bool next(uint8_t& tag, const uint8_t*& data, size_t& len) {
+        if (p >= end) return false;
+        tag = *p++;
+        switch (tag) {
+            case LOG_ARG_INT32:
+            case LOG_ARG_UINT32:  len = 4; break;
+            case LOG_ARG_INT64:
+            case LOG_ARG_UINT64:
+            case LOG_ARG_DOUBLE:
+            case LOG_ARG_POINTER: len = 8; break;
+            case LOG_ARG_STRING:
+            case LOG_ARG_HEX:
+                if (p >= end) return false;
+                len = *p++;
+                break;
+            default: return false;
+        }
+        if (p + len > end) return false;
+        data = p;
+        p += len;
+        return true;
+    }
+};
+
+int64_t argInt(uint8_t tag, const uint8_t* data) {
+    switch (tag) {
+        case LOG_ARG_INT32:  { int32_t v;  memcpy(&v, data, 4); return v; }
+        case LOG_ARG_UINT32: { uint32_t v; memcpy(&v, data, 4); return v; }
+        case LOG_ARG_INT64:  { int64_t v;  memcpy(&v, data, 8); return v; }
+        case LOG_ARG_UINT64:
+        case LOG_ARG_POINTER:{ uint64_t v; memcpy(&v, data, 8); return (int64_t)v; }
+        case LOG_ARG_DOUBLE: { double v;   memcpy(&v, data, 8); return (int64_t)v; }
+        default: return 0;
+    }
+}
+
+double argDouble(uint8_t tag, const uint8_t* data) {
+    switch (tag) {
+        case LOG_ARG_DOUBLE: { double v; memcpy(&v, data, 8); return v; }
+        case LOG_ARG_UINT64:
+        case LOG_ARG_POINTER:{ uint64_t v; memcpy(&v, data, 8); return (double)v; }
+        default: return (double)argInt(tag, data);
+    }
+}
+
+} // namespace
+
+size_t LogRing::format(const LogRecord& rec, char* out, size_t max_len) {
+    if (max_len == 0) return 0;
+    size_t o = 0;
+    const char* f = rec.fmt ? rec.fmt : "";
+    ArgReader args = { rec.args, rec.args + rec.size };
+
+    // Appends snprintf output, cut at the end of `out`
+    #define LOG_EMIT(...) do { \
+        int n = snprintf(out + o, max_len - o, __VA_ARGS__); \
+        if (n > 0) o += ((size_t)n < max_len - o) ? (size_t)n : max_len - o - 1; \
+    } while (0)
+
+    while (*f && o < max_len - 1) {
+        if (*f != '%') {
+            out[o++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            out[o++] = '%';
+            f += 2;
+            continue;
+        }
+
+        // Rebuild the conversion without length modifiers: %[flags][width][.prec]
+        char spec[32];
+        size_t s = 0;
+        spec[s++] = *f++;
+        while (*f && strchr("-+ #0", *f) && s < 8) spec[s++] = *f++;
+        for (int part = 0; part < 2; part++) {
+            if (part == 1) {
+                if (*f != '.') break;
+                spec[s++] = *f++;
+            }
+            if (*f == '*') {
+                // Width/precision from the arguments
+                uint8_t tag; const uint8_t* data; size_t len;
+                long v = args.next(tag, data, len) ? (long)argInt(tag, data) : 0;
+                if (v < -99) v = -99;
+                if (v > 999) v = 999;
+                s += snprintf(spec + s, sizeof(spec) - s, "%ld", v);
+                f++;
+            } else {
+                while (*f >= '0' && *f <= '9' && s < 20) spec[s++] = *f++;
+            }
+        }
+        while (*f && strchr("hlLqjzt", *f)) f++;
+        char conv = *f;
+        if (conv == '\0') break;
+        f++;
+
+        uint8_t tag; const uint8_t* data; size_t len;
+        if (!args.next(tag, data, len)) {
+            out[o++] = '?';
+            continue;
+        }
+
+        switch (conv) {
+            case 'd': case 'i':
+                spec[s++] = 'l'; spec[s++] = 'l'; spec[s++] = 'd'; spec[s] = '\0';
+                LOG_EMIT(spec, (long long)argInt(tag, data));
+                break;
+            case 'u': case 'x': case 'X': case 'o':
+                spec[s++] = 'l'; spec[s++] = 'l'; spec[s++] = conv; spec[s] = '\0';
+                LOG_EMIT(spec, (unsigned long long)argInt(tag, data));
+                break;
+            case 'c':
+                spec[s++] = 'c'; spec[s] = '\0';
+                LOG_EMIT(spec, (int)argInt(tag, data));
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                spec[s++] = conv; spec[s] = '\0';
+                LOG_EMIT(spec, argDouble(tag, data));
+                break;
+            case 'p':
+                LOG_EMIT("0x%llx", (unsigned long long)argInt(tag, data));
+                break;
+            case 's': {
+                spec[s++] = 's'; spec[s] = '\0';
+                if (tag == LOG_ARG_STRING) {
+                    char text[LOG_RECORD_ARGS + 1];
+                    memcpy(text, data, len);
+                    text[len] = '\0';
+                    LOG_EMIT(spec, text);
+                } else if (tag == LOG_ARG_HEX) {
+                    static const char digits[] = "0123456789ABCDEF";
+                    char hex[2 * LOG_RECORD_ARGS + 1];
+                    for (size_t i = 0; i < len; i++) {
+                        hex[2 * i] = digits[data[i] >> 4];
+                        hex[2 * i + 1] = digits[data[i] & 0x0F];
+                    }
+                    hex[2 * len] = '\0';
+                    LOG_EMIT(spec, hex);
+                } else {
+                    LOG_EMIT("%lld", (long long)argInt(tag, data));
+                }
+                break;
+            }
+            default:
+                // Unknown conversion: print it as written
+                spec[s++] = conv; spec[s] = '\0';
+                LOG_EMIT("%s", spec);
+                break;
+        }
+    }
+    #undef LOG_EMIT
+
+    if (rec.truncated && o + 4 < max_len) {
+        memcpy(out + o, " ...", 4);
+        o += 4;
+    }
+    out[o] = '\0';
+    return o;
+}
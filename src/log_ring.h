@@ -0,0 +1,177 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+#include "config.h"
+
+// ============================================================================
+// LOG RING (BINARY RECORDS)
+// ============================================================================
+// Fixed-size ring of log records in binary form: time, level, module, the
+// format string's address and the arguments, each tagged with its type.
+// Nothing is formatted when a record is written; format() turns a record into
+// text later, on the drain task.
+//
+// Writers never block and never take a lock: any task (or interrupt) claims
+// a slot with one compare-and-swap on the write position, fills it and
+// publishes it through the slot's sequence number (bounded MPMC queue after
+// D. Vyukov). There is one reader. When the ring is full the record is
+// dropped and counted.
+//
+// Arguments: integers and enums, float/double, C strings (copied, cut to
+// what fits) and LogHex(data, len) for byte dumps, printed through %s. The
+// format string itself is not copied and must be a literal.
+//
+// Pure module (no Arduino dependencies): time is passed in.
+
+#define LOG_RECORD_HEADER    (4 + 4 + sizeof(const char*) + 4)
+#define LOG_RECORD_ARGS      (LOG_RECORD_SIZE - LOG_RECORD_HEADER)
+
+static_assert((LOG_RING_RECORDS & (LOG_RING_RECORDS - 1)) == 0, "LOG_RING_RECORDS must be a power of two");
+static_assert(LOG_RECORD_SIZE > LOG_RECORD_HEADER + 16, "LOG_RECORD_SIZE leaves no room for arguments");
+
+enum LogArgType : uint8_t {
+    LOG_ARG_INT32 = 1,
+    LOG_ARG_UINT32,
+    LOG_ARG_INT64,
+    LOG_ARG_UINT64,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING,     // Length byte, then the characters (no terminator)
+    LOG_ARG_HEX,        // Length byte, then the bytes (length = what was copied)
+    LOG_ARG_POINTER
+};
+
+// Byte dump argument: LOG_I(..., "Payload: %s", LogHex(payload, len))
+struct LogHex {
+    const uint8_t* data;
+    size_t len;
+    LogHex(const uint8_t* data, size_t len) : data(data), len(len) {}
+};
+
+struct LogRecord {
+    std::atomic<uint32_t> seq;      // Ring position this slot is ready for (see log_ring.cpp)
+    uint32_t time;                  // millis()
+    const char* fmt;
+    uint8_t level;
+    uint8_t module;                 // LogModule
+    uint8_t size;                   // Argument bytes used
+    uint8_t truncated;              // Arguments did not fit (strings cut or dropped)
+    uint8_t args[LOG_RECORD_ARGS];
+};
+
+// ============================================================================
+// ARGUMENT PACKING
+// ============================================================================
+
+class LogPacker {
+public:
+    LogPacker(uint8_t* buf, size_t cap) : buf(buf), cap(cap), used(0), cut(false) {}
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+    pack(T value) {
+        typedef typename std::conditional<std::is_enum<T>::value, int, T>::type V;
+        if (sizeof(V) > 4) {
+            if (std::is_signed<V>::value) {
+                int64_t v = (int64_t)value;
+                putValue(LOG_ARG_INT64, &v, sizeof(v));
+            } else {
+                uint64_t v = (uint64_t)value;
+                putValue(LOG_ARG_UINT64, &v, sizeof(v));
+            }
+        } else if (std::is_signed<V>::value) {
+            int32_t v = (int32_t)value;
+            putValue(LOG_ARG_INT32, &v, sizeof(v));
+        } else {
+            uint32_t v = (uint32_t)value;
+            putValue(LOG_ARG_UINT32, &v, sizeof(v));
+        }
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    pack(T value) {
+        double v = (double)value;
+        putValue(LOG_ARG_DOUBLE, &v, sizeof(v));
+    }
+
+    void pack(const char* str) { putBytes(LOG_ARG_STRING, str ? str : "(null)", str ? strlen(str) : 6); }
+    void pack(char* str) { pack((const char*)str); }
+    void pack(const LogHex& hex) { putBytes(LOG_ARG_HEX, hex.data, hex.len); }
+    void pack(const void* ptr) {
+        uint64_t v = (uint64_t)(uintptr_t)ptr;
+        putValue(LOG_ARG_POINTER, &v, sizeof(v));
+    }
+
+    size_t size() const { return used; }
+    bool truncated() const { return cut; }
+
+private:
+    uint8_t* buf;
+    size_t cap;
+    size_t used;
+    bool cut;
+
+    void putValue(uint8_t tag, const void* value, size_t len);
+    void putBytes(uint8_t tag, const void* data, size_t len);
+};
+
+inline void logPackArgs(LogPacker&) {}
+
+template <typename T, typename... Rest>
+inline void logPackArgs(LogPacker& packer, const T& first, const Rest&... rest) {
+    packer.pack(first);
+    logPackArgs(packer, rest...);
+}
+
+// ============================================================================
+// RING
+// ============================================================================
+
+class LogRing {
+public:
+    LogRing();
+
+    // Writer: claim a slot, fill it, publish it. nullptr = ring full (counted).
+    LogRecord* claim();
+    void publish(LogRecord* rec);
+
+    template <typename... Args>
+    bool write(uint32_t time, uint8_t level, uint8_t module, const char* fmt, const Args&... args) {
+        LogRecord* rec = claim();
+        if (!rec) return false;
+        rec->time = time;
+        rec->fmt = fmt;
+        rec->level = level;
+        rec->module = module;
+        LogPacker packer(rec->args, sizeof(rec->args));
+        logPackArgs(packer, args...);
+        rec->size = (uint8_t)packer.size();
+        rec->truncated = packer.truncated() ? 1 : 0;
+        publish(rec);
+        return true;
+    }
+
+    // Reader (one at a time): oldest published record, or nullptr. The
+    // record stays valid until release().
+    const LogRecord* peek();
+    void release();
+
+    uint32_t getDropped() const;
+    uint32_t getWritten() const;
+
+    // Record as text (no newline); returns the length (cut at max_len - 1)
+    static size_t format(const LogRecord& rec, char* out, size_t max_len);
+
+private:
+    LogRecord slots[LOG_RING_RECORDS];
+    std::atomic<uint32_t> write_pos;
+    uint32_t read_pos;
+    std::atomic<uint32_t> dropped;
+};
+
+#endif // LOG_RING_H
@@ -0,0 +1,211 @@
+#include "logger.h"
+
+// Global instance
+Logger logger;
+
+const char* const LOG_LEVEL_NAMES[LOG_LEVEL_COUNT] = {
+    "Off",
+    "Error",
+    "Warning",
+    "Info",
+    "Debug",
+    "Verbose"
+};
+
+static const char LOG_LEVEL_LETTERS[LOG_LEVEL_COUNT] = { '-', 'E', 'W', 'I', 'D', 'V' };
+
+// ============================================================================
+// CONSTRUCTOR / INITIALIZATION
+// ============================================================================
+
+Logger::Logger() :
+    sink_count(0),
+    drain_lock(nullptr),
+    recent_lock(nullptr),
+    task_handle(nullptr),
+    recent_len(0),
+    reported_drops(0) {
+
+    for (uint8_t i = 0; i < LOG_MODULE_COUNT; i++) {
+        levels[i] = LOG_DEFAULT_LEVEL;
+    }
+    sinks[sink_count++] = serialSink;
+    line[0] = '\0';
+}
+
+void Logger::begin() {
+    if (task_handle) return;
+
+    drain_lock = xSemaphoreCreateMutex();
+    recent_lock = xSemaphoreCreateMutex();
+
+    if (preferences.begin("logging", true)) {  // Read-only: nothing saved yet is fine
+        uint8_t saved[LOG_MODULE_COUNT];
+        size_t n = preferences.getBytes("levels", saved, sizeof(saved));
+        for (size_t i = 0; i < n && i < LOG_MODULE_COUNT; i++) {
+            if (saved[i] < LOG_LEVEL_COUNT) levels[i] = saved[i];
+        }
+        preferences.end();
+    }
+
+    // Below the web server and WiFi; prints whatever queued up during boot first
+    xTaskCreate(drainTask, "LogTask", LOG_TASK_STACK, this, LOG_TASK_PRIORITY, &task_handle);
+
+    Serial.printf(">>> Deferred logging: %u records of %u bytes, compile-time level %s\n",
+        (unsigned)LOG_RING_RECORDS, (unsigned)LOG_RECORD_SIZE, LOG_LEVEL_NAMES[LOG_COMPILE_LEVEL]);
+}
+
+// ============================================================================
+// LEVELS
+// ============================================================================
+
+uint8_t Logger::getLevel(uint8_t module) const {
+    return module < LOG_MODULE_COUNT ? levels[module] : (uint8_t)LOG_LEVEL_NONE;
+}
+
+void Logger::setLevel(uint8_t module, uint8_t level) {
+    if (module >= LOG_MODULE_COUNT) return;
+    if (level >= LOG_LEVEL_COUNT) level = LOG_LEVEL_VERBOSE;
+    levels[module] = level;
+}
+
+void Logger::saveLevels() {
+    if (!preferences.begin("logging", false)) {
+        Serial.println(">>> Failed to open logging preferences for writing");
+        return;
+    }
+    uint8_t saved[LOG_MODULE_COUNT];
+    for (uint8_t i = 0; i < LOG_MODULE_COUNT; i++) {
+        saved[i] = levels[i];
+    }
+    preferences.putBytes("levels", saved, sizeof(saved));
+    preferences.end();
+    Serial.println(">>> Log levels saved to NVS");
+}
+
+// ============================================================================
+// SINKS
+// ============================================================================
+
+bool Logger::addSink(LogSink sink) {
+    if (!sink || sink_count >= LOG_MAX_SINKS) return false;
+    if (drain_lock) xSemaphoreTake(drain_lock, portMAX_DELAY);
+    sinks[sink_count++] = sink;
+    if (drain_lock) xSemaphoreGive(drain_lock);
+    return true;
+}
+
+void Logger::serialSink(uint8_t, uint8_t, uint32_t, const char* line, size_t len) {
+    // Same text as the Serial.printf calls it replaces; blocks this task only
+    Serial.write((const uint8_t*)line, len);
+    Serial.println();
+}
+
+// ============================================================================
+// DRAIN
+// ============================================================================
+
+void Logger::drainTask(void* param) {
+    Logger* self = (Logger*)param;
+    for (;;) {
+        self->flush();
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_MS));
+    }
+}
+
+void Logger::flush() {
+    // Before begin() the records wait in the ring
+    if (!drain_lock) return;
+    xSemaphoreTake(drain_lock, portMAX_DELAY);
+    drain();
+    xSemaphoreGive(drain_lock);
+}
+
+void Logger::drain() {
+    const LogRecord* rec;
+    while ((rec = ring.peek()) != nullptr) {
+        size_t len = LogRing::format(*rec, line, sizeof(line));
+        uint8_t level = rec->level;
+        uint8_t module = rec->module;
+        uint32_t time = rec->time;
+        ring.release();
+
+        for (uint8_t i = 0; i < sink_count; i++) {
+            sinks[i](level, module, time, line, len);
+        }
+        addRecent(level, module, time, line, len);
+    }
+
+    uint32_t dropped = ring.getDropped();
+    if (dropped != reported_drops) {
+        size_t len = snprintf(line, sizeof(line), ">>> Log: %lu record(s) dropped, ring full",
+            (unsigned long)(dropped - reported_drops));
+        reported_drops = dropped;
+        for (uint8_t i = 0; i < sink_count; i++) {
+            sinks[i](LOG_LEVEL_WARN, LOG_SYSTEM, millis(), line, len);
+        }
+        addRecent(LOG_LEVEL_WARN, LOG_SYSTEM, millis(), line, len);
+    }
+}
+
+// ============================================================================
+// RECENT LINES (/logs)
+// ============================================================================
+
+void Logger::addRecent(uint8_t level, uint8_t module, uint32_t time, const char* text, size_t len) {
+    // Blank lines before a message only space out the Serial output
+    while (len > 0 && *text == '\n') {
+        text++;
+        len--;
+    }
+
+    char entry[LOG_LINE_MAX + 32];
+    int n = snprintf(entry, sizeof(entry), "%6lu.%03lu %c %-8s %.*s\n",
+        (unsigned long)(time / 1000), (unsigned long)(time % 1000),
+        LOG_LEVEL_LETTERS[level < LOG_LEVEL_COUNT ? level : 0],
+        module < LOG_MODULE_COUNT ? LOG_MODULE_NAMES[module] : "?", (int)len, text);
+    if (n <= 0) return;
+    size_t entry_len = (size_t)n < sizeof(entry) ? (size_t)n : sizeof(entry) - 1;
+
+    xSemaphoreTake(recent_lock, portMAX_DELAY);
+    if (recent_len + entry_len > sizeof(recent)) {
+        // Drop whole lines from the front
+        size_t cut = recent_len + entry_len - sizeof(recent);
+        while (cut < recent_len && recent[cut - 1] != '\n') cut++;
+        if (cut > recent_len) cut = recent_len;
+        memmove(recent, recent + cut, recent_len - cut);
+        recent_len -= cut;
+    }
+    memcpy(recent + recent_len, entry, entry_len);
+    recent_len += entry_len;
+    xSemaphoreGive(recent_lock);
+}
+
+size_t Logger::copyRecent(char* out, size_t max_len) {
+    if (max_len == 0) return 0;
+    if (!recent_lock) {
+        out[0] = '\0';
+        return 0;
+    }
+
+    xSemaphoreTake(recent_lock, portMAX_DELAY);
+    size_t start = recent_len >= max_len ? recent_len - (max_len - 1) : 0;
+    size_t len = recent_len - start;
+    memcpy(out, recent + start, len);
+    xSemaphoreGive(recent_lock);
+
+    out[len] = '\0';
+    return len;
+}
+
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+uint32_t Logger::getDropped() const {
+    return ring.getDropped();
+}
+
+uint32_t Logger::getWritten() const {
+    return ring.getWritten();
+}
@@ -0,0 +1,109 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+#include "log_ring.h"
+
+// ============================================================================
+// LOGGER (DEFERRED, LEVELED)
+// ============================================================================
+// LOG_E/W/I/D/V(module, fmt, ...) replace Serial.printf on the hot paths
+// (uplinks, session saves, Modbus writes, authentication, display updates).
+// A call checks the module's level, copies the arguments into the binary
+// log ring and returns: nothing is formatted and nothing waits for the USB
+// host. A low-priority task drains the ring, formats the records and hands
+// each line to the sinks: Serial, the recent lines on /logs, and whatever
+// was added with addSink() (e.g. a file).
+//
+// Levels: LOG_COMPILE_LEVEL in config.h is the ceiling (calls above it are
+// removed by the compiler); below it every module has a runtime level, set on
+// /logs and kept in NVS. Messages have no trailing newline.
+//
+// Everything not converted still prints with Serial directly, so lines from
+// both may interleave out of order by a few milliseconds. flush() prints what
+// is queued at once (before sleeping or restarting).
+
+enum LogLevel : uint8_t {
+    LOG_LEVEL_NONE = 0,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_VERBOSE,
+    LOG_LEVEL_COUNT
+};
+
+extern const char* const LOG_LEVEL_NAMES[LOG_LEVEL_COUNT];
+
+// Output for formatted lines (called on the drain task)
+typedef void (*LogSink)(uint8_t level, uint8_t module, uint32_t time, const char* line, size_t len);
+
+class Logger {
+public:
+    Logger();
+
+    // Levels from NVS, drain task. Records written before are kept.
+    void begin();
+
+    bool enabled(uint8_t module, uint8_t level) const {
+        return module < LOG_MODULE_COUNT && level <= levels[module];
+    }
+
+    template <typename... Args>
+    void write(uint8_t level, uint8_t module, const char* fmt, const Args&... args) {
+        ring.write(millis(), level, module, fmt, args...);
+    }
+
+    // Runtime levels (saved with saveLevels())
+    uint8_t getLevel(uint8_t module) const;
+    void setLevel(uint8_t module, uint8_t level);
+    void saveLevels();
+
+    bool addSink(LogSink sink);
+
+    // Print everything queued now, in the caller's task
+    void flush();
+
+    // Recent lines for /logs, oldest first ("time level module message")
+    size_t copyRecent(char* out, size_t max_len);
+
+    uint32_t getDropped() const;
+    uint32_t getWritten() const;
+
+private:
+    LogRing ring;
+    volatile uint8_t levels[LOG_MODULE_COUNT];
+    LogSink sinks[LOG_MAX_SINKS];
+    uint8_t sink_count;
+    SemaphoreHandle_t drain_lock;    // One reader at a time (task or flush())
+    SemaphoreHandle_t recent_lock;   // Recent lines: drain task vs web server
+    TaskHandle_t task_handle;
+    char line[LOG_LINE_MAX];
+    char recent[LOG_WEB_BUFFER];
+    size_t recent_len;
+    uint32_t reported_drops;
+    Preferences preferences;
+
+    void drain();
+    void addRecent(uint8_t level, uint8_t module, uint32_t time, const char* text, size_t len);
+    static void drainTask(void* param);
+    static void serialSink(uint8_t level, uint8_t module, uint32_t time, const char* line, size_t len);
+};
+
+// Global instance
+extern Logger logger;
+
+#define LOG_AT(level, module, fmt, ...) do { \
+        if ((level) <= LOG_COMPILE_LEVEL && logger.enabled((module), (level))) \
+            logger.write((level), (module), fmt, ##__VA_ARGS__); \
+    } while (0)
+
+#define LOG_E(module, fmt, ...) LOG_AT(LOG_LEVEL_ERROR, module, fmt, ##__VA_ARGS__)
+#define LOG_W(module, fmt, ...) LOG_AT(LOG_LEVEL_WARN, module, fmt, ##__VA_ARGS__)
+#define LOG_I(module, fmt, ...) LOG_AT(LOG_LEVEL_INFO, module, fmt, ##__VA_ARGS__)
+#define LOG_D(module, fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, module, fmt, ##__VA_ARGS__)
+#define LOG_V(module, fmt, ...) LOG_AT(LOG_LEVEL_VERBOSE, module, fmt, ##__VA_ARGS__)
+
+#endif // LOGGER_H
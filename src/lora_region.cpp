@@ -0,0 +1,79 @@
+#include "lora_region.h"
+
+// EU868: ETSI EN 300 220 / ERC REC 70-03 sub-bands. AS923: 1% on the whole
+// band (local rules vary; 1% is what most AS923 countries require). AU915 has
+// no duty-cycle limit, only the 400 ms dwell time.
+const DutyCycleBand DUTY_CYCLE_BANDS[DUTY_CYCLE_BAND_COUNT] = {
+    { "863.0-865.0", 863000, 865000, 1 },           // h1.2: 0.1%
+    { "865.0-868.0", 865000, 868000, 10 },          // h1.3: 1%
+    { "868.0-868.6", 868000, 868600, 10 },          // h1.4: 1% (default channels)
+    { "868.7-869.2", 868700, 869200, 1 },           // h1.5: 0.1%
+    { "869.4-869.65", 869400, 869650, 100 },        // h1.6: 10% (RX2 downlinks)
+    { "869.7-870.0", 869700, 870000, 10 },          // h1.7: 1%
+    { "915.0-928.0 (AS923)", 915000, 928000, 10 },  // 1%
+    { "915.0-928.0 (AU915)", 915000, 928000, 0 }    // No duty cycle
+};
+
+// EU868: DR0-DR6 LoRa, DR7 FSK 50 kbps
+static const RegionDataRate EU868_DATARATES[] = {
+    { 12, 125, 51 }, { 11, 125, 51 }, { 10, 125, 51 }, { 9, 125, 115 },
+    { 8, 125, 222 }, { 7, 125, 222 }, { 7, 250, 222 }, { 0, 0, 222 }
+};
+
+// AS923 (all frequency plans), UplinkDwellTime = 1: SF12/SF11 frames exceed 400 ms
+static const RegionDataRate AS923_DATARATES[] = {
+    { 12, 125, 0 }, { 11, 125, 0 }, { 10, 125, 11 }, { 9, 125, 53 },
+    { 8, 125, 125 }, { 7, 125, 222 }, { 7, 250, 222 }, { 0, 0, 222 }
+};
+
+// AU915, UplinkDwellTime = 1: DR0-DR5 125 kHz, DR6 SF8/500 kHz
+static const RegionDataRate AU915_DATARATES[] = {
+    { 12, 125, 0 }, { 11, 125, 0 }, { 10, 125, 11 }, { 9, 125, 53 },
+    { 8, 125, 125 }, { 7, 125, 222 }, { 8, 500, 222 }
+};
+
+#define DR_COUNT(table) (uint8_t)(sizeof(table) / sizeof(table[0]))
+
+// Same order as LoRaRegion
+static const RegionPlan REGION_PLANS[REGION_COUNT] = {
+    { EU868_DATARATES, DR_COUNT(EU868_DATARATES), 0, 6, 2, 0 },     // EU868
+    { AS923_DATARATES, DR_COUNT(AS923_DATARATES), 6, 1, 6, 400 },   // AS923-1
+    { AS923_DATARATES, DR_COUNT(AS923_DATARATES), 6, 1, 6, 400 },   // AS923-2
+    { AS923_DATARATES, DR_COUNT(AS923_DATARATES), 6, 1, 6, 400 },   // AS923-3
+    { AS923_DATARATES, DR_COUNT(AS923_DATARATES), 6, 1, 6, 400 },   // AS923-4
+    { AU915_DATARATES, DR_COUNT(AU915_DATARATES), 7, 1, 7, 400 }    // AU915
+};
+
+const RegionPlan& LoRaRegions::get(LoRaRegion region) {
+    if (region >= REGION_COUNT) region = REGION_EU868;
+    return REGION_PLANS[region];
+}
+
+const char* LoRaRegions::name(LoRaRegion region) {
+    if (region >= REGION_COUNT) region = REGION_EU868;
+    return LORA_REGION_NAMES[region];
+}
+
+uint8_t LoRaRegions::usableDatarate(LoRaRegion region, uint8_t datarate) {
+    const RegionPlan& plan = get(region);
+    if (datarate >= plan.datarate_count) datarate = plan.datarate_count - 1;
+    while (plan.datarates[datarate].max_payload == 0 && datarate + 1 < plan.datarate_count) {
+        datarate++;
+    }
+    return datarate;
+}
+
+size_t LoRaRegions::maxAppPayload(LoRaRegion region, uint8_t datarate) {
+    const RegionPlan& plan = get(region);
+    return plan.datarates[usableDatarate(region, datarate)].max_payload;
+}
+
+int LoRaRegions::findBand(LoRaRegion region, uint32_t freq_khz) {
+    const RegionPlan& plan = get(region);
+    for (int i = plan.first_band; i < plan.first_band + plan.band_count; i++) {
+        if (freq_khz >= DUTY_CYCLE_BANDS[i].freq_min_khz && freq_khz <= DUTY_CYCLE_BANDS[i].freq_max_khz) {
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,67 @@
+#ifndef LORA_REGION_H
+#define LORA_REGION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+// ============================================================================
+// REGIONAL CHANNEL PLANS (TABLE-DRIVEN)
+// ============================================================================
+// Everything the firmware itself needs to know about a region, one table entry
+// per LoRaRegion (config.h): data rates with their maximum FRMPayload, the
+// regulatory duty-cycle bands and the uplink dwell-time limit. RadioLib keeps
+// its own channel plan per region (LoRaWANHandler maps the region to it); these
+// tables drive airtime estimates, the duty-cycle ledger and payload sizing.
+//
+// Values from LoRaWAN Regional Parameters RP002-1.0.3. Maximum payloads are the
+// repeater-compatible ones (as the EU868 table always used). Where a 400 ms
+// uplink dwell time applies, payloads are those for UplinkDwellTime = 1, and data
+// rates whose frames cannot meet it have a maximum payload of 0.
+//
+// Adding a region: a LoRaRegion value and name in config.h, its entry in
+// REGION_PLANS and the RadioLib band in LoRaWANHandler::radioLibBand().
+
+// Regulatory sub-band with its duty-cycle limit
+struct DutyCycleBand {
+    const char* name;
+    uint32_t freq_min_khz;
+    uint32_t freq_max_khz;
+    uint16_t duty_permille;  // 10 = 1%, 1 = 0.1%, 100 = 10%, 0 = no duty-cycle limit
+};
+
+// All bands of all regions; each region uses a contiguous range
+#define DUTY_CYCLE_BAND_COUNT 8
+extern const DutyCycleBand DUTY_CYCLE_BANDS[DUTY_CYCLE_BAND_COUNT];
+
+struct RegionDataRate {
+    uint8_t sf;            // Spreading factor, 0 = FSK 50 kbps
+    uint16_t bw_khz;
+    uint8_t max_payload;   // Largest FRMPayload without FOpts, 0 = not usable for uplinks
+};
+
+struct RegionPlan {
+    const RegionDataRate* datarates;
+    uint8_t datarate_count;      // Uplink data rates DR0..count-1
+    uint8_t first_band;          // Range in DUTY_CYCLE_BANDS
+    uint8_t band_count;
+    uint8_t default_band;        // Default (join) channels; charged for unknown frequencies
+    uint16_t dwell_time_ms;      // Uplink dwell-time limit, 0 = none
+};
+
+class LoRaRegions {
+public:
+    // Unknown values resolve to EU868
+    static const RegionPlan& get(LoRaRegion region);
+    static const char* name(LoRaRegion region);
+
+    // Nearest usable uplink data rate (out-of-range values clamp to the table,
+    // rates blocked by the dwell time move up to the first usable one)
+    static uint8_t usableDatarate(LoRaRegion region, uint8_t datarate);
+    static size_t maxAppPayload(LoRaRegion region, uint8_t datarate);
+
+    // Band in the region's range containing the frequency, or -1
+    static int findBand(LoRaRegion region, uint32_t freq_khz);
+};
+
+#endif // LORA_REGION_H
@@ -1,5 +1,10 @@
 #include "lorawan_handler.h"
+#include "boot_timeline.h"
+#include "power_manager.h"
 #include "modbus_handler.h"  // For InputRegisters structure
+#include "payload_codec.h"
+#include "logger.h"
+#include <esp_heap_caps.h>
 
 // Global instance
 LoRaWANHandler lorawanHandler;
@@ -18,11 +23,34 @@ LoRaWANHandler::LoRaWANHandler() :
     joined(false),
     uplink_count(0),
     downlink_count(0),
+    class_c_downlinks(0),
     last_rssi(0),
     last_snr(0.0),
-    last_uplink_time(0) {
-
-    memset(last_profile_uplinks, 0, sizeof(last_profile_uplinks));
+    session_buffers(nullptr),
+    session_cache_psram(false),
+    last_airtime_log(0),
+    map_lock(nullptr),
+    frame_lock(nullptr),
+    frame_history_psram(false),
+    startup_remaining(0),
+    startup_total(0),
+    startup_sent(0),
+    startup_home(0) {
+
+    memset(node_pool, 0, sizeof(node_pool));
+    memset(pool_owner, 0xFF, sizeof(pool_owner));
+    memset(pool_last_used, 0, sizeof(pool_last_used));
+    memset(pool_region, 0, sizeof(pool_region));
+    memset(profile_slot, -1, sizeof(profile_slot));
+    memset(session_valid, 0, sizeof(session_valid));
+    memset(profile_datarate, LORAWAN_DEFAULT_DATARATE, sizeof(profile_datarate));
+    memset(startup_pending, 0, sizeof(startup_pending));
+    memset(pending_expedite, 0, sizeof(pending_expedite));
+    memset(pending_ack, 0, sizeof(pending_ack));
+    memset(pending_ack_len, 0, sizeof(pending_ack_len));
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        uplink_interval_s[i] = defaultIntervalS();
+    }
     memset(appKey, 0, sizeof(appKey));
     memset(nwkKey, 0, sizeof(nwkKey));
     
@@ -43,19 +71,8 @@ void LoRaWANHandler::begin(bool loadConfig) {
     Serial.println("Initializing LoRaWAN...");
     Serial.println("========================================");
 
-    // Clean up existing instances if re-initializing
-    if (node) {
-        delete node;
-        node = nullptr;
-    }
-    if (radio) {
-        delete radio;
-        radio = nullptr;
-    }
-
-    // Initialize SPI bus for LoRa radio (only once)
-    static bool spi_initialized = false;
-    if (!spi_initialized) {
+    // The radio is created once and shared by every profile context for the whole uptime
+    if (!radio) {
         Serial.println("Initializing LoRa radio on SPI bus...");
         Serial.printf("  LoRa pins: SCK=%d, MISO=%d, MOSI=%d, NSS=%d\n", LORA_SCK, LORA_MISO, LORA_MOSI, LORA_NSS);
         Serial.printf("  LoRa control: DIO1=%d, RESET=%d, BUSY=%d\n", LORA_DIO1, LORA_NRST, LORA_BUSY);
@@ -64,32 +81,202 @@ void LoRaWANHandler::begin(bool loadConfig) {
         SPI.begin(LORA_SCK, LORA_MISO, LORA_MOSI, LORA_NSS);
         Serial.println("done");
         delay(100);
-        spi_initialized = true;
-    }
 
-    // Create radio instance
-    radio = new SX1262(new Module(LORA_NSS, LORA_DIO1, LORA_NRST, LORA_BUSY));
+        // Create radio instance
+        radio = new SX1262(new Module(LORA_NSS, LORA_DIO1, LORA_NRST, LORA_BUSY));
 
-    initializeRadio();
-    configureRadio();
+        initializeRadio();
+        configureRadio();
+    }
+
+    // Profile data partition and the PSRAM session cache come before anything is loaded
+    profileStore.begin();
+    if (nonceLog.begin()) {
+        migrateNoncesToLog();
+    }
+    allocateSessionCache();
+    allocateFrameHistory();
+    loadPayloadMap();
 
     if (loadConfig) {
         // Load profiles (generates if not present) - New multi-profile system
         loadProfiles();
         
+        // Load per-profile sessions into RAM cache (lets rotation skip re-joins)
+        loadSession();
+        
         // Set active profile (loads credentials into legacy fields)
         setActiveProfile(active_profile_index);
     }
+
+    // Preallocate the LoRaWAN node context pool (no-op after the first call)
+    allocateNodePool();
+    selectNodeContext();
     
     // Print active profile info
     printProfile(active_profile_index);
-
-    // Create LoRaWAN node instance
-    node = new LoRaWANNode(radio, &EU868);  // Change region as needed
+    printMemoryUsage();
 
     Serial.println("========================================\n");
 }
 
+void LoRaWANHandler::allocateNodePool() {
+    for (int i = 0; i < LORAWAN_NODE_POOL_SIZE; i++) {
+        if (!node_pool[i]) {
+            // Rebuilt in acquireNode() if the owning profile uses another region
+            node_pool[i] = createNode(LORAWAN_DEFAULT_REGION);
+            pool_region[i] = LORAWAN_DEFAULT_REGION;
+        }
+    }
+}
+
+LoRaWANNode* LoRaWANHandler::createNode(LoRaRegion region) {
+    // Fixed-channel plans listen on one 8-channel sub-band; RadioLib ignores it elsewhere
+    uint8_t sub_band = (region == REGION_AU915) ? LORAWAN_AU915_SUBBAND : 0;
+    LoRaWANNode* ctx = new LoRaWANNode(radio, radioLibBand(region), sub_band);
+    ctx->setADR(LORAWAN_ADR_ENABLED);  // Network LinkADRReq commands are applied by RadioLib
+    return ctx;
+}
+
+const LoRaWANBand_t* LoRaWANHandler::radioLibBand(LoRaRegion region) {
+    switch (region) {
+        case REGION_AS923_1: return &AS923;
+        case REGION_AS923_2: return &AS923_2;
+        case REGION_AS923_3: return &AS923_3;
+        case REGION_AS923_4: return &AS923_4;
+        case REGION_AU915:   return &AU915;
+        default:             return &EU868;
+    }
+}
+
+void LoRaWANHandler::allocateSessionCache() {
+    if (session_buffers) return;
+
+    // PSRAM first; the cache is only touched on profile switches, not in timing-critical code
+    session_buffers = (uint8_t (*)[RADIOLIB_LORAWAN_SESSION_BUF_SIZE])heap_caps_calloc(
+        MAX_LORA_PROFILES, RADIOLIB_LORAWAN_SESSION_BUF_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    session_cache_psram = (session_buffers != nullptr);
+    if (!session_buffers) {
+        session_buffers = (uint8_t (*)[RADIOLIB_LORAWAN_SESSION_BUF_SIZE])calloc(
+            MAX_LORA_PROFILES, RADIOLIB_LORAWAN_SESSION_BUF_SIZE);
+    }
+    if (!session_buffers) {
+        // Without the cache every profile switch re-joins; nothing else depends on it
+        Serial.println(">>> ERROR: Session cache allocation failed");
+    }
+}
+
+void LoRaWANHandler::allocateFrameHistory() {
+    if (frame_history.isActive()) return;
+
+    frame_lock = xSemaphoreCreateMutex();
+
+    // PSRAM holds a long history; internal RAM only enough for the last few cycles
+    uint16_t capacity = LORAWAN_FRAME_HISTORY_SIZE;
+    FrameRecord* ring = (FrameRecord*)heap_caps_calloc(capacity, sizeof(FrameRecord), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    frame_history_psram = (ring != nullptr);
+    if (!ring) {
+        capacity = LORAWAN_FRAME_HISTORY_FALLBACK;
+        ring = (FrameRecord*)calloc(capacity, sizeof(FrameRecord));
+    }
+    if (!ring || !frame_lock) {
+        Serial.println(">>> ERROR: Frame history allocation failed");
+        free(ring);
+        return;
+    }
+    frame_history.begin(ring, capacity);
+}
+
+void LoRaWANHandler::recordFrame(FrameRecord& rec, const uint8_t* payload, size_t len) {
+    if (!frame_history.isActive()) return;
+    rec.time = millis();
+    xSemaphoreTake(frame_lock, portMAX_DELAY);
+    frame_history.record(rec, payload, len);
+    xSemaphoreGive(frame_lock);
+}
+
+size_t LoRaWANHandler::queryFrames(const FrameQuery& q, FrameRecord* out, size_t max, uint32_t* next_cursor) {
+    *next_cursor = 0;
+    if (!frame_history.isActive()) return 0;
+    xSemaphoreTake(frame_lock, portMAX_DELAY);
+    size_t n = frame_history.query(q, out, max, next_cursor);
+    xSemaphoreGive(frame_lock);
+    return n;
+}
+
+const FrameHistory& LoRaWANHandler::getFrameHistory() const {
+    return frame_history;
+}
+
+bool LoRaWANHandler::isFrameHistoryInPSRAM() const {
+    return frame_history_psram;
+}
+
+void LoRaWANHandler::selectNodeContext() {
+    // Context swap: a profile keeps its node (session, FCnt, MAC state) while it holds a pool slot
+    node = acquireNode(active_profile_index);
+    joined = node->isActivated();
+    LOG_D(LOG_LORAWAN, "Node context: Profile %d, slot %d (%s)", active_profile_index,
+        profile_slot[active_profile_index], joined ? "session active" : "not activated");
+}
+
+LoRaWANNode* LoRaWANHandler::nodeFor(uint8_t index) const {
+    if (index >= MAX_LORA_PROFILES || profile_slot[index] < 0) return nullptr;
+    return node_pool[profile_slot[index]];
+}
+
+LoRaWANNode* LoRaWANHandler::acquireNode(uint8_t index) {
+    int slot = profile_slot[index];
+    if (slot < 0) {
+        // Free slot, otherwise the least recently used one
+        slot = 0;
+        for (int i = 0; i < LORAWAN_NODE_POOL_SIZE; i++) {
+            if (pool_owner[i] == 0xFF) {
+                slot = i;
+                break;
+            }
+            if ((long)(pool_last_used[i] - pool_last_used[slot]) < 0) slot = i;
+        }
+
+        uint8_t owner = pool_owner[slot];
+        LoRaWANNode* victim = node_pool[slot];
+        if (owner != 0xFF) {
+            // Keep the evicted session in the cache so the owner can resume without a join
+            if (victim->isActivated() && session_buffers) {
+                memcpy(session_buffers[owner], victim->getBufferSession(), RADIOLIB_LORAWAN_SESSION_BUF_SIZE);
+                session_valid[owner] = true;
+            }
+            victim->clearSession();
+            profile_slot[owner] = -1;
+            LOG_D(LOG_LORAWAN, "Node slot %d: evicted Profile %d", slot, owner);
+        }
+
+        pool_owner[slot] = index;
+        profile_slot[index] = slot;
+    }
+
+    // RadioLib binds the channel plan at construction: a context of another
+    // region is replaced (its session is gone with the region change anyway)
+    LoRaRegion region = profiles[index].region;
+    if (pool_region[slot] != region) {
+        delete node_pool[slot];
+        node_pool[slot] = createNode(region);
+        pool_region[slot] = region;
+        LOG_D(LOG_LORAWAN, "Node slot %d: rebuilt for %s", slot, LoRaRegions::name(region));
+    }
+
+    pool_last_used[slot] = millis();
+    return node_pool[slot];
+}
+
+bool LoRaWANHandler::switchToProfile(uint8_t index) {
+    if (!setActiveProfile(index)) {
+        return false;
+    }
+    selectNodeContext();
+    return true;
+}
+
 // ============================================================================
 // RADIO INITIALIZATION
 // ============================================================================
@@ -128,102 +315,157 @@ void LoRaWANHandler::configureRadio() {
 // ============================================================================
 
 bool LoRaWANHandler::join() {
-    Serial.println("\nChecking for saved nonces (required for DevNonce tracking)...");
+    // Context already holds a live session (e.g. joined earlier in this uptime)
+    if (node->isActivated()) {
+        LOG_I(LOG_LORAWAN, "Profile %d session already active - no join needed", active_profile_index);
+        joined = true;
+        return true;
+    }
+
+    LOG_D(LOG_SESSION, "Checking for saved nonces (required for DevNonce tracking)...");
 
+    const LoRaProfile& prof = profiles[active_profile_index];
     bool noncesRestored = restoreNonces();
+    bool sessionRestored = false;
 
     // Initialize node if nonces weren't restored
     if (!noncesRestored) {
-        Serial.println("\nInitializing LoRaWAN node...");
-        Serial.println("Region: EU868");
-        node->beginOTAA(joinEUI, devEUI, nwkKey, appKey);
+        LOG_I(LOG_LORAWAN, "Initializing LoRaWAN node (region %s)", LoRaRegions::name(prof.region));
+        beginActivation();
     } else {
-        Serial.println("\nNonces restored - proceeding with fresh join using incremented DevNonce...");
+        // Session can only be restored on top of matching nonces
+        sessionRestored = restoreSession();
+        if (sessionRestored) {
+            LOG_I(LOG_SESSION, "Session restored - activation will not transmit a join request");
+        } else {
+            LOG_I(LOG_SESSION, "Nonces restored - proceeding with fresh join using incremented DevNonce...");
+        }
     }
 
-    Serial.println("LoRaWAN credentials configured");
+    LOG_D(LOG_LORAWAN, "LoRaWAN credentials configured");
 
-    // Print diagnostic information before join attempt
-    Serial.println("\n========================================");
-    Serial.println("LoRaWAN Join Diagnostics");
-    Serial.println("========================================");
-    Serial.printf("Active Profile: %d (%s)\n", active_profile_index, profiles[active_profile_index].name);
-    Serial.printf("DevEUI: 0x%016llX\n", devEUI);
-    Serial.printf("JoinEUI: 0x%016llX\n", joinEUI);
-    Serial.printf("Region: EU868\n");
-    Serial.printf("TX Power: 14 dBm\n");
-    Serial.printf("Data Rate: DR5 (SF7BW125)\n");
-    Serial.println("========================================\n");
+    // Diagnostic information before the join attempt
+    LOG_I(LOG_LORAWAN, "========================================");
+    LOG_I(LOG_LORAWAN, "LoRaWAN Join Diagnostics");
+    LOG_I(LOG_LORAWAN, "Active Profile: %d (%s), %s", active_profile_index, prof.name, prof.abp ? "ABP" : "OTAA");
+    LOG_I(LOG_LORAWAN, "DevEUI: 0x%016llX", devEUI);
+    if (prof.abp) {
+        LOG_I(LOG_LORAWAN, "DevAddr: 0x%08lX", (unsigned long)prof.devAddr);
+    } else {
+        LOG_I(LOG_LORAWAN, "JoinEUI: 0x%016llX", joinEUI);
+    }
+    LOG_I(LOG_LORAWAN, "Region: %s, TX Power: 14 dBm", LoRaRegions::name(prof.region));
+    LOG_I(LOG_LORAWAN, "Data Rate: DR%d (last used), ADR %s", profile_datarate[active_profile_index],
+        LORAWAN_ADR_ENABLED ? "enabled" : "disabled");
+    LOG_I(LOG_LORAWAN, "========================================");
+
+    // ABP: the session is configured locally and nothing goes on air
+    if (prof.abp) {
+        int state = node->activateABP();
+        if (state == RADIOLIB_LORAWAN_NEW_SESSION || state == RADIOLIB_LORAWAN_SESSION_RESTORED) {
+            LOG_I(LOG_LORAWAN, "ABP session %s (DevAddr 0x%08lX)",
+                state == RADIOLIB_LORAWAN_NEW_SESSION ? "started, frame counters from 0" : "restored, frame counters continue",
+                (unsigned long)node->getDevAddr());
+            saveSession();
+            enableClassC();
+            joined = true;
+            return true;
+        }
+        LOG_E(LOG_LORAWAN, "ABP activation failed, code %d - check DevAddr and session keys", state);
+        join_backoff.recordFailure(active_profile_index, millis(), 0, esp_random());
+        joined = false;
+        return false;
+    }
 
-    // Attempt OTAA join
-    Serial.println("Attempting OTAA join...");
-    Serial.println("Transmitting join request...");
+    // Attempt OTAA join (returns immediately with SESSION_RESTORED if a session was restored)
+    LOG_I(LOG_LORAWAN, "Attempting OTAA join%s", sessionRestored ? "..." : ", transmitting join request...");
     unsigned long joinStart = millis();
+    if (!sessionRestored) {
+        join_backoff.attemptStarted(active_profile_index, joinStart);
+    }
     
     int state = node->activateOTAA();
     
     unsigned long joinDuration = millis() - joinStart;
-    Serial.printf("Join attempt completed in %lu ms\n", joinDuration);
+    LOG_I(LOG_LORAWAN, "Join attempt completed in %lu ms", joinDuration);
+
+    // A join request went on air unless the session was restored - charge it to the ledger
+    uint32_t joinToa = AirtimeLedger::joinTimeOnAirMs(prof.region, profile_datarate[active_profile_index]);
+    if (state != RADIOLIB_LORAWAN_SESSION_RESTORED) {
+        // RadioLib picks a default (join) channel; charged to the region's default band
+        airtime.record(millis(), active_profile_index, prof.region, 0, joinToa);
+        powerManager.noteRadio(joinToa, 2 * POWER_RX_WINDOW_MS);
+
+        FrameRecord rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.profile = active_profile_index;
+        rec.direction = FRAME_JOIN;
+        rec.result = state;
+        rec.datarate = profile_datarate[active_profile_index];
+        rec.toa_ms = joinToa;
+        recordFrame(rec, nullptr, 0);
+    }
 
     // Save nonces after EVERY join attempt (successful or failed)
     // This keeps DevNonce synchronized even if device reboots after failed attempts
     // Critical: Network server may see failed join attempts and increment its expected DevNonce
-    Serial.println("\nSaving DevNonce to NVS (keeps counter synchronized)...");
+    LOG_D(LOG_SESSION, "Saving DevNonce (keeps counter synchronized)...");
     saveSession();
 
     // Check for successful join
     // -1118 = RADIOLIB_LORAWAN_NEW_SESSION (new join successful)
     // -1117 = RADIOLIB_LORAWAN_SESSION_RESTORED (restored from persistent storage)
     if (state == RADIOLIB_LORAWAN_NEW_SESSION || state == RADIOLIB_LORAWAN_SESSION_RESTORED) {
-        Serial.println("\nJoin successful!");
+        LOG_I(LOG_LORAWAN, "Join successful! %s, DevAddr: 0x%08lX",
+            state == RADIOLIB_LORAWAN_NEW_SESSION ? "New LoRaWAN session established" : "Previous session restored",
+            (unsigned long)node->getDevAddr());
+        enableClassC();
         if (state == RADIOLIB_LORAWAN_NEW_SESSION) {
-            Serial.println("Status: New LoRaWAN session established");
-        } else {
-            Serial.println("Status: Previous session restored");
+            join_backoff.recordSuccess(active_profile_index, millis());
+            const JoinStats& js = join_backoff.getStats(active_profile_index);
+            LOG_I(LOG_LORAWAN, "Join latency: %lu ms (%lu attempt(s) so far, %lu failed)",
+                (unsigned long)js.last_latency_ms, (unsigned long)js.attempts, (unsigned long)js.failures);
         }
-        Serial.print("DevAddr: 0x");
-        Serial.println(node->getDevAddr(), HEX);
         joined = true;
 
         return true;
     } else {
-        Serial.print("\nJoin failed, code ");
-        Serial.println(state);
-
-        // Print helpful error messages
+        // Helpful error messages
         if (state == RADIOLIB_ERR_NO_JOIN_ACCEPT) {  // -1116
-            Serial.println("Error: No Join-Accept received (RADIOLIB_ERR_NO_JOIN_ACCEPT)");
-            Serial.println("  - Join request transmitted successfully");
-            Serial.println("  - No response received from network server");
-            Serial.println("\nPossible causes:");
-            Serial.println("  1. Device not registered in network server (TTN/Chirpstack)");
-            Serial.println("  2. Wrong credentials (DevEUI, JoinEUI, AppKey mismatch)");
-            Serial.println("  3. No gateway in range or gateway offline");
-            Serial.println("  4. Gateway not forwarding to correct network server");
-            Serial.println("  5. Network server having issues");
-            Serial.println("\nTroubleshooting:");
-            Serial.println("  - Verify device is registered with EXACT credentials above");
-            Serial.println("  - Check gateway coverage at your location");
-            Serial.println("  - Verify gateway is connected to network server");
-            Serial.println("  - Check network server console for join attempts");
-            Serial.println("  - Try moving closer to a known gateway");
+            LOG_E(LOG_LORAWAN, "Join failed, code %d: No Join-Accept received (RADIOLIB_ERR_NO_JOIN_ACCEPT)", state);
+            LOG_I(LOG_LORAWAN, "  - Join request transmitted successfully, no response received from network server");
+            LOG_I(LOG_LORAWAN, "Possible causes:");
+            LOG_I(LOG_LORAWAN, "  1. Device not registered in network server (TTN/Chirpstack)");
+            LOG_I(LOG_LORAWAN, "  2. Wrong credentials (DevEUI, JoinEUI, AppKey mismatch)");
+            LOG_I(LOG_LORAWAN, "  3. No gateway in range or gateway offline");
+            LOG_I(LOG_LORAWAN, "  4. Gateway not forwarding to correct network server");
+            LOG_I(LOG_LORAWAN, "  5. Network server having issues");
+            LOG_I(LOG_LORAWAN, "Troubleshooting:");
+            LOG_I(LOG_LORAWAN, "  - Verify device is registered with EXACT credentials above");
+            LOG_I(LOG_LORAWAN, "  - Check gateway coverage at your location");
+            LOG_I(LOG_LORAWAN, "  - Verify gateway is connected to network server");
+            LOG_I(LOG_LORAWAN, "  - Check network server console for join attempts");
+            LOG_I(LOG_LORAWAN, "  - Try moving closer to a known gateway");
         } else if (state == RADIOLIB_ERR_CHIP_NOT_FOUND) {
-            Serial.println("Error: Radio communication lost (RADIOLIB_ERR_CHIP_NOT_FOUND)");
-            Serial.println("  - SPI communication failure");
-            Serial.println("  - Check: SPI bus conflicts");
-            Serial.println("  - Check: Radio power and connections");
+            LOG_E(LOG_LORAWAN, "Join failed, code %d: Radio communication lost (RADIOLIB_ERR_CHIP_NOT_FOUND)", state);
+            LOG_I(LOG_LORAWAN, "  - SPI communication failure");
+            LOG_I(LOG_LORAWAN, "  - Check: SPI bus conflicts");
+            LOG_I(LOG_LORAWAN, "  - Check: Radio power and connections");
         } else if (state == RADIOLIB_ERR_TX_TIMEOUT) {  // -101
-            Serial.println("Error: Transmission timeout (RADIOLIB_ERR_TX_TIMEOUT)");
-            Serial.println("  - Join request failed to transmit");
-            Serial.println("  - Check: Radio configuration");
-            Serial.println("  - Check: Antenna connection");
+            LOG_E(LOG_LORAWAN, "Join failed, code %d: Transmission timeout (RADIOLIB_ERR_TX_TIMEOUT)", state);
+            LOG_I(LOG_LORAWAN, "  - Join request failed to transmit");
+            LOG_I(LOG_LORAWAN, "  - Check: Radio configuration");
+            LOG_I(LOG_LORAWAN, "  - Check: Antenna connection");
         } else {
-            Serial.println("Error: Unknown error code");
-            Serial.println("  - See RadioLib documentation for error code details");
-            Serial.println("  - https://jgromes.github.io/RadioLib/group__status__codes.html");
+            LOG_E(LOG_LORAWAN, "Join failed, code %d: Unknown error code", state);
+            LOG_I(LOG_LORAWAN, "  - See RadioLib documentation for error code details");
+            LOG_I(LOG_LORAWAN, "  - https://jgromes.github.io/RadioLib/group__status__codes.html");
         }
 
-        Serial.println("\nWill retry in next cycle...");
+        uint32_t retry = join_backoff.recordFailure(active_profile_index, millis(), joinToa, esp_random());
+        const JoinStats& js = join_backoff.getStats(active_profile_index);
+        LOG_W(LOG_LORAWAN, "Join failure %u in a row for Profile %d - next attempt in %lu s",
+            js.consecutive_failures, active_profile_index, (unsigned long)(retry / 1000));
         joined = false;
         return false;
     }
@@ -237,213 +479,524 @@ bool LoRaWANHandler::isJoined() const {
 // UPLINK/DOWNLINK
 // ============================================================================
 
-void LoRaWANHandler::performStartupSequence(const InputRegisters& input) {
-    Serial.println("\n========================================");
-    Serial.println("Startup Uplink Sequence");
-    Serial.println("========================================");
-    
-    int enabled_count = getEnabledProfileCount();
-    Serial.printf("Sending initial uplinks from %d enabled profile(s)...\n\n", enabled_count);
-    
-    // Track which profiles we've sent from
-    int uplinks_sent = 0;
-    
-    // Get initial profile index to restore later
-    uint8_t initial_profile = active_profile_index;
-    
-    // Iterate through all profiles and send from enabled ones
+void LoRaWANHandler::scheduleStartupUplinks() {
+    startup_total = 0;
     for (int i = 0; i < MAX_LORA_PROFILES; i++) {
-        if (!profiles[i].enabled) continue;
-        
-        // Switch to this profile
-        Serial.printf("\n>>> Switching to Profile %d: %s\n", i, profiles[i].name);
-        setActiveProfile(i);
-        begin(false); // Re-initialize radio but DON'T reload profiles from NVS
-        
-        // Join with this profile
-        Serial.printf(">>> Joining network with Profile %d...\n", i);
-        if (join()) {
-            Serial.printf(">>> Join successful for Profile %d!\n", i);
-            delay(1000);
-            
-            // Send uplink
-            Serial.printf(">>> Sending startup uplink from Profile %d\n", i);
-            sendUplink(input);
-            uplinks_sent++;
-            
-            // Mark this profile as having sent recently
-            last_profile_uplinks[i] = millis();
-            last_uplink_time = millis();
-            
-            Serial.printf(">>> Uplink sent from Profile %d (%d/%d)\n", i, uplinks_sent, enabled_count);
-            
-            // Delay before next profile (10 seconds to allow RX windows to complete)
-            if (uplinks_sent < enabled_count) {
-                Serial.println(">>> Waiting 10 seconds before next profile...");
-                delay(10000);
-            }
-        } else {
-            Serial.printf(">>> Join failed for Profile %d, skipping uplink\n", i);
-        }
+        startup_pending[i] = profiles[i].enabled;
+        if (startup_pending[i]) startup_total++;
     }
-    
+    startup_remaining = startup_total;
+    startup_sent = 0;
+    startup_home = active_profile_index;
+    if (startup_total == 0) return;
+
     Serial.println("\n========================================");
-    Serial.printf("Startup sequence complete: %d/%d uplinks sent\n", uplinks_sent, enabled_count);
+    Serial.println("Startup Uplinks");
+    Serial.println("========================================");
+    Serial.printf("Initial uplinks from %d enabled profile(s) queued, %lu s apart\n",
+        startup_total, (unsigned long)(scheduler.getMinGap() / 1000));
+    Serial.println("Sent in the background - Modbus and HTTPS are not held up");
     Serial.println("========================================\n");
-    
-    // Return to initial profile (or keep last one if auto-rotation is on? usually restore initial)
-    // If auto-rotation is on, we might want to start from the next one in sequence, but restoring initial is safer.
-    if (active_profile_index != initial_profile) {
-        Serial.printf("\n>>> Returning to initial Profile %d for normal operation\n", initial_profile);
-        setActiveProfile(initial_profile);
-        begin(false);
-        join();
+}
+
+bool LoRaWANHandler::isStartupPending() const {
+    return startup_remaining > 0;
+}
+
+void LoRaWANHandler::endStartupUplink(uint8_t index, bool sent) {
+    if (index >= MAX_LORA_PROFILES || !startup_pending[index]) return;
+
+    startup_pending[index] = false;
+    startup_remaining--;
+    if (sent) {
+        startup_sent++;
+        LOG_I(LOG_LORAWAN, "Startup uplink sent from Profile %d (%d/%d)", index, startup_sent, startup_total);
+    } else {
+        LOG_I(LOG_LORAWAN, "Startup uplink from Profile %d skipped", index);
+    }
+    if (startup_remaining > 0) return;
+
+    LOG_I(LOG_LORAWAN, "Startup uplinks complete: %d/%d sent", startup_sent, startup_total);
+    bootTimeline.mark(BOOT_STARTUP_UPLINKS_DONE, millis());
+
+    // Without rotation only the initial profile stays scheduled
+    bool rotating = auto_rotation_enabled && getEnabledProfileCount() > 1;
+    if (!rotating && active_profile_index != startup_home) {
+        LOG_I(LOG_LORAWAN, "Returning to initial Profile %d for normal operation", startup_home);
+        switchToProfile(startup_home);
     }
 }
 
 void LoRaWANHandler::process(const InputRegisters& input) {
-    // If not joined, try to join
+    unsigned long now = millis();
+
+    // Downlinks received while listening in Class C are applied right away
+    pollClassC();
+
+    // Buffer samples between uplinks for the batched delta payload
+    uint16_t sample[BATCH_FIELD_COUNT] = {
+        input.sf6_density, input.sf6_pressure_20c, input.sf6_temperature, input.sf6_pressure_var
+    };
+    batcher.sampleIfDue(now, sample);
+
+    syncSchedule(now);
+    checkForChanges(sample, now);
+
+    // Earliest deadline first; -1 while nothing is due or the stagger gap is running
+    int next_profile = scheduler.nextDue(now);
+    if (next_profile < 0) {
+        return;
+    }
+
+    // A retransmission on its own must leave room for one routine frame in the
+    // duty-cycle budget; otherwise the profile's next regular uplink (sent
+    // confirmed) carries it
+    bool retry_only = delivery.isPending(next_profile) && !change_reporter.isPending(next_profile) &&
+                      !startup_pending[next_profile] && (long)(now - scheduler.getDeadline(next_profile)) < 0;
+    if (retry_only &&
+        airtime.waitTimeMs(now, profiles[next_profile].region, 2 * estimateUplinkAirtime(next_profile)) > 0) {
+        LOG_I(LOG_LORAWAN, "Retransmission for Profile %d moved to its next uplink (airtime budget)", next_profile);
+        scheduler.hold(next_profile, scheduler.getDeadline(next_profile));
+        return;
+    }
+
+    // Hold the profile (deadline unchanged) until its frame fits the duty-cycle budget
+    unsigned long wait = airtimeWaitMs(next_profile, now);
+    if (wait > 0) {
+        scheduler.hold(next_profile, now + (wait > AIRTIME_WINDOW_MS ? AIRTIME_WINDOW_MS : wait));
+        return;
+    }
+
+    if (next_profile != active_profile_index) {
+        LOG_D(LOG_LORAWAN, "Switching to profile %d (earliest deadline)", next_profile);
+        switchToProfile(next_profile);
+    }
+
+    // Join only if this context has no live session (restores cached session if available)
     if (!joined) {
-        static unsigned long last_join_attempt = 0;
-        if (millis() - last_join_attempt > 30000) { // Retry every 30s
-            last_join_attempt = millis();
-            Serial.println("LoRaWAN not joined, attempting to join...");
-            join();
+        LOG_I(LOG_LORAWAN, "LoRaWAN not joined, attempting to join...");
+        if (!join_backoff.canAttempt(next_profile, now)) {
+            scheduler.hold(next_profile, join_backoff.getNextAttempt(next_profile));
+            endStartupUplink(next_profile, false);
+            return;
         }
+        if (!join()) {
+            // Each profile retries on its own randomized backoff
+            scheduler.noteTransmission(millis());
+            scheduler.hold(next_profile, join_backoff.getNextAttempt(next_profile));
+            endStartupUplink(next_profile, false);
+            return;
+        }
+        LOG_I(LOG_LORAWAN, "Joined with profile %d", active_profile_index);
+    }
+
+    long lateness = (long)(now - scheduler.getDeadline(next_profile));
+    if (startup_pending[next_profile]) {
+        LOG_I(LOG_LORAWAN, "Sending startup uplink from Profile %d: %s", next_profile, profiles[next_profile].name);
+    } else {
+        LOG_D(LOG_LORAWAN, "Profile %d is due for uplink (%ld ms after deadline)", next_profile, lateness);
+    }
+    bool change_report = change_reporter.isPending(next_profile);
+    bool sent = sendUplink(input);
+    scheduler.complete(next_profile, now);
+
+    // The heartbeat counts from the last report
+    if (sent && change_report) {
+        scheduler.rearm(next_profile, now);
+    }
+
+    // Unacknowledged confirmed frame: one extra uplink after the retry backoff
+    if (sent && delivery.isPending(next_profile)) {
+        scheduler.expedite(next_profile, delivery.getRetryAt(next_profile));
+    }
+    endStartupUplink(next_profile, sent);
+}
+
+void LoRaWANHandler::handleDownlink(const uint8_t* data, size_t len, const LoRaWANEvent_t& event, bool class_c) {
+    FrameRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.profile = active_profile_index;
+    rec.direction = FRAME_DOWNLINK;
+    rec.flags = FRAME_FLAG_RADIO | (class_c ? FRAME_FLAG_CLASS_C : 0);
+    rec.fcnt = event.fCnt;
+    rec.fport = event.fPort;
+    rec.datarate = event.datarate;
+    rec.rssi = last_rssi;
+    rec.snr = (int8_t)roundf(last_snr);
+    recordFrame(rec, data, len);
+
+    if (len == 0) {
+        LOG_I(LOG_LORAWAN, "Downlink ACK received (no payload)");
         return;
     }
 
-    unsigned long now = millis();
+    LOG_I(LOG_LORAWAN, "Downlink payload (%u bytes): %s", (unsigned)len, LogHex(data, len));
 
-    if (auto_rotation_enabled && getEnabledProfileCount() > 1) {
-        // Multi-profile mode: Each profile sends every 5 minutes, staggered by 1 minute
-        unsigned long time_since_last = now - last_profile_uplinks[active_profile_index];
-        
-        // Check if current profile is due for transmission (5 minutes since its last uplink)
-        if (time_since_last >= 300000) {
-            Serial.printf("Profile %d is due for uplink (5min elapsed)\n", active_profile_index);
-            
-            // Send uplink from current profile
-            last_profile_uplinks[active_profile_index] = now;
-            last_uplink_time = now;
-            sendUplink(input);
-            
-            // After sending, rotate to next enabled profile and join
-            if (rotateToNextProfile()) {
-                Serial.println("Auto-rotation: Switching to next profile");
-                
-                // Re-join network with new profile credentials
-                joined = false;
-                begin(false); // Re-initialize radio
-                if (join()) {
-                    joined = true;
-                    Serial.printf("Joined with profile %d\n", active_profile_index);
-                } else {
-                    Serial.println("Failed to join after profile rotation");
-                }
-            }
-        } else {
-            // Check if we should switch to a different profile that's ready to send
-            // This ensures 1-minute staggering between profiles
-            uint8_t next_profile = getNextEnabledProfile();
-            if (next_profile != active_profile_index) {
-                unsigned long next_time_since_last = now - last_profile_uplinks[next_profile];
-                
-                // If next profile is due AND at least 1 minute has passed since any uplink
-                if (next_time_since_last >= 300000 && (now - last_uplink_time >= 60000)) {
-                    Serial.printf("Switching to profile %d which is ready to send\n", next_profile);
-                    
-                    // Rotate to next profile
-                    if (rotateToNextProfile()) {
-                        // Re-join network
-                        joined = false;
-                        begin(false);
-                        if (join()) {
-                            joined = true;
-                            Serial.printf("Joined with profile %d\n", active_profile_index);
-                            
-                            // Send immediately after joining
-                            last_profile_uplinks[next_profile] = now;
-                            last_uplink_time = now;
-                            sendUplink(input);
-                        } else {
-                            Serial.println("Failed to join with next profile");
-                        }
-                    }
-                }
-            }
-        }
+    // Remote configuration; results are acknowledged in this profile's next uplink
+    if (event.fPort == LORAWAN_CMD_FPORT) {
+        pending_ack_len[active_profile_index] = DownlinkCommands::process(
+            active_profile_index, data, len, (uint8_t)event.fCnt, pending_ack[active_profile_index]);
+    }
+}
+
+// ============================================================================
+// CLASS C (CONTINUOUS RECEIVE)
+// ============================================================================
+
+void LoRaWANHandler::enableClassC() {
+    if (!LORAWAN_CLASS_C || !node->isActivated()) return;
+
+    // RadioLib keeps the radio in RX2 between uplinks and flags received
+    // frames from its DIO1 interrupt; process() only checks that flag
+    int16_t state = node->setClass(RADIOLIB_LORAWAN_CLASS_C);
+    if (state == RADIOLIB_ERR_NONE) {
+        LOG_I(LOG_LORAWAN, "Class C: Profile %d listening between uplinks", active_profile_index);
     } else {
-        // Single profile mode: Send every 5 minutes
-        if (now - last_uplink_time >= 300000) {
-            last_uplink_time = now;
-            last_profile_uplinks[active_profile_index] = now;
-            
-            Serial.printf("Sending uplink from profile %d\n", active_profile_index);
-            sendUplink(input);
+        LOG_W(LOG_LORAWAN, "Class C could not be enabled for Profile %d (%d) - staying Class A", active_profile_index, state);
+    }
+}
+
+void LoRaWANHandler::pollClassC() {
+    if (!LORAWAN_CLASS_C || !joined) return;
+
+    uint8_t data[256];
+    size_t len = 0;
+    LoRaWANEvent_t event;
+    int16_t state = node->getDownlinkClassC(data, &len, &event);
+    if (state == 0) return;  // Nothing received since the last check
+    if (state < 0) {
+        LOG_W(LOG_LORAWAN, "Class C downlink dropped (%d)", state);
+        return;
+    }
+
+    LOG_I(LOG_LORAWAN, "Class C downlink for Profile %d (FPort %d, FCnt %lu)",
+        active_profile_index, event.fPort, (unsigned long)event.fCnt);
+    downlink_count++;
+    class_c_downlinks++;
+    last_rssi = radio->getRSSI();
+    last_snr = radio->getSNR();
+    handleDownlink(data, len, event, true);
+}
+
+uint32_t LoRaWANHandler::getClassCDownlinkCount() const {
+    return class_c_downlinks;
+}
+
+// ============================================================================
+// UPLINK SCHEDULING
+// ============================================================================
+
+void LoRaWANHandler::syncSchedule(unsigned long now) {
+    // Rotation schedules every enabled profile; otherwise only the active one
+    // sends, plus profiles whose startup uplink is still pending
+    bool rotating = auto_rotation_enabled && getEnabledProfileCount() > 1;
+    uint8_t home = startup_remaining > 0 ? startup_home : active_profile_index;
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        bool wanted = rotating ? profiles[i].enabled : (i == home);
+        if (startup_pending[i] && !profiles[i].enabled) {
+            endStartupUplink(i, false);  // Disabled before its turn
+        }
+        scheduler.setScheduled(i, wanted || startup_pending[i], now);
+        if (!scheduler.isScheduled(i)) {
+            delivery.cancel(i);  // No uplinks left to retransmit with
+        }
+
+        // Remote "uplink now" requests; applied here so the send that delivered
+        // the command doesn't consume them in complete()
+        if (pending_expedite[i]) {
+            pending_expedite[i] = false;
+            scheduler.expedite(i, now);
         }
     }
 }
 
+uint16_t LoRaWANHandler::defaultIntervalS() {
+    return (LORAWAN_REPORT_ON_CHANGE ? LORAWAN_REPORT_MAX_INTERVAL_MS : LORAWAN_UPLINK_INTERVAL_MS) / 1000;
+}
+
+void LoRaWANHandler::checkForChanges(const uint16_t* sample, unsigned long now) {
+    if (!LORAWAN_REPORT_ON_CHANGE) return;
+
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        if (!scheduler.isScheduled(i)) {
+            change_reporter.cancel(i);
+            continue;
+        }
+
+        ReportTrigger trigger = change_reporter.check(i, sample, now);
+        if (trigger == REPORT_NONE) continue;
+
+        change_reporter.requested(i, trigger, sample);
+        scheduler.expedite(i, now);
+        const ReportField& field = REPORT_FIELDS[change_reporter.getStats(i).last_field];
+        LOG_I(LOG_LORAWAN, "Report on change: Profile %d, %s %s", i, field.name,
+            trigger == REPORT_THRESHOLD ? "crossed its alarm level" : "left its deadband");
+    }
+}
+
+unsigned long LoRaWANHandler::airtimeWaitMs(uint8_t index, unsigned long now) {
+    uint32_t toa = estimateUplinkAirtime(index);
+    unsigned long wait = airtime.waitTimeMs(now, profiles[index].region, toa);
+    if (wait == 0) {
+        return 0;
+    }
+
+    // Log at most once per stagger slot so a blocked scheduler doesn't flood the log
+    if (last_airtime_log == 0 || now - last_airtime_log >= LORAWAN_STAGGER_MS) {
+        last_airtime_log = now;
+        LOG_W(LOG_LORAWAN, "Duty-cycle budget exhausted: profile %d (%lu ms frame) can send in %lu s",
+            index, (unsigned long)toa, wait / 1000);
+    }
+    return wait;
+}
+
+// ============================================================================
+// LOW-POWER OPERATION
+// ============================================================================
+
+unsigned long LoRaWANHandler::timeUntilNextUplink(unsigned long now) const {
+    return scheduler.timeUntilNext(now);
+}
+
+unsigned long LoRaWANHandler::timeUntilNextSample(unsigned long now) const {
+    return batcher.timeUntilSample(now);
+}
+
+void LoRaWANHandler::sleepRadio() {
+    if (radio) radio->sleep();
+}
+
+void LoRaWANHandler::retainState(unsigned long now, LoRaWANRetained& out) {
+    memset(&out, 0, sizeof(out));
+    scheduler.retain(now, out.schedule);
+    airtime.retain(now, out.airtime);
+    join_backoff.retain(now, out.joins);
+    memcpy(out.profile_datarate, profile_datarate, sizeof(out.profile_datarate));
+    memcpy(out.startup_pending, startup_pending, sizeof(out.startup_pending));
+    out.startup_total = startup_total;
+    out.startup_sent = startup_sent;
+    out.startup_home = startup_home;
+    out.uplink_count = uplink_count;
+    out.downlink_count = downlink_count;
+    out.active_profile = active_profile_index;
+
+    out.session_profile = 0xFF;
+    if (node && node->isActivated()) {
+        memcpy(out.nonces, node->getBufferNonces(), sizeof(out.nonces));
+        memcpy(out.session, node->getBufferSession(), sizeof(out.session));
+        out.session_profile = active_profile_index;
+    }
+}
+
+void LoRaWANHandler::resumeState(const LoRaWANRetained& in, unsigned long saved_at) {
+    scheduler.resume(in.schedule, saved_at);
+    airtime.resume(in.airtime, saved_at);
+    join_backoff.resume(in.joins, saved_at);
+    memcpy(profile_datarate, in.profile_datarate, sizeof(profile_datarate));
+    memcpy(startup_pending, in.startup_pending, sizeof(startup_pending));
+    startup_remaining = 0;
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        if (startup_pending[i]) startup_remaining++;
+    }
+    startup_total = in.startup_total;
+    startup_sent = in.startup_sent;
+    startup_home = in.startup_home;
+    uplink_count = in.uplink_count;
+    downlink_count = in.downlink_count;
+
+    if (in.active_profile != active_profile_index && in.active_profile < MAX_LORA_PROFILES) {
+        switchToProfile(in.active_profile);
+    }
+
+    // The active profile continues its session without reading flash or
+    // sending a join request (the other profiles restore from the nonce log)
+    if (in.session_profile == active_profile_index && !node->isActivated()) {
+        beginActivation();
+        bool resumed = node->setBufferNonces(in.nonces) == RADIOLIB_ERR_NONE &&
+                       node->setBufferSession(in.session) == RADIOLIB_ERR_NONE;
+        if (resumed) {
+            int16_t state = profiles[active_profile_index].abp ? node->activateABP() : node->activateOTAA();
+            resumed = (state == RADIOLIB_LORAWAN_SESSION_RESTORED);
+        }
+        joined = resumed;
+        if (resumed && session_buffers) {
+            memcpy(session_buffers[active_profile_index], in.session, RADIOLIB_LORAWAN_SESSION_BUF_SIZE);
+            session_valid[active_profile_index] = true;
+        }
+        Serial.printf(">>> Profile %d session %s\n", active_profile_index,
+            resumed ? "resumed from RTC memory" : "not resumed from RTC memory - restoring from flash");
+    }
+
+    Serial.printf(">>> LoRaWAN state resumed: %lu uplinks so far, next uplink in %lu s\n",
+        (unsigned long)uplink_count, timeUntilNextUplink(millis()) / 1000);
+}
+
+// ============================================================================
+// ADAPTIVE DATA RATE
+// ============================================================================
+
+void LoRaWANHandler::applyAdrBackoff() {
+    // Network ADR raises the data rate on good links. If the network stays silent
+    // the uplinks may not be reaching it: step one data rate slower after
+    // LORAWAN_ADR_BACKOFF_LIMIT unanswered uplinks, then again every
+    // LORAWAN_ADR_BACKOFF_DELAY, down to DR0.
+    if (!LORAWAN_ADR_ENABLED) return;
+
+    uint8_t idx = active_profile_index;
+    uint16_t silent = link_history.getUplinksSinceDownlink(idx);
+    if (silent < LORAWAN_ADR_BACKOFF_LIMIT) return;
+    if ((silent - LORAWAN_ADR_BACKOFF_LIMIT) % LORAWAN_ADR_BACKOFF_DELAY != 0) return;
+
+    // Lowest rate the region allows for uplinks (dwell time rules out SF11/SF12 in AS923/AU915)
+    uint8_t dr = profile_datarate[idx];
+    if (dr <= LoRaRegions::usableDatarate(profiles[idx].region, 0)) return;
+
+    if (node->setDatarate(dr - 1) == RADIOLIB_ERR_NONE) {
+        profile_datarate[idx] = dr - 1;
+        LOG_W(LOG_LORAWAN, "ADR backoff: profile %d has %u uplinks without downlink, DR%d -> DR%d",
+            idx, silent, dr, dr - 1);
+    }
+}
+
+uint32_t LoRaWANHandler::estimateUplinkAirtime(uint8_t index) const {
+    if (index >= MAX_LORA_PROFILES) return 0;
+
+    // Size the real frame: batched frames grow with the samples pending for this profile
+    const PayloadCodec& codec = PayloadCodecs::get(profiles[index].payload_type);
+    PayloadContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.profile = index;
+    ctx.batcher = &batcher;
+    ctx.map = &payload_map;
+    size_t size = codec.encode(nullptr, maxAppPayload(index), ctx);
+    if (size == 0) size = codec.size;
+
+    if (pending_ack_len[index] > 0) {
+        size += pending_ack_len[index] + 1;
+    }
+    return AirtimeLedger::uplinkTimeOnAirMs(profiles[index].region, profile_datarate[index], size);
+}
+
+size_t LoRaWANHandler::maxAppPayload(uint8_t index) const {
+    // Dwell-time limited rates (AS923/AU915 DR2) leave no room after the reserve
+    size_t max_len = LoRaRegions::maxAppPayload(profiles[index].region, profile_datarate[index]);
+    size_t overhead = LORAWAN_BATCH_FOPTS_RESERVE;
+
+    // A pending command acknowledgement is prepended (plus the original FPort byte)
+    if (pending_ack_len[index] > 0) {
+        overhead += pending_ack_len[index] + 1;
+    }
+    return max_len > overhead ? max_len - overhead : 0;
+}
+
+const AirtimeLedger& LoRaWANHandler::getAirtime() const {
+    return airtime;
+}
+
+UplinkScheduler& LoRaWANHandler::getScheduler() {
+    return scheduler;
+}
+
 bool LoRaWANHandler::sendUplink(const InputRegisters& input) {
     if (!joined) {
-        Serial.println("LoRaWAN: Not joined, skipping uplink");
+        LOG_W(LOG_LORAWAN, "LoRaWAN: Not joined, skipping uplink");
         return false;
     }
 
-    Serial.println("========================================");
-    Serial.println("Sending LoRaWAN uplink...");
+    LOG_I(LOG_LORAWAN, "========================================");
+    LOG_I(LOG_LORAWAN, "Sending LoRaWAN uplink...");
 
     // Set device status for LoRaWAN network server
     // Battery level: 0 = external power, 1-254 = battery level, 255 = unable to measure
-    node->setDeviceStatus(0);
+    node->setDeviceStatus(POWER_MODE == POWER_ALWAYS_ON ? 0 : 255);
 
     // Get current profile's payload type
     LoRaProfile* current_profile = getProfile(active_profile_index);
     PayloadType payload_type = current_profile ? current_profile->payload_type : PAYLOAD_ADEUNIS_MODBUS_SF6;
     
-    Serial.printf("Using payload format: %s\n", PAYLOAD_TYPE_NAMES[payload_type]);
+    LOG_I(LOG_LORAWAN, "Using payload format: %s", PAYLOAD_TYPE_NAMES[payload_type]);
+
+    // Encode through the codec registry (layouts: payload_codec.cpp)
+    const PayloadCodec& codec = PayloadCodecs::get(payload_type);
+    PayloadContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.input = &input;
+    ctx.holding = &modbusHandler.getHoldingRegisters();
+    ctx.map = &payload_map;
+    ctx.uplink_count = uplink_count;
+    ctx.profile = active_profile_index;
+    ctx.now = millis();
+    ctx.batcher = &batcher;
+
+    // Batched frames need at least one sample (e.g. first uplink right after boot)
+    uint16_t sample[BATCH_FIELD_COUNT] = {
+        input.sf6_density, input.sf6_pressure_20c, input.sf6_temperature, input.sf6_pressure_var
+    };
+    batcher.sampleIfDue(ctx.now, sample);
 
-    // Prepare payload based on profile's payload type
     uint8_t payload[256];  // Max LoRaWAN payload size
-    size_t payload_size = 0;
-    
-    switch (payload_type) {
-        case PAYLOAD_ADEUNIS_MODBUS_SF6:
-            payload_size = buildAdeunisModbusSF6Payload(payload, input);
-            break;
-        case PAYLOAD_VISTRON_LORA_MOD_CON:
-            payload_size = buildVistronLoraModConPayload(payload, input);
-            break;
-        case PAYLOAD_CAYENNE_LPP:
-            payload_size = buildCayenneLPPPayload(payload, input);
-            break;
-        case PAYLOAD_RAW_MODBUS:
-            payload_size = buildRawModbusPayload(payload, input);
-            break;
-        case PAYLOAD_CUSTOM:
-            payload_size = buildCustomPayload(payload, input);
-            break;
-        default:
-            payload_size = buildAdeunisModbusSF6Payload(payload, input);
-            break;
+    // The web server may replace the user mapping meanwhile
+    xSemaphoreTake(map_lock, portMAX_DELAY);
+    size_t payload_size = codec.encode(payload, maxAppPayload(active_profile_index), ctx);
+    if (payload_size > 0 && LORAWAN_PAYLOAD_BREAKDOWN) {
+        PayloadCodecs::printBreakdown(payload_type, payload, payload_size, &payload_map);
+    }
+    xSemaphoreGive(map_lock);
+    if (payload_size == 0) {
+        LOG_W(LOG_LORAWAN, "Payload does not fit at DR%d, skipping uplink", profile_datarate[active_profile_index]);
+        LOG_I(LOG_LORAWAN, "========================================");
+        return false;
+    }
+
+    uint8_t fport = codec.fport;
+
+    // Acknowledge the last command downlink: [ack block][original FPort][payload] on FPort 10
+    uint8_t ack_len = pending_ack_len[active_profile_index];
+    if (ack_len > 0) {
+        memmove(payload + ack_len + 1, payload, payload_size);
+        memcpy(payload, pending_ack[active_profile_index], ack_len);
+        payload[ack_len] = fport;
+        payload_size += ack_len + 1;
+        fport = LORAWAN_CMD_FPORT;
+        LOG_I(LOG_LORAWAN, "Acknowledging %d command(s) from downlink FCnt %d", payload[1], payload[0]);
     }
 
     // Print payload in hex for debugging
-    Serial.print("Payload (");
-    Serial.print(payload_size);
-    Serial.print(" bytes): ");
-    for (size_t i = 0; i < payload_size; i++) {
-        if (payload[i] < 0x10) Serial.print("0");
-        Serial.print(payload[i], HEX);
+    LOG_I(LOG_LORAWAN, "Payload (%u bytes): %s", (unsigned)payload_size, LogHex(payload, payload_size));
+
+    // Confirmed per the profile's mode; while a message is outstanding every
+    // uplink of the profile is confirmed (and counts as its retransmission)
+    ConfirmMode confirm_mode = profiles[active_profile_index].confirm;
+    bool alarm_frame = change_reporter.getPending(active_profile_index) == REPORT_THRESHOLD ||
+                       ChangeReporter::inAlarm(sample);
+    bool confirmed = delivery.isPending(active_profile_index) || confirm_mode == CONFIRM_ALL ||
+                     (confirm_mode == CONFIRM_ALARMS && alarm_frame);
+    if (confirmed) {
+        LOG_I(LOG_LORAWAN, "Confirmed uplink (transmission %d of up to %d)",
+            delivery.getTransmissions(active_profile_index) + 1, LORAWAN_CONFIRM_MAX_RETRIES + 1);
     }
-    Serial.println();
 
-    // Send unconfirmed uplink on port 1
     uint8_t downlinkPayload[256];
     size_t downlinkSize = 0;
+    LoRaWANEvent_t eventUp;
+    LoRaWANEvent_t eventDown;
+
+    // Piggyback a LinkCheckReq every few uplinks to learn the gateway-side margin
+    bool link_check = (link_history.getCount(active_profile_index) % LORAWAN_LINK_CHECK_EVERY) == 0;
+    if (link_check) {
+        node->sendMacCommandReq(RADIOLIB_LORAWAN_MAC_LINK_CHECK);
+    }
+
+    int state = node->sendReceive(payload, payload_size, fport, downlinkPayload, &downlinkSize,
+                                  confirmed, &eventUp, &eventDown);
 
-    int state = node->sendReceive(payload, payload_size, 1, downlinkPayload, &downlinkSize);
+    FrameRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.profile = active_profile_index;
+    rec.direction = FRAME_UPLINK;
+    rec.result = state;
+    rec.fport = fport;
+    rec.flags = confirmed ? FRAME_FLAG_CONFIRMED : 0;
 
     // RadioLib sendReceive() return values:
     // < 0: Error occurred
@@ -451,267 +1004,117 @@ bool LoRaWANHandler::sendUplink(const InputRegisters& input) {
     // 1: Success, downlink in RX1 window
     // 2: Success, downlink in RX2 window
     if (state >= RADIOLIB_ERR_NONE) {
-        Serial.println("Uplink successful!");
+        LOG_I(LOG_LORAWAN, "Uplink successful!");
         uplink_count++;
 
-        // Get RSSI and SNR from last transmission
-        last_rssi = radio->getRSSI();
-        last_snr = radio->getSNR();
+        // Charge the frame to the airtime ledger using the channel and data rate actually used
+        profile_datarate[active_profile_index] = eventUp.datarate;
+        uint32_t toa = node->getLastToA();
+        if (toa == 0) {
+            toa = AirtimeLedger::uplinkTimeOnAirMs(profiles[active_profile_index].region, eventUp.datarate, payload_size);
+        }
+        airtime.record(millis(), active_profile_index, profiles[active_profile_index].region, (uint32_t)(eventUp.freq * 1000.0f), toa);
+        LOG_I(LOG_LORAWAN, "Airtime: %lu ms on %.1f MHz (DR%d)", (unsigned long)toa, eventUp.freq, eventUp.datarate);
+
+        // Energy estimate: TX plus the receive windows opened (RX2 only without a downlink in RX1)
+        powerManager.noteRadio(toa, (state == 1 ? 1 : 2) * POWER_RX_WINDOW_MS);
+
+        // The ACK bit comes with a downlink in RX1/RX2 (possibly without payload)
+        bool acked = confirmed && state > 0 && eventDown.confirming;
+        if (acked) rec.flags |= FRAME_FLAG_ACKED;
+
+        // Recorded before the downlink it may have triggered
+        rec.fcnt = eventUp.fCnt;
+        rec.datarate = eventUp.datarate;
+        rec.toa_ms = toa > 0xFFFF ? 0xFFFF : toa;
+        recordFrame(rec, payload, payload_size);
+
+        // Link quality: RSSI/SNR are only meaningful when a downlink was received
+        LinkSample link;
+        memset(&link, 0, sizeof(link));
+        link.time = millis();
+        link.datarate = eventUp.datarate;
+        link.power = eventUp.power;
+        link.margin = LINK_MARGIN_NONE;
+        link.has_downlink = (state > 0);
+        if (link.has_downlink) {
+            last_rssi = radio->getRSSI();
+            last_snr = radio->getSNR();
+            link.rssi = last_rssi;
+            link.snr = (int8_t)roundf(last_snr);
+
+            LOG_I(LOG_LORAWAN, "RSSI: %d dBm, SNR: %.2f dB", last_rssi, last_snr);
+        }
+        if (link_check && node->getMacLinkCheckAns(&link.margin, &link.gateways) == RADIOLIB_ERR_NONE) {
+            LOG_I(LOG_LORAWAN, "LinkCheckAns: margin %u dB, %u gateway(s)", link.margin, link.gateways);
+        } else {
+            link.margin = LINK_MARGIN_NONE;
+        }
+        link_history.record(active_profile_index, link);
+        applyAdrBackoff();
 
-        Serial.print("RSSI: ");
-        Serial.print(last_rssi);
-        Serial.print(" dBm, SNR: ");
-        Serial.print(last_snr);
-        Serial.println(" dB");
+        // Command results went out with this uplink
+        pending_ack_len[active_profile_index] = 0;
 
         // Check if downlink was received
         if (state > 0) {
-            Serial.print("Downlink received in RX");
-            Serial.print(state);
-            Serial.println(" window");
+            LOG_I(LOG_LORAWAN, "Downlink received in RX%d window", state);
             downlink_count++;
 
-            // Check if downlink has data
-            if (downlinkSize > 0) {
-                Serial.print("Downlink payload (");
-                Serial.print(downlinkSize);
-                Serial.print(" bytes): ");
-                for (size_t i = 0; i < downlinkSize; i++) {
-                    if (downlinkPayload[i] < 0x10) Serial.print("0");
-                    Serial.print(downlinkPayload[i], HEX);
-                    Serial.print(" ");
-                }
-                Serial.println();
-            } else {
-                Serial.println("Downlink ACK received (no payload)");
+            handleDownlink(downlinkPayload, downlinkSize, eventDown, false);
+        }
+
+        if (confirmed) {
+            trackDelivery(acked);
+        }
+
+        // Reference for the next deadband/threshold check
+        change_reporter.reported(active_profile_index, sample, ctx.now);
+        bootTimeline.mark(BOOT_FIRST_UPLINK, millis());
+
+        // Batched samples are delivered - the next frame starts after them
+        // (unacknowledged confirmed frames keep them for the retransmission)
+        if (ctx.batch_used && !delivery.isPending(active_profile_index)) {
+            uint32_t lost = batcher.markSent(active_profile_index, ctx.batch_first, ctx.batch_seq);
+            if (lost > 0) {
+                LOG_W(LOG_LORAWAN, "Batched payload: %u unsent samples dropped (frame full or ring overwritten), profile %d",
+                      (unsigned)lost, active_profile_index);
             }
         }
 
         // Save nonces after uplink to persist DevNonce
         saveSession();
+        powerManager.noteUplink();
 
-        Serial.println("========================================");
+        LOG_I(LOG_LORAWAN, "========================================");
         return true;
     } else {
-        Serial.print("Uplink failed, code ");
-        Serial.println(state);
-        Serial.println("========================================");
+        rec.fcnt = node->getFCntUp();
+        rec.datarate = profile_datarate[active_profile_index];
+        recordFrame(rec, payload, payload_size);
+
+        LOG_E(LOG_LORAWAN, "Uplink failed, code %d", state);
+        LOG_I(LOG_LORAWAN, "========================================");
         return false;
     }
 }
 
-// ============================================================================
-// PAYLOAD BUILDERS
-// ============================================================================
-
-size_t LoRaWANHandler::buildAdeunisModbusSF6Payload(uint8_t* payload, const InputRegisters& input) {
-    // AdeunisModbusSf6 format (10 bytes)
-    // Bytes 0-1: Header (uplink counter for tracking, decoder ignores these)
-    // Bytes 2-3: SF6 Density (kg/m³ × 100, big-endian)
-    // Bytes 4-5: SF6 Pressure @20C (bar × 1000, big-endian)
-    // Bytes 6-7: SF6 Temperature (Kelvin × 10, big-endian)
-    // Bytes 8-9: SF6 Pressure Variance (bar × 1000, big-endian)
-    
-    // Header (bytes 0-1) - Uplink counter for tracking
-    payload[0] = (uplink_count >> 8) & 0xFF;
-    payload[1] = uplink_count & 0xFF;
-
-    // SF6 Density (2 bytes, big-endian)
-    payload[2] = (input.sf6_density >> 8) & 0xFF;
-    payload[3] = input.sf6_density & 0xFF;
-
-    // SF6 Pressure @20C (2 bytes, big-endian)
-    payload[4] = (input.sf6_pressure_20c >> 8) & 0xFF;
-    payload[5] = input.sf6_pressure_20c & 0xFF;
-
-    // SF6 Temperature (2 bytes, big-endian)
-    payload[6] = (input.sf6_temperature >> 8) & 0xFF;
-    payload[7] = input.sf6_temperature & 0xFF;
-
-    // SF6 Pressure Variance (2 bytes, big-endian)
-    payload[8] = (input.sf6_pressure_var >> 8) & 0xFF;
-    payload[9] = input.sf6_pressure_var & 0xFF;
-
-    Serial.println("Payload breakdown (Adeunis Modbus SF6):");
-    Serial.printf("  Header (uplink #%u) - bytes 0-1 skipped by decoder\n",
-        (payload[0] << 8) | payload[1]);
-    Serial.printf("  SF6 Density: %u (%.2f kg/m³)\n",
-        (payload[2] << 8) | payload[3],
-        ((payload[2] << 8) | payload[3]) / 100.0);
-    Serial.printf("  SF6 Pressure @20C: %u (%.3f bar)\n",
-        (payload[4] << 8) | payload[5],
-        ((payload[4] << 8) | payload[5]) / 1000.0);
-    Serial.printf("  SF6 Temperature: %u (%.1f °C)\n",
-        (payload[6] << 8) | payload[7],
-        (((payload[6] << 8) | payload[7]) / 10.0) - 273.15);
-    Serial.printf("  SF6 Pressure Var: %u (%.3f bar)\n",
-        (payload[8] << 8) | payload[9],
-        ((payload[8] << 8) | payload[9]) / 1000.0);
-
-    return 10;
-}
-
-size_t LoRaWANHandler::buildCayenneLPPPayload(uint8_t* payload, const InputRegisters& input) {
-    // Cayenne LPP format (variable length)
-    // Each data point: Channel (1) + Type (1) + Data (n bytes)
-    size_t index = 0;
-
-    // Channel 1: Temperature (Type 0x67, 2 bytes, 0.1°C signed)
-    float temp_celsius = (input.sf6_temperature / 10.0) - 273.15;
-    int16_t temp_encoded = (int16_t)(temp_celsius * 10);
-    payload[index++] = 1;  // Channel
-    payload[index++] = 0x67;  // Temperature type
-    payload[index++] = (temp_encoded >> 8) & 0xFF;
-    payload[index++] = temp_encoded & 0xFF;
-
-    // Channel 2: Analog Input for Pressure (Type 0x02, 2 bytes, 0.01 signed)
-    float pressure_bar = input.sf6_pressure_20c / 1000.0;
-    int16_t pressure_encoded = (int16_t)(pressure_bar * 100);
-    payload[index++] = 2;  // Channel
-    payload[index++] = 0x02;  // Analog Input type
-    payload[index++] = (pressure_encoded >> 8) & 0xFF;
-    payload[index++] = pressure_encoded & 0xFF;
-
-    // Channel 3: Analog Input for Density (Type 0x02, 2 bytes, 0.01 signed)
-    float density_kgm3 = input.sf6_density / 100.0;
-    int16_t density_encoded = (int16_t)(density_kgm3 * 100);
-    payload[index++] = 3;  // Channel
-    payload[index++] = 0x02;  // Analog Input type
-    payload[index++] = (density_encoded >> 8) & 0xFF;
-    payload[index++] = density_encoded & 0xFF;
-
-    Serial.println("Payload breakdown (Cayenne LPP):");
-    Serial.printf("  Ch1 Temperature: %.1f °C\n", temp_celsius);
-    Serial.printf("  Ch2 Pressure: %.3f bar\n", pressure_bar);
-    Serial.printf("  Ch3 Density: %.2f kg/m³\n", density_kgm3);
-
-    return index;
-}
-
-size_t LoRaWANHandler::buildRawModbusPayload(uint8_t* payload, const InputRegisters& input) {
-    // Raw Modbus registers format (10 bytes)
-    // Send the raw uint16_t values as-is (big-endian)
-    size_t index = 0;
-
-    // Uplink counter (2 bytes)
-    payload[index++] = (uplink_count >> 8) & 0xFF;
-    payload[index++] = uplink_count & 0xFF;
-
-    // SF6 Density (2 bytes)
-    payload[index++] = (input.sf6_density >> 8) & 0xFF;
-    payload[index++] = input.sf6_density & 0xFF;
-
-    // SF6 Pressure @20C (2 bytes)
-    payload[index++] = (input.sf6_pressure_20c >> 8) & 0xFF;
-    payload[index++] = input.sf6_pressure_20c & 0xFF;
-
-    // SF6 Temperature (2 bytes)
-    payload[index++] = (input.sf6_temperature >> 8) & 0xFF;
-    payload[index++] = input.sf6_temperature & 0xFF;
-
-    // SF6 Pressure Variance (2 bytes)
-    payload[index++] = (input.sf6_pressure_var >> 8) & 0xFF;
-    payload[index++] = input.sf6_pressure_var & 0xFF;
-
-    Serial.println("Payload breakdown (Raw Modbus Registers):");
-    Serial.printf("  Uplink Count: %u\n", uplink_count);
-    Serial.printf("  SF6 Density (raw): %u\n", input.sf6_density);
-    Serial.printf("  SF6 Pressure @20C (raw): %u\n", input.sf6_pressure_20c);
-    Serial.printf("  SF6 Temperature (raw): %u\n", input.sf6_temperature);
-    Serial.printf("  SF6 Pressure Var (raw): %u\n", input.sf6_pressure_var);
-
-    return index;
-}
-
-size_t LoRaWANHandler::buildCustomPayload(uint8_t* payload, const InputRegisters& input) {
-    // Custom format - simple example (can be customized)
-    // 1 byte: payload type identifier
-    // 4 bytes: temperature (float, LSB)
-    // 4 bytes: pressure (float, LSB)
-    // 4 bytes: density (float, LSB)
-    size_t index = 0;
-
-    payload[index++] = 0xFF;  // Custom format identifier
-
-    // Convert temperature to Celsius as float
-    float temp_celsius = (input.sf6_temperature / 10.0) - 273.15;
-    memcpy(&payload[index], &temp_celsius, 4);
-    index += 4;
-
-    // Convert pressure to bar as float
-    float pressure_bar = input.sf6_pressure_20c / 1000.0;
-    memcpy(&payload[index], &pressure_bar, 4);
-    index += 4;
-
-    // Convert density to kg/m³ as float
-    float density_kgm3 = input.sf6_density / 100.0;
-    memcpy(&payload[index], &density_kgm3, 4);
-    index += 4;
-
-    Serial.println("Payload breakdown (Custom Format):");
-    Serial.printf("  Temperature: %.2f °C\n", temp_celsius);
-    Serial.printf("  Pressure: %.3f bar\n", pressure_bar);
-    Serial.printf("  Density: %.2f kg/m³\n", density_kgm3);
-
-    return index;
-}
-
-size_t LoRaWANHandler::buildVistronLoraModConPayload(uint8_t* payload, const InputRegisters& input) {
-    // Vistron LoRa Mod Con format (16 bytes total)
-    // Frame Type 3: Periodic Modbus data uplink
-    // Bytes 0-7: Vistron frame header
-    // Bytes 8-15: Modbus sensor data (same as Trafag H72517o format)
-    size_t index = 0;
-
-    // Header for Frame Type 3 (Periodic Modbus uplink)
-    payload[index++] = 0x03;  // Frame type: 3 = Periodic Modbus data
-    payload[index++] = 0x00;  // Reserved/status byte
-    payload[index++] = 0x00;  // Error code: 0 = No error
-    
-    // Additional header bytes (can be uplink counter, device status, etc.)
-    payload[index++] = (uplink_count >> 8) & 0xFF;  // Uplink counter high byte
-    payload[index++] = uplink_count & 0xFF;         // Uplink counter low byte
-    payload[index++] = 0x00;  // Reserved
-    payload[index++] = 0x00;  // Reserved
-    payload[index++] = 0x08;  // Modbus data length (8 bytes)
-
-    // Modbus sensor data (8 bytes) - Trafag H72517o SF6 format
-    // Bytes 8-9: Density (kg/m³ × 100, big-endian)
-    payload[index++] = (input.sf6_density >> 8) & 0xFF;
-    payload[index++] = input.sf6_density & 0xFF;
-
-    // Bytes 10-11: Absolute Pressure at 20°C (bar × 1000, big-endian)
-    payload[index++] = (input.sf6_pressure_20c >> 8) & 0xFF;
-    payload[index++] = input.sf6_pressure_20c & 0xFF;
-
-    // Bytes 12-13: Temperature (Kelvin × 10, big-endian)
-    payload[index++] = (input.sf6_temperature >> 8) & 0xFF;
-    payload[index++] = input.sf6_temperature & 0xFF;
-
-    // Bytes 14-15: Absolute Pressure current (bar × 1000, big-endian)
-    // Using pressure_var as current pressure since we don't have a separate field
-    payload[index++] = (input.sf6_pressure_var >> 8) & 0xFF;
-    payload[index++] = input.sf6_pressure_var & 0xFF;
-
-    Serial.println("Payload breakdown (Vistron Lora Mod Con):");
-    Serial.printf("  Frame Type: 3 (Periodic Modbus uplink)\n");
-    Serial.printf("  Error Code: 0 (No errors)\n");
-    Serial.printf("  Uplink Count: %u\n", uplink_count);
-    Serial.println("  Modbus Data (Trafag H72517o format):");
-    Serial.printf("    Density: %u (%.2f kg/m³)\n",
-        (payload[8] << 8) | payload[9],
-        ((payload[8] << 8) | payload[9]) / 100.0);
-    Serial.printf("    Pressure @20°C: %u (%.3f bar)\n",
-        (payload[10] << 8) | payload[11],
-        ((payload[10] << 8) | payload[11]) / 1000.0);
-    Serial.printf("    Temperature: %u (%.1f °C)\n",
-        (payload[12] << 8) | payload[13],
-        (((payload[12] << 8) | payload[13]) / 10.0) - 273.15);
-    Serial.printf("    Absolute Pressure: %u (%.3f bar)\n",
-        (payload[14] << 8) | payload[15],
-        ((payload[14] << 8) | payload[15]) / 1000.0);
-
-    return index;
+void LoRaWANHandler::trackDelivery(bool acked) {
+    uint8_t index = active_profile_index;
+    unsigned long now = millis();
+    delivery.sent(index, now);
+    uint8_t transmissions = delivery.getTransmissions(index);
+
+    if (acked) {
+        delivery.acknowledged(index, now);
+        LOG_I(LOG_LORAWAN, "ACK received after %lu ms (transmission %d)",
+            (unsigned long)delivery.getStats(index).last_ack_ms, transmissions);
+    } else if (delivery.unacknowledged(index, now, esp_random())) {
+        LOG_W(LOG_LORAWAN, "No ACK - retransmission %d/%d in %lu s", transmissions, LORAWAN_CONFIRM_MAX_RETRIES,
+            (delivery.getRetryAt(index) - now) / 1000);
+    } else {
+        LOG_E(LOG_LORAWAN, "No ACK after %d transmissions - confirmed frame lost", transmissions);
+    }
 }
 
 // ============================================================================
@@ -873,7 +1276,7 @@ void LoRaWANHandler::printCredentials() {
 void LoRaWANHandler::loadProfiles() {
     Serial.println(">>> Loading LoRaWAN profiles from NVS...");
     
-    if (!preferences.begin("lorawan_prof", false)) {  // Read-write (creates if not exists)
+    if (!profileStore.open(preferences, "lorawan_prof")) {  // Read-write (creates if not exists)
         Serial.println(">>> Failed to open lorawan_prof namespace");
         initializeDefaultProfiles();
         return;
@@ -882,6 +1285,15 @@ void LoRaWANHandler::loadProfiles() {
     bool has_profiles = preferences.getBool("has_profiles", false);
     active_profile_index = preferences.getUChar("active_idx", 0);
     auto_rotation_enabled = preferences.getBool("auto_rotate", false);
+
+    // Uplink intervals (set remotely, default LORAWAN_UPLINK_INTERVAL_MS or the
+    // report-on-change heartbeat)
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "intv%d", i);
+        uplink_interval_s[i] = preferences.getUShort(key, defaultIntervalS());
+        scheduler.setPeriod(i, (unsigned long)uplink_interval_s[i] * 1000UL);
+    }
     
     if (!has_profiles) {
         Serial.println(">>> No profiles found - initializing defaults");
@@ -890,40 +1302,84 @@ void LoRaWANHandler::loadProfiles() {
         return;
     }
     
-    // Load each profile
+    // Load each profile (compact "prf<N>" record; raw "prof<N>" struct from older firmware)
+    bool rewrite[MAX_LORA_PROFILES] = {};
+    int loaded = 0;
+    int generated = 0;
     for (int i = 0; i < MAX_LORA_PROFILES; i++) {
-        char key[20];
-        snprintf(key, sizeof(key), "prof%d", i);
-        
-        size_t len = preferences.getBytes(key, &profiles[i], sizeof(LoRaProfile));
-        if (len == sizeof(LoRaProfile)) {
-            // Validate payload_type (ensure it's within valid range)
-            if (profiles[i].payload_type > PAYLOAD_VISTRON_LORA_MOD_CON) {
-                Serial.printf("    Warning: Invalid payload_type for Profile %d, resetting to default\n", i);
+        char key[16];
+        snprintf(key, sizeof(key), "prf%d", i);
+        char legacy_key[16];
+        snprintf(legacy_key, sizeof(legacy_key), "prof%d", i);
+
+        if (preferences.isKey(key)) {
+            uint8_t record[PROFILE_RECORD_MAX_SIZE];
+            size_t len = preferences.getBytes(key, record, sizeof(record));
+            if (!ProfileStore::decode(record, len, profiles[i])) {
+                Serial.printf("    Warning: Profile %d record invalid (%d bytes) - regenerating\n", i, len);
+                generateProfile(i, (String("Profile ") + String(i)).c_str());
+                profiles[i].enabled = false;
+                rewrite[i] = true;
+                generated++;
+                continue;
+            }
+        } else if (preferences.isKey(legacy_key)) {
+            memset(&profiles[i], 0, sizeof(LoRaProfile));
+            size_t len = preferences.getBytes(legacy_key, &profiles[i], LEGACY_PROFILE_SIZE);
+            if (len < LEGACY_PROFILE_SIZE) {
+                // Partial load - likely from older firmware version without payload_type field
+                Serial.printf("    Warning: Profile %d size mismatch (got %d bytes, expected %d) - setting default payload type\n",
+                    i, len, LEGACY_PROFILE_SIZE);
                 profiles[i].payload_type = PAYLOAD_ADEUNIS_MODBUS_SF6;
             }
-            Serial.printf("    Loaded Profile %d: %s (%s, %s)\n", 
-                i, profiles[i].name, 
-                profiles[i].enabled ? "enabled" : "disabled",
-                PAYLOAD_TYPE_NAMES[profiles[i].payload_type]);
-        } else if (len > 0 && len < sizeof(LoRaProfile)) {
-            // Partial load - likely from older firmware version without payload_type field
-            Serial.printf("    Warning: Profile %d size mismatch (got %d bytes, expected %d) - setting default payload type\n", 
-                i, len, sizeof(LoRaProfile));
-            profiles[i].payload_type = PAYLOAD_ADEUNIS_MODBUS_SF6;
+            profiles[i].name[sizeof(profiles[i].name) - 1] = '\0';
+            rewrite[i] = true;  // Convert to a compact record
         } else {
-            Serial.printf("    Warning: Profile %d load failed (got %d bytes)\n", i, len);
+            // Profile table grew since the profiles were created
+            generateProfile(i, (String("Profile ") + String(i)).c_str());
+            profiles[i].enabled = false;
+            rewrite[i] = true;
+            generated++;
+            continue;
+        }
+
+        // Validate payload_type (ensure it's within valid range)
+        if (profiles[i].payload_type >= PAYLOAD_TYPE_COUNT) {
+            Serial.printf("    Warning: Invalid payload_type for Profile %d, resetting to default\n", i);
+            profiles[i].payload_type = PAYLOAD_ADEUNIS_MODBUS_SF6;
+        }
+        loaded++;
+        if (profiles[i].enabled) {
+            Serial.printf("    Loaded Profile %d: %s (enabled, %s)\n",
+                i, profiles[i].name, PAYLOAD_TYPE_NAMES[profiles[i].payload_type]);
         }
     }
-    
+
+    // Write compact records for converted/generated profiles and drop the raw ones
+    int converted = 0;
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        if (!rewrite[i]) continue;
+        writeProfileRecord(i);
+        char legacy_key[16];
+        snprintf(legacy_key, sizeof(legacy_key), "prof%d", i);
+        if (preferences.isKey(legacy_key)) {
+            preferences.remove(legacy_key);
+            converted++;
+        }
+    }
+
     preferences.end();
+    eui_index.rebuild(profiles, MAX_LORA_PROFILES);
+
+    Serial.printf(">>> %d profile(s) loaded, %d generated, %d converted to compact records, %d enabled\n",
+        loaded, generated, converted, getEnabledProfileCount());
     Serial.printf(">>> Active profile index: %d\n", active_profile_index);
 }
 
 void LoRaWANHandler::saveProfiles() {
     Serial.println(">>> Saving LoRaWAN profiles to NVS...");
     
-    if (!preferences.begin("lorawan_prof", false)) {
+    if (!profileStore.open(preferences, "lorawan_prof")) {
         Serial.println(">>> Failed to open lorawan_prof namespace for writing");
         return;
     }
@@ -934,16 +1390,35 @@ void LoRaWANHandler::saveProfiles() {
     
     // Save each profile
     for (int i = 0; i < MAX_LORA_PROFILES; i++) {
-        char key[20];
-        snprintf(key, sizeof(key), "prof%d", i);
-        
-        size_t written = preferences.putBytes(key, &profiles[i], sizeof(LoRaProfile));
-        Serial.printf("    Saved Profile %d: %s (%d bytes)\n", 
-            i, profiles[i].name, written);
+        writeProfileRecord(i);
     }
     
     preferences.end();
-    Serial.println(">>> Profiles saved to NVS");
+    Serial.printf(">>> %d profiles saved to NVS\n", MAX_LORA_PROFILES);
+}
+
+void LoRaWANHandler::saveProfile(uint8_t index) {
+    if (index >= MAX_LORA_PROFILES) {
+        return;
+    }
+
+    if (!profileStore.open(preferences, "lorawan_prof")) {
+        Serial.println(">>> Failed to open lorawan_prof namespace for writing");
+        return;
+    }
+
+    size_t written = writeProfileRecord(index);
+    preferences.end();
+    Serial.printf(">>> Saved Profile %d: %s (%d bytes)\n", index, profiles[index].name, written);
+}
+
+size_t LoRaWANHandler::writeProfileRecord(uint8_t index) {
+    uint8_t record[PROFILE_RECORD_MAX_SIZE];
+    size_t len = ProfileStore::encode(profiles[index], record);
+
+    char key[16];
+    snprintf(key, sizeof(key), "prf%d", index);
+    return preferences.putBytes(key, record, len);
 }
 
 void LoRaWANHandler::initializeDefaultProfiles() {
@@ -960,6 +1435,7 @@ void LoRaWANHandler::initializeDefaultProfiles() {
     }
     
     active_profile_index = 0;
+    eui_index.rebuild(profiles, MAX_LORA_PROFILES);
     
     // Save to NVS
     saveProfiles();
@@ -1006,6 +1482,14 @@ void LoRaWANHandler::generateProfile(uint8_t index, const char* name) {
     
     // Set default payload type
     prof->payload_type = PAYLOAD_ADEUNIS_MODBUS_SF6;
+
+    // OTAA by default; ABP session keys are entered on the profile page
+    prof->abp = false;
+    prof->region = LORAWAN_DEFAULT_REGION;
+    prof->confirm = LORAWAN_DEFAULT_CONFIRM;
+    prof->devAddr = 0;
+    memset(prof->nwkSKey, 0, 16);
+    memset(prof->appSKey, 0, 16);
     
     Serial.printf("    Generated Profile %d: %s\n", index, prof->name);
     Serial.printf("      DevEUI: 0x%016llX\n", prof->devEUI);
@@ -1015,16 +1499,16 @@ void LoRaWANHandler::generateProfile(uint8_t index, const char* name) {
 
 bool LoRaWANHandler::setActiveProfile(uint8_t index) {
     if (index >= MAX_LORA_PROFILES) {
-        Serial.printf(">>> Error: Invalid profile index %d\n", index);
+        LOG_E(LOG_LORAWAN, "Invalid profile index %d", index);
         return false;
     }
     
     if (!profiles[index].enabled) {
-        Serial.printf(">>> Error: Profile %d is disabled\n", index);
+        LOG_E(LOG_LORAWAN, "Profile %d is disabled", index);
         return false;
     }
     
-    Serial.printf(">>> Setting active profile to %d: %s\n", index, profiles[index].name);
+    LOG_I(LOG_LORAWAN, "Setting active profile to %d: %s", index, profiles[index].name);
     
     active_profile_index = index;
     
@@ -1035,12 +1519,12 @@ bool LoRaWANHandler::setActiveProfile(uint8_t index) {
     memcpy(nwkKey, profiles[index].nwkKey, 16);
     
     // Save active index to NVS
-    if (preferences.begin("lorawan_prof", false)) {
+    if (profileStore.open(preferences, "lorawan_prof")) {
         preferences.putUChar("active_idx", active_profile_index);
         preferences.end();
     }
     
-    Serial.println(">>> Active profile updated");
+    LOG_D(LOG_LORAWAN, "Active profile updated");
     return true;
 }
 
@@ -1061,10 +1545,39 @@ bool LoRaWANHandler::updateProfile(uint8_t index, const LoRaProfile& profile) {
         return false;
     }
     
+    // Two virtual devices with one DevEUI would confuse the network server
+    int other = eui_index.find(profile.devEUI, profiles, index);
+    if (other >= 0) {
+        Serial.printf(">>> Error: DevEUI 0x%016llX already used by profile %d\n", profile.devEUI, other);
+        return false;
+    }
+
     Serial.printf(">>> Updating profile %d\n", index);
     
+    // A cached session belongs to the old credentials - drop it so the next activation re-joins
+    if (profiles[index].devEUI != profile.devEUI ||
+        profiles[index].joinEUI != profile.joinEUI ||
+        memcmp(profiles[index].appKey, profile.appKey, 16) != 0 ||
+        memcmp(profiles[index].nwkKey, profile.nwkKey, 16) != 0 ||
+        profiles[index].abp != profile.abp ||
+        profiles[index].region != profile.region ||
+        profiles[index].devAddr != profile.devAddr ||
+        memcmp(profiles[index].nwkSKey, profile.nwkSKey, 16) != 0 ||
+        memcmp(profiles[index].appSKey, profile.appSKey, 16) != 0) {
+        clearSession(index);
+        join_backoff.reset(index);
+        delivery.cancel(index);
+    }
+    if (profile.confirm == CONFIRM_NONE) {
+        delivery.cancel(index);
+    }
+    
     // Copy profile data
+    bool eui_changed = profiles[index].devEUI != profile.devEUI;
     memcpy(&profiles[index], &profile, sizeof(LoRaProfile));
+    if (eui_changed) {
+        eui_index.rebuild(profiles, MAX_LORA_PROFILES);
+    }
     
     // If this is the active profile, update legacy credentials
     if (index == active_profile_index) {
@@ -1075,7 +1588,7 @@ bool LoRaWANHandler::updateProfile(uint8_t index, const LoRaProfile& profile) {
     }
     
     // Save to NVS
-    saveProfiles();
+    saveProfile(index);
     
     Serial.println(">>> Profile updated");
     return true;
@@ -1098,11 +1611,76 @@ bool LoRaWANHandler::toggleProfileEnabled(uint8_t index) {
         profiles[index].enabled ? "enabled" : "disabled");
     
     // Save to NVS
-    saveProfiles();
+    saveProfile(index);
     
     return true;
 }
 
+// ============================================================================
+// REMOTE CONFIGURATION (DOWNLINK COMMANDS)
+// ============================================================================
+
+bool LoRaWANHandler::setUplinkInterval(uint8_t index, uint16_t seconds) {
+    if (index >= MAX_LORA_PROFILES || seconds < CMD_MIN_INTERVAL_S) {
+        return false;
+    }
+
+    uplink_interval_s[index] = seconds;
+    scheduler.setPeriod(index, (unsigned long)seconds * 1000UL);
+    Serial.printf(">>> Profile %d uplink interval set to %u s\n", index, seconds);
+
+    if (profileStore.open(preferences, "lorawan_prof")) {
+        char key[16];
+        snprintf(key, sizeof(key), "intv%d", index);
+        preferences.putUShort(key, seconds);
+        preferences.end();
+    }
+    return true;
+}
+
+uint16_t LoRaWANHandler::getUplinkInterval(uint8_t index) const {
+    if (index >= MAX_LORA_PROFILES) return defaultIntervalS();
+    return uplink_interval_s[index];
+}
+
+bool LoRaWANHandler::setPayloadType(uint8_t index, PayloadType type) {
+    if (index >= MAX_LORA_PROFILES || type >= PAYLOAD_TYPE_COUNT) {
+        return false;
+    }
+    if (profiles[index].payload_type == type) {
+        return true;
+    }
+
+    profiles[index].payload_type = type;
+    Serial.printf(">>> Profile %d payload format set to %s\n", index, PAYLOAD_TYPE_NAMES[type]);
+    saveProfile(index);
+    return true;
+}
+
+bool LoRaWANHandler::setProfileEnabled(uint8_t index, bool enabled) {
+    if (index >= MAX_LORA_PROFILES) {
+        return false;
+    }
+    if (profiles[index].enabled == enabled) {
+        return true;
+    }
+    return toggleProfileEnabled(index);
+}
+
+bool LoRaWANHandler::requestUplink(uint8_t index) {
+    // Only profiles that are on the schedule can be expedited
+    if (index >= MAX_LORA_PROFILES || !scheduler.isScheduled(index)) {
+        return false;
+    }
+    pending_expedite[index] = true;
+    Serial.printf(">>> Profile %d: immediate uplink requested\n", index);
+    return true;
+}
+
+bool LoRaWANHandler::hasPendingAck(uint8_t index) const {
+    return index < MAX_LORA_PROFILES && pending_ack_len[index] > 0;
+}
+
 void LoRaWANHandler::printProfile(uint8_t index) {
     if (index >= MAX_LORA_PROFILES) {
         Serial.printf(">>> Error: Invalid profile index %d\n", index);
@@ -1132,6 +1710,61 @@ void LoRaWANHandler::printProfile(uint8_t index) {
     Serial.println("========================================\n");
 }
 
+// ============================================================================
+// USER PAYLOAD MAPPING
+// ============================================================================
+
+void LoRaWANHandler::loadPayloadMap() {
+    if (!map_lock) {
+        map_lock = xSemaphoreCreateMutex();
+    }
+
+    static char spec[PAYLOAD_MAP_SPEC_MAX];
+    spec[0] = '\0';
+    if (profileStore.open(preferences, "lorawan_prof", true)) {
+        preferences.getString("paymap", spec, sizeof(spec));
+        preferences.end();
+    }
+
+    char error[80];
+    if (spec[0] != '\0' && payload_map.compile(spec, error, sizeof(error))) {
+        Serial.printf(">>> User payload mapping: %u field(s), %u bytes\n",
+            payload_map.getFieldCount(), (unsigned)payload_map.getSize());
+        return;
+    }
+    if (spec[0] != '\0') {
+        Serial.printf(">>> Saved payload mapping invalid (%s) - using the default\n", error);
+    }
+    payload_map.compile(PAYLOAD_MAP_DEFAULT_SPEC, error, sizeof(error));
+}
+
+bool LoRaWANHandler::setPayloadMap(const char* spec, char* error, size_t error_len) {
+    // Compiled aside: an uplink only ever sees a complete program
+    PayloadMap* compiled = new PayloadMap();
+    if (!compiled->compile(spec, error, error_len)) {
+        delete compiled;
+        return false;
+    }
+    xSemaphoreTake(map_lock, portMAX_DELAY);
+    payload_map = *compiled;
+    xSemaphoreGive(map_lock);
+    delete compiled;
+
+    if (profileStore.open(preferences, "lorawan_prof")) {
+        preferences.putString("paymap", spec);
+        preferences.end();
+    }
+    Serial.printf(">>> User payload mapping saved: %u field(s), %u bytes\n",
+        payload_map.getFieldCount(), (unsigned)payload_map.getSize());
+    return true;
+}
+
+void LoRaWANHandler::getPayloadMap(PayloadMap& out) {
+    xSemaphoreTake(map_lock, portMAX_DELAY);
+    out = payload_map;
+    xSemaphoreGive(map_lock);
+}
+
 // ============================================================================
 // AUTO-ROTATION (MULTI-PROFILE CYCLING)
 // ============================================================================
@@ -1141,7 +1774,7 @@ void LoRaWANHandler::setAutoRotation(bool enabled) {
     Serial.printf(">>> Auto-rotation %s\n", enabled ? "enabled" : "disabled");
     
     // Save to NVS
-    if (preferences.begin("lorawan_prof", false)) {
+    if (profileStore.open(preferences, "lorawan_prof")) {
         preferences.putBool("auto_rotate", auto_rotation_enabled);
         preferences.end();
     }
@@ -1183,7 +1816,7 @@ bool LoRaWANHandler::rotateToNextProfile() {
     Serial.printf(">>> Rotating from profile %d to profile %d\n", 
         active_profile_index, next_index);
     
-    return setActiveProfile(next_index);
+    return switchToProfile(next_index);
 }
 
 int LoRaWANHandler::getEnabledProfileCount() const {
@@ -1201,151 +1834,233 @@ int LoRaWANHandler::getEnabledProfileCount() const {
 // ============================================================================
 
 void LoRaWANHandler::saveSession() {
-    Serial.println(">>> saveLoRaWANNonces() called");
-
     // Get NONCES buffer from RadioLib (needed to track DevNonce)
     uint8_t* noncesPtr = node->getBufferNonces();
     if (noncesPtr == nullptr) {
-        Serial.println(">>> ERROR: No nonces buffer available");
+        LOG_E(LOG_SESSION, "No nonces buffer available");
         return;
     }
     const size_t noncesSize = RADIOLIB_LORAWAN_NONCES_BUF_SIZE;
-    uint8_t noncesBuffer[RADIOLIB_LORAWAN_NONCES_BUF_SIZE];
-    memcpy(noncesBuffer, noncesPtr, noncesSize);
+    const size_t sessionSize = RADIOLIB_LORAWAN_SESSION_BUF_SIZE;
 
-    if (!preferences.begin("lorawan", false)) {
-        Serial.println(">>> Failed to open preferences");
-        return;
+    // nonceLog.write() refuses larger records, so every session save would fail
+    static_assert(RADIOLIB_LORAWAN_SESSION_BUF_SIZE <= NONCE_LOG_MAX_PAYLOAD,
+                  "RadioLib session buffer does not fit a nonce log record (NONCE_LOG_MAX_PAYLOAD)");
+
+    // Session (DevAddr, session keys, frame counters) so a later switch back
+    // to this profile can restore it instead of sending a new join request
+    uint8_t* sessionPtr = node->isActivated() ? node->getBufferSession() : nullptr;
+    if (sessionPtr != nullptr && session_buffers) {
+        memcpy(session_buffers[active_profile_index], sessionPtr, sessionSize);
+        session_valid[active_profile_index] = true;
     }
 
-    // Save nonces per profile using profile-specific key with retry and verification
-    char noncesKey[16];
-    sprintf(noncesKey, "nonces_%d", active_profile_index);
-    char hasNoncesKey[16];
-    sprintf(hasNoncesKey, "has_nonces_%d", active_profile_index);
-    
-    const int MAX_RETRIES = 3;
-    bool success = false;
-    
-    for (int attempt = 1; attempt <= MAX_RETRIES && !success; attempt++) {
-        if (attempt > 1) {
-            Serial.printf(">>> Retry attempt %d/%d...\n", attempt, MAX_RETRIES);
-            delay(10); // Short delay before retry
+    // Append-only log: one flash write per changed record, unchanged nonces are skipped
+    if (nonceLog.isActive()) {
+        if (!nonceLog.write(active_profile_index, NONCE_LOG_NONCES, noncesPtr, noncesSize)) {
+            LOG_E(LOG_SESSION, "Failed to log nonces for Profile %d - DevNonce may not persist", active_profile_index);
         }
-        
-        // Write nonces to NVS
-        size_t written = preferences.putBytes(noncesKey, noncesBuffer, noncesSize);
-        
-        // Verify write size
-        if (written != noncesSize) {
-            Serial.printf(">>> ERROR: Nonces write failed! Expected %d bytes, wrote %d bytes\n", noncesSize, written);
-            continue; // Try again
+        if (sessionPtr != nullptr && !nonceLog.write(active_profile_index, NONCE_LOG_SESSION, sessionPtr, sessionSize)) {
+            LOG_E(LOG_SESSION, "Failed to log session for Profile %d", active_profile_index);
         }
-        
-        // Read back and verify
-        uint8_t verifyBuffer[RADIOLIB_LORAWAN_NONCES_BUF_SIZE];
-        size_t readBack = preferences.getBytes(noncesKey, verifyBuffer, noncesSize);
-        
-        if (readBack != noncesSize) {
-            Serial.printf(">>> ERROR: Nonces verification read failed! Expected %d bytes, read %d bytes\n", noncesSize, readBack);
-            continue; // Try again
-        }
-        
-        // Compare written and read data
-        if (memcmp(noncesBuffer, verifyBuffer, noncesSize) == 0) {
-            success = true;
-            preferences.putBool(hasNoncesKey, true);
-            Serial.printf(">>> ✓ Nonces verified: %d bytes saved correctly for Profile %d (attempt %d/%d)\n", 
-                noncesSize, active_profile_index, attempt, MAX_RETRIES);
+        return;
+    }
+
+    // No log partition (old partition table): NVS blobs
+    if (!profileStore.open(preferences, "lorawan")) {
+        LOG_E(LOG_SESSION, "Failed to open preferences");
+        return;
+    }
+
+    char key[16];
+    sprintf(key, "nonces_%d", active_profile_index);
+    if (preferences.putBytes(key, noncesPtr, noncesSize) == noncesSize) {
+        sprintf(key, "has_nonces_%d", active_profile_index);
+        preferences.putBool(key, true);
+    } else {
+        LOG_E(LOG_SESSION, "Failed to save nonces for Profile %d - DevNonce may not persist", active_profile_index);
+    }
+
+    if (sessionPtr != nullptr) {
+        sprintf(key, "session_%d", active_profile_index);
+        if (preferences.putBytes(key, sessionPtr, sessionSize) == sessionSize) {
+            sprintf(key, "has_session_%d", active_profile_index);
+            preferences.putBool(key, true);
         } else {
-            Serial.printf(">>> ERROR: Nonces verification failed! Data mismatch on attempt %d/%d\n", attempt, MAX_RETRIES);
+            LOG_E(LOG_SESSION, "Session write failed for Profile %d", active_profile_index);
         }
     }
-    
+
     preferences.end();
-    
-    if (!success) {
-        Serial.printf(">>> CRITICAL: Failed to save nonces after %d attempts! DevNonce may not persist!\n", MAX_RETRIES);
-    }
 }
 
 void LoRaWANHandler::loadSession() {
-    Serial.println(">>> load_lorawan_session() called");
+    Serial.println(">>> Loading per-profile LoRaWAN sessions...");
 
-    if (!preferences.begin("lorawan", false)) {  // Read-write (creates if not exists)
-        Serial.println(">>> ERROR: Cannot open preferences to load session");
+    if (!session_buffers) {
         return;
     }
 
-    // Debug: Check all keys in namespace
-    bool hasCreds = preferences.getBool("has_creds", false);
-    bool hasSession = preferences.getBool("has_session", false);
-    Serial.printf(">>> has_creds flag: %s\n", hasCreds ? "true" : "false");
-    Serial.printf(">>> has_session flag: %s\n", hasSession ? "true" : "false");
+    const size_t sessionSize = RADIOLIB_LORAWAN_SESSION_BUF_SIZE;
 
-    if (!hasSession) {
-        Serial.println(">>> No saved session found in NVS");
-        preferences.end();
+    if (nonceLog.isActive()) {
+        for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+            session_valid[i] = nonceLog.read(i, NONCE_LOG_SESSION, session_buffers[i], sessionSize);
+            if (session_valid[i]) {
+                Serial.printf("    Profile %d: session cached (%d bytes)\n", i, sessionSize);
+            }
+        }
         return;
     }
 
-    // Allocate buffer for session
-    const size_t sessionSize = RADIOLIB_LORAWAN_SESSION_BUF_SIZE;
-    uint8_t sessionBuffer[RADIOLIB_LORAWAN_SESSION_BUF_SIZE];
+    if (!profileStore.open(preferences, "lorawan")) {  // Read-write (creates if not exists)
+        Serial.println(">>> ERROR: Cannot open preferences to load sessions");
+        return;
+    }
+
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        char hasSessionKey[16];
+        sprintf(hasSessionKey, "has_session_%d", i);
+        session_valid[i] = false;
+
+        if (!preferences.getBool(hasSessionKey, false)) {
+            continue;
+        }
+
+        char sessionKey[16];
+        sprintf(sessionKey, "session_%d", i);
+        size_t bytesRead = preferences.getBytes(sessionKey, session_buffers[i], sessionSize);
+
+        if (bytesRead == sessionSize) {
+            session_valid[i] = true;
+            Serial.printf("    Profile %d: session cached (%d bytes)\n", i, bytesRead);
+        } else {
+            Serial.printf("    Profile %d: session read mismatch (expected %d, got %d bytes) - ignoring\n",
+                i, sessionSize, bytesRead);
+        }
+    }
 
-    Serial.printf(">>> Reading %d bytes from NVS...\n", sessionSize);
-    size_t bytesRead = preferences.getBytes("session", sessionBuffer, sessionSize);
     preferences.end();
+}
+
+bool LoRaWANHandler::restoreSession() {
+    if (!session_valid[active_profile_index]) {
+        LOG_D(LOG_SESSION, "No cached session for Profile %d", active_profile_index);
+        return false;
+    }
+
+    // Nonces must already be applied (setBufferNonces) for RadioLib to accept the session
+    if (!session_buffers) return false;
+    int16_t state = node->setBufferSession(session_buffers[active_profile_index]);
+    LOG_D(LOG_SESSION, "setBufferSession() returned: %d", state);
+
+    if (state == RADIOLIB_ERR_NONE) {
+        LOG_I(LOG_SESSION, "Session restored for Profile %d", active_profile_index);
+        return true;
+    }
 
-    Serial.printf(">>> Read %d bytes from NVS\n", bytesRead);
+    LOG_W(LOG_SESSION, "Session restore failed for Profile %d - will re-join", active_profile_index);
+    clearSession(active_profile_index);
+    return false;
+}
 
-    if (bytesRead != sessionSize) {
-        Serial.printf(">>> ERROR: Session read mismatch: expected %d, got %d bytes\n", sessionSize, bytesRead);
+void LoRaWANHandler::clearSession(uint8_t index) {
+    if (index >= MAX_LORA_PROFILES) {
         return;
     }
 
-    Serial.printf(">>> Calling setBufferSession()...\n");
+    session_valid[index] = false;
 
-    // Restore session to RadioLib (only needs buffer pointer)
-    int16_t state = node->setBufferSession(sessionBuffer);
-    Serial.printf(">>> setBufferSession() returned: %d\n", state);
+    // A new session starts with a fresh link: forget history and ADR state
+    link_history.clear(index);
+    profile_datarate[index] = LORAWAN_DEFAULT_DATARATE;
 
-    if (state == RADIOLIB_ERR_NONE) {
-        Serial.println(">>> Session restored successfully!");
-        joined = true;
+    // Drop the live session held by this profile's node context as well
+    LoRaWANNode* ctx = nodeFor(index);
+    if (ctx && ctx->isActivated()) {
+        ctx->clearSession();
+        if (index == active_profile_index) {
+            joined = false;
+        }
+    }
 
-        uint32_t devAddr = node->getDevAddr();
-        Serial.printf(">>> Restored DevAddr: 0x%08X\n", devAddr);
-    } else {
-        Serial.printf(">>> ERROR: Session restore failed, code %d\n", state);
-        // Clear invalid session
-        preferences.begin("lorawan", false);
-        preferences.putBool("has_session", false);
+    if (nonceLog.isActive()) {
+        nonceLog.remove(index, NONCE_LOG_SESSION);
+    } else if (profileStore.open(preferences, "lorawan")) {
+        char hasSessionKey[16];
+        char sessionKey[16];
+        sprintf(hasSessionKey, "has_session_%d", index);
+        sprintf(sessionKey, "session_%d", index);
+
+        if (preferences.isKey(hasSessionKey)) {
+            preferences.remove(hasSessionKey);
+        }
+        if (preferences.isKey(sessionKey)) {
+            preferences.remove(sessionKey);
+        }
         preferences.end();
-        Serial.println(">>> Cleared invalid session from NVS");
     }
+
+    LOG_I(LOG_SESSION, "Cleared cached session for Profile %d", index);
+}
+
+bool LoRaWANHandler::hasSession(uint8_t index) const {
+    if (index >= MAX_LORA_PROFILES) {
+        return false;
+    }
+    return session_valid[index];
 }
 
 void LoRaWANHandler::resetNonces() {
-    Serial.println("\n========================================");
-    Serial.println("Resetting LoRaWAN Nonces");
-    Serial.println("========================================");
+    LOG_I(LOG_LORAWAN, "Resetting LoRaWAN nonces");
     
-    if (!preferences.begin("lorawan", false)) {
-        Serial.println("Error: Failed to open NVS for nonce reset");
+    nonceLog.clear();
+
+    // Pooled node contexts still hold the old DevNonce and frame counters, and
+    // the next saveSession() would write them back: replace them with fresh ones
+    for (int s = 0; s < LORAWAN_NODE_POOL_SIZE; s++) {
+        if (pool_owner[s] != 0xFF) {
+            profile_slot[pool_owner[s]] = -1;
+            pool_owner[s] = 0xFF;
+        }
+        if (node_pool[s]) {
+            delete node_pool[s];
+            node_pool[s] = createNode(pool_region[s]);
+        }
+    }
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        session_valid[i] = false;
+    }
+    if (node) {
+        node = acquireNode(active_profile_index);
+        joined = false;
+    }
+
+    // NVS keys as well: fallback storage, or left over from before the log
+    if (!profileStore.open(preferences, "lorawan")) {
+        LOG_E(LOG_LORAWAN, "Failed to open NVS for nonce reset");
         return;
     }
     
-    // Clear nonces for all profiles
+    // Clear nonces and sessions for all profiles (a session is only valid with its nonces)
+    int withKeys = 0;
     for (int i = 0; i < MAX_LORA_PROFILES; i++) {
         char hasNoncesKey[16];
         char noncesKey[16];
+        char hasSessionKey[16];
+        char sessionKey[16];
         sprintf(hasNoncesKey, "has_nonces_%d", i);
         sprintf(noncesKey, "nonces_%d", i);
+        sprintf(hasSessionKey, "has_session_%d", i);
+        sprintf(sessionKey, "session_%d", i);
         
         // Check if keys exist before trying to remove them to avoid NVS errors
         bool hasNoncesExists = preferences.isKey(hasNoncesKey);
         bool noncesExists = preferences.isKey(noncesKey);
+        bool sessionExists = preferences.isKey(sessionKey);
+        if (hasNoncesExists || noncesExists || sessionExists) {
+            withKeys++;
+        }
         
         if (hasNoncesExists) {
             preferences.remove(hasNoncesKey);
@@ -1353,60 +2068,122 @@ void LoRaWANHandler::resetNonces() {
         if (noncesExists) {
             preferences.remove(noncesKey);
         }
-        
-        Serial.printf("✓ Cleared nonces for Profile %d\n", i);
+        if (preferences.isKey(hasSessionKey)) {
+            preferences.remove(hasSessionKey);
+        }
+        if (sessionExists) {
+            preferences.remove(sessionKey);
+        }
+        session_valid[i] = false;
     }
     
     preferences.end();
-    
-    Serial.println("✓ All nonces reset - DevNonce will start fresh on next join");
-    Serial.println("✓ This resolves nonce misalignment with network server");
-    Serial.println("========================================\n");
+    LOG_I(LOG_LORAWAN, "Cleared nonces and sessions of all %d profiles (%d with NVS keys) - DevNonce will start fresh on next join",
+        MAX_LORA_PROFILES, withKeys);
 }
 
-bool LoRaWANHandler::restoreNonces() {
-    if (!preferences.begin("lorawan", false)) {  // Read-write (creates if not exists)
-        return false;
-    }
+void LoRaWANHandler::migrateNoncesToLog() {
+    // Nonces and sessions saved as NVS blobs move into the log once; keys are
+    // removed only after their record is in the log, so an interrupted
+    // migration continues on the next boot
+    if (!profileStore.open(preferences, "lorawan")) return;
 
-    // Check for profile-specific nonces
-    char hasNoncesKey[16];
-    sprintf(hasNoncesKey, "has_nonces_%d", active_profile_index);
-    bool hasNonces = preferences.getBool(hasNoncesKey, false);
-    Serial.printf(">>> has_nonces flag for Profile %d: %s\n", active_profile_index, hasNonces ? "true" : "false");
+    const size_t noncesSize = RADIOLIB_LORAWAN_NONCES_BUF_SIZE;
+    const size_t sessionSize = RADIOLIB_LORAWAN_SESSION_BUF_SIZE;
+    uint8_t buf[RADIOLIB_LORAWAN_SESSION_BUF_SIZE > RADIOLIB_LORAWAN_NONCES_BUF_SIZE ?
+                RADIOLIB_LORAWAN_SESSION_BUF_SIZE : RADIOLIB_LORAWAN_NONCES_BUF_SIZE];
+    int moved = 0;
+
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        char key[16];
+        char hasKey[16];
+
+        sprintf(key, "nonces_%d", i);
+        sprintf(hasKey, "has_nonces_%d", i);
+        if (preferences.isKey(key)) {
+            bool valid = preferences.getBool(hasKey, false) &&
+                         preferences.getBytes(key, buf, noncesSize) == noncesSize;
+            if (valid && !nonceLog.has(i, NONCE_LOG_NONCES) &&
+                !nonceLog.write(i, NONCE_LOG_NONCES, buf, noncesSize)) {
+                continue;  // Keep the NVS copy, retried on the next boot
+            }
+            preferences.remove(key);
+            if (preferences.isKey(hasKey)) preferences.remove(hasKey);
+            if (valid) moved++;
+        }
+
+        sprintf(key, "session_%d", i);
+        sprintf(hasKey, "has_session_%d", i);
+        if (preferences.isKey(key)) {
+            if (!nonceLog.has(i, NONCE_LOG_SESSION) && preferences.getBool(hasKey, false) &&
+                preferences.getBytes(key, buf, sessionSize) == sessionSize) {
+                nonceLog.write(i, NONCE_LOG_SESSION, buf, sessionSize);
+            }
+            preferences.remove(key);
+            if (preferences.isKey(hasKey)) preferences.remove(hasKey);
+        }
+    }
     preferences.end();
 
+    if (moved > 0) {
+        Serial.printf(">>> Moved nonces of %d profile(s) from NVS to the nonce log\n", moved);
+    }
+}
+
+void LoRaWANHandler::beginActivation() {
+    const LoRaProfile& prof = profiles[active_profile_index];
+    if (prof.abp) {
+        // LoRaWAN 1.0.x ABP: NwkSKey is the network session encryption key, no 1.1 integrity keys
+        node->beginABP(prof.devAddr, nullptr, nullptr, prof.nwkSKey, prof.appSKey);
+    } else {
+        node->beginOTAA(joinEUI, devEUI, nwkKey, appKey);
+    }
+}
+
+bool LoRaWANHandler::restoreNonces() {
+    bool hasNonces = false;
+    if (nonceLog.isActive()) {
+        hasNonces = nonceLog.has(active_profile_index, NONCE_LOG_NONCES);
+    } else if (profileStore.open(preferences, "lorawan", true)) {
+        char hasNoncesKey[16];
+        sprintf(hasNoncesKey, "has_nonces_%d", active_profile_index);
+        hasNonces = preferences.getBool(hasNoncesKey, false);
+        preferences.end();
+    }
+
     if (!hasNonces) {
-        Serial.printf(">>> No saved nonces found for Profile %d\n", active_profile_index);
+        LOG_I(LOG_SESSION, "No saved nonces found for Profile %d", active_profile_index);
         return false;
     }
 
-    Serial.printf(">>> Found saved nonces for Profile %d - restoring...\n", active_profile_index);
+    LOG_D(LOG_SESSION, "Found saved nonces for Profile %d - restoring...", active_profile_index);
 
     // Initialize node first
-    node->beginOTAA(joinEUI, devEUI, nwkKey, appKey);
+    beginActivation();
 
-    // Load profile-specific nonces from NVS
-    if (preferences.begin("lorawan", false)) {  // Read-write (creates if not exists)
-        const size_t noncesSize = RADIOLIB_LORAWAN_NONCES_BUF_SIZE;
-        uint8_t noncesBuffer[RADIOLIB_LORAWAN_NONCES_BUF_SIZE];
-        
+    const size_t noncesSize = RADIOLIB_LORAWAN_NONCES_BUF_SIZE;
+    uint8_t noncesBuffer[RADIOLIB_LORAWAN_NONCES_BUF_SIZE];
+    bool loaded = false;
+
+    if (nonceLog.isActive()) {
+        loaded = nonceLog.read(active_profile_index, NONCE_LOG_NONCES, noncesBuffer, noncesSize);
+    } else if (profileStore.open(preferences, "lorawan", true)) {
         char noncesKey[16];
         sprintf(noncesKey, "nonces_%d", active_profile_index);
-        size_t noncesRead = preferences.getBytes(noncesKey, noncesBuffer, noncesSize);
+        loaded = preferences.getBytes(noncesKey, noncesBuffer, noncesSize) == noncesSize;
         preferences.end();
+    }
 
-        if (noncesRead == noncesSize) {
-            Serial.printf(">>> Loaded nonces (%d bytes) for Profile %d\n", noncesRead, active_profile_index);
-            int16_t state = node->setBufferNonces(noncesBuffer);
-            Serial.printf(">>> setBufferNonces() returned: %d\n", state);
+    if (loaded) {
+        LOG_D(LOG_SESSION, "Loaded nonces (%u bytes) for Profile %d", (unsigned)noncesSize, active_profile_index);
+        int16_t state = node->setBufferNonces(noncesBuffer);
+        LOG_D(LOG_SESSION, "setBufferNonces() returned: %d", state);
 
-            if (state == RADIOLIB_ERR_NONE) {
-                Serial.printf(">>> Nonces restored for Profile %d - DevNonce will continue from last value\n", active_profile_index);
-                return true;
-            } else {
-                Serial.printf(">>> Nonces restore failed for Profile %d: %d\n", active_profile_index, state);
-            }
+        if (state == RADIOLIB_ERR_NONE) {
+            LOG_I(LOG_SESSION, "Nonces restored for Profile %d - DevNonce will continue from last value", active_profile_index);
+            return true;
+        } else {
+            LOG_E(LOG_SESSION, "Nonces restore failed for Profile %d: %d", active_profile_index, state);
         }
     }
 
@@ -1433,6 +2210,31 @@ float LoRaWANHandler::getLastSNR() const {
     return last_snr;
 }
 
+const LinkQualityHistory& LoRaWANHandler::getLinkHistory() const {
+    return link_history;
+}
+
+const JoinBackoff& LoRaWANHandler::getJoinBackoff() const {
+    return join_backoff;
+}
+
+const ChangeReporter& LoRaWANHandler::getChangeReporter() const {
+    return change_reporter;
+}
+
+const SampleBatcher& LoRaWANHandler::getBatcher() const {
+    return batcher;
+}
+
+const DeliveryTracker& LoRaWANHandler::getDelivery() const {
+    return delivery;
+}
+
+uint8_t LoRaWANHandler::getProfileDatarate(uint8_t index) const {
+    if (index >= MAX_LORA_PROFILES) return LORAWAN_DEFAULT_DATARATE;
+    return profile_datarate[index];
+}
+
 uint64_t LoRaWANHandler::getDevEUI() const {
     return devEUI;
 }
@@ -1456,6 +2258,10 @@ uint32_t LoRaWANHandler::getDevAddr() const {
     return 0;
 }
 
+int LoRaWANHandler::findProfileByDevEUI(uint64_t devEUI) const {
+    return eui_index.find(devEUI, profiles);
+}
+
 int LoRaWANHandler::getEnabledDevEUIs(uint64_t* euis, int max_count) const {
     int count = 0;
     for (int i = 0; i < MAX_LORA_PROFILES && count < max_count; i++) {
@@ -1465,3 +2271,25 @@ int LoRaWANHandler::getEnabledDevEUIs(uint64_t* euis, int max_count) const {
     }
     return count;
 }
+
+void LoRaWANHandler::printMemoryUsage() const {
+    // Everything sized by MAX_LORA_PROFILES is allocated once at boot; nothing grows at runtime
+    size_t state_bytes = sizeof(profiles) + sizeof(eui_index) + sizeof(profile_slot)
+        + sizeof(session_valid) + sizeof(profile_datarate) + sizeof(uplink_interval_s)
+        + sizeof(pending_expedite) + sizeof(pending_ack) + sizeof(pending_ack_len)
+        + sizeof(scheduler) + sizeof(link_history) + sizeof(join_backoff) + sizeof(airtime)
+        + sizeof(change_reporter) + sizeof(delivery) + sizeof(startup_pending);
+    size_t cache_bytes = (size_t)MAX_LORA_PROFILES * RADIOLIB_LORAWAN_SESSION_BUF_SIZE;
+    size_t pool_bytes = LORAWAN_NODE_POOL_SIZE * sizeof(LoRaWANNode);
+
+    Serial.printf(">>> LoRaWAN memory: %d profiles, %d node contexts\n", MAX_LORA_PROFILES, LORAWAN_NODE_POOL_SIZE);
+    Serial.printf("    Profile state: %u bytes (%u per profile)\n",
+        (unsigned)state_bytes, (unsigned)(state_bytes / MAX_LORA_PROFILES));
+    Serial.printf("    Session cache: %u bytes in %s\n", (unsigned)cache_bytes,
+        session_cache_psram ? "PSRAM" : "internal RAM");
+    Serial.printf("    Node pool:     %u bytes (%u per context)\n",
+        (unsigned)pool_bytes, (unsigned)sizeof(LoRaWANNode));
+    Serial.printf("    Frame history: %u bytes in %s (%u records)\n",
+        (unsigned)(frame_history.getCapacity() * sizeof(FrameRecord)),
+        frame_history_psram ? "PSRAM" : "internal RAM", frame_history.getCapacity());
+}
@@ -5,6 +5,19 @@
 #include <RadioLib.h>
 #include <Preferences.h>
 #include "config.h"
+#include "airtime_ledger.h"
+#include "lora_region.h"
+#include "uplink_scheduler.h"
+#include "sample_batch.h"
+#include "link_quality.h"
+#include "join_backoff.h"
+#include "change_report.h"
+#include "delivery_tracker.h"
+#include "frame_history.h"
+#include "downlink_commands.h"
+#include "profile_store.h"
+#include "nonce_log.h"
+#include "payload_map.h"
 
 // ============================================================================
 // LORAWAN HANDLER CLASS
@@ -13,6 +26,26 @@
 // Forward declarations for parameter structures
 struct InputRegisters;
 
+// LoRaWAN state kept in RTC memory over deep sleep (plain data, power_manager.h).
+// Sessions and nonces of every profile are in the nonce log as well; the
+// active profile's copy here lets it send right after wake.
+struct LoRaWANRetained {
+    ScheduleRetained schedule;
+    AirtimeRetained airtime;
+    JoinRetained joins;
+    uint8_t nonces[RADIOLIB_LORAWAN_NONCES_BUF_SIZE];
+    uint8_t session[RADIOLIB_LORAWAN_SESSION_BUF_SIZE];
+    uint8_t session_profile;                      // 0xFF = no live session
+    uint8_t active_profile;
+    uint8_t profile_datarate[MAX_LORA_PROFILES];
+    bool startup_pending[MAX_LORA_PROFILES];
+    uint8_t startup_total;
+    uint8_t startup_sent;
+    uint8_t startup_home;
+    uint32_t uplink_count;
+    uint32_t downlink_count;
+};
+
 class LoRaWANHandler {
 public:
     LoRaWANHandler();
@@ -30,8 +63,18 @@ public:
     // Main processing loop (handles auto-rotation and periodic uplinks)
     void process(const InputRegisters& input);
 
-    // Startup sequence (send initial uplink from all enabled profiles)
-    void performStartupSequence(const InputRegisters& input);
+    // One initial uplink from every enabled profile, sent by process() in the
+    // background (staggered by the scheduler like any other uplink)
+    void scheduleStartupUplinks();
+    bool isStartupPending() const;
+
+    // Low-power operation (power_manager.h): time until process() has
+    // something to send, radio to sleep, state kept over deep sleep
+    unsigned long timeUntilNextUplink(unsigned long now) const;
+    unsigned long timeUntilNextSample(unsigned long now) const;  // Batched payload sampling
+    void sleepRadio();
+    void retainState(unsigned long now, LoRaWANRetained& out);
+    void resumeState(const LoRaWANRetained& in, unsigned long saved_at);
 
     // Credentials management (legacy - for backward compatibility)
     void loadCredentials();
@@ -41,14 +84,17 @@ public:
 
     // Profile management (new multi-profile system)
     void loadProfiles();
-    void saveProfiles();
+    void saveProfiles();                 // All records (first boot); edits use saveProfile()
+    void saveProfile(uint8_t index);     // One compact record
     void initializeDefaultProfiles();
     void generateProfile(uint8_t index, const char* name);
     bool setActiveProfile(uint8_t index);
+    bool switchToProfile(uint8_t index);  // setActiveProfile() + swap to that profile's node context
     uint8_t getActiveProfileIndex() const;
     LoRaProfile* getProfile(uint8_t index);
     bool updateProfile(uint8_t index, const LoRaProfile& profile);
     bool toggleProfileEnabled(uint8_t index);
+    int findProfileByDevEUI(uint64_t devEUI) const;  // Profile index or -1 (hash lookup)
     void printProfile(uint8_t index);
     
     // Auto-rotation (cycle through multiple profiles)
@@ -58,10 +104,12 @@ public:
     uint8_t getNextEnabledProfile() const;
     int getEnabledProfileCount() const;
 
-    // Session persistence (nonces only - session restore not working in RadioLib 7.4.0)
+    // Session persistence (per-profile nonces + session, RAM cache mirrored to NVS)
     void saveSession();
     void loadSession();
     void resetNonces();  // Clear saved nonces to force fresh DevNonce sequence
+    void clearSession(uint8_t index);  // Drop cached session for one profile (forces re-join)
+    bool hasSession(uint8_t index) const;
 
     // Status getters
     uint32_t getUplinkCount() const;
@@ -74,20 +122,65 @@ public:
     void getNwkKey(uint8_t* buffer) const;
     uint32_t getDevAddr() const;
     int getEnabledDevEUIs(uint64_t* euis, int max_count) const;
+    void printMemoryUsage() const;
+
+    // Link quality and data rate per profile (ADR)
+    const LinkQualityHistory& getLinkHistory() const;
+    uint8_t getProfileDatarate(uint8_t index) const;
+
+    // Join retry state and statistics per profile
+    const JoinBackoff& getJoinBackoff() const;
+
+    // Deadband/threshold-triggered uplinks (LORAWAN_REPORT_ON_CHANGE)
+    const ChangeReporter& getChangeReporter() const;
+
+    // Confirmed uplinks: outstanding messages, delivery ratio, retries, ACK latency
+    const DeliveryTracker& getDelivery() const;
+
+    // Batched delta payload: pending and dropped samples per profile
+    const SampleBatcher& getBatcher() const;
+
+    // Frame history of all profiles (thread-safe: called from the web server)
+    size_t queryFrames(const FrameQuery& q, FrameRecord* out, size_t max, uint32_t* next_cursor);
+    const FrameHistory& getFrameHistory() const;
+    bool isFrameHistoryInPSRAM() const;
+
+    // Downlinks received between uplinks (LORAWAN_CLASS_C)
+    uint32_t getClassCDownlinkCount() const;
+
+    // Remote configuration (FPort 10 downlink commands, see downlink_commands.h)
+    bool setUplinkInterval(uint8_t index, uint16_t seconds);  // Persisted per profile
+    uint16_t getUplinkInterval(uint8_t index) const;
+    bool setPayloadType(uint8_t index, PayloadType type);
+    bool setProfileEnabled(uint8_t index, bool enabled);      // Refuses to disable the active profile
+    bool requestUplink(uint8_t index);                        // One extra uplink as soon as possible
+    bool hasPendingAck(uint8_t index) const;
 
-    // Payload builders
-    size_t buildAdeunisModbusSF6Payload(uint8_t* payload, const InputRegisters& input);
-    size_t buildCayenneLPPPayload(uint8_t* payload, const InputRegisters& input);
-    size_t buildRawModbusPayload(uint8_t* payload, const InputRegisters& input);
-    size_t buildCustomPayload(uint8_t* payload, const InputRegisters& input);
-    size_t buildVistronLoraModConPayload(uint8_t* payload, const InputRegisters& input);
+    // User payload mapping (PAYLOAD_USER_MAP): one layout for every profile
+    // that selects it, compiled when saved (thread-safe against uplinks)
+    bool setPayloadMap(const char* spec, char* error, size_t error_len);  // Compiles, then persists
+    void getPayloadMap(PayloadMap& out);                                   // Copy of the current program
+
+    // Airtime accounting (regional duty cycle) and uplink schedule, shared by all profiles
+    const AirtimeLedger& getAirtime() const;
+    UplinkScheduler& getScheduler();
+    uint32_t estimateUplinkAirtime(uint8_t index) const;  // Time-on-air of the profile's next uplink (ms)
 
 private:
     Preferences preferences;
 
     // Radio and node instances
+    // One radio for the whole uptime and a pool of LORAWAN_NODE_POOL_SIZE node
+    // contexts. A profile keeps its context until the least recently used one is
+    // needed by another profile; its session then lives on in the session cache.
+    // `node` always points at the active profile's context.
     SX1262* radio;
     LoRaWANNode* node;
+    LoRaWANNode* node_pool[LORAWAN_NODE_POOL_SIZE];
+    uint8_t pool_owner[LORAWAN_NODE_POOL_SIZE];       // Profile index, 0xFF = free
+    unsigned long pool_last_used[LORAWAN_NODE_POOL_SIZE];
+    LoRaRegion pool_region[LORAWAN_NODE_POOL_SIZE];   // Channel plan the context was built for
+    int8_t profile_slot[MAX_LORA_PROFILES];           // Pool slot, -1 = no context
 
     // LoRaWAN credentials (OTAA) - legacy, kept for backward compatibility
     uint64_t joinEUI;  // AppEUI (MSB)
@@ -97,6 +190,7 @@ private:
 
     // Multi-profile system
     LoRaProfile profiles[MAX_LORA_PROFILES];
+    DevEuiIndex eui_index;
     uint8_t active_profile_index;
     bool auto_rotation_enabled;
 
@@ -104,17 +198,99 @@ private:
     bool joined;
     uint32_t uplink_count;
     uint32_t downlink_count;
+    uint32_t class_c_downlinks;
     int16_t last_rssi;
     float last_snr;
     
-    // Timing
-    unsigned long last_uplink_time;
-    unsigned long last_profile_uplinks[MAX_LORA_PROFILES];
+    // Timing (earliest-deadline-first over the scheduled profiles)
+    UplinkScheduler scheduler;
+
+    // Per-profile session cache (RAM copy of RadioLib session buffer, mirrored to NVS)
+    // Restoring a cached session lets a profile switch skip the OTAA join entirely.
+    // Allocated in PSRAM when available (MAX_LORA_PROFILES x ~440 bytes).
+    uint8_t (*session_buffers)[RADIOLIB_LORAWAN_SESSION_BUF_SIZE];
+    bool session_cache_psram;
+    bool session_valid[MAX_LORA_PROFILES];
+
+    // Airtime ledger and last data rate used per profile (ADR may change it)
+    AirtimeLedger airtime;
+    uint8_t profile_datarate[MAX_LORA_PROFILES];
+    unsigned long last_airtime_log;
+
+    // Multi-sample buffer for the batched delta payload (shared by all profiles)
+    SampleBatcher batcher;
+
+    // Compiled user payload mapping; the lock covers replacing it from the web
+    // server against encoding in the loop task
+    PayloadMap payload_map;
+    SemaphoreHandle_t map_lock;
+    void loadPayloadMap();
+
+    // Payload room at the profile's data rate after MAC and acknowledgement overhead
+    size_t maxAppPayload(uint8_t index) const;
+
+    // Per-profile link-quality history (drives the ADR backoff)
+    LinkQualityHistory link_history;
+
+    // Per-profile join retry backoff (randomized, join duty cycle) and join statistics
+    JoinBackoff join_backoff;
+
+    // Values each profile last reported; asks for extra uplinks on change
+    ChangeReporter change_reporter;
+
+    // Confirmed uplinks waiting for an ACK and their retransmission backoff
+    DeliveryTracker delivery;
+    void trackDelivery(bool acked);  // After a confirmed uplink of the active profile
+
+    // Uplink/downlink/join records (ring in PSRAM when available); the lock
+    // covers recording in the loop task against queries from the web server
+    FrameHistory frame_history;
+    SemaphoreHandle_t frame_lock;
+    bool frame_history_psram;
+    void recordFrame(FrameRecord& rec, const uint8_t* payload, size_t len);
+    void checkForChanges(const uint16_t* sample, unsigned long now);
+    static uint16_t defaultIntervalS();
+
+    // Startup uplinks still to go; profiles outside the regular schedule are
+    // scheduled until theirs is done. Without rotation the schedule stays on
+    // `startup_home` meanwhile, and it is active again afterwards.
+    bool startup_pending[MAX_LORA_PROFILES];
+    uint8_t startup_remaining;
+    uint8_t startup_total;
+    uint8_t startup_sent;
+    uint8_t startup_home;
+    void endStartupUplink(uint8_t index, bool sent);
+
+    // Remote configuration: per-profile uplink interval, expedite requests
+    // (applied on the next schedule sync) and command results waiting for the
+    // profile's next uplink
+    uint16_t uplink_interval_s[MAX_LORA_PROFILES];
+    bool pending_expedite[MAX_LORA_PROFILES];
+    uint8_t pending_ack[MAX_LORA_PROFILES][LORAWAN_CMD_ACK_MAX];
+    uint8_t pending_ack_len[MAX_LORA_PROFILES];
 
     // Helper functions
     void initializeRadio();
     void configureRadio();
+    void beginActivation();  // beginOTAA() or beginABP() with the active profile's keys
     bool restoreNonces();
+    bool restoreSession();
+    void migrateNoncesToLog();
+    void handleDownlink(const uint8_t* data, size_t len, const LoRaWANEvent_t& event, bool class_c);
+    void enableClassC();
+    void pollClassC();
+    void allocateNodePool();
+    void allocateSessionCache();
+    void allocateFrameHistory();
+    void selectNodeContext();
+    LoRaWANNode* acquireNode(uint8_t index);
+    LoRaWANNode* createNode(LoRaRegion region);
+    static const LoRaWANBand_t* radioLibBand(LoRaRegion region);
+    LoRaWANNode* nodeFor(uint8_t index) const;  // Context currently held by a profile, or nullptr
+    size_t writeProfileRecord(uint8_t index);   // Preferences must be open on lorawan_prof
+    void syncSchedule(unsigned long now);
+    unsigned long airtimeWaitMs(uint8_t index, unsigned long now);
+    void applyAdrBackoff();
 };
 
 // Global instance
@@ -10,6 +10,8 @@
  * - DisplayManager: Manages E-Ink display updates
  * - SF6Emulator: Manages sensor simulation logic
  * - WebServerManager: Manages HTTPS server and web interface
+ * - PowerManager: Manages sleep between uplinks (battery operation)
+ * - Logger: Deferred, leveled logging drained by a background task
  */
 
 #include <Arduino.h>
@@ -24,9 +26,13 @@
 #include "auth_manager.h"
 #include "display_manager.h"
 #include "lorawan_handler.h"
+#include "payload_codec.h"
 #include "sf6_emulator.h"
 #include "web_server.h"
 #include "ota_manager.h"
+#include "boot_timeline.h"
+#include "power_manager.h"
+#include "logger.h"
 
 // ============================================================================
 // GLOBAL OBJECTS
@@ -41,10 +47,21 @@ ModbusIP mbTCP;
 
 void setup() {
     Serial.begin(115200);
-    delay(1000);
 
-    // Initialize Display FIRST to clear screen immediately
-    displayManager.begin(DISPLAY_ROTATION);
+    // Deep-sleep wake: only what the next uplink needs. The e-ink keeps its
+    // last image without power, WiFi and HTTPS stay off.
+    bool resumed = powerManager.begin();
+
+    // Drain task for LOG_x() output (levels from NVS)
+    logger.begin();
+
+    if (!resumed) {
+        delay(1000);
+
+        // Initialize Display FIRST to clear screen immediately (shows the startup screen)
+        displayManager.begin(DISPLAY_ROTATION);
+        bootTimeline.mark(BOOT_DISPLAY_READY, millis());
+    }
 
     Serial.println("\n\n========================================");
     Serial.println("Vision Master E290 - Modbus RTU/TCP");
@@ -53,33 +70,22 @@ void setup() {
     Serial.println("Display: 2.9\" E-Ink (296x128)");
     Serial.println("========================================\n");
 
+    // Subsystems are only started here, nothing waits on the network or the
+    // radio: Modbus and HTTPS answer from the first loop(), the WiFi client
+    // connection completes in wifiManager.process() and the LoRaWAN startup
+    // uplinks go out from lorawanHandler.process().
+
     // Initialize Authentication
     authManager.begin();
 
     // Initialize SF6 Emulator (loads values from NVS)
     sf6Emulator.begin();
 
-    // Initialize LoRaWAN
-    lorawanHandler.begin();
-    
-    // Perform startup uplink sequence
-    if (lorawanHandler.getEnabledProfileCount() > 0) {
-        Serial.println(">>> Starting LoRaWAN uplink sequence...");
-        lorawanHandler.performStartupSequence(modbusHandler.getInputRegisters());
+    // Payload encoders vs. the decoders' golden vectors (debug builds)
+    if (LORAWAN_CODEC_SELFTEST) {
+        PayloadCodecs::selfTest();
     }
 
-    // Show startup screen after LoRaWAN init
-    displayManager.showStartupScreen();
-
-    // Initialize WiFi
-    wifiManager.begin();
-
-    // Initialize Web Server
-    webServer.begin();
-
-    // Initialize OTA Manager
-    otaManager.begin();
-
     // Initialize Modbus RTU
     // Get slave ID from preferences or default
     Preferences prefs;
@@ -95,9 +101,15 @@ void setup() {
     }
     
     modbusHandler.begin(slave_id);
+    bootTimeline.mark(BOOT_MODBUS_READY, millis());
+
+    // Initialize WiFi (AP at once; a saved client network connects in the background)
+    if (!resumed) {
+        wifiManager.begin();
+    }
 
     // Initialize Modbus TCP if enabled
-    if (tcp_enabled) {
+    if (tcp_enabled && !resumed) {
         Serial.println("\n>>> Initializing Modbus TCP...");
         mbTCP.server();
         
@@ -107,6 +119,27 @@ void setup() {
         
         Serial.println(">>> Modbus TCP server started on port 502");
     }
+
+    if (!resumed) {
+        // Initialize Web Server
+        webServer.begin();
+
+        // Initialize OTA Manager
+        otaManager.begin();
+    }
+
+    // Initialize LoRaWAN (radio, profiles, sessions); no join or uplink here.
+    // After a deep sleep the schedule continues where it was.
+    lorawanHandler.begin();
+    if (resumed) {
+        powerManager.resumeLoRaWAN();
+    } else {
+        lorawanHandler.scheduleStartupUplinks();
+    }
+    bootTimeline.mark(BOOT_LORAWAN_READY, millis());
+
+    bootTimeline.mark(BOOT_SETUP_DONE, millis());
+    bootTimeline.print();
 }
 
 // ============================================================================
@@ -173,8 +206,9 @@ void loop() {
         }
     }
 
-    // Update Display every 30 seconds
-    if (now - last_display_update >= 30000) {
+    // Update Display every 30 seconds (not while sleeping between uplinks:
+    // an e-ink refresh costs more than an uplink)
+    if (now - last_display_update >= 30000 && !powerManager.isSleepEnabled()) {
         last_display_update = now;
         
         // Check if an update is available from OTA manager
@@ -224,20 +258,26 @@ void loop() {
         }
     }
 
-    // Handle LoRaWAN Uplinks (Auto-rotation and periodic sending)
-    lorawanHandler.process(modbusHandler.getInputRegisters());
+    // Handle Modbus RTU
+    modbusHandler.task();
 
-    // Handle WiFi Timeout
+    // Handle Modbus TCP
+    mbTCP.task();
+
+    // Handle WiFi (boot-time client connection, AP timeout)
+    wifiManager.process();
     wifiManager.handleTimeout();
 
     // Handle Web Server
     webServer.handle();
 
-    // Handle Modbus RTU
-    modbusHandler.task();
+    // Handle LoRaWAN Uplinks (Auto-rotation and periodic sending)
+    // Last: a join or uplink blocks through its receive windows, so pending
+    // Modbus requests are answered first
+    lorawanHandler.process(modbusHandler.getInputRegisters());
 
-    // Handle Modbus TCP
-    mbTCP.task();
+    // Energy estimate; sleeps until the next uplink in low-power mode
+    powerManager.process();
 
     yield();
 }
@@ -1,5 +1,7 @@
 #include "modbus_handler.h"
 #include "config.h"
+#include "boot_timeline.h"
+#include "logger.h"
 
 // Global instance
 ModbusHandler modbusHandler;
@@ -129,7 +131,7 @@ void ModbusHandler::setSlaveId(uint8_t slave_id) {
     this->slave_id = slave_id;
     input_regs.slave_id = slave_id;  // Update input register
     mb.slave(slave_id);
-    Serial.printf("Modbus Slave ID changed to: %d\n", slave_id);
+    LOG_I(LOG_MODBUS, "Modbus Slave ID changed to: %d", slave_id);
 }
 
 uint8_t ModbusHandler::getSlaveId() {
@@ -145,6 +147,7 @@ uint16_t ModbusHandler::cbRead(TRegister* reg, uint16_t val) {
 
     instance->stats.request_count++;
     instance->stats.read_count++;
+    bootTimeline.mark(BOOT_FIRST_MODBUS_RESPONSE, millis());
 
     uint16_t addr = reg->address.address;
 
@@ -197,13 +200,14 @@ uint16_t ModbusHandler::cbWrite(TRegister* reg, uint16_t val) {
 
     instance->stats.request_count++;
     instance->stats.write_count++;
+    bootTimeline.mark(BOOT_FIRST_MODBUS_RESPONSE, millis());
 
     uint16_t addr = reg->address.address;
 
     // Allow writing to register 0 (sequential counter)
     if (addr == 0) {
         instance->holding_regs.sequential_counter = val;
-        Serial.printf("Modbus Write: Register 0 = %d\n", val);
+        LOG_I(LOG_MODBUS, "Modbus Write: Register 0 = %d", val);
     }
 
     return val;
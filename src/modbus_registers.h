@@ -0,0 +1,48 @@
+#ifndef MODBUS_REGISTERS_H
+#define MODBUS_REGISTERS_H
+
+#include <stdint.h>
+
+// ============================================================================
+// MODBUS DATA STRUCTURES
+// ============================================================================
+
+struct HoldingRegisters {
+    uint16_t sequential_counter;
+    uint16_t random_number;
+    uint32_t uptime_seconds;  // 32-bit for ~136 years (spans registers 2-3)
+    uint16_t free_heap_kb_low;
+    uint16_t free_heap_kb_high;
+    uint16_t min_heap_kb;
+    uint16_t cpu_freq_mhz;
+    uint16_t task_count;
+    uint16_t temperature_x10;
+    uint16_t cpu_cores;
+    uint16_t wifi_enabled;
+    uint16_t wifi_clients;
+};
+
+struct InputRegisters {
+    uint16_t sf6_density;           // kg/m3 x 100
+    uint16_t sf6_pressure_20c;      // kPa x 10
+    uint16_t sf6_temperature;       // K x 10
+    uint16_t sf6_pressure_var;      // kPa x 10
+    uint16_t slave_id;
+    uint16_t serial_hi;
+    uint16_t serial_lo;
+    uint16_t sw_release;
+    uint16_t quartz_freq;
+};
+
+// ============================================================================
+// MODBUS STATISTICS
+// ============================================================================
+
+struct ModbusStats {
+    uint32_t request_count;
+    uint32_t read_count;
+    uint32_t write_count;
+    uint32_t error_count;
+};
+
+#endif // MODBUS_REGISTERS_H
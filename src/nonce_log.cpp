@@ -0,0 +1,449 @@
+#include "nonce_log.h"
+#include <esp_rom_crc.h>
+
+// Global instance
+NonceLog nonceLog;
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+NonceLog::NonceLog() :
+    partition(nullptr),
+    sector_count(0),
+    write_sector(0),
+    write_pos(0),
+    sector_seq(0),
+    next_seq(1),
+    appends(0),
+    skipped(0),
+    compactions(0),
+    relocating(false) {
+    resetIndex();
+}
+
+bool NonceLog::begin() {
+    if (partition) return true;
+
+    const esp_partition_t* part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)NONCE_LOG_SUBTYPE, NONCE_LOG_PARTITION);
+    if (!part) {
+        Serial.println(">>> No '" NONCE_LOG_PARTITION "' partition - nonces and sessions stay in NVS");
+        return false;
+    }
+    if (part->size / NONCE_LOG_SECTOR_SIZE < NONCE_LOG_MIN_SECTORS) {
+        Serial.printf(">>> Nonce log partition too small (%lu bytes, needs %u sectors) - using NVS\n",
+            (unsigned long)part->size, (unsigned)NONCE_LOG_MIN_SECTORS);
+        return false;
+    }
+
+    partition = part;
+    sector_count = part->size / NONCE_LOG_SECTOR_SIZE;
+    resetIndex();
+
+    // Newest valid sector is the write sector
+    bool found = false;
+    for (uint32_t s = 0; s < sector_count; s++) {
+        uint32_t header[4];
+        if (esp_partition_read(partition, s * NONCE_LOG_SECTOR_SIZE, header, sizeof(header)) != ESP_OK) continue;
+        if (header[0] != NONCE_LOG_SECTOR_MAGIC ||
+            header[3] != esp_rom_crc32_le(0, (const uint8_t*)header, 8)) continue;
+        if (!found || header[1] > sector_seq) {
+            sector_seq = header[1];
+            write_sector = s;
+            found = true;
+        }
+    }
+
+    if (!found) {
+        Serial.println(">>> Nonce log empty - formatting");
+        format();
+    } else {
+        for (uint32_t s = 0; s < sector_count; s++) {
+            scanSector(s, s == write_sector);
+        }
+        // Power lost between entering a sector and erasing the oldest one:
+        // finish the compaction. If a torn copy used up the room the rest
+        // needed, the erase was never reached and the oldest sector still holds
+        // everything copied: drop the copies and compact again.
+        uint32_t spare = (write_sector + 1) % sector_count;
+        if (!sectorIsErased(spare) && !relocate(spare) && holdsOnlyCopies(write_sector, spare)) {
+            Serial.println(">>> Nonce log: compaction interrupted by a power loss - repeating it");
+            esp_partition_erase_range(partition, write_sector * NONCE_LOG_SECTOR_SIZE, NONCE_LOG_SECTOR_SIZE);
+            write_sector = (write_sector + sector_count - 1) % sector_count;
+            resetIndex();
+            for (uint32_t s = 0; s < sector_count; s++) {
+                scanSector(s, false);
+            }
+            advanceSector();
+        } else {
+            restoreSpare();
+        }
+    }
+
+    printStatus();
+    return true;
+}
+
+bool NonceLog::isActive() const {
+    return partition != nullptr;
+}
+
+void NonceLog::resetIndex() {
+    for (int p = 0; p < MAX_LORA_PROFILES; p++) {
+        for (int t = 0; t < NONCE_LOG_TYPE_COUNT; t++) {
+            index[p][t].offset = NONE;
+            index[p][t].seq = 0;
+            index[p][t].crc = 0;
+            index[p][t].len = 0;
+        }
+    }
+}
+
+void NonceLog::format() {
+    esp_partition_erase_range(partition, 0, sector_count * NONCE_LOG_SECTOR_SIZE);
+    resetIndex();
+    write_sector = 0;
+    write_pos = NONCE_LOG_HEADER_SIZE;
+    sector_seq = 1;
+    next_seq = 1;
+    writeSectorHeader(0, sector_seq);
+}
+
+// ============================================================================
+// BOOT SCAN
+// ============================================================================
+
+void NonceLog::scanSector(uint32_t sector, bool is_write_sector) {
+    uint32_t base = sector * NONCE_LOG_SECTOR_SIZE;
+    uint32_t header[4];
+    if (esp_partition_read(partition, base, header, sizeof(header)) != ESP_OK ||
+        header[0] != NONCE_LOG_SECTOR_MAGIC ||
+        header[3] != esp_rom_crc32_le(0, (const uint8_t*)header, 8)) {
+        return;
+    }
+
+    uint8_t* buf = (uint8_t*)malloc(NONCE_LOG_SECTOR_SIZE);
+    if (!buf) return;
+    esp_partition_read(partition, base, buf, NONCE_LOG_SECTOR_SIZE);
+
+    uint32_t pos = NONCE_LOG_HEADER_SIZE;
+    bool torn = false;
+    while (pos + NONCE_LOG_HEADER_SIZE <= NONCE_LOG_SECTOR_SIZE) {
+        const uint8_t* rec = buf + pos;
+        uint16_t magic = rec[0] | (rec[1] << 8);
+        uint16_t len = rec[4] | (rec[5] << 8);
+
+        if (magic == 0xFFFF) {
+            // Erased slot ends the sector; anything programmed in it is a torn header
+            for (int i = 0; i < NONCE_LOG_HEADER_SIZE; i++) {
+                if (rec[i] != 0xFF) torn = true;
+            }
+            break;
+        }
+        if (magic != NONCE_LOG_RECORD_MAGIC || len > NONCE_LOG_MAX_PAYLOAD ||
+            pos + recordSize(len) > NONCE_LOG_SECTOR_SIZE) {
+            torn = true;  // Damaged header: the rest of the sector can't be walked
+            break;
+        }
+        uint32_t seq, crc;
+        memcpy(&seq, rec + 8, 4);
+        memcpy(&crc, rec + 12, 4);
+        if (crc != recordCrc(rec, rec + NONCE_LOG_HEADER_SIZE, len)) {
+            // Payload cut short by a power loss: skip the slot, the previous record stays current
+            Serial.printf(">>> Nonce log: torn record at sector %lu +%lu ignored\n",
+                (unsigned long)sector, (unsigned long)pos);
+            pos += recordSize(len);
+            continue;
+        }
+
+        uint8_t profile = rec[2];
+        uint8_t type = rec[3];
+        if (profile < MAX_LORA_PROFILES && type < NONCE_LOG_TYPE_COUNT && seq > index[profile][type].seq) {
+            Entry& e = index[profile][type];
+            e.seq = seq;
+            e.len = len;
+            e.offset = len ? base + pos : NONE;
+            e.crc = esp_rom_crc32_le(0, rec + NONCE_LOG_HEADER_SIZE, len);
+        }
+        if (seq >= next_seq) next_seq = seq + 1;
+        pos += recordSize(len);
+    }
+    free(buf);
+
+    if (is_write_sector) {
+        // Never append behind a damaged header: the next write opens a new sector
+        write_pos = torn ? NONCE_LOG_SECTOR_SIZE : pos;
+        if (torn) Serial.println(">>> Nonce log: damaged header in write sector - closing it");
+    }
+}
+
+// ============================================================================
+// RECORDS
+// ============================================================================
+
+bool NonceLog::write(uint8_t profile, NonceLogRecordType type, const uint8_t* data, uint16_t len) {
+    if (!partition || profile >= MAX_LORA_PROFILES || type >= NONCE_LOG_TYPE_COUNT ||
+        len == 0 || len > NONCE_LOG_MAX_PAYLOAD) {
+        return false;
+    }
+
+    // Nonces only change on a join: most calls rewrite identical data
+    const Entry& e = index[profile][type];
+    uint32_t crc = esp_rom_crc32_le(0, data, len);
+    if (e.offset != NONE && e.len == len && e.crc == crc) {
+        uint8_t current[NONCE_LOG_MAX_PAYLOAD];
+        if (esp_partition_read(partition, e.offset + NONCE_LOG_HEADER_SIZE, current, len) == ESP_OK &&
+            memcmp(current, data, len) == 0) {
+            skipped++;
+            return true;
+        }
+    }
+    return append(profile, type, data, len, crc);
+}
+
+bool NonceLog::read(uint8_t profile, NonceLogRecordType type, uint8_t* data, uint16_t len) const {
+    if (!partition || profile >= MAX_LORA_PROFILES || type >= NONCE_LOG_TYPE_COUNT) return false;
+
+    const Entry& e = index[profile][type];
+    if (e.offset == NONE || e.len != len) return false;
+    if (esp_partition_read(partition, e.offset + NONCE_LOG_HEADER_SIZE, data, len) != ESP_OK) return false;
+    return esp_rom_crc32_le(0, data, len) == e.crc;
+}
+
+bool NonceLog::has(uint8_t profile, NonceLogRecordType type) const {
+    if (profile >= MAX_LORA_PROFILES || type >= NONCE_LOG_TYPE_COUNT) return false;
+    return index[profile][type].offset != NONE;
+}
+
+void NonceLog::remove(uint8_t profile, NonceLogRecordType type) {
+    if (!partition || profile >= MAX_LORA_PROFILES || type >= NONCE_LOG_TYPE_COUNT) return;
+    if (index[profile][type].offset == NONE) return;
+    append(profile, type, nullptr, 0, 0);
+}
+
+void NonceLog::clear() {
+    if (!partition) return;
+    format();
+    Serial.println(">>> Nonce log erased");
+}
+
+bool NonceLog::append(uint8_t profile, uint8_t type, const uint8_t* data, uint16_t len, uint32_t crc) {
+    uint32_t size = recordSize(len);
+    if (write_pos + size > NONCE_LOG_SECTOR_SIZE) {
+        if (relocating) return false;  // Only after a power loss in the middle of a compaction
+
+        // A sector full of current records moves forward whole: compact the next
+        // one. One pass round the ring frees room (NONCE_LOG_MIN_SECTORS).
+        for (uint32_t step = 0; write_pos + size > NONCE_LOG_SECTOR_SIZE; step++) {
+            if (step == sector_count || !advanceSector()) {
+                Serial.printf(">>> ERROR: Nonce log full - record for Profile %d not written\n", profile);
+                return false;
+            }
+        }
+    }
+
+    // Header and payload in one flash write
+    uint8_t rec[NONCE_LOG_HEADER_SIZE + NONCE_LOG_MAX_PAYLOAD];
+    memset(rec, 0xFF, size);
+    uint32_t seq = next_seq++;
+    rec[0] = NONCE_LOG_RECORD_MAGIC & 0xFF;
+    rec[1] = NONCE_LOG_RECORD_MAGIC >> 8;
+    rec[2] = profile;
+    rec[3] = type;
+    rec[4] = len & 0xFF;
+    rec[5] = len >> 8;
+    memcpy(rec + 8, &seq, 4);
+    if (len) memcpy(rec + NONCE_LOG_HEADER_SIZE, data, len);
+    uint32_t rec_crc = recordCrc(rec, rec + NONCE_LOG_HEADER_SIZE, len);
+    memcpy(rec + 12, &rec_crc, 4);
+
+    uint32_t offset = write_sector * NONCE_LOG_SECTOR_SIZE + write_pos;
+    esp_err_t err = esp_partition_write(partition, offset, rec, size);
+    write_pos += size;  // A failed write still consumed the slot
+    if (err != ESP_OK) {
+        Serial.printf(">>> ERROR: Nonce log write failed (%d) for Profile %d\n", err, profile);
+        return false;
+    }
+
+    Entry& e = index[profile][type];
+    e.seq = seq;
+    e.len = len;
+    e.offset = len ? offset : NONE;
+    e.crc = crc;
+    appends++;
+    return true;
+}
+
+// ============================================================================
+// COMPACTION
+// ============================================================================
+
+bool NonceLog::advanceSector() {
+    // The sector after the write sector is erased unless a compaction could not finish
+    uint32_t next = (write_sector + 1) % sector_count;
+    if (!sectorIsErased(next)) return false;
+
+    write_sector = next;
+    write_pos = NONCE_LOG_HEADER_SIZE;
+    writeSectorHeader(write_sector, ++sector_seq);
+
+    // Restore the spare from the oldest sector. Its live records fit in the
+    // empty write sector, as they did in the sector they come from.
+    return restoreSpare();
+}
+
+bool NonceLog::restoreSpare() {
+    uint32_t spare = (write_sector + 1) % sector_count;
+    if (sectorIsErased(spare)) return true;
+
+    // Records that could not be moved are still current: keep the sector
+    if (!relocate(spare)) {
+        Serial.printf(">>> ERROR: Nonce log sector %lu kept - its live records did not fit\n", (unsigned long)spare);
+        return false;
+    }
+    esp_partition_erase_range(partition, spare * NONCE_LOG_SECTOR_SIZE, NONCE_LOG_SECTOR_SIZE);
+    compactions++;
+    return true;
+}
+
+bool NonceLog::relocate(uint32_t sector) {
+    uint32_t base = sector * NONCE_LOG_SECTOR_SIZE;
+    uint8_t* buf = (uint8_t*)malloc(NONCE_LOG_SECTOR_SIZE);
+    if (!buf) return false;
+    esp_partition_read(partition, base, buf, NONCE_LOG_SECTOR_SIZE);
+
+    const uint32_t* header = (const uint32_t*)buf;
+    bool complete = true;
+    if (header[0] == NONCE_LOG_SECTOR_MAGIC && header[3] == esp_rom_crc32_le(0, buf, 8)) {
+        relocating = true;
+        int moved = 0;
+        uint32_t pos = NONCE_LOG_HEADER_SIZE;
+        while (pos + NONCE_LOG_HEADER_SIZE <= NONCE_LOG_SECTOR_SIZE) {
+            const uint8_t* rec = buf + pos;
+            uint16_t len = rec[4] | (rec[5] << 8);
+            if ((rec[0] | (rec[1] << 8)) != NONCE_LOG_RECORD_MAGIC || len > NONCE_LOG_MAX_PAYLOAD ||
+                pos + recordSize(len) > NONCE_LOG_SECTOR_SIZE) {
+                break;
+            }
+            uint32_t seq, crc;
+            memcpy(&seq, rec + 8, 4);
+            memcpy(&crc, rec + 12, 4);
+            uint8_t profile = rec[2];
+            uint8_t type = rec[3];
+
+            // Current records only; a deletion is kept while it is the newest record of its key
+            if (profile < MAX_LORA_PROFILES && type < NONCE_LOG_TYPE_COUNT &&
+                index[profile][type].seq == seq && crc == recordCrc(rec, rec + NONCE_LOG_HEADER_SIZE, len)) {
+                if (append(profile, type, rec + NONCE_LOG_HEADER_SIZE, len, index[profile][type].crc)) {
+                    moved++;
+                } else {
+                    complete = false;
+                }
+            }
+            pos += recordSize(len);
+        }
+        relocating = false;
+        Serial.printf(">>> Nonce log: compacted sector %lu (%d live record(s) moved)\n", (unsigned long)sector, moved);
+    }
+    free(buf);
+    return complete;
+}
+
+bool NonceLog::holdsOnlyCopies(uint32_t sector, uint32_t source) const {
+    uint8_t* buf = (uint8_t*)malloc(2 * NONCE_LOG_SECTOR_SIZE);
+    if (!buf) return false;
+    uint8_t* src = buf + NONCE_LOG_SECTOR_SIZE;
+    esp_partition_read(partition, sector * NONCE_LOG_SECTOR_SIZE, buf, NONCE_LOG_SECTOR_SIZE);
+    esp_partition_read(partition, source * NONCE_LOG_SECTOR_SIZE, src, NONCE_LOG_SECTOR_SIZE);
+
+    // Every intact record must have an intact twin (same key and payload) in `source`
+    bool copies = true;
+    for (uint32_t pos = NONCE_LOG_HEADER_SIZE; copies && pos + NONCE_LOG_HEADER_SIZE <= NONCE_LOG_SECTOR_SIZE; ) {
+        const uint8_t* rec = buf + pos;
+        uint16_t len = rec[4] | (rec[5] << 8);
+        if ((rec[0] | (rec[1] << 8)) != NONCE_LOG_RECORD_MAGIC || len > NONCE_LOG_MAX_PAYLOAD ||
+            pos + recordSize(len) > NONCE_LOG_SECTOR_SIZE) {
+            break;
+        }
+        uint32_t crc;
+        memcpy(&crc, rec + 12, 4);
+        if (crc == recordCrc(rec, rec + NONCE_LOG_HEADER_SIZE, len)) {
+            copies = false;
+            for (uint32_t p = NONCE_LOG_HEADER_SIZE; !copies && p + NONCE_LOG_HEADER_SIZE <= NONCE_LOG_SECTOR_SIZE; ) {
+                const uint8_t* twin = src + p;
+                uint16_t twin_len = twin[4] | (twin[5] << 8);
+                if ((twin[0] | (twin[1] << 8)) != NONCE_LOG_RECORD_MAGIC || twin_len > NONCE_LOG_MAX_PAYLOAD ||
+                    p + recordSize(twin_len) > NONCE_LOG_SECTOR_SIZE) {
+                    break;
+                }
+                uint32_t twin_crc;
+                memcpy(&twin_crc, twin + 12, 4);
+                copies = twin[2] == rec[2] && twin[3] == rec[3] && twin_len == len &&
+                         twin_crc == recordCrc(twin, twin + NONCE_LOG_HEADER_SIZE, twin_len) &&
+                         memcmp(twin + NONCE_LOG_HEADER_SIZE, rec + NONCE_LOG_HEADER_SIZE, len) == 0;
+                p += recordSize(twin_len);
+            }
+        }
+        pos += recordSize(len);
+    }
+    free(buf);
+    return copies;
+}
+
+bool NonceLog::writeSectorHeader(uint32_t sector, uint32_t seq) {
+    uint32_t header[4] = { NONCE_LOG_SECTOR_MAGIC, seq, 0xFFFFFFFFUL, 0 };
+    header[3] = esp_rom_crc32_le(0, (const uint8_t*)header, 8);
+    return esp_partition_write(partition, sector * NONCE_LOG_SECTOR_SIZE, header, sizeof(header)) == ESP_OK;
+}
+
+bool NonceLog::sectorIsErased(uint32_t sector) const {
+    uint32_t words[64];
+    for (uint32_t off = 0; off < NONCE_LOG_SECTOR_SIZE; off += sizeof(words)) {
+        if (esp_partition_read(partition, sector * NONCE_LOG_SECTOR_SIZE + off, words, sizeof(words)) != ESP_OK) {
+            return false;
+        }
+        for (size_t i = 0; i < sizeof(words) / 4; i++) {
+            if (words[i] != 0xFFFFFFFFUL) return false;
+        }
+    }
+    return true;
+}
+
+uint32_t NonceLog::recordSize(uint16_t len) {
+    return NONCE_LOG_HEADER_SIZE + ((len + 3) & ~3u);
+}
+
+uint32_t NonceLog::recordCrc(const uint8_t* header, const uint8_t* data, uint16_t len) {
+    uint32_t crc = esp_rom_crc32_le(0, header, 12);
+    return esp_rom_crc32_le(crc, data, len);
+}
+
+// ============================================================================
+// STATUS
+// ============================================================================
+
+uint32_t NonceLog::getAppendCount() const {
+    return appends;
+}
+
+uint32_t NonceLog::getSkippedCount() const {
+    return skipped;
+}
+
+uint32_t NonceLog::getCompactionCount() const {
+    return compactions;
+}
+
+void NonceLog::printStatus() const {
+    if (!partition) return;
+    int live = 0;
+    for (int p = 0; p < MAX_LORA_PROFILES; p++) {
+        for (int t = 0; t < NONCE_LOG_TYPE_COUNT; t++) {
+            if (index[p][t].offset != NONE) live++;
+        }
+    }
+    Serial.printf(">>> Nonce log: %lu x 4 KB sectors, write sector %lu at +%lu, %d live record(s), next seq %lu\n",
+        (unsigned long)sector_count, (unsigned long)write_sector, (unsigned long)write_pos,
+        live, (unsigned long)next_seq);
+}
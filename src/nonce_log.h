@@ -0,0 +1,122 @@
+#ifndef NONCE_LOG_H
+#define NONCE_LOG_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "config.h"
+
+// ============================================================================
+// NONCE LOG (APPEND-ONLY, DEDICATED PARTITION)
+// ============================================================================
+// DevNonces and sessions (frame counters) of every profile are appended to the
+// "noncelog" data partition (partitions.csv) instead of being rewritten as NVS
+// blobs after each join and uplink. Appending is a single flash write: no
+// erase, no read-back; the record CRC is what detects a torn write.
+//
+// Layout: 4 KB sectors used as a ring. Each sector starts with a header
+// (magic, sector sequence), followed by records:
+//   0-1    Magic (NONCE_LOG_RECORD_MAGIC)
+//   2      Profile index
+//   3      Record type (NONCE_LOG_NONCES / NONCE_LOG_SESSION)
+//   4-5    Payload length (0 = record deleted)
+//   6-7    Reserved (0xFFFF)
+//   8-11   Global sequence number
+//   12-15  CRC32 of bytes 0-11 and the payload
+//   16-    Payload, padded to 4 bytes
+// The record with the highest sequence wins. A RAM index (profile x type ->
+// flash offset) is rebuilt by one scan at boot, so reads and appends are O(1).
+//
+// Compaction: one sector is always kept erased. Moving into it erases the
+// oldest sector after copying the records in it that are still current; a
+// sector whose records could not all be copied is never erased. An append
+// that still does not fit compacts the next sector, at most once round the
+// ring: NONCE_LOG_MIN_SECTORS guarantees that is enough.
+
+#define NONCE_LOG_PARTITION        "noncelog"
+#define NONCE_LOG_SUBTYPE          0x40   // Custom data subtype (partitions.csv)
+#define NONCE_LOG_SECTOR_SIZE      4096
+#define NONCE_LOG_SECTOR_MAGIC     0x474F4C4EUL   // "NLOG"
+#define NONCE_LOG_RECORD_MAGIC     0x4C4E
+#define NONCE_LOG_HEADER_SIZE      16     // Sector header and record header
+#define NONCE_LOG_MAX_PAYLOAD      512    // Largest record is a RadioLib session buffer
+#define NONCE_LOG_MAX_RECORD       (NONCE_LOG_HEADER_SIZE + NONCE_LOG_MAX_PAYLOAD)
+
+// Every current record (one per profile and type) plus the one being appended,
+// all of maximum size, must fit in the sectors besides the spare even if each
+// ends with a gap just short of a record: 21 sectors for 64 profiles. Smaller
+// partitions are not used (begin() returns false, NVS keeps the data).
+#define NONCE_LOG_MIN_SECTORS \
+    (1 + ((MAX_LORA_PROFILES * NONCE_LOG_TYPE_COUNT + 1) * NONCE_LOG_MAX_RECORD + \
+          (NONCE_LOG_SECTOR_SIZE - NONCE_LOG_HEADER_SIZE - NONCE_LOG_MAX_RECORD) - 1) / \
+         (NONCE_LOG_SECTOR_SIZE - NONCE_LOG_HEADER_SIZE - NONCE_LOG_MAX_RECORD))
+
+enum NonceLogRecordType : uint8_t {
+    NONCE_LOG_NONCES = 0,
+    NONCE_LOG_SESSION = 1,
+    NONCE_LOG_TYPE_COUNT
+};
+
+class NonceLog {
+public:
+    NonceLog();
+
+    // Find the partition and rebuild the index. False: no usable partition
+    // (old partition table) - callers keep the NVS path.
+    bool begin();
+    bool isActive() const;
+
+    // Append a record. Skipped (returns true) if it equals the current one.
+    bool write(uint8_t profile, NonceLogRecordType type, const uint8_t* data, uint16_t len);
+    // Current record; false if missing or of a different length
+    bool read(uint8_t profile, NonceLogRecordType type, uint8_t* data, uint16_t len) const;
+    bool has(uint8_t profile, NonceLogRecordType type) const;
+    void remove(uint8_t profile, NonceLogRecordType type);
+    // Erase every record of every profile
+    void clear();
+
+    uint32_t getAppendCount() const;
+    uint32_t getSkippedCount() const;
+    uint32_t getCompactionCount() const;
+    void printStatus() const;
+
+private:
+    struct Entry {
+        uint32_t offset;   // NONE: no current record (deleted or never written)
+        uint32_t seq;      // Sequence of the newest record seen, deleted or not
+        uint32_t crc;
+        uint16_t len;
+    };
+
+    static const uint32_t NONE = 0xFFFFFFFFUL;
+
+    const esp_partition_t* partition;
+    uint32_t sector_count;
+    uint32_t write_sector;
+    uint32_t write_pos;      // Offset within write_sector
+    uint32_t sector_seq;     // Sequence of write_sector
+    uint32_t next_seq;       // Next record sequence
+    uint32_t appends;
+    uint32_t skipped;
+    uint32_t compactions;
+    bool relocating;
+    Entry index[MAX_LORA_PROFILES][NONCE_LOG_TYPE_COUNT];
+
+    void resetIndex();
+    void format();
+    void scanSector(uint32_t sector, bool is_write_sector);
+    bool append(uint8_t profile, uint8_t type, const uint8_t* data, uint16_t len, uint32_t crc);
+    bool advanceSector();             // False if the next sector could not be freed
+    bool restoreSpare();              // Compact the sector after the write sector
+    bool relocate(uint32_t sector);   // False if a live record did not fit
+    bool holdsOnlyCopies(uint32_t sector, uint32_t source) const;
+    bool writeSectorHeader(uint32_t sector, uint32_t seq);
+    bool sectorIsErased(uint32_t sector) const;
+
+    static uint32_t recordSize(uint16_t len);
+    static uint32_t recordCrc(const uint8_t* header, const uint8_t* data, uint16_t len);
+};
+
+// Global instance
+extern NonceLog nonceLog;
+
+#endif // NONCE_LOG_H
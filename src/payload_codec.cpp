@@ -0,0 +1,303 @@
+#include "payload_codec.h"
+#include "modbus_registers.h"
+#include "sample_batch.h"
+#include "payload_map.h"
+#include <string.h>
+
+// ============================================================================
+// DESCRIPTOR HELPERS
+// ============================================================================
+
+static constexpr PayloadField constant8(const char* name, uint8_t offset, uint8_t value) {
+    return PayloadField{ name, "", offset, 1, FIELD_UNSIGNED, ORDER_BIG_ENDIAN, SRC_CONSTANT, value, 1, 0.0 };
+}
+
+static constexpr PayloadField u8(const char* name, uint8_t offset, PayloadSource source,
+                                 const char* unit = "") {
+    return PayloadField{ name, unit, offset, 1, FIELD_UNSIGNED, ORDER_BIG_ENDIAN, source, 0, 1, 0.0 };
+}
+
+static constexpr PayloadField u16be(const char* name, uint8_t offset, PayloadSource source,
+                                    uint16_t divisor = 1, double bias = 0.0, const char* unit = "") {
+    return PayloadField{ name, unit, offset, 2, FIELD_UNSIGNED, ORDER_BIG_ENDIAN, source, 0, divisor, bias };
+}
+
+static constexpr PayloadField s16be(const char* name, uint8_t offset, PayloadSource source,
+                                    uint16_t divisor, const char* unit) {
+    return PayloadField{ name, unit, offset, 2, FIELD_SIGNED, ORDER_BIG_ENDIAN, source, 0, divisor, 0.0 };
+}
+
+static constexpr PayloadField f32le(const char* name, uint8_t offset, PayloadSource source,
+                                    uint16_t divisor, double bias, const char* unit) {
+    return PayloadField{ name, unit, offset, 4, FIELD_FLOAT, ORDER_LITTLE_ENDIAN, source, 0, divisor, bias };
+}
+
+template <typename T, size_t N>
+static constexpr size_t countOf(const T (&)[N]) {
+    return N;
+}
+
+// Frame size = end of the last byte any field covers
+static constexpr size_t layoutSize(const PayloadField* fields, size_t count) {
+    return count == 0 ? 0
+        : (fields[count - 1].offset + fields[count - 1].width > layoutSize(fields, count - 1)
+            ? fields[count - 1].offset + fields[count - 1].width
+            : layoutSize(fields, count - 1));
+}
+
+// ============================================================================
+// FORMAT DESCRIPTORS
+// ============================================================================
+
+// Adeunis Modbus SF6 (10 bytes). The decoder skips the counter.
+static constexpr PayloadField ADEUNIS_FIELDS[] = {
+    u16be("Uplink count",      0, SRC_UPLINK_COUNT),
+    u16be("SF6 density",       2, SRC_DENSITY,      100,  0.0,     "kg/m³"),
+    u16be("SF6 pressure @20C", 4, SRC_PRESSURE_20C, 1000, 0.0,     "bar"),
+    u16be("SF6 temperature",   6, SRC_TEMPERATURE,  10,   -273.15, "°C"),
+    u16be("SF6 pressure var",  8, SRC_PRESSURE_VAR, 1000, 0.0,     "bar"),
+};
+
+// Cayenne LPP (12 bytes): temperature (0x67, 0.1 °C) and two analog inputs (0x02, 0.01)
+static constexpr PayloadField CAYENNE_FIELDS[] = {
+    constant8("Ch1 channel", 0, 1),
+    constant8("Ch1 type",    1, 0x67),
+    s16be("Temperature",     2, SRC_TEMPERATURE_DC,   10,  "°C"),
+    constant8("Ch2 channel", 4, 2),
+    constant8("Ch2 type",    5, 0x02),
+    s16be("Pressure",        6, SRC_PRESSURE_20C_KPA, 100, "bar"),
+    constant8("Ch3 channel", 8, 3),
+    constant8("Ch3 type",    9, 0x02),
+    s16be("Density",         10, SRC_DENSITY,         100, "kg/m³"),
+};
+
+// Raw Modbus registers (10 bytes), values exactly as read over Modbus
+static constexpr PayloadField RAW_MODBUS_FIELDS[] = {
+    u16be("Uplink count",            0, SRC_UPLINK_COUNT),
+    u16be("SF6 density (raw)",       2, SRC_DENSITY),
+    u16be("SF6 pressure @20C (raw)", 4, SRC_PRESSURE_20C),
+    u16be("SF6 temperature (raw)",   6, SRC_TEMPERATURE),
+    u16be("SF6 pressure var (raw)",  8, SRC_PRESSURE_VAR),
+};
+
+// Custom (13 bytes): format id and three little-endian floats in physical units
+static constexpr PayloadField CUSTOM_FIELDS[] = {
+    constant8("Format id", 0, 0xFF),
+    f32le("Temperature",   1, SRC_TEMPERATURE,  10,   -273.15, "°C"),
+    f32le("Pressure",      5, SRC_PRESSURE_20C, 1000, 0.0,     "bar"),
+    f32le("Density",       9, SRC_DENSITY,      100,  0.0,     "kg/m³"),
+};
+
+// Vistron LoRa Mod Con frame type 3 (16 bytes): 8-byte header, then the
+// Trafag H72517o registers. Current absolute pressure carries the pressure
+// variance register (the emulator has no separate field).
+static constexpr PayloadField VISTRON_FIELDS[] = {
+    constant8("Frame type",      0, 0x03),
+    constant8("Status",          1, 0x00),
+    constant8("Error code",      2, 0x00),
+    u16be("Uplink count",        3, SRC_UPLINK_COUNT),
+    constant8("Reserved",        5, 0x00),
+    constant8("Reserved",        6, 0x00),
+    constant8("Modbus length",   7, 0x08),
+    u16be("Density",             8,  SRC_DENSITY,      100,  0.0,     "kg/m³"),
+    u16be("Pressure @20C",       10, SRC_PRESSURE_20C, 1000, 0.0,     "bar"),
+    u16be("Temperature",         12, SRC_TEMPERATURE,  10,   -273.15, "°C"),
+    u16be("Absolute pressure",   14, SRC_PRESSURE_VAR, 1000, 0.0,     "bar"),
+};
+
+// Batched delta: fixed header only, the deltas follow (see sample_batch.h)
+static constexpr PayloadField BATCH_HEADER_FIELDS[] = {
+    constant8("Version",         0, BATCH_FORMAT_VERSION),
+    u8("Samples",                1, SRC_BATCH_HEADER),
+    u16be("Interval",            2, SRC_BATCH_HEADER, 1, 0.0, "s"),
+    u16be("Newest sample age",   4, SRC_BATCH_HEADER, 1, 0.0, "s"),
+    u16be("Oldest density",      6,  SRC_BATCH_HEADER, 100,  0.0,     "kg/m³"),
+    u16be("Oldest pressure",     8,  SRC_BATCH_HEADER, 1000, 0.0,     "bar"),
+    u16be("Oldest temperature",  10, SRC_BATCH_HEADER, 10,   -273.15, "°C"),
+    u16be("Oldest pressure var", 12, SRC_BATCH_HEADER, 1000, 0.0,     "bar"),
+};
+
+static_assert(layoutSize(ADEUNIS_FIELDS, countOf(ADEUNIS_FIELDS)) == 10, "Adeunis frame is 10 bytes");
+static_assert(layoutSize(CAYENNE_FIELDS, countOf(CAYENNE_FIELDS)) == 12, "Cayenne frame is 12 bytes");
+static_assert(layoutSize(RAW_MODBUS_FIELDS, countOf(RAW_MODBUS_FIELDS)) == 10, "Raw Modbus frame is 10 bytes");
+static_assert(layoutSize(CUSTOM_FIELDS, countOf(CUSTOM_FIELDS)) == 13, "Custom frame is 13 bytes");
+static_assert(layoutSize(VISTRON_FIELDS, countOf(VISTRON_FIELDS)) == 16, "Vistron frame is 16 bytes");
+static_assert(layoutSize(BATCH_HEADER_FIELDS, countOf(BATCH_HEADER_FIELDS)) == BATCH_HEADER_SIZE,
+              "Batch header descriptors out of sync with sample_batch.h");
+
+// ============================================================================
+// ENCODERS
+// ============================================================================
+
+static inline int32_t sourceValue(PayloadSource source, const PayloadContext& ctx) {
+    switch (source) {
+        case SRC_UPLINK_COUNT:     return (int32_t)ctx.uplink_count;
+        case SRC_DENSITY:          return ctx.input->sf6_density;
+        case SRC_PRESSURE_20C:     return ctx.input->sf6_pressure_20c;
+        case SRC_TEMPERATURE:      return ctx.input->sf6_temperature;
+        case SRC_PRESSURE_VAR:     return ctx.input->sf6_pressure_var;
+        // Integer arithmetic: float scaling lost a count at exact multiples (1.03 bar -> 102)
+        case SRC_TEMPERATURE_DC:   return ((int32_t)ctx.input->sf6_temperature * 10 - 27315) / 10;
+        case SRC_PRESSURE_20C_KPA: return ctx.input->sf6_pressure_20c / 10;
+        default:                   return 0;
+    }
+}
+
+// Descriptor is a compile-time constant in every caller, so the branches and
+// the byte loop fold away
+static inline void writeField(uint8_t* out, const PayloadField& field, const PayloadContext& ctx) {
+    uint32_t bits;
+    if (field.source == SRC_CONSTANT) {
+        bits = (uint32_t)field.constant;
+    } else if (field.kind == FIELD_FLOAT) {
+        float value = sourceValue(field.source, ctx) / (double)field.divisor + field.bias;
+        memcpy(&bits, &value, sizeof(bits));
+    } else {
+        bits = (uint32_t)sourceValue(field.source, ctx);
+    }
+
+    uint8_t* p = out + field.offset;
+    for (uint8_t i = 0; i < field.width; i++) {
+        uint8_t shift = (field.order == ORDER_BIG_ENDIAN) ? 8 * (field.width - 1 - i) : 8 * i;
+        p[i] = (bits >> shift) & 0xFF;
+    }
+}
+
+// Unrolls a descriptor table into one writeField() per field
+template <const PayloadField* Fields, size_t I, size_t Count>
+struct FieldWriter {
+    static inline void write(uint8_t* out, const PayloadContext& ctx) {
+        writeField(out, Fields[I], ctx);
+        FieldWriter<Fields, I + 1, Count>::write(out, ctx);
+    }
+};
+
+template <const PayloadField* Fields, size_t Count>
+struct FieldWriter<Fields, Count, Count> {
+    static inline void write(uint8_t*, const PayloadContext&) {}
+};
+
+template <const PayloadField* Fields, size_t Count>
+static size_t encodeFixed(uint8_t* out, size_t max_len, PayloadContext& ctx) {
+    constexpr size_t size = layoutSize(Fields, Count);
+    if (size > max_len) return 0;
+    if (out) FieldWriter<Fields, 0, Count>::write(out, ctx);
+    return size;
+}
+
+static size_t encodeBatchedDelta(uint8_t* out, size_t max_len, PayloadContext& ctx) {
+    if (!ctx.batcher) return 0;
+    size_t size = ctx.batcher->encode(ctx.profile, out, max_len, ctx.now,
+                                       &ctx.batch_seq, &ctx.batch_first);
+    ctx.batch_used = (size > 0);
+    return size;
+}
+
+// User mapping: runs the program compiled from the web form
+static size_t encodeUserMap(uint8_t* out, size_t max_len, PayloadContext& ctx) {
+    if (!ctx.map || ctx.map->getSize() > max_len) return 0;
+    if (!out) return ctx.map->getSize();
+
+    // Both register structs hold their Modbus register words in order
+    // (little-endian: uptime low word first, as registers 2-3)
+    uint16_t input[PAYLOAD_MAP_INPUT_REGS];
+    uint16_t holding[PAYLOAD_MAP_HOLDING_REGS] = {};
+    memcpy(input, ctx.input, sizeof(input));
+    if (ctx.holding) memcpy(holding, ctx.holding, sizeof(holding));
+
+    PayloadMapInputs in = { input, holding, ctx.uplink_count };
+    return ctx.map->encode(out, max_len, in);
+}
+
+static_assert(sizeof(InputRegisters) == PAYLOAD_MAP_INPUT_REGS * sizeof(uint16_t),
+              "Input registers out of sync with payload_map.h");
+static_assert(offsetof(HoldingRegisters, wifi_clients) == (PAYLOAD_MAP_HOLDING_REGS - 1) * sizeof(uint16_t),
+              "Holding registers out of sync with payload_map.h");
+
+// ============================================================================
+// REGISTRY (INDEXED BY PayloadType)
+// ============================================================================
+
+#define FIXED_CODEC(fields) \
+    { PAYLOAD_DEFAULT_FPORT, (uint8_t)layoutSize(fields, countOf(fields)), fields, \
+      (uint8_t)countOf(fields), encodeFixed<fields, countOf(fields)> }
+
+static const PayloadCodec PAYLOAD_CODECS[] = {
+    FIXED_CODEC(ADEUNIS_FIELDS),     // PAYLOAD_ADEUNIS_MODBUS_SF6
+    FIXED_CODEC(CAYENNE_FIELDS),     // PAYLOAD_CAYENNE_LPP
+    FIXED_CODEC(RAW_MODBUS_FIELDS),  // PAYLOAD_RAW_MODBUS
+    FIXED_CODEC(CUSTOM_FIELDS),      // PAYLOAD_CUSTOM
+    FIXED_CODEC(VISTRON_FIELDS),     // PAYLOAD_VISTRON_LORA_MOD_CON
+    // PAYLOAD_BATCHED_DELTA: typical size is 10 samples (airtime estimates size the real frame)
+    { LORAWAN_BATCH_FPORT, 50, BATCH_HEADER_FIELDS, (uint8_t)countOf(BATCH_HEADER_FIELDS), encodeBatchedDelta },
+    // PAYLOAD_USER_MAP: typical size is the default layout
+    { LORAWAN_MAP_FPORT, 10, nullptr, 0, encodeUserMap },
+};
+
+static_assert(countOf(PAYLOAD_CODECS) == PAYLOAD_TYPE_COUNT, "One codec per PayloadType");
+static_assert(countOf(PAYLOAD_TYPE_NAMES) == PAYLOAD_TYPE_COUNT, "One name per PayloadType");
+
+const PayloadCodec& PayloadCodecs::get(PayloadType type) {
+    if ((unsigned)type >= PAYLOAD_TYPE_COUNT) type = PAYLOAD_ADEUNIS_MODBUS_SF6;
+    return PAYLOAD_CODECS[type];
+}
+
+size_t PayloadCodecs::fieldsSize(const PayloadCodec& codec) {
+    return layoutSize(codec.fields, codec.field_count);
+}
+
+int32_t PayloadCodecs::sourceValue(PayloadSource source, const PayloadContext& ctx) {
+    return ::sourceValue(source, ctx);
+}
+
+// ============================================================================
+// DECODING
+// ============================================================================
+
+uint32_t PayloadCodecs::readRaw(const PayloadField& field, const uint8_t* frame) {
+    const uint8_t* p = frame + field.offset;
+    uint32_t bits = 0;
+    for (uint8_t i = 0; i < field.width; i++) {
+        uint8_t byte = (field.order == ORDER_BIG_ENDIAN) ? p[i] : p[field.width - 1 - i];
+        bits = (bits << 8) | byte;
+    }
+    return bits;
+}
+
+int32_t PayloadCodecs::readStored(const PayloadField& field, const uint8_t* frame) {
+    uint32_t bits = readRaw(field, frame);
+    if (field.kind == FIELD_SIGNED && field.width < 4) {
+        uint32_t sign = 1UL << (8 * field.width - 1);
+        return (int32_t)(bits ^ sign) - (int32_t)sign;
+    }
+    return (int32_t)bits;
+}
+
+double PayloadCodecs::readValue(const PayloadField& field, const uint8_t* frame) {
+    if (field.kind == FIELD_FLOAT) {
+        uint32_t bits = readRaw(field, frame);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    int32_t stored = readStored(field, frame);
+    double value = (field.kind == FIELD_UNSIGNED) ? (double)(uint32_t)stored : (double)stored;
+    return value / field.divisor + field.bias;
+}
+
+size_t PayloadCodecs::decode(PayloadType type, const uint8_t* frame, size_t len,
+                             double* values, size_t max_values) {
+    const PayloadCodec& codec = get(type);
+    if (len < layoutSize(codec.fields, codec.field_count) || max_values < codec.field_count) {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < codec.field_count; i++) {
+        const PayloadField& field = codec.fields[i];
+        if (field.source == SRC_CONSTANT && readStored(field, frame) != field.constant) {
+            return 0;
+        }
+        values[i] = readValue(field, frame);
+    }
+    return codec.field_count;
+}
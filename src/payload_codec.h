@@ -0,0 +1,133 @@
+#ifndef PAYLOAD_CODEC_H
+#define PAYLOAD_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+struct InputRegisters;
+struct HoldingRegisters;
+class SampleBatcher;
+class PayloadMap;
+
+// ============================================================================
+// PAYLOAD CODEC REGISTRY
+// ============================================================================
+// Every uplink format is declared once in payload_codec.cpp as a constexpr
+// table of field descriptors (offset, width, kind, byte order, source, scale).
+// The encoder of a fixed-layout format is a template instantiated over its
+// table and unrolled at compile time into plain byte stores; the generic
+// decoder reads frames back through the same table, so the firmware encoder
+// and any host-side check can never disagree about the layout.
+//
+// Formats whose layout depends on runtime data (batched delta) supply their
+// own encoder and describe only their fixed header. The user mapping is
+// compiled at runtime (payload_map.h) and has no descriptors here.
+//
+// Adding a format: a PayloadType value and name in config.h plus one entry in
+// PAYLOAD_CODECS. Nothing in the uplink path changes.
+//
+// Scaling: physical value = stored / divisor + bias. Integer fields carry the
+// stored value; float fields carry the physical value (IEEE 754 single).
+
+enum PayloadFieldKind : uint8_t {
+    FIELD_UNSIGNED,
+    FIELD_SIGNED,
+    FIELD_FLOAT     // Width 4
+};
+
+enum PayloadByteOrder : uint8_t {
+    ORDER_BIG_ENDIAN,
+    ORDER_LITTLE_ENDIAN
+};
+
+enum PayloadSource : uint8_t {
+    SRC_CONSTANT,          // PayloadField::constant
+    SRC_UPLINK_COUNT,      // Uplinks sent since boot (truncated to the field width)
+    SRC_DENSITY,           // Input register, kg/m3 x100
+    SRC_PRESSURE_20C,      // Input register, kPa x10 (= bar x1000)
+    SRC_TEMPERATURE,       // Input register, K x10
+    SRC_PRESSURE_VAR,      // Input register, kPa x10
+    SRC_TEMPERATURE_DC,    // Temperature in 0.1 degC (signed, truncated toward zero)
+    SRC_PRESSURE_20C_KPA,  // Pressure @20C in kPa (= bar x100)
+    SRC_BATCH_HEADER       // Written by the batched encoder (decode only)
+};
+
+struct PayloadField {
+    const char* name;
+    const char* unit;      // Empty: printed without scaling
+    uint8_t offset;
+    uint8_t width;         // 1, 2 or 4 bytes
+    PayloadFieldKind kind;
+    PayloadByteOrder order;
+    PayloadSource source;
+    int32_t constant;      // SRC_CONSTANT only
+    uint16_t divisor;
+    double bias;
+};
+
+// Inputs of one uplink. Encoders report what they consumed back through it.
+struct PayloadContext {
+    const InputRegisters* input;
+    const HoldingRegisters* holding;  // User mapping only
+    const PayloadMap* map;            // User mapping only
+    uint32_t uplink_count;
+    uint8_t profile;
+    unsigned long now;
+    const SampleBatcher* batcher;
+    bool batch_used;       // Out: frame carries batched samples batch_first..batch_seq
+    uint32_t batch_seq;
+    uint32_t batch_first;
+};
+
+#define PAYLOAD_DEFAULT_FPORT 1    // All fixed formats; batched and mapped frames have their own
+
+// Encoder: writes at most max_len bytes and returns the frame size, 0 if the
+// frame does not fit. out == nullptr only computes the size.
+typedef size_t (*PayloadEncoder)(uint8_t* out, size_t max_len, PayloadContext& ctx);
+
+struct PayloadCodec {
+    uint8_t fport;
+    uint8_t size;                 // Fixed size, or typical size of a variable format
+    const PayloadField* fields;   // Whole frame, or fixed header of a variable format
+    uint8_t field_count;
+    PayloadEncoder encode;
+};
+
+class PayloadCodecs {
+public:
+    // Unknown types resolve to the default format (Adeunis Modbus SF6)
+    static const PayloadCodec& get(PayloadType type);
+
+    // Bytes the descriptor fields cover (the whole frame of a fixed format, the
+    // header of a variable one)
+    static size_t fieldsSize(const PayloadCodec& codec);
+
+    // Value a field's source takes for `ctx`, before scaling
+    static int32_t sourceValue(PayloadSource source, const PayloadContext& ctx);
+
+    // Field access through the descriptors; `frame` must hold offset + width bytes
+    static uint32_t readRaw(const PayloadField& field, const uint8_t* frame);
+    static int32_t readStored(const PayloadField& field, const uint8_t* frame);
+    static double readValue(const PayloadField& field, const uint8_t* frame);
+
+    // Physical value of every field into `values`. Returns the field count, or 0
+    // if the frame is too short or a constant field does not match.
+    static size_t decode(PayloadType type, const uint8_t* frame, size_t len,
+                         double* values, size_t max_values);
+
+    // Field-by-field dump (debugging; kept out of the uplink path unless
+    // LORAWAN_PAYLOAD_BREAKDOWN is set). `map` is the user mapping.
+    static void printBreakdown(PayloadType type, const uint8_t* frame, size_t len,
+                               const PayloadMap* map = nullptr);
+
+    // Golden vectors (test/golden_vectors.json, also checked by the decoders and
+    // test/test_payload_codec), descriptor round trip over fuzzed registers, the
+    // default user mapping against the Raw Modbus frames and an encoder
+    // throughput benchmark. Boot-time check behind LORAWAN_CODEC_SELFTEST;
+    // returns false on any mismatch.
+    // printBreakdown() and selfTest() live in payload_diagnostics.cpp (Serial/log).
+    static bool selfTest();
+};
+
+#endif // PAYLOAD_CODEC_H
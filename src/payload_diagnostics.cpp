@@ -0,0 +1,232 @@
+#include "payload_codec.h"
+#include "payload_golden.h"
+#include "payload_map.h"
+#include "modbus_registers.h"
+#include "logger.h"
+
+// Serial and log output of the codecs, kept apart from payload_codec.cpp so the
+// encoders build on the host (test/test_payload_codec)
+
+// ============================================================================
+// DIAGNOSTICS
+// ============================================================================
+
+void PayloadCodecs::printBreakdown(PayloadType type, const uint8_t* frame, size_t len,
+                                   const PayloadMap* map) {
+    if (type == PAYLOAD_USER_MAP) {
+        if (!map || len < map->getSize()) {
+            LOG_I(LOG_CODEC, "Payload breakdown: frame too short (%u bytes)", (unsigned)len);
+            return;
+        }
+        LOG_I(LOG_CODEC, "Payload breakdown (%s):", PAYLOAD_TYPE_NAMES[type]);
+        for (uint8_t i = 0; i < map->getFieldCount(); i++) {
+            LOG_I(LOG_CODEC, "  %s: %lu (%.3f)", map->getField(i).name,
+                (unsigned long)map->readStored(i, frame), map->decodeField(i, frame));
+        }
+        return;
+    }
+
+    const PayloadCodec& codec = get(type);
+    if (len < fieldsSize(codec)) {
+        LOG_I(LOG_CODEC, "Payload breakdown: frame too short (%u bytes)", (unsigned)len);
+        return;
+    }
+
+    LOG_I(LOG_CODEC, "Payload breakdown (%s):", PAYLOAD_TYPE_NAMES[(unsigned)type < PAYLOAD_TYPE_COUNT ? type : 0]);
+    for (uint8_t i = 0; i < codec.field_count; i++) {
+        const PayloadField& field = codec.fields[i];
+        if (field.source == SRC_CONSTANT) continue;
+
+        if (field.kind == FIELD_FLOAT) {
+            LOG_I(LOG_CODEC, "  %s: %.3f %s", field.name, readValue(field, frame), field.unit);
+        } else if (field.unit[0] == '\0') {
+            LOG_I(LOG_CODEC, "  %s: %ld", field.name, (long)readStored(field, frame));
+        } else {
+            // One decimal per power of ten in the divisor
+            int decimals = 0;
+            for (uint16_t d = field.divisor; d >= 10; d /= 10) decimals++;
+            LOG_I(LOG_CODEC, "  %s: %ld (%.*f %s)", field.name, (long)readStored(field, frame),
+                decimals, readValue(field, frame), field.unit);
+        }
+    }
+    if (len > fieldsSize(codec)) {
+        LOG_I(LOG_CODEC, "  + %u variable byte(s)", (unsigned)(len - fieldsSize(codec)));
+    }
+}
+
+// ============================================================================
+// SELF-TEST AND BENCHMARK
+// ============================================================================
+// Golden vectors come from test/golden_vectors.json (payload_golden.h, generated by
+// tools/golden_vectors.py), the same frames lorawan_decoder.js/.py check.
+
+static bool matchesHex(const uint8_t* frame, size_t len, const char* hex) {
+    static const char digits[] = "0123456789ABCDEF";
+    if (strlen(hex) != len * 2) return false;
+    for (size_t i = 0; i < len; i++) {
+        if (hex[2 * i] != digits[frame[i] >> 4] || hex[2 * i + 1] != digits[frame[i] & 0x0F]) return false;
+    }
+    return true;
+}
+
+static void printHex(const uint8_t* frame, size_t len) {
+    for (size_t i = 0; i < len; i++) Serial.printf("%02X", frame[i]);
+}
+
+bool PayloadCodecs::selfTest() {
+    Serial.println(">>> Payload codec self-test...");
+    uint8_t frame[64];
+    int failures = 0;
+
+    // Golden vectors: exact bytes the decoders are checked against
+    for (size_t v = 0; v < GOLDEN_VECTOR_COUNT; v++) {
+        const GoldenVector& g = GOLDEN_VECTORS[v];
+        InputRegisters input;
+        memset(&input, 0, sizeof(input));
+        input.sf6_density = g.density;
+        input.sf6_pressure_20c = g.pressure_20c;
+        input.sf6_temperature = g.temperature;
+        input.sf6_pressure_var = g.pressure_var;
+
+        PayloadContext ctx;
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.input = &input;
+        ctx.uplink_count = g.uplink_count;
+
+        for (int type = 0; type < PAYLOAD_BATCHED_DELTA; type++) {
+            size_t len = get((PayloadType)type).encode(frame, sizeof(frame), ctx);
+            if (!matchesHex(frame, len, g.frames[type])) {
+                Serial.printf("    FAIL vector %u %s: expected %s, got ", (unsigned)v, PAYLOAD_TYPE_NAMES[type], g.frames[type]);
+                printHex(frame, len);
+                Serial.println();
+                failures++;
+            }
+        }
+    }
+
+    // The default user mapping is the Raw Modbus Registers layout
+    static PayloadMap map;  // ~1.5 KB, kept off the setup() stack
+    char error[80];
+    if (!map.compile(PAYLOAD_MAP_DEFAULT_SPEC, error, sizeof(error))) {
+        Serial.printf("    FAIL default mapping: %s\n", error);
+        failures++;
+    }
+    for (size_t v = 0; v < GOLDEN_VECTOR_COUNT; v++) {
+        const GoldenVector& g = GOLDEN_VECTORS[v];
+        InputRegisters input;
+        memset(&input, 0, sizeof(input));
+        input.sf6_density = g.density;
+        input.sf6_pressure_20c = g.pressure_20c;
+        input.sf6_temperature = g.temperature;
+        input.sf6_pressure_var = g.pressure_var;
+
+        PayloadContext ctx;
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.input = &input;
+        ctx.map = &map;
+        ctx.uplink_count = g.uplink_count;
+
+        size_t len = get(PAYLOAD_USER_MAP).encode(frame, sizeof(frame), ctx);
+        if (!matchesHex(frame, len, g.frames[PAYLOAD_RAW_MODBUS])) {
+            Serial.printf("    FAIL vector %u %s: expected %s, got ", (unsigned)v, PAYLOAD_TYPE_NAMES[PAYLOAD_USER_MAP],
+                g.frames[PAYLOAD_RAW_MODBUS]);
+            printHex(frame, len);
+            Serial.println();
+            failures++;
+        }
+    }
+
+    static SampleBatcher batcher;  // ~1 KB, kept off the setup() stack
+    for (size_t i = 0; i < GOLDEN_BATCH_SAMPLE_COUNT; i++) {
+        batcher.addSample(i * GOLDEN_BATCH_INTERVAL_MS, GOLDEN_BATCH_SAMPLES[i]);
+    }
+    PayloadContext batch_ctx;
+    memset(&batch_ctx, 0, sizeof(batch_ctx));
+    batch_ctx.batcher = &batcher;
+    batch_ctx.now = (GOLDEN_BATCH_SAMPLE_COUNT - 1) * GOLDEN_BATCH_INTERVAL_MS + GOLDEN_BATCH_AGE_MS;
+    size_t batch_len = get(PAYLOAD_BATCHED_DELTA).encode(frame, sizeof(frame), batch_ctx);
+    if (!matchesHex(frame, batch_len, GOLDEN_BATCH_FRAME)) {
+        Serial.printf("    FAIL batched: expected %s, got ", GOLDEN_BATCH_FRAME);
+        printHex(frame, batch_len);
+        Serial.println();
+        failures++;
+    }
+
+    // Fuzz: every field must read back through its descriptor as the value encoded
+    // (register ranges as accepted by the web form and downlink commands)
+    const int FUZZ_ROUNDS = 2000;
+    InputRegisters input;
+    memset(&input, 0, sizeof(input));
+    PayloadContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.input = &input;
+    ctx.map = &map;
+    for (int n = 0; n < FUZZ_ROUNDS; n++) {
+        input.sf6_density = esp_random() % 6001;
+        input.sf6_pressure_20c = esp_random() % 11001;
+        input.sf6_temperature = 2150 + esp_random() % 1451;
+        input.sf6_pressure_var = esp_random() % 11001;
+        ctx.uplink_count = esp_random();
+
+        for (int type = 0; type < PAYLOAD_BATCHED_DELTA; type++) {
+            const PayloadCodec& codec = get((PayloadType)type);
+            size_t len = codec.encode(frame, sizeof(frame), ctx);
+            for (uint8_t i = 0; i < codec.field_count; i++) {
+                const PayloadField& field = codec.fields[i];
+                bool ok;
+                if (field.source == SRC_CONSTANT) {
+                    ok = readStored(field, frame) == field.constant;
+                } else if (field.kind == FIELD_FLOAT) {
+                    float expected = sourceValue(field.source, ctx) / (double)field.divisor + field.bias;
+                    ok = readValue(field, frame) == (double)expected;
+                } else {
+                    uint32_t mask = (field.width == 4) ? 0xFFFFFFFFUL : ((1UL << (8 * field.width)) - 1);
+                    ok = (readRaw(field, frame) & mask) == ((uint32_t)sourceValue(field.source, ctx) & mask) &&
+                         (field.source == SRC_UPLINK_COUNT || readStored(field, frame) == sourceValue(field.source, ctx));
+                }
+                if (!ok) {
+                    if (failures < 10) {
+                        Serial.printf("    FAIL fuzz %s field '%s': ", PAYLOAD_TYPE_NAMES[type], field.name);
+                        printHex(frame, len);
+                        Serial.println();
+                    }
+                    failures++;
+                }
+            }
+        }
+    }
+
+    Serial.printf(">>> Codec self-test: %u golden frames, %d fuzz rounds, %d failure(s)\n",
+        (unsigned)(GOLDEN_VECTOR_COUNT * (PAYLOAD_BATCHED_DELTA + 1) + 1), FUZZ_ROUNDS, failures);
+
+    // Throughput: encode + decode per format, registers changing every frame
+    const int BENCH_FRAMES = 10000;
+    double values[16];
+    for (int type = 0; type < PAYLOAD_TYPE_COUNT; type++) {
+        const PayloadCodec& codec = get((PayloadType)type);
+        PayloadContext& bench_ctx = (type == PAYLOAD_BATCHED_DELTA) ? batch_ctx : ctx;
+        size_t bytes = 0;
+
+        unsigned long start = micros();
+        for (int n = 0; n < BENCH_FRAMES; n++) {
+            input.sf6_density = n & 0x0FFF;
+            bench_ctx.uplink_count = n;
+            bytes += codec.encode(frame, sizeof(frame), bench_ctx);
+        }
+        unsigned long encode_us = micros() - start;
+
+        start = micros();
+        for (int n = 0; n < BENCH_FRAMES; n++) {
+            decode((PayloadType)type, frame, codec.size, values, 16);
+        }
+        unsigned long decode_us = micros() - start;
+
+        Serial.printf("    %-22s encode %5lu ns/frame (%lu KB/s), decode %5lu ns/frame\n",
+            PAYLOAD_TYPE_NAMES[type],
+            (unsigned long)(encode_us * 1000UL / BENCH_FRAMES),
+            encode_us ? (unsigned long)(bytes * 1000ULL / encode_us) : 0,
+            (unsigned long)(decode_us * 1000UL / BENCH_FRAMES));
+    }
+
+    return failures == 0;
+}
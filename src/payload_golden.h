@@ -0,0 +1,63 @@
+// Generated by tools/golden_vectors.py from test/golden_vectors.json - do not edit
+#ifndef PAYLOAD_GOLDEN_H
+#define PAYLOAD_GOLDEN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "sample_batch.h"
+
+struct GoldenVector {
+    uint16_t density, pressure_20c, temperature, pressure_var;
+    uint32_t uplink_count;
+    const char* frames[PAYLOAD_BATCHED_DELTA];  // Hex per fixed PayloadType
+};
+
+static const GoldenVector GOLDEN_VECTORS[] = {
+    { 2554, 5500, 2930, 5500, 42,
+      { "002A09FA157C0B72157C", "016700C602020226030209FA", "002A09FA157C0B72157C",
+        "FFCDCC9E410000B040EC51CC41", "030000002A00000809FA157C0B72157C" } },
+    { 0, 0, 2150, 0, 0,
+      { "00000000000008660000", "0167FDBB0202000003020000", "00000000000008660000",
+        "FF9A9968C20000000000000000", "03000000000000080000000008660000" } },
+    { 6000, 11000, 3600, 11000, 65535,
+      { "FFFF17702AF80E102AF8", "016703640202044C03021770", "FFFF17702AF80E102AF8",
+        "FF33B3AD420000304100007042", "030000FFFF00000817702AF80E102AF8" } },
+    { 3350, 1030, 2931, 57, 65543,
+      { "00070D1604060B730039", "016700C70202006703020D16", "00070D1604060B730039",
+        "FF9A999F410AD7833F00000642", "03000000070000080D1604060B730039" } },
+    { 1030, 1030, 2700, 1, 1000,
+      { "03E8040604060A8C0001", "0167FFE10202006703020406", "03E8040604060A8C0001",
+        "FF9A9949C00AD7833FCDCC2441", "03000003E8000008040604060A8C0001" } },
+    { 5374, 7662, 2788, 8291, 54067,
+      { "D33314FE1DEE0AE42063", "01670038020202FE030214FE", "D33314FE1DEE0AE42063",
+        "FFCDCCB4401B2FF540C3F55642", "030000D33300000814FE1DEE0AE42063" } },
+    { 352, 1472, 2498, 2292, 64072,
+      { "FA48016005C009C208F4", "0167FF170202009303020160", "FA48016005C009C208F4",
+        "FFCDCCBAC17F6ABC3FAE476140", "030000FA48000008016005C009C208F4" } },
+    { 4144, 710, 3190, 1550, 1062,
+      { "0426103002C60C76060E", "016701CA0202004703021030", "0426103002C60C76060E",
+        "FF666637428FC2353F8FC22542", "0300000426000008103002C60C76060E" } },
+};
+
+static const size_t GOLDEN_VECTOR_COUNT = sizeof(GOLDEN_VECTORS) / sizeof(GOLDEN_VECTORS[0]);
+
+// Batched frame: samples GOLDEN_BATCH_INTERVAL_MS apart, encoded GOLDEN_BATCH_AGE_MS after the newest
+#define GOLDEN_BATCH_INTERVAL_MS 30000UL
+#define GOLDEN_BATCH_AGE_MS      7000UL
+
+static_assert(GOLDEN_BATCH_INTERVAL_MS == LORAWAN_BATCH_SAMPLE_MS,
+              "Batched golden frame was encoded with another sample interval");
+
+static const uint16_t GOLDEN_BATCH_SAMPLES[][BATCH_FIELD_COUNT] = {
+    { 2554, 5500, 2930, 5500 },
+    { 2555, 5500, 2929, 5500 },
+    { 2554, 5500, 2929, 5498 },
+    { 2554, 5620, 2929, 5498 },
+    { 2400, 5620, 2960, 4000 },
+};
+
+static const size_t GOLDEN_BATCH_SAMPLE_COUNT = sizeof(GOLDEN_BATCH_SAMPLES) / sizeof(GOLDEN_BATCH_SAMPLES[0]);
+static const char* const GOLDEN_BATCH_FRAME = "0105001E000709FA157C0B72157C020001000100000300F0010000B302003EB317";
+
+#endif // PAYLOAD_GOLDEN_H
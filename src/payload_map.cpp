@@ -0,0 +1,514 @@
+#include "payload_map.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <math.h>
+
+const char* const PAYLOAD_MAP_ENCODING_NAMES[] = {
+    "u8",
+    "u16",
+    "s16",
+    "u32",
+    "f16",
+    "bits"
+};
+
+PayloadMap::PayloadMap() : op_count(0), size(0) {
+    memset(ops, 0, sizeof(ops));
+    spec[0] = '\0';
+}
+
+// ============================================================================
+// COMPILER
+// ============================================================================
+
+#define MAP_LINE_MAX   96
+#define MAP_TOKENS_MAX 7
+
+static bool validName(const char* name) {
+    size_t len = strlen(name);
+    if (len == 0 || len >= PAYLOAD_MAP_NAME_MAX) return false;
+    if (name[0] >= '0' && name[0] <= '9') return false;
+    for (size_t i = 0; i < len; i++) {
+        char c = name[i];
+        bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        if (!ok) return false;
+    }
+    return true;
+}
+
+// Whole token must be a number
+static bool parseNumber(const char* token, double* value) {
+    char* end;
+    *value = strtod(token, &end);
+    return end != token && *end == '\0';
+}
+
+static bool parseSource(const char* token, PayloadMapOp& op) {
+    char* end;
+    if (strcmp(token, "count") == 0) {
+        op.source = MAP_SRC_COUNT;
+        return true;
+    }
+    if (token[0] == '=') {
+        long value = strtol(token + 1, &end, 0);
+        if (end == token + 1 || *end != '\0') return false;
+        op.source = MAP_SRC_CONSTANT;
+        op.constant = (int32_t)value;
+        return true;
+    }
+    if ((token[0] == 'i' || token[0] == 'h') && token[1] == 'r' && token[2] >= '0' && token[2] <= '9') {
+        unsigned long index = strtoul(token + 2, &end, 10);
+        if (*end != '\0') return false;
+        op.source = (token[0] == 'i') ? MAP_SRC_INPUT : MAP_SRC_HOLDING;
+        unsigned long count = (token[0] == 'i') ? PAYLOAD_MAP_INPUT_REGS : PAYLOAD_MAP_HOLDING_REGS;
+        if (index >= count) return false;
+        op.index = (uint8_t)index;
+        return true;
+    }
+    return false;
+}
+
+static bool parseEncoding(const char* token, PayloadMapOp& op) {
+    op.min = 0;
+    if (strcmp(token, "u8") == 0) {
+        op.encoding = MAP_U8;  op.bits = 8;  op.max = 0xFF;
+    } else if (strcmp(token, "u16") == 0) {
+        op.encoding = MAP_U16; op.bits = 16; op.max = 0xFFFF;
+    } else if (strcmp(token, "s16") == 0) {
+        op.encoding = MAP_S16; op.bits = 16; op.min = -32768; op.max = 32767;
+    } else if (strcmp(token, "u32") == 0) {
+        op.encoding = MAP_U32; op.bits = 32; op.max = 0xFFFFFFFFLL;
+    } else if (strcmp(token, "f16") == 0 || strcmp(token, "float16") == 0) {
+        op.encoding = MAP_F16; op.bits = 16; op.max = 0;
+    } else if (strncmp(token, "bits", 4) == 0) {
+        char* end;
+        unsigned long bits = strtoul(token + 4, &end, 10);
+        if (end == token + 4 || *end != '\0' || bits < 1 || bits > 16) return false;
+        op.encoding = MAP_BITS;
+        op.bits = (uint8_t)bits;
+        op.max = (1LL << bits) - 1;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool PayloadMap::compile(const char* text, char* error, size_t error_len) {
+    PayloadMapOp parsed[PAYLOAD_MAP_MAX_FIELDS];
+    uint8_t count = 0;
+    uint32_t bit = 0;
+    int line_no = 0;
+
+#define FAIL(...) do { \
+        int n = snprintf(error, error_len, "Line %d: ", line_no); \
+        if (n >= 0 && (size_t)n < error_len) snprintf(error + n, error_len - n, __VA_ARGS__); \
+        return false; \
+    } while (0)
+
+    if (strlen(text) >= PAYLOAD_MAP_SPEC_MAX) {
+        snprintf(error, error_len, "Layout longer than %d characters", PAYLOAD_MAP_SPEC_MAX - 1);
+        return false;
+    }
+
+    const char* p = text;
+    while (*p) {
+        line_no++;
+        const char* eol = strchr(p, '\n');
+        size_t len = eol ? (size_t)(eol - p) : strlen(p);
+
+        char line[MAP_LINE_MAX];
+        if (len >= sizeof(line)) FAIL("longer than %d characters", MAP_LINE_MAX - 1);
+        memcpy(line, p, len);
+        line[len] = '\0';
+        p += len + (eol ? 1 : 0);
+
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char* tokens[MAP_TOKENS_MAX];
+        int n = 0;
+        char* save;
+        for (char* t = strtok_r(line, " \t\r", &save); t; t = strtok_r(nullptr, " \t\r", &save)) {
+            if (n == MAP_TOKENS_MAX) FAIL("too many values");
+            tokens[n++] = t;
+        }
+        if (n == 0) continue;
+        if (n < 3) FAIL("expected name, source and encoding");
+        if (count == PAYLOAD_MAP_MAX_FIELDS) FAIL("more than %d fields", PAYLOAD_MAP_MAX_FIELDS);
+
+        PayloadMapOp& op = parsed[count];
+        memset(&op, 0, sizeof(op));
+
+        if (!validName(tokens[0])) FAIL("invalid name '%s' (letters, digits, '_', up to %d)", tokens[0], PAYLOAD_MAP_NAME_MAX - 1);
+        for (uint8_t i = 0; i < count; i++) {
+            if (strcmp(parsed[i].name, tokens[0]) == 0) FAIL("duplicate name '%s'", tokens[0]);
+        }
+        strcpy(op.name, tokens[0]);
+
+        if (!parseSource(tokens[1], op)) FAIL("unknown source '%s' (ir0-ir8, hr0-hr12, count, =N)", tokens[1]);
+        if (!parseEncoding(tokens[2], op)) FAIL("unknown encoding '%s' (u8, u16, s16, u32, f16, bits1-bits16)", tokens[2]);
+
+        // [scale] [offset] [le], numbers in that order
+        double scale = 1.0;
+        double offset = 0.0;
+        int numbers = 0;
+        for (int t = 3; t < n; t++) {
+            double value;
+            if (strcmp(tokens[t], "le") == 0) {
+                if (op.bits < 16 || op.encoding == MAP_BITS) FAIL("'le' needs a multi-byte encoding");
+                op.little_endian = true;
+            } else if (parseNumber(tokens[t], &value) && numbers < 2 && !op.little_endian) {
+                if (numbers++ == 0) scale = value; else offset = value;
+            } else {
+                FAIL("unexpected '%s'", tokens[t]);
+            }
+        }
+        if (scale == 0.0 || !isfinite(scale) || !isfinite(offset)) FAIL("scale must be a non-zero number");
+
+        op.scale = (float)scale;
+        op.offset = (float)offset;
+        op.integer = scale == 1.0 && offset == floor(offset) && fabs(offset) < 2147483647.0;
+        op.offset_int = op.integer ? (int32_t)offset : 0;
+
+        // Bit fields continue the current byte; everything else is byte-aligned
+        if (op.encoding != MAP_BITS) bit = (bit + 7) & ~7UL;
+        op.bit_pos = (uint16_t)bit;
+        bit += op.bits;
+        if ((bit + 7) / 8 > PAYLOAD_MAP_MAX_BYTES) FAIL("frame longer than %d bytes", PAYLOAD_MAP_MAX_BYTES);
+
+        count++;
+    }
+#undef FAIL
+
+    if (count == 0) {
+        snprintf(error, error_len, "No fields");
+        return false;
+    }
+
+    memcpy(ops, parsed, count * sizeof(PayloadMapOp));
+    op_count = count;
+    size = (uint8_t)((bit + 7) / 8);
+    strcpy(spec, text);
+    return true;
+}
+
+// ============================================================================
+// ENCODER
+// ============================================================================
+
+// Source value -> the bits written for it
+static inline uint32_t storedValue(const PayloadMapOp& op, int64_t raw) {
+    uint32_t stored;
+    if (op.encoding == MAP_F16) {
+        stored = PayloadMap::toHalf((float)raw * op.scale + op.offset);
+    } else {
+        int64_t value;
+        if (op.integer) {
+            value = raw + op.offset_int;
+        } else {
+            float scaled = (float)raw * op.scale + op.offset;
+            if (scaled <= (float)op.min) value = op.min;
+            else if (scaled >= (float)op.max) value = op.max;
+            else value = (int64_t)(scaled + (scaled >= 0 ? 0.5f : -0.5f));
+        }
+        // The uplink counter wraps at the field width like in the fixed formats
+        if (!(op.integer && op.source == MAP_SRC_COUNT)) {
+            if (value < op.min) value = op.min;
+            if (value > op.max) value = op.max;
+        }
+        stored = (uint32_t)value;
+    }
+    return op.bits < 32 ? stored & ((1UL << op.bits) - 1) : stored;
+}
+
+size_t PayloadMap::encode(uint8_t* out, size_t max_len, const PayloadMapInputs& in) const {
+    if (size == 0 || size > max_len) return 0;
+    memset(out, 0, size);
+
+    for (uint8_t i = 0; i < op_count; i++) {
+        const PayloadMapOp& op = ops[i];
+
+        int64_t raw;
+        switch (op.source) {
+            case MAP_SRC_INPUT:   raw = in.input[op.index]; break;
+            case MAP_SRC_HOLDING: raw = in.holding[op.index]; break;
+            case MAP_SRC_COUNT:   raw = in.uplink_count; break;
+            default:              raw = op.constant; break;
+        }
+
+        uint32_t stored = storedValue(op, raw);
+        uint8_t* p = out + (op.bit_pos >> 3);
+        if (op.little_endian) {
+            for (uint8_t b = 0; b < op.bits / 8; b++) p[b] = (stored >> (8 * b)) & 0xFF;
+        } else if ((op.bit_pos & 7) == 0 && (op.bits & 7) == 0) {
+            for (uint8_t b = 0; b < op.bits / 8; b++) p[b] = (stored >> (op.bits - 8 - 8 * b)) & 0xFF;
+        } else {
+            // Bit field: MSB first from bit_pos
+            for (uint8_t b = 0; b < op.bits; b++) {
+                uint16_t pos = op.bit_pos + b;
+                if ((stored >> (op.bits - 1 - b)) & 1) out[pos >> 3] |= 0x80 >> (pos & 7);
+            }
+        }
+    }
+    return size;
+}
+
+uint16_t PayloadMap::toHalf(float value) {
+    uint32_t x;
+    memcpy(&x, &value, sizeof(x));
+    uint16_t sign = (x >> 16) & 0x8000;
+    int32_t exp = (int32_t)((x >> 23) & 0xFF) - 127 + 15;
+    uint32_t mant = x & 0x7FFFFF;
+
+    if (((x >> 23) & 0xFF) == 0xFF) return sign | 0x7C00 | (mant ? 0x200 : 0);  // Inf/NaN
+    if (exp <= 0) {
+        // Subnormal half (or zero)
+        if (exp < -10) return sign;
+        mant |= 0x800000;
+        uint32_t shift = 14 - exp;
+        uint32_t half = mant >> shift;
+        uint32_t rest = mant & ((1UL << shift) - 1);
+        uint32_t halfway = 1UL << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) half++;
+        return sign | half;
+    }
+
+    // Round to nearest even; a carry into the exponent is correct
+    uint32_t half = ((uint32_t)exp << 10) | (mant >> 13);
+    uint32_t rest = mant & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++;
+    if (half >= 0x7C00) half = 0x7BFF;  // Clamp to the largest finite value (65504)
+    return sign | half;
+}
+
+float PayloadMap::fromHalf(uint16_t half) {
+    uint32_t exp = (half >> 10) & 0x1F;
+    uint32_t mant = half & 0x3FF;
+    float value;
+    if (exp == 0) {
+        value = mant / 16777216.0f;  // 2^-24
+    } else if (exp == 31) {
+        value = mant ? NAN : INFINITY;
+    } else {
+        uint32_t x = ((exp - 15 + 127) << 23) | (mant << 13);
+        memcpy(&value, &x, sizeof(value));
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+// ============================================================================
+// DECODING
+// ============================================================================
+
+uint32_t PayloadMap::readStored(uint8_t index, const uint8_t* frame) const {
+    if (index >= op_count) return 0;
+    const PayloadMapOp& op = ops[index];
+
+    uint32_t stored = 0;
+    if (op.little_endian) {
+        const uint8_t* p = frame + (op.bit_pos >> 3);
+        for (int b = op.bits / 8 - 1; b >= 0; b--) stored = (stored << 8) | p[b];
+    } else {
+        for (uint8_t b = 0; b < op.bits; b++) {
+            uint16_t pos = op.bit_pos + b;
+            stored = (stored << 1) | ((frame[pos >> 3] >> (7 - (pos & 7))) & 1);
+        }
+    }
+    return stored;
+}
+
+double PayloadMap::decodeField(uint8_t index, const uint8_t* frame) const {
+    if (index >= op_count) return 0;
+    const PayloadMapOp& op = ops[index];
+    if (op.source == MAP_SRC_CONSTANT) return op.constant;
+
+    uint32_t stored = readStored(index, frame);
+    double value;
+    if (op.encoding == MAP_F16) {
+        value = fromHalf((uint16_t)stored);
+    } else if (op.encoding == MAP_S16) {
+        value = (int16_t)stored;
+    } else {
+        value = stored;
+    }
+    return op.integer ? value - op.offset_int : (value - op.offset) / op.scale;
+}
+
+// ============================================================================
+// DECODER GENERATOR
+// ============================================================================
+
+struct TextOut {
+    char* out;
+    size_t max_len;
+    size_t len;
+
+    void add(const char* format, ...) {
+        if (len + 1 >= max_len) return;
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(out + len, max_len - len, format, args);
+        va_end(args);
+        if (n < 0) return;
+        len += (size_t)n;
+        if (len >= max_len) len = max_len - 1;
+    }
+};
+
+static void sourceLabel(const PayloadMapOp& op, char* buf, size_t len) {
+    switch (op.source) {
+        case MAP_SRC_INPUT:   snprintf(buf, len, "ir%u", op.index); break;
+        case MAP_SRC_HOLDING: snprintf(buf, len, "hr%u", op.index); break;
+        case MAP_SRC_COUNT:   snprintf(buf, len, "count"); break;
+        default:              snprintf(buf, len, "=%ld", (long)op.constant); break;
+    }
+}
+
+size_t PayloadMap::generateDecoder(char* out, size_t max_len) const {
+    if (max_len == 0) return 0;
+    TextOut js = { out, max_len, 0 };
+    out[0] = '\0';
+
+    js.add("/**\n");
+    js.add(" * LoRaWAN Payload Decoder for Vision Master E290 - user payload mapping\n");
+    js.add(" * Generated by the device from its mapping; regenerate after every change.\n");
+    js.add(" *\n");
+    js.add(" * Compatible with TTN v3 (decodeUplink) and ChirpStack v4 (Decode).\n");
+    js.add(" * FPort %d, %u bytes. Values are in source units (Modbus register value,\n", LORAWAN_MAP_FPORT, size);
+    js.add(" * uplink counter): the transport scaling is undone.\n");
+    js.add(" *\n");
+    for (uint8_t i = 0; i < op_count; i++) {
+        const PayloadMapOp& op = ops[i];
+        char source[16];
+        sourceLabel(op, source, sizeof(source));
+        js.add(" * - Bits %u-%u: %s (%s, %s", op.bit_pos, op.bit_pos + op.bits - 1, op.name, source,
+            PAYLOAD_MAP_ENCODING_NAMES[op.encoding]);
+        if (op.encoding == MAP_BITS) js.add("%u", op.bits);
+        if (op.little_endian) js.add(" little-endian");
+        if (!op.integer || op.offset_int != 0) {
+            js.add(", stored = value x %g %c %g", op.scale, op.offset < 0 ? '-' : '+', fabs(op.offset));
+        }
+        js.add(")\n");
+    }
+    js.add(" */\n\n");
+
+    js.add("function mapBits(bytes, pos, n) {\n");
+    js.add("  var v = 0;\n");
+    js.add("  for (var i = 0; i < n; i++) {\n");
+    js.add("    var b = pos + i;\n");
+    js.add("    v = v * 2 + ((bytes[b >> 3] >> (7 - (b & 7))) & 1);\n");
+    js.add("  }\n");
+    js.add("  return v;\n");
+    js.add("}\n\n");
+    js.add("function mapLE(bytes, i, n) {\n");
+    js.add("  var v = 0;\n");
+    js.add("  for (var k = n - 1; k >= 0; k--) v = v * 256 + bytes[i + k];\n");
+    js.add("  return v;\n");
+    js.add("}\n\n");
+    js.add("function mapHalf(h) {\n");
+    js.add("  var e = (h >> 10) & 0x1F, m = h & 0x3FF;\n");
+    js.add("  var v = e === 0 ? m * Math.pow(2, -24) : e === 31 ? (m ? NaN : Infinity) : (1 + m / 1024) * Math.pow(2, e - 15);\n");
+    js.add("  return h & 0x8000 ? -v : v;\n");
+    js.add("}\n\n");
+
+    js.add("function decodeMapped(bytes) {\n");
+    js.add("  if (bytes.length !== %u) throw new Error(\"Expected %u bytes, got \" + bytes.length);\n", size, size);
+    js.add("  var data = {};\n");
+    for (uint8_t i = 0; i < op_count; i++) {
+        const PayloadMapOp& op = ops[i];
+
+        char raw[64];
+        if (op.little_endian) {
+            snprintf(raw, sizeof(raw), "mapLE(bytes, %u, %u)", op.bit_pos / 8, op.bits / 8);
+        } else {
+            snprintf(raw, sizeof(raw), "mapBits(bytes, %u, %u)", op.bit_pos, op.bits);
+        }
+
+        // Constants identify the layout: checked, not returned
+        if (op.source == MAP_SRC_CONSTANT) {
+            js.add("  if (%s !== %lu) throw new Error(\"Unexpected %s\");\n", raw,
+                (unsigned long)storedValue(op, op.constant), op.name);
+            continue;
+        }
+
+        char value[96];
+        if (op.encoding == MAP_F16) {
+            snprintf(value, sizeof(value), "mapHalf(%s)", raw);
+        } else if (op.encoding == MAP_S16) {
+            snprintf(value, sizeof(value), "((%s ^ 0x8000) - 0x8000)", raw);
+        } else {
+            snprintf(value, sizeof(value), "%s", raw);
+        }
+
+        if (op.integer) {
+            if (op.offset_int == 0) js.add("  data.%s = %s;\n", op.name, value);
+            else js.add("  data.%s = %s %c %ld;\n", op.name, value, op.offset_int > 0 ? '-' : '+',
+                    labs((long)op.offset_int));
+        } else {
+            // Divide by a scale like 0.1 as a multiplication by 10 (exact in JS)
+            double inverse = 1.0 / op.scale;
+            char unscale[32];
+            if (fabs(inverse - floor(inverse + 0.5)) < 1e-4 * fabs(inverse)) {
+                snprintf(unscale, sizeof(unscale), " * %.0f", inverse);
+            } else {
+                snprintf(unscale, sizeof(unscale), " / %g", op.scale);
+            }
+            if (op.offset == 0) js.add("  data.%s = %s%s;\n", op.name, value, unscale);
+            else js.add("  data.%s = (%s %c %g)%s;\n", op.name, value, op.offset > 0 ? '-' : '+',
+                    fabs(op.offset), unscale);
+        }
+    }
+    js.add("  return data;\n");
+    js.add("}\n\n");
+
+    js.add("// TTN v3\n");
+    js.add("function decodeUplink(input) {\n");
+    js.add("  if (input.fPort !== %d) {\n", LORAWAN_MAP_FPORT);
+    js.add("    return { data: {}, warnings: [\"Unexpected port: \" + input.fPort], errors: [] };\n");
+    js.add("  }\n");
+    js.add("  try {\n");
+    js.add("    return { data: decodeMapped(input.bytes), warnings: [], errors: [] };\n");
+    js.add("  } catch (e) {\n");
+    js.add("    return { data: {}, warnings: [], errors: [e.message] };\n");
+    js.add("  }\n");
+    js.add("}\n\n");
+
+    js.add("// ChirpStack v4\n");
+    js.add("function Decode(fPort, bytes) {\n");
+    js.add("  if (fPort !== %d) {\n", LORAWAN_MAP_FPORT);
+    js.add("    return { error: \"Unexpected port: \" + fPort };\n");
+    js.add("  }\n");
+    js.add("  try {\n");
+    js.add("    return decodeMapped(bytes);\n");
+    js.add("  } catch (e) {\n");
+    js.add("    return { error: e.message };\n");
+    js.add("  }\n");
+    js.add("}\n\n");
+
+    js.add("if (typeof module !== \"undefined\") {\n");
+    js.add("  module.exports = { decodeUplink: decodeUplink, Decode: Decode };\n");
+    js.add("}\n");
+    return js.len;
+}
+
+// ============================================================================
+// GETTERS
+// ============================================================================
+
+size_t PayloadMap::getSize() const {
+    return size;
+}
+
+uint8_t PayloadMap::getFieldCount() const {
+    return op_count;
+}
+
+const PayloadMapOp& PayloadMap::getField(uint8_t index) const {
+    return ops[index < op_count ? index : 0];
+}
+
+const char* PayloadMap::getSpec() const {
+    return spec;
+}
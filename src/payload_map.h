@@ -0,0 +1,136 @@
+#ifndef PAYLOAD_MAP_H
+#define PAYLOAD_MAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+// ============================================================================
+// USER PAYLOAD MAPPING (PAYLOAD_USER_MAP)
+// ============================================================================
+// A payload layout defined at runtime as text, one field per line, in frame
+// order:
+//
+//   # name      source  encoding  [scale]  [offset]  [le]
+//   counter     count   u16
+//   density     ir0     u16
+//   temperature ir2     s16       1        -2731
+//   pressure    ir1     u8        0.02
+//   wifi        hr11    bits1
+//   version     =2      bits7
+//
+// Sources:   ir0-ir8 (input registers), hr0-hr12 (holding registers),
+//            count (uplink counter, 32 bit), =N (constant N)
+// Encodings: u8, u16, s16, u32, f16 (IEEE 754 half), bitsN (N = 1-16)
+// Stored:    round(source x scale + offset), clamped to the encoding's range
+//            (an unscaled count wraps at the field width instead)
+// le:        little-endian (multi-byte encodings; default big-endian)
+//
+// Bit fields are packed MSB first; consecutive bit fields share bytes, any
+// other field starts at the next byte.
+//
+// compile() checks the text once, when it is saved or loaded, and turns it
+// into a flat program: one op per field with its bit position, width, source
+// slot and scaling resolved. encode() runs the ops with no text handling and
+// no allocation. generateDecoder() writes the matching network-server
+// decoder (TTN v3 / ChirpStack v4 JavaScript), which undoes the scaling and
+// returns every field in source units, e.g. `density` in kg/m3 x 100 as read
+// over Modbus.
+//
+// Pure module (no Arduino dependencies): the registers are passed in.
+
+#define PAYLOAD_MAP_MAX_FIELDS   16
+#define PAYLOAD_MAP_MAX_BYTES    48     // Slow data rates allow less (checked per uplink)
+#define PAYLOAD_MAP_SPEC_MAX     640    // Text incl. comments, stored in NVS
+#define PAYLOAD_MAP_NAME_MAX     16     // Field name incl. terminator (letters, digits, '_')
+#define PAYLOAD_MAP_INPUT_REGS   9
+#define PAYLOAD_MAP_HOLDING_REGS 13
+
+// Until a layout is saved: the Raw Modbus Registers frame
+#define PAYLOAD_MAP_DEFAULT_SPEC \
+    "# name  source  encoding  [scale]  [offset]  [le]\n" \
+    "counter     count  u16\n" \
+    "density     ir0    u16\n" \
+    "pressure    ir1    u16\n" \
+    "temperature ir2    u16\n" \
+    "pressure_var ir3   u16\n"
+
+enum PayloadMapSource : uint8_t {
+    MAP_SRC_INPUT,
+    MAP_SRC_HOLDING,
+    MAP_SRC_COUNT,
+    MAP_SRC_CONSTANT
+};
+
+enum PayloadMapEncoding : uint8_t {
+    MAP_U8,
+    MAP_U16,
+    MAP_S16,
+    MAP_U32,
+    MAP_F16,
+    MAP_BITS
+};
+
+extern const char* const PAYLOAD_MAP_ENCODING_NAMES[];
+
+// One compiled field
+struct PayloadMapOp {
+    char name[PAYLOAD_MAP_NAME_MAX];
+    PayloadMapSource source;
+    uint8_t index;             // Register number (input/holding)
+    PayloadMapEncoding encoding;
+    uint8_t bits;              // Width in bits
+    uint16_t bit_pos;          // First bit in the frame (MSB of byte 0 = 0)
+    bool little_endian;
+    bool integer;              // Scale 1 and integral offset: no float arithmetic
+    int32_t min;               // Stored range
+    int64_t max;
+    int32_t offset_int;
+    int32_t constant;          // MAP_SRC_CONSTANT
+    float scale;
+    float offset;
+};
+
+// Register snapshot for encode()
+struct PayloadMapInputs {
+    const uint16_t* input;     // PAYLOAD_MAP_INPUT_REGS words
+    const uint16_t* holding;   // PAYLOAD_MAP_HOLDING_REGS words
+    uint32_t uplink_count;
+};
+
+class PayloadMap {
+public:
+    PayloadMap();
+
+    // Parse and check `spec`. On success the program (and the text) is
+    // replaced; on failure it is kept and `error` names the line.
+    bool compile(const char* spec, char* error, size_t error_len);
+
+    // Frame size in bytes (0 = no program)
+    size_t getSize() const;
+    uint8_t getFieldCount() const;
+    const PayloadMapOp& getField(uint8_t index) const;
+    const char* getSpec() const;
+
+    // Writes getSize() bytes; returns 0 if they do not fit in max_len
+    size_t encode(uint8_t* out, size_t max_len, const PayloadMapInputs& in) const;
+
+    // Field value in source units (scaling undone), as the generated decoder
+    // computes it. `frame` must hold getSize() bytes.
+    double decodeField(uint8_t index, const uint8_t* frame) const;
+    uint32_t readStored(uint8_t index, const uint8_t* frame) const;
+
+    // Decoder source code; returns its length (truncated at max_len - 1)
+    size_t generateDecoder(char* out, size_t max_len) const;
+
+    static uint16_t toHalf(float value);
+    static float fromHalf(uint16_t half);
+
+private:
+    PayloadMapOp ops[PAYLOAD_MAP_MAX_FIELDS];
+    uint8_t op_count;
+    uint8_t size;
+    char spec[PAYLOAD_MAP_SPEC_MAX];
+};
+
+#endif // PAYLOAD_MAP_H
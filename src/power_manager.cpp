@@ -0,0 +1,220 @@
+#include "power_manager.h"
+#include "lorawan_handler.h"
+#include "wifi_manager.h"
+#include "ota_manager.h"
+#include "logger.h"
+#include <esp_sleep.h>
+#include <esp_rom_crc.h>
+#include <driver/gpio.h>
+#include <stddef.h>
+
+// Class C listens on RX2 between uplinks, so it cannot sleep
+static_assert(POWER_MODE == POWER_ALWAYS_ON || !LORAWAN_CLASS_C,
+              "Light and deep sleep need Class A (LORAWAN_CLASS_C false)");
+
+// Global instance
+PowerManager powerManager;
+
+// ============================================================================
+// RTC MEMORY
+// ============================================================================
+// Survives deep sleep; every other reset loads it from the firmware image
+// (zeroed). The magic, size and CRC reject anything not written by this
+// build right before its last deep sleep.
+
+#define POWER_RETAINED_MAGIC 0x504D5254  // "PMRT"
+
+struct PowerRetained {
+    uint32_t magic;
+    uint32_t size;
+    uint32_t sleep_ms;          // Planned duration of the last deep sleep
+    uint32_t sleep_count;
+    EnergyStats energy;
+    LoRaWANRetained lorawan;
+    uint32_t crc;               // Over everything above
+};
+
+RTC_DATA_ATTR static PowerRetained rtc_state;
+
+static uint32_t retainedCrc() {
+    return esp_rom_crc32_le(0, (const uint8_t*)&rtc_state, offsetof(PowerRetained, crc));
+}
+
+// ============================================================================
+// CONSTRUCTOR / WAKE
+// ============================================================================
+
+PowerManager::PowerManager() :
+    resumed(false),
+    sleep_enabled(false),
+    last_account(0),
+    sleep_count(0) {
+}
+
+bool PowerManager::begin() {
+    bool timer_wake = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+
+    if (POWER_MODE == POWER_DEEP_SLEEP && timer_wake) {
+        // Release the radio's chip select held through the sleep
+        gpio_hold_dis((gpio_num_t)LORA_NSS);
+        gpio_deep_sleep_hold_dis();
+
+        if (rtc_state.magic == POWER_RETAINED_MAGIC && rtc_state.size == sizeof(PowerRetained) &&
+            rtc_state.crc == retainedCrc()) {
+            resumed = true;
+            sleep_enabled = true;
+            sleep_count = rtc_state.sleep_count;
+            energy.restore(rtc_state.energy);
+            energy.add(ENERGY_DEEP_SLEEP, rtc_state.sleep_ms);
+            Serial.printf("\n>>> Woke from deep sleep %lu after %lu s\n",
+                (unsigned long)sleep_count, (unsigned long)(rtc_state.sleep_ms / 1000));
+        } else {
+            Serial.println("\n>>> Woke from deep sleep without valid RTC state - starting cold");
+        }
+    }
+
+    // Consumed: a reset before the next deep sleep starts cold
+    rtc_state.magic = 0;
+
+    if (!resumed && POWER_MODE != POWER_ALWAYS_ON) {
+        Serial.printf(">>> Power mode: %s after a %lu min service window\n",
+            POWER_MODE_NAMES[POWER_MODE], POWER_SERVICE_WINDOW_MS / 60000);
+    }
+    return resumed;
+}
+
+bool PowerManager::isResumed() const {
+    return resumed;
+}
+
+void PowerManager::resumeLoRaWAN() {
+    if (!resumed) return;
+
+    // millis() restarted at wake: the state was saved one sleep before 0
+    unsigned long saved_at = 0UL - rtc_state.sleep_ms;
+    lorawanHandler.resumeState(rtc_state.lorawan, saved_at);
+}
+
+// ============================================================================
+// SLEEP
+// ============================================================================
+
+void PowerManager::process() {
+    unsigned long now = millis();
+    account(now);
+    if (POWER_MODE == POWER_ALWAYS_ON) return;
+
+    if (!sleep_enabled) {
+        if (now < POWER_SERVICE_WINDOW_MS || otaManager.isUpdating()) return;
+        endServiceWindow();
+    }
+
+    // Light sleep also wakes for the batched payload's samples
+    unsigned long wait = lorawanHandler.timeUntilNextUplink(now);
+    if (POWER_MODE == POWER_LIGHT_SLEEP) {
+        unsigned long sample = lorawanHandler.timeUntilNextSample(now);
+        if (sample < wait) wait = sample;
+    }
+    if (wait < POWER_MIN_SLEEP_MS) return;
+
+    if (POWER_MODE == POWER_DEEP_SLEEP) {
+        deepSleep(wait);
+    } else {
+        lightSleep(wait);
+    }
+}
+
+void PowerManager::endServiceWindow() {
+    sleep_enabled = true;
+
+    LOG_I(LOG_SYSTEM, "Service window over - %s between uplinks", POWER_MODE_NAMES[POWER_MODE]);
+    LOG_I(LOG_SYSTEM, "WiFi off; Modbus is only served while awake");
+    wifiManager.stop();
+}
+
+void PowerManager::lightSleep(unsigned long ms) {
+    lorawanHandler.sleepRadio();
+    logger.flush();
+    Serial.flush();
+
+    // millis() keeps counting through light sleep
+    unsigned long start = millis();
+    esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000ULL);
+    esp_light_sleep_start();
+
+    last_account = millis();
+    energy.add(ENERGY_LIGHT_SLEEP, last_account - start);
+    sleep_count++;
+}
+
+void PowerManager::deepSleep(unsigned long ms) {
+    unsigned long now = millis();
+    account(now);
+
+    rtc_state.size = sizeof(PowerRetained);
+    rtc_state.sleep_ms = ms;
+    rtc_state.sleep_count = sleep_count + 1;
+    rtc_state.energy = energy.getStats();
+    lorawanHandler.retainState(now, rtc_state.lorawan);
+    rtc_state.magic = POWER_RETAINED_MAGIC;
+    rtc_state.crc = retainedCrc();
+
+    LOG_I(LOG_SYSTEM, "Deep sleep for %lu s until the next uplink", ms / 1000);
+    logger.flush();   // Queued records are lost with RAM
+    Serial.flush();
+
+    // The sleeping SX1262 must not see the chip select float while the pins are unpowered
+    lorawanHandler.sleepRadio();
+    gpio_hold_en((gpio_num_t)LORA_NSS);
+    gpio_deep_sleep_hold_en();
+
+    esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000ULL);
+    esp_deep_sleep_start();
+}
+
+// ============================================================================
+// ENERGY ESTIMATE
+// ============================================================================
+
+void PowerManager::account(unsigned long now) {
+    uint32_t ms = now - last_account;
+    last_account = now;
+    energy.add(ENERGY_ACTIVE, ms);
+    if (wifiManager.isOn()) {
+        energy.add(ENERGY_WIFI, ms);
+    }
+}
+
+void PowerManager::noteRadio(uint32_t tx_ms, uint32_t rx_ms) {
+    energy.add(ENERGY_TX, tx_ms);
+    energy.add(ENERGY_RX, rx_ms);
+}
+
+void PowerManager::noteUplink() {
+    account(millis());
+    energy.uplinkSent();
+
+    uint32_t uj = energy.lastUplinkUj();
+    LOG_I(LOG_SYSTEM, "Energy: %lu.%03lu mJ since the previous uplink (estimate), average current %lu uA",
+        (unsigned long)(uj / 1000), (unsigned long)(uj % 1000), (unsigned long)energy.averageCurrentUa());
+}
+
+// ============================================================================
+// GETTERS
+// ============================================================================
+
+PowerMode PowerManager::getMode() const {
+    return POWER_MODE;
+}
+
+bool PowerManager::isSleepEnabled() const {
+    return sleep_enabled;
+}
+
+uint32_t PowerManager::getSleepCount() const {
+    return sleep_count;
+}
+
+const EnergyMeter& PowerManager::getEnergy() const {
+    return energy;
+}
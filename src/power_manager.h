@@ -0,0 +1,70 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "energy_meter.h"
+
+// ============================================================================
+// POWER MANAGER (LOW-POWER MODE)
+// ============================================================================
+// POWER_MODE in config.h selects how the device spends the time between
+// uplinks:
+//   Always on    loop() spins, WiFi/HTTPS/Modbus always available (mains power)
+//   Light sleep  ESP32 light sleep until the next uplink or batch sample;
+//                RAM, sessions and statistics are kept
+//   Deep sleep   ESP32 deep sleep until the next uplink; every wake is a
+//                restart. The schedule, duty-cycle windows and the active
+//                profile's session are kept in RTC memory, so the device
+//                resumes without a join; other RAM state starts over.
+//
+// Sleep starts once the service window after a cold boot is over
+// (POWER_SERVICE_WINDOW_MS): until then the device stays awake with WiFi,
+// HTTPS and Modbus for configuration. At its end WiFi is switched off; the
+// radio is put to sleep before every sleep.
+//
+// The energy estimate (energy_meter.h) runs in every mode: awake time is
+// counted by process(), radio time by the LoRaWAN handler, sleep time here.
+
+class PowerManager {
+public:
+    PowerManager();
+
+    // First thing in setup(): wakeup cause and RTC state. True = woke from
+    // deep sleep with valid retained state; setup() then skips the display,
+    // WiFi and HTTPS.
+    bool begin();
+    bool isResumed() const;
+
+    // After lorawanHandler.begin() on a deep-sleep wake
+    void resumeLoRaWAN();
+
+    // End of loop(): energy accounting; sleeps when nothing is due
+    void process();
+
+    PowerMode getMode() const;
+    bool isSleepEnabled() const;       // Low-power mode and service window over
+    uint32_t getSleepCount() const;    // Since cold boot (deep-sleep wakes included)
+
+    // Energy estimate (called by the LoRaWAN handler)
+    void noteRadio(uint32_t tx_ms, uint32_t rx_ms);
+    void noteUplink();
+    const EnergyMeter& getEnergy() const;
+
+private:
+    bool resumed;
+    bool sleep_enabled;
+    unsigned long last_account;
+    uint32_t sleep_count;
+    EnergyMeter energy;
+
+    void account(unsigned long now);   // Awake time since the last call
+    void endServiceWindow();
+    void lightSleep(unsigned long ms);
+    void deepSleep(unsigned long ms);
+};
+
+// Global instance
+extern PowerManager powerManager;
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,271 @@
+#include "profile_store.h"
+#include <nvs_flash.h>
+#include <esp_partition.h>
+
+// Global instance
+ProfileStore profileStore;
+
+// ============================================================================
+// PARTITION
+// ============================================================================
+
+ProfileStore::ProfileStore() :
+    partition(nullptr),
+    started(false) {
+}
+
+void ProfileStore::begin() {
+    if (started) return;
+    started = true;
+
+    const esp_partition_t* part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, LORAWAN_NVS_PARTITION);
+    if (!part) {
+        Serial.println(">>> No '" LORAWAN_NVS_PARTITION "' NVS partition - LoRaWAN data stays in the default partition");
+        return;
+    }
+
+    esp_err_t err = nvs_flash_init_partition(LORAWAN_NVS_PARTITION);
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        Serial.println(">>> LoRaWAN NVS partition unreadable - erasing");
+        nvs_flash_erase_partition(LORAWAN_NVS_PARTITION);
+        err = nvs_flash_init_partition(LORAWAN_NVS_PARTITION);
+    }
+    if (err != ESP_OK) {
+        Serial.printf(">>> LoRaWAN NVS partition init failed (%d) - using the default partition\n", err);
+        return;
+    }
+
+    partition = LORAWAN_NVS_PARTITION;
+    Serial.printf(">>> LoRaWAN data on NVS partition '%s' (%lu KB)\n", partition, (unsigned long)(part->size / 1024));
+
+    migrateFromDefaultPartition();
+}
+
+bool ProfileStore::hasDedicatedPartition() const {
+    return partition != nullptr;
+}
+
+bool ProfileStore::open(Preferences& prefs, const char* ns, bool readOnly) {
+    return prefs.begin(ns, readOnly, partition);
+}
+
+// ============================================================================
+// MIGRATION (DEFAULT PARTITION -> DEDICATED PARTITION)
+// ============================================================================
+
+static bool copyKey(Preferences& src, Preferences& dst, const char* key) {
+    if (!src.isKey(key)) return false;
+
+    switch (src.getType(key)) {
+        case PT_U8:  // Bools are stored as uint8
+            dst.putUChar(key, src.getUChar(key));
+            return true;
+        case PT_U16:
+            dst.putUShort(key, src.getUShort(key));
+            return true;
+        case PT_BLOB: {
+            uint8_t buf[512];  // Largest blob is a RadioLib session buffer
+            size_t len = src.getBytesLength(key);
+            if (len == 0 || len > sizeof(buf)) return false;
+            src.getBytes(key, buf, len);
+            return dst.putBytes(key, buf, len) == len;
+        }
+        default:
+            return false;
+    }
+}
+
+void ProfileStore::migrateFromDefaultPartition() {
+    Preferences src;
+    Preferences dst;
+
+    if (!src.begin("lorawan_prof", true)) return;  // Nothing stored by older firmware
+    bool has_old = src.getBool("has_profiles", false);
+    src.end();
+    if (!has_old) return;
+
+    if (!dst.begin("lorawan_prof", false, partition)) return;
+    bool has_new = dst.getBool("has_profiles", false);
+    dst.end();
+    if (has_new) return;
+
+    Serial.println(">>> Migrating LoRaWAN profiles, nonces and sessions to the LoRaWAN partition...");
+
+    // Profiles (raw "prof<N>" records are converted to compact records on load)
+    src.begin("lorawan_prof", false);
+    dst.begin("lorawan_prof", false, partition);
+    copyKey(src, dst, "active_idx");
+    copyKey(src, dst, "auto_rotate");
+    for (int i = 0; i < LEGACY_PROFILE_COUNT; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "prof%d", i);
+        copyKey(src, dst, key);
+        snprintf(key, sizeof(key), "intv%d", i);
+        copyKey(src, dst, key);
+    }
+    dst.end();
+
+    // DevNonces and sessions - a lost nonce would make the network reject the next join
+    Preferences src_lw;
+    int nonces = 0;
+    if (src_lw.begin("lorawan", false) && dst.begin("lorawan", false, partition)) {
+        for (int i = 0; i < LEGACY_PROFILE_COUNT; i++) {
+            char key[16];
+            snprintf(key, sizeof(key), "nonces_%d", i);
+            if (copyKey(src_lw, dst, key)) nonces++;
+            snprintf(key, sizeof(key), "has_nonces_%d", i);
+            copyKey(src_lw, dst, key);
+            snprintf(key, sizeof(key), "session_%d", i);
+            copyKey(src_lw, dst, key);
+            snprintf(key, sizeof(key), "has_session_%d", i);
+            copyKey(src_lw, dst, key);
+        }
+        dst.end();
+
+        for (int i = 0; i < LEGACY_PROFILE_COUNT; i++) {
+            char key[16];
+            snprintf(key, sizeof(key), "nonces_%d", i);
+            if (src_lw.isKey(key)) src_lw.remove(key);
+            snprintf(key, sizeof(key), "has_nonces_%d", i);
+            if (src_lw.isKey(key)) src_lw.remove(key);
+            snprintf(key, sizeof(key), "session_%d", i);
+            if (src_lw.isKey(key)) src_lw.remove(key);
+            snprintf(key, sizeof(key), "has_session_%d", i);
+            if (src_lw.isKey(key)) src_lw.remove(key);
+        }
+    }
+    src_lw.end();
+
+    // Marker last: an interrupted migration is simply repeated on the next boot
+    dst.begin("lorawan_prof", false, partition);
+    dst.putBool("has_profiles", true);
+    dst.end();
+    src.clear();
+    src.end();
+
+    Serial.printf(">>> Migration complete (%d nonce record(s))\n", nonces);
+}
+
+// ============================================================================
+// COMPACT RECORDS
+// ============================================================================
+
+static void putU64(uint8_t* out, uint64_t value) {
+    for (int i = 7; i >= 0; i--) {
+        out[i] = value & 0xFF;
+        value >>= 8;
+    }
+}
+
+static uint64_t getU64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+size_t ProfileStore::encode(const LoRaProfile& profile, uint8_t* out) {
+    bool shared_key = memcmp(profile.appKey, profile.nwkKey, 16) == 0;
+    size_t name_len = strnlen(profile.name, sizeof(profile.name) - 1);
+
+    out[0] = PROFILE_RECORD_VERSION;
+    out[1] = (profile.enabled ? PROFILE_FLAG_ENABLED : 0) | (shared_key ? PROFILE_FLAG_SHARED_KEY : 0) |
+             (profile.abp ? PROFILE_FLAG_ABP : 0) |
+             ((profile.confirm << PROFILE_CONFIRM_SHIFT) & PROFILE_CONFIRM_MASK);
+    out[2] = (uint8_t)((profile.region << 4) | (profile.payload_type & 0x0F));
+    out[3] = (uint8_t)name_len;
+    putU64(out + 4, profile.devEUI);
+    putU64(out + 12, profile.joinEUI);
+    memcpy(out + 20, profile.appKey, 16);
+
+    size_t pos = 36;
+    if (!shared_key) {
+        memcpy(out + pos, profile.nwkKey, 16);
+        pos += 16;
+    }
+    memcpy(out + pos, profile.name, name_len);
+    pos += name_len;
+
+    if (profile.abp) {
+        out[pos] = profile.devAddr >> 24;
+        out[pos + 1] = profile.devAddr >> 16;
+        out[pos + 2] = profile.devAddr >> 8;
+        out[pos + 3] = profile.devAddr;
+        memcpy(out + pos + 4, profile.nwkSKey, 16);
+        memcpy(out + pos + 20, profile.appSKey, 16);
+        pos += PROFILE_ABP_BLOCK_SIZE;
+    }
+    return pos;
+}
+
+bool ProfileStore::decode(const uint8_t* data, size_t len, LoRaProfile& profile) {
+    if (len < 36 || data[0] != PROFILE_RECORD_VERSION) return false;
+
+    bool shared_key = data[1] & PROFILE_FLAG_SHARED_KEY;
+    bool abp = data[1] & PROFILE_FLAG_ABP;
+    size_t name_pos = shared_key ? 36 : 52;
+    size_t name_len = data[3];
+    size_t abp_pos = name_pos + name_len;
+    if (name_len > sizeof(profile.name) - 1 || len != abp_pos + (abp ? PROFILE_ABP_BLOCK_SIZE : 0)) return false;
+
+    memset(&profile, 0, sizeof(LoRaProfile));
+    profile.enabled = data[1] & PROFILE_FLAG_ENABLED;
+    profile.payload_type = (PayloadType)(data[2] & 0x0F);
+    profile.region = (data[2] >> 4) < REGION_COUNT ? (LoRaRegion)(data[2] >> 4) : REGION_EU868;
+    uint8_t confirm = (data[1] & PROFILE_CONFIRM_MASK) >> PROFILE_CONFIRM_SHIFT;
+    profile.confirm = confirm < CONFIRM_MODE_COUNT ? (ConfirmMode)confirm : CONFIRM_NONE;
+    profile.devEUI = getU64(data + 4);
+    profile.joinEUI = getU64(data + 12);
+    memcpy(profile.appKey, data + 20, 16);
+    memcpy(profile.nwkKey, shared_key ? data + 20 : data + 36, 16);
+    memcpy(profile.name, data + name_pos, name_len);
+
+    profile.abp = abp;
+    if (abp) {
+        const uint8_t* block = data + abp_pos;
+        profile.devAddr = ((uint32_t)block[0] << 24) | ((uint32_t)block[1] << 16) | ((uint32_t)block[2] << 8) | block[3];
+        memcpy(profile.nwkSKey, block + 4, 16);
+        memcpy(profile.appSKey, block + 20, 16);
+    }
+    return true;
+}
+
+// ============================================================================
+// DEVEUI INDEX
+// ============================================================================
+
+DevEuiIndex::DevEuiIndex() {
+    memset(slots, 0, sizeof(slots));
+}
+
+uint16_t DevEuiIndex::hash(uint64_t devEUI) {
+    // Fibonacci hashing; generated DevEUIs share the MAC prefix, so mix the whole value
+    uint64_t h = (devEUI ^ (devEUI >> 32)) * 0x9E3779B97F4A7C15ULL;
+    return (uint16_t)(h >> 48) & (LORAWAN_DEVEUI_INDEX_SIZE - 1);
+}
+
+void DevEuiIndex::rebuild(const LoRaProfile* profiles, uint8_t count) {
+    memset(slots, 0, sizeof(slots));
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t pos = hash(profiles[i].devEUI);
+        while (slots[pos] != 0) {
+            pos = (pos + 1) & (LORAWAN_DEVEUI_INDEX_SIZE - 1);
+        }
+        slots[pos] = i + 1;
+    }
+}
+
+int DevEuiIndex::find(uint64_t devEUI, const LoRaProfile* profiles, int exclude) const {
+    uint16_t pos = hash(devEUI);
+    // At most half the slots are used, so an empty slot always ends the probe
+    while (slots[pos] != 0) {
+        int index = slots[pos] - 1;
+        if (index != exclude && profiles[index].devEUI == devEUI) {
+            return index;
+        }
+        pos = (pos + 1) & (LORAWAN_DEVEUI_INDEX_SIZE - 1);
+    }
+    return -1;
+}
@@ -0,0 +1,94 @@
+#ifndef PROFILE_STORE_H
+#define PROFILE_STORE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+
+// ============================================================================
+// PROFILE STORE (COMPACT RECORDS, DEDICATED NVS PARTITION)
+// ============================================================================
+// Profiles, nonces and sessions live in the "lorawan" NVS partition
+// (partitions.csv) so 64+ profiles don't crowd WiFi/auth settings out of the
+// 20 KB default partition. Devices flashed with the old partition table (OTA
+// updates keep it) fall back to the default partition.
+//
+// Compact profile record, key "prf<N>" in namespace lorawan_prof:
+//   0      Record version (PROFILE_RECORD_VERSION)
+//   1      Flags: bit0 enabled, bit1 NwkKey equals AppKey (NwkKey not stored),
+//          bit2 ABP, bits 3-4 confirmed uplinks (ConfirmMode; 0 = unconfirmed)
+//   2      Payload type (bits 0-3), region (bits 4-7; 0 = EU868, so older records read as EU868)
+//   3      Name length (0-32)
+//   4-11   DevEUI (big-endian)
+//   12-19  JoinEUI (big-endian)
+//   20-35  AppKey
+//   36-51  NwkKey (only if flag bit1 is clear)
+//   ...    Name (no terminator)
+//   ...    ABP only (flag bit2): DevAddr (big-endian), NwkSKey, AppSKey - 36 bytes
+// A default profile ("Profile 12", LoRaWAN 1.0.x keys) takes 46 bytes instead
+// of the 96-byte raw struct the old "prof<N>" keys held.
+
+#define LORAWAN_NVS_PARTITION      "lorawan"
+#define PROFILE_RECORD_VERSION     1
+#define PROFILE_RECORD_MAX_SIZE    (36 + 16 + 32 + PROFILE_ABP_BLOCK_SIZE)
+#define PROFILE_ABP_BLOCK_SIZE     36
+#define PROFILE_FLAG_ENABLED       0x01
+#define PROFILE_FLAG_SHARED_KEY    0x02
+#define PROFILE_FLAG_ABP           0x04
+#define PROFILE_CONFIRM_MASK       0x18
+#define PROFILE_CONFIRM_SHIFT      3
+#define LEGACY_PROFILE_COUNT       4   // Profiles stored by firmware before the compact format
+#define LEGACY_PROFILE_SIZE        offsetof(LoRaProfile, abp)  // Raw "prof<N>" struct
+
+class ProfileStore {
+public:
+    ProfileStore();
+
+    // Mount the dedicated partition (if present) and move old data into it once
+    void begin();
+    bool hasDedicatedPartition() const;
+
+    // Preferences::begin() on the partition the LoRaWAN data lives on
+    bool open(Preferences& prefs, const char* ns, bool readOnly = false);
+
+    static size_t encode(const LoRaProfile& profile, uint8_t* out);
+    static bool decode(const uint8_t* data, size_t len, LoRaProfile& profile);
+
+private:
+    const char* partition;  // nullptr = default NVS partition
+    bool started;
+
+    void migrateFromDefaultPartition();
+};
+
+// ============================================================================
+// DEVEUI INDEX
+// ============================================================================
+// Open-addressing hash of DevEUI -> profile index. Slots hold index + 1 and the
+// EUIs are compared against the profile table, so the index costs one byte per
+// slot. Rebuilt whenever credentials change (rare); lookups are O(1) expected.
+
+class DevEuiIndex {
+public:
+    DevEuiIndex();
+
+    void rebuild(const LoRaProfile* profiles, uint8_t count);
+    // Profile with this DevEUI, or -1. `exclude` skips one profile (duplicate checks).
+    int find(uint64_t devEUI, const LoRaProfile* profiles, int exclude = -1) const;
+
+private:
+    uint8_t slots[LORAWAN_DEVEUI_INDEX_SIZE];
+
+    static uint16_t hash(uint64_t devEUI);
+};
+
+static_assert(MAX_LORA_PROFILES < 0xFE, "Profile index must fit in uint8_t below the command target codes");
+static_assert(LORAWAN_NODE_POOL_SIZE <= MAX_LORA_PROFILES, "Node pool larger than the profile table");
+static_assert((LORAWAN_DEVEUI_INDEX_SIZE & (LORAWAN_DEVEUI_INDEX_SIZE - 1)) == 0 &&
+              LORAWAN_DEVEUI_INDEX_SIZE >= 2 * MAX_LORA_PROFILES,
+              "DevEUI index must be a power of two with at least 2 slots per profile");
+
+// Global instance
+extern ProfileStore profileStore;
+
+#endif // PROFILE_STORE_H
@@ -0,0 +1,160 @@
+#include "sample_batch.h"
+#include <string.h>
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+SampleBatcher::SampleBatcher() :
+    next_seq(0),
+    last_sample_time(0) {
+
+    memset(ring, 0, sizeof(ring));
+    memset(sent_seq, 0, sizeof(sent_seq));
+    memset(dropped, 0, sizeof(dropped));
+}
+
+// ============================================================================
+// SAMPLING
+// ============================================================================
+
+bool SampleBatcher::sampleIfDue(unsigned long now, const uint16_t fields[BATCH_FIELD_COUNT]) {
+    if (next_seq != 0 && now - last_sample_time < LORAWAN_BATCH_SAMPLE_MS) {
+        return false;
+    }
+    addSample(now, fields);
+    return true;
+}
+
+unsigned long SampleBatcher::timeUntilSample(unsigned long now) const {
+    if (next_seq == 0) return 0;
+    unsigned long since = now - last_sample_time;
+    return since >= LORAWAN_BATCH_SAMPLE_MS ? 0 : LORAWAN_BATCH_SAMPLE_MS - since;
+}
+
+void SampleBatcher::addSample(unsigned long now, const uint16_t fields[BATCH_FIELD_COUNT]) {
+    BatchSample& s = ring[next_seq % LORAWAN_BATCH_BUFFER_SIZE];
+    memcpy(s.fields, fields, sizeof(s.fields));
+    s.time = now;
+    next_seq++;
+    last_sample_time = now;
+}
+
+uint32_t SampleBatcher::oldestSeq() const {
+    return next_seq > LORAWAN_BATCH_BUFFER_SIZE ? next_seq - LORAWAN_BATCH_BUFFER_SIZE : 0;
+}
+
+const BatchSample& SampleBatcher::at(uint32_t seq) const {
+    return ring[seq % LORAWAN_BATCH_BUFFER_SIZE];
+}
+
+// ============================================================================
+// ZIG-ZAG VARINT
+// ============================================================================
+
+size_t SampleBatcher::zigzagVarintSize(int32_t delta) {
+    uint32_t v = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+    size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+size_t SampleBatcher::writeZigzagVarint(uint8_t* out, int32_t delta) {
+    uint32_t v = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v & 0x7F) | 0x80;
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+// ============================================================================
+// ENCODING
+// ============================================================================
+
+size_t SampleBatcher::encode(uint8_t profile, uint8_t* out, size_t max_len, unsigned long now,
+                             uint32_t* newest_seq, uint32_t* first_seq) const {
+    if (next_seq == 0 || profile >= MAX_LORA_PROFILES || max_len < BATCH_HEADER_SIZE) {
+        return 0;
+    }
+
+    uint32_t newest = next_seq - 1;
+    uint32_t first = sent_seq[profile];
+    if (first < oldestSeq()) first = oldestSeq();  // Overwritten before this profile sent them
+    if (first > newest) first = newest;            // Nothing new: repeat the latest sample
+
+    // Walk back from the newest sample while the deltas still fit in the frame
+    size_t size = BATCH_HEADER_SIZE;
+    uint32_t start = newest;
+    while (start > first && (newest - start + 1) < BATCH_MAX_SAMPLES) {
+        const BatchSample& cur = at(start);
+        const BatchSample& prev = at(start - 1);
+        size_t add = 0;
+        for (int f = 0; f < BATCH_FIELD_COUNT; f++) {
+            add += zigzagVarintSize((int32_t)cur.fields[f] - (int32_t)prev.fields[f]);
+        }
+        if (size + add > max_len) break;
+        size += add;
+        start--;
+    }
+
+    if (newest_seq) *newest_seq = newest;
+    if (first_seq) *first_seq = start;
+    if (!out) return size;
+
+    uint32_t count = newest - start + 1;
+    unsigned long interval_s = LORAWAN_BATCH_SAMPLE_MS / 1000;
+    unsigned long age_s = (now - at(newest).time) / 1000;
+    if (age_s > 0xFFFF) age_s = 0xFFFF;
+
+    size_t i = 0;
+    out[i++] = BATCH_FORMAT_VERSION;
+    out[i++] = (uint8_t)count;
+    out[i++] = (interval_s >> 8) & 0xFF;
+    out[i++] = interval_s & 0xFF;
+    out[i++] = (age_s >> 8) & 0xFF;
+    out[i++] = age_s & 0xFF;
+
+    const BatchSample& base = at(start);
+    for (int f = 0; f < BATCH_FIELD_COUNT; f++) {
+        out[i++] = (base.fields[f] >> 8) & 0xFF;
+        out[i++] = base.fields[f] & 0xFF;
+    }
+
+    for (uint32_t seq = start + 1; seq <= newest; seq++) {
+        const BatchSample& cur = at(seq);
+        const BatchSample& prev = at(seq - 1);
+        for (int f = 0; f < BATCH_FIELD_COUNT; f++) {
+            i += writeZigzagVarint(&out[i], (int32_t)cur.fields[f] - (int32_t)prev.fields[f]);
+        }
+    }
+    return i;
+}
+
+uint32_t SampleBatcher::markSent(uint8_t profile, uint32_t first_seq, uint32_t newest_seq) {
+    if (profile >= MAX_LORA_PROFILES) return 0;
+    uint32_t lost = first_seq > sent_seq[profile] ? first_seq - sent_seq[profile] : 0;
+    dropped[profile] += lost;
+    sent_seq[profile] = newest_seq + 1;
+    return lost;
+}
+
+uint32_t SampleBatcher::getPendingCount(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) return 0;
+    uint32_t first = sent_seq[profile];
+    if (first < oldestSeq()) first = oldestSeq();
+    return next_seq > first ? next_seq - first : 0;
+}
+
+uint32_t SampleBatcher::getDroppedCount(uint8_t profile) const {
+    return profile < MAX_LORA_PROFILES ? dropped[profile] : 0;
+}
+
+uint32_t SampleBatcher::getSampleCount() const {
+    return next_seq;
+}
@@ -0,0 +1,75 @@
+#ifndef SAMPLE_BATCH_H
+#define SAMPLE_BATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+// ============================================================================
+// BATCHED DELTA PAYLOAD (MULTI-SAMPLE UPLINKS)
+// ============================================================================
+// SF6 input registers are sampled every LORAWAN_BATCH_SAMPLE_MS into a shared
+// ring. Each profile keeps a cursor to the last sample it has sent, so every
+// profile's next batched uplink carries the samples taken since its previous one.
+//
+// Frame layout (big-endian, FPort LORAWAN_BATCH_FPORT):
+//   Byte 0:     Format version (0x01)
+//   Byte 1:     Sample count N (>= 1)
+//   Byte 2-3:   Sample interval (seconds)
+//   Byte 4-5:   Age of the newest sample at uplink time (seconds)
+//   Byte 6-13:  Oldest sample: density, pressure@20C, temperature, pressure var (uint16 each)
+//   Byte 14-..: For samples 2..N, per field: zig-zag varint of (value - previous value)
+//
+// Zig-zag maps signed deltas to unsigned (0,-1,1,-2.. -> 0,1,2,3..); varint uses
+// 7 data bits per byte with the MSB as continuation flag. A steady reading costs
+// one byte per field per sample.
+
+#define BATCH_FORMAT_VERSION 0x01
+#define BATCH_HEADER_SIZE    14
+#define BATCH_FIELD_COUNT    4
+#define BATCH_MAX_SAMPLES    255   // Sample count is one byte
+
+struct BatchSample {
+    uint16_t fields[BATCH_FIELD_COUNT];  // density, pressure@20C, temperature, pressure var
+    unsigned long time;                  // millis() when sampled
+};
+
+class SampleBatcher {
+public:
+    SampleBatcher();
+
+    // Add a sample if the sample interval has elapsed (or the ring is empty)
+    bool sampleIfDue(unsigned long now, const uint16_t fields[BATCH_FIELD_COUNT]);
+    unsigned long timeUntilSample(unsigned long now) const;  // 0 = due now
+    void addSample(unsigned long now, const uint16_t fields[BATCH_FIELD_COUNT]);
+
+    // Encode the samples `profile` has not sent yet, newest first, as many as fit in
+    // max_len. `out` may be NULL to only compute the size. Returns 0 if the ring is empty.
+    // first_seq/newest_seq receive the range the frame carries.
+    size_t encode(uint8_t profile, uint8_t* out, size_t max_len, unsigned long now,
+                  uint32_t* newest_seq = nullptr, uint32_t* first_seq = nullptr) const;
+
+    // Uplink delivered: samples up to `newest_seq` are no longer pending for this
+    // profile. Pending samples older than `first_seq` (did not fit in the frame or
+    // were overwritten in the ring) are lost; returns how many.
+    uint32_t markSent(uint8_t profile, uint32_t first_seq, uint32_t newest_seq);
+
+    uint32_t getPendingCount(uint8_t profile) const;
+    uint32_t getDroppedCount(uint8_t profile) const;  // Samples lost since boot
+    uint32_t getSampleCount() const;
+
+    static size_t zigzagVarintSize(int32_t delta);
+    static size_t writeZigzagVarint(uint8_t* out, int32_t delta);
+
+private:
+    BatchSample ring[LORAWAN_BATCH_BUFFER_SIZE];
+    uint32_t next_seq;                        // Sequence number of the next sample
+    uint32_t sent_seq[MAX_LORA_PROFILES];     // Next unsent sequence number per profile
+    uint32_t dropped[MAX_LORA_PROFILES];      // Samples never sent per profile
+    unsigned long last_sample_time;
+
+    uint32_t oldestSeq() const;
+    const BatchSample& at(uint32_t seq) const;
+};
+
+#endif // SAMPLE_BATCH_H
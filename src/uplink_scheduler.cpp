@@ -0,0 +1,357 @@
+#include "uplink_scheduler.h"
+#include <string.h>
+
+// ============================================================================
+// CONSTRUCTOR / CONFIGURATION
+// ============================================================================
+
+UplinkScheduler::UplinkScheduler() :
+    heap_size(0),
+    gap_limit(LORAWAN_STAGGER_MS),
+    min_gap(LORAWAN_STAGGER_MS),
+    last_tx(0),
+    has_tx(false) {
+
+    memset(entries, 0, sizeof(entries));
+    memset(heap, 0, sizeof(heap));
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        entries[i].period = LORAWAN_UPLINK_INTERVAL_MS;
+    }
+    resetStats();
+}
+
+void UplinkScheduler::setPeriod(uint8_t profile, unsigned long period_ms) {
+    if (profile >= MAX_LORA_PROFILES || period_ms == 0) return;
+
+    Entry& e = entries[profile];
+    if (e.scheduled && e.has_sent) {
+        // Keep the phase: re-anchor the pending deadline on the previous one
+        e.deadline = e.deadline - e.period + period_ms;
+    }
+    e.period = period_ms;
+    if (e.scheduled) {
+        heapFix(heapFind(profile));
+        updateGap();
+    }
+}
+
+void UplinkScheduler::setMinGap(unsigned long gap_ms) {
+    gap_limit = gap_ms;
+    updateGap();
+}
+
+void UplinkScheduler::updateGap() {
+    // n profiles need n gaps per period; leave the rest of the period for
+    // loop latency, holds and extra uplinks
+    unsigned long shortest = 0;
+    unsigned long count = 0;
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        if (!entries[i].scheduled) continue;
+        count++;
+        if (shortest == 0 || entries[i].period < shortest) shortest = entries[i].period;
+    }
+
+    min_gap = gap_limit;
+    if (count > 0) {
+        unsigned long fit = shortest / 100 * LORAWAN_STAGGER_FILL_PCT / count;
+        if (fit < min_gap) min_gap = fit;
+    }
+}
+
+unsigned long UplinkScheduler::getPeriod(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) return LORAWAN_UPLINK_INTERVAL_MS;
+    return entries[profile].period;
+}
+
+unsigned long UplinkScheduler::getMinGap() const {
+    return min_gap;
+}
+
+void UplinkScheduler::resetStats() {
+    memset(stats, 0, sizeof(stats));
+}
+
+// ============================================================================
+// SCHEDULE MEMBERSHIP
+// ============================================================================
+
+void UplinkScheduler::setScheduled(uint8_t profile, bool scheduled, unsigned long now) {
+    if (profile >= MAX_LORA_PROFILES || entries[profile].scheduled == scheduled) {
+        return;
+    }
+
+    if (!scheduled) {
+        int pos = heapFind(profile);
+        if (pos >= 0) heapRemoveAt(pos);
+        entries[profile].scheduled = false;
+        updateGap();
+        return;
+    }
+
+    // Gap for the queue including the new profile
+    entries[profile].scheduled = true;
+    unsigned long previous_gap = min_gap;
+    updateGap();
+
+    // Stagger behind the latest deadline already queued so profiles don't bunch up
+    unsigned long deadline = now;
+    for (uint8_t i = 0; i < heap_size; i++) {
+        unsigned long slot = entries[heap[i]].deadline + min_gap;
+        if (before(deadline, slot)) deadline = slot;
+    }
+
+    Entry& e = entries[profile];
+    e.deadline = deadline;
+    e.has_hold = false;
+    e.expedited = false;
+    heapPush(profile);
+
+    if (min_gap < previous_gap) restagger();
+}
+
+void UplinkScheduler::restagger() {
+    // Profiles still waiting for their first uplink were staggered with the
+    // longer gap of a smaller queue (e.g. enabled one by one at boot): pull
+    // them in to the current gap, in deadline order
+    uint8_t order[MAX_LORA_PROFILES];
+    int n = 0;
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        if (!entries[i].scheduled || entries[i].has_sent) continue;
+        int pos = n++;
+        while (pos > 0 && before(entries[i].deadline, entries[order[pos - 1]].deadline)) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = i;
+    }
+
+    for (int k = 1; k < n; k++) {
+        unsigned long slot = entries[order[k - 1]].deadline + min_gap;
+        if (before(slot, entries[order[k]].deadline)) {
+            entries[order[k]].deadline = slot;
+            heapFix(heapFind(order[k]));
+        }
+    }
+}
+
+bool UplinkScheduler::isScheduled(uint8_t profile) const {
+    return profile < MAX_LORA_PROFILES && entries[profile].scheduled;
+}
+
+// ============================================================================
+// DISPATCH
+// ============================================================================
+
+unsigned long UplinkScheduler::eligibleAt(uint8_t profile) const {
+    const Entry& e = entries[profile];
+    unsigned long at = e.deadline;
+    if (e.expedited && before(e.expedite_at, at)) {
+        at = e.expedite_at;
+    }
+    if (e.has_hold && before(at, e.hold_until)) {
+        at = e.hold_until;
+    }
+    return at;
+}
+
+int UplinkScheduler::nextDue(unsigned long now) const {
+    if (heap_size == 0) return -1;
+    if (has_tx && before(now, last_tx + min_gap)) return -1;
+    if (before(now, eligibleAt(heap[0]))) return -1;
+    return heap[0];
+}
+
+unsigned long UplinkScheduler::timeUntilNext(unsigned long now) const {
+    if (heap_size == 0) return LORAWAN_UPLINK_INTERVAL_MS;
+
+    unsigned long wait = 0;
+    unsigned long at = eligibleAt(heap[0]);
+    if (before(now, at)) wait = at - now;
+    if (has_tx && before(now, last_tx + min_gap)) {
+        unsigned long gap_wait = last_tx + min_gap - now;
+        if (gap_wait > wait) wait = gap_wait;
+    }
+    return wait;
+}
+
+void UplinkScheduler::complete(uint8_t profile, unsigned long now) {
+    if (profile >= MAX_LORA_PROFILES) return;
+
+    Entry& e = entries[profile];
+    ScheduleStats& s = stats[profile];
+    last_tx = now;
+    has_tx = true;
+
+    if (!e.scheduled) return;
+
+    // Lateness (early sends, e.g. the startup sequence, count as on time)
+    unsigned long lateness = before(now, e.deadline) ? 0 : now - e.deadline;
+    s.sent++;
+    s.last_lateness = lateness;
+    s.total_lateness += lateness;
+    if (lateness > s.max_lateness) s.max_lateness = lateness;
+
+    if (e.has_sent) {
+        unsigned long interval = now - e.last_sent;
+        if (s.min_interval == 0 || interval < s.min_interval) s.min_interval = interval;
+        if (interval > s.max_interval) s.max_interval = interval;
+    }
+    e.last_sent = now;
+    e.has_sent = true;
+
+    e.has_hold = false;
+
+    // Extra uplink ahead of the deadline: the regular slot stays where it is
+    if (e.expedited) {
+        e.expedited = false;
+        if (before(now, e.deadline)) {
+            heapFix(heapFind(profile));
+            return;
+        }
+    }
+
+    // Anchored deadline; skip whole periods that are already over instead of bursting
+    e.deadline += e.period;
+    if (!before(now, e.deadline)) {
+        unsigned long skipped = (now - e.deadline) / e.period + 1;
+        e.deadline += skipped * e.period;
+        s.missed += skipped;
+    }
+
+    heapFix(heapFind(profile));
+}
+
+void UplinkScheduler::hold(uint8_t profile, unsigned long until) {
+    if (profile >= MAX_LORA_PROFILES || !entries[profile].scheduled) return;
+
+    entries[profile].hold_until = until;
+    entries[profile].has_hold = true;
+    heapFix(heapFind(profile));
+}
+
+void UplinkScheduler::noteTransmission(unsigned long now) {
+    last_tx = now;
+    has_tx = true;
+}
+
+void UplinkScheduler::expedite(uint8_t profile, unsigned long now) {
+    if (profile >= MAX_LORA_PROFILES || !entries[profile].scheduled) return;
+
+    entries[profile].expedite_at = now;
+    entries[profile].expedited = true;
+    heapFix(heapFind(profile));
+}
+
+void UplinkScheduler::rearm(uint8_t profile, unsigned long now) {
+    if (profile >= MAX_LORA_PROFILES || !entries[profile].scheduled) return;
+
+    entries[profile].deadline = now + entries[profile].period;
+    heapFix(heapFind(profile));
+}
+
+unsigned long UplinkScheduler::getDeadline(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) return 0;
+    return entries[profile].deadline;
+}
+
+const ScheduleStats& UplinkScheduler::getStats(uint8_t profile) const {
+    if (profile >= MAX_LORA_PROFILES) profile = 0;
+    return stats[profile];
+}
+
+// ============================================================================
+// DEEP SLEEP RETENTION
+// ============================================================================
+
+void UplinkScheduler::retain(unsigned long now, ScheduleRetained& out) const {
+    memset(&out, 0, sizeof(out));
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        const Entry& e = entries[i];
+        out.deadline_in[i] = (int32_t)(e.deadline - now);
+        out.hold_in[i] = (int32_t)(e.hold_until - now);
+        out.expedite_in[i] = (int32_t)(e.expedite_at - now);
+        out.last_sent_in[i] = (int32_t)(e.last_sent - now);
+        out.flags[i] = (e.scheduled ? SCHED_RETAIN_SCHEDULED : 0) |
+                       (e.has_hold ? SCHED_RETAIN_HOLD : 0) |
+                       (e.expedited ? SCHED_RETAIN_EXPEDITED : 0) |
+                       (e.has_sent ? SCHED_RETAIN_SENT : 0);
+    }
+    out.last_tx_in = (int32_t)(last_tx - now);
+    out.has_tx = has_tx;
+}
+
+void UplinkScheduler::resume(const ScheduleRetained& in, unsigned long saved_at) {
+    heap_size = 0;
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        Entry& e = entries[i];
+        e.deadline = saved_at + in.deadline_in[i];
+        e.hold_until = saved_at + in.hold_in[i];
+        e.expedite_at = saved_at + in.expedite_in[i];
+        e.last_sent = saved_at + in.last_sent_in[i];
+        e.scheduled = in.flags[i] & SCHED_RETAIN_SCHEDULED;
+        e.has_hold = in.flags[i] & SCHED_RETAIN_HOLD;
+        e.expedited = in.flags[i] & SCHED_RETAIN_EXPEDITED;
+        e.has_sent = in.flags[i] & SCHED_RETAIN_SENT;
+        if (e.scheduled) heapPush(i);
+    }
+    last_tx = saved_at + in.last_tx_in;
+    has_tx = in.has_tx;
+    updateGap();
+}
+
+// ============================================================================
+// BINARY HEAP
+// ============================================================================
+
+int UplinkScheduler::heapFind(uint8_t profile) const {
+    for (uint8_t i = 0; i < heap_size; i++) {
+        if (heap[i] == profile) return i;
+    }
+    return -1;
+}
+
+void UplinkScheduler::heapPush(uint8_t profile) {
+    if (heap_size >= MAX_LORA_PROFILES) return;
+    heap[heap_size] = profile;
+    siftUp(heap_size);
+    heap_size++;
+}
+
+void UplinkScheduler::heapRemoveAt(int pos) {
+    heap_size--;
+    if (pos == heap_size) return;
+    heap[pos] = heap[heap_size];
+    heapFix(pos);
+}
+
+void UplinkScheduler::heapFix(int pos) {
+    if (pos < 0) return;
+    siftUp(pos);
+    siftDown(pos);
+}
+
+void UplinkScheduler::siftUp(int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!before(eligibleAt(heap[pos]), eligibleAt(heap[parent]))) break;
+        uint8_t tmp = heap[pos];
+        heap[pos] = heap[parent];
+        heap[parent] = tmp;
+        pos = parent;
+    }
+}
+
+void UplinkScheduler::siftDown(int pos) {
+    while (true) {
+        int smallest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < heap_size && before(eligibleAt(heap[left]), eligibleAt(heap[smallest]))) smallest = left;
+        if (right < heap_size && before(eligibleAt(heap[right]), eligibleAt(heap[smallest]))) smallest = right;
+        if (smallest == pos) break;
+        uint8_t tmp = heap[pos];
+        heap[pos] = heap[smallest];
+        heap[smallest] = tmp;
+        pos = smallest;
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef UPLINK_SCHEDULER_H
+#define UPLINK_SCHEDULER_H
+
+#include <stdint.h>
+#include "config.h"
+
+// ============================================================================
+// UPLINK SCHEDULER (EARLIEST DEADLINE FIRST)
+// ============================================================================
+// Every scheduled profile has a period and an absolute deadline. A binary
+// min-heap keyed by deadline always serves the earliest one. Deadlines are
+// anchored (next = deadline + period), so a late uplink does not shift the
+// profile's phase and intervals don't drift.
+//
+// A profile can be held back (failed join, no airtime) without moving its
+// deadline; the hold only delays eligibility, and the delay shows up as
+// lateness when it is finally sent. An expedited profile (remote "uplink now"
+// command) becomes eligible immediately for one extra uplink; its regular
+// deadline is not moved either. Report-on-change uplinks re-arm the deadline
+// instead, so the period counts from the last report (heartbeat).
+//
+// The gap between two uplinks is LORAWAN_STAGGER_MS unless the scheduled
+// profiles would not fit one period that way: then it is shortened to
+// LORAWAN_STAGGER_FILL_PCT of the shortest scheduled period, divided by the
+// number of scheduled profiles, so every profile still sends once per period.
+//
+// Time is passed in by the caller (millis()). Comparisons are wrap-safe.
+//
+// Deep sleep restarts millis(); the schedule is kept in RTC memory as times
+// relative to the moment it was saved (ScheduleRetained) and put back against
+// the new clock after wake. Statistics are not retained.
+
+struct ScheduleStats {
+    uint32_t sent;               // Completed uplinks
+    uint32_t missed;             // Whole periods skipped because the profile fell behind
+    unsigned long last_lateness; // Send time - deadline of the last uplink (ms)
+    unsigned long max_lateness;
+    unsigned long total_lateness;
+    unsigned long min_interval;  // Observed interval between consecutive uplinks (ms)
+    unsigned long max_interval;
+};
+
+// Schedule state kept over deep sleep (plain data for RTC memory)
+struct ScheduleRetained {
+    int32_t deadline_in[MAX_LORA_PROFILES];   // ms after the save (negative = overdue)
+    int32_t hold_in[MAX_LORA_PROFILES];
+    int32_t expedite_in[MAX_LORA_PROFILES];
+    int32_t last_sent_in[MAX_LORA_PROFILES];
+    uint8_t flags[MAX_LORA_PROFILES];         // SCHED_RETAIN_* bits
+    int32_t last_tx_in;
+    bool has_tx;
+};
+
+#define SCHED_RETAIN_SCHEDULED  0x01
+#define SCHED_RETAIN_HOLD       0x02
+#define SCHED_RETAIN_EXPEDITED  0x04
+#define SCHED_RETAIN_SENT       0x08
+
+class UplinkScheduler {
+public:
+    UplinkScheduler();
+
+    // Per-profile period; the next deadline moves with it (anchored to the previous one)
+    void setPeriod(uint8_t profile, unsigned long period_ms);
+    unsigned long getPeriod(uint8_t profile) const;
+    // Longest gap between two uplinks; getMinGap() is the one in use
+    void setMinGap(unsigned long gap_ms);
+    unsigned long getMinGap() const;
+
+    // Add/remove a profile. New profiles are staggered one gap after the
+    // latest deadline already in the queue.
+    void setScheduled(uint8_t profile, bool scheduled, unsigned long now);
+    bool isScheduled(uint8_t profile) const;
+
+    // Profile whose turn it is now, or -1 (nothing due, or min gap not elapsed)
+    int nextDue(unsigned long now) const;
+    // Milliseconds until nextDue() can return a profile (0 = now)
+    unsigned long timeUntilNext(unsigned long now) const;
+
+    // Uplink sent: record lateness and interval, advance deadline by one period
+    void complete(uint8_t profile, unsigned long now);
+    // Keep the profile ineligible until `until`; the deadline is not changed
+    void hold(uint8_t profile, unsigned long until);
+    // Something was transmitted outside the schedule (e.g. join request)
+    void noteTransmission(unsigned long now);
+    // One extra uplink as soon as possible (still subject to holds and the min gap)
+    void expedite(uint8_t profile, unsigned long now);
+    // Next deadline one full period after `now` (phase restarts at this uplink)
+    void rearm(uint8_t profile, unsigned long now);
+
+    unsigned long getDeadline(uint8_t profile) const;
+    const ScheduleStats& getStats(uint8_t profile) const;
+    void resetStats();
+
+    // Deep sleep: save relative to `now`; resume with the save time expressed
+    // in the current clock (now - time elapsed since the save). Periods are
+    // not part of the state; they are set from the profiles before resume().
+    void retain(unsigned long now, ScheduleRetained& out) const;
+    void resume(const ScheduleRetained& in, unsigned long saved_at);
+
+private:
+    struct Entry {
+        unsigned long period;
+        unsigned long deadline;
+        unsigned long hold_until;
+        unsigned long expedite_at;
+        unsigned long last_sent;
+        bool scheduled;
+        bool has_hold;
+        bool has_sent;
+        bool expedited;
+    };
+
+    Entry entries[MAX_LORA_PROFILES];
+    ScheduleStats stats[MAX_LORA_PROFILES];
+
+    // Min-heap of profile indices ordered by eligibility time
+    uint8_t heap[MAX_LORA_PROFILES];
+    uint8_t heap_size;
+
+    unsigned long gap_limit;     // setMinGap()
+    unsigned long min_gap;       // In use: gap_limit, or shorter to fit the scheduled profiles
+    unsigned long last_tx;
+    bool has_tx;
+
+    static bool before(unsigned long a, unsigned long b) { return (long)(a - b) < 0; }
+    void updateGap();
+    void restagger();
+    unsigned long eligibleAt(uint8_t profile) const;
+    int heapFind(uint8_t profile) const;
+    void heapPush(uint8_t profile);
+    void heapRemoveAt(int pos);
+    void heapFix(int pos);
+    void siftUp(int pos);
+    void siftDown(int pos);
+};
+
+#endif // UPLINK_SCHEDULER_H
@@ -0,0 +1,272 @@
+// Generated by tools/web_assets.py from web/ - do not edit
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+struct WebAsset {
+    const char* name;       // Path under /static/
+    const char* type;
+    const uint8_t* data;    // gzip
+    size_t len;
+    const char* etag;       // Quoted, as sent in ETag
+    const char* version;    // Appended to links (?v=) so a new firmware is fetched again
+};
+
+// style-light.css: 3087 bytes, 2906 minified, 1115 gzipped
+static const uint8_t WEB_ASSET_0[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x56, 0xdb, 0x8e, 0xa3, 0x38,
+    0x10, 0xfd, 0x15, 0xa4, 0xa8, 0x35, 0x89, 0x14, 0x22, 0x6e, 0xb9, 0x19, 0x8d, 0xb4, 0xfb, 0xb8,
+    0xaf, 0xbb, 0xda, 0xa7, 0xd5, 0x3c, 0x18, 0xbb, 0x9c, 0x58, 0x0d, 0x36, 0xb2, 0x4d, 0x27, 0x3d,
+    0x88, 0x7f, 0x5f, 0x9b, 0x4b, 0x02, 0x84, 0x56, 0x0b, 0x09, 0x11, 0x13, 0x8e, 0xab, 0x4e, 0x9d,
+    0x3a, 0xe5, 0x4c, 0xd2, 0xcf, 0x9a, 0x49, 0x61, 0x7c, 0x86, 0x0b, 0x9e, 0x7f, 0xa2, 0x1f, 0xff,
+    0xc0, 0x45, 0x82, 0xf7, 0xef, 0x5f, 0x3f, 0xb6, 0x7f, 0x2a, 0x8e, 0xf3, 0xad, 0xc6, 0x42, 0xfb,
+    0x1a, 0x14, 0x67, 0x69, 0x81, 0xd5, 0x85, 0x0b, 0x14, 0xa4, 0x25, 0xa6, 0x94, 0x8b, 0x0b, 0x8a,
+    0x82, 0xf2, 0x9e, 0x66, 0x98, 0xbc, 0x5f, 0x94, 0xac, 0x04, 0x45, 0x2b, 0xb6, 0x77, 0x57, 0xb3,
+    0x23, 0x16, 0x11, 0x73, 0x01, 0xaa, 0x2e, 0xf0, 0xdd, 0xbf, 0x71, 0x6a, 0xae, 0xe8, 0x1c, 0xb8,
+    0x7f, 0x0f, 0x18, 0x1e, 0xae, 0x8c, 0x1c, 0x7f, 0x7b, 0xbb, 0x72, 0x03, 0x0f, 0xe4, 0xb8, 0x45,
+    0x96, 0x8a, 0x82, 0xf2, 0x15, 0xa6, 0xbc, 0xd2, 0x28, 0xec, 0x96, 0xee, 0xbe, 0xbe, 0x62, 0x2a,
+    0x6f, 0x16, 0x22, 0x2a, 0xef, 0x9e, 0x5b, 0xf5, 0xd4, 0x25, 0xc3, 0xeb, 0x60, 0xdb, 0x5e, 0xbb,
+    0x70, 0xd3, 0x5c, 0xc3, 0x9a, 0xc8, 0x5c, 0x2a, 0xb4, 0x8a, 0x48, 0x0c, 0xfb, 0xa0, 0xdf, 0xd5,
+    0x37, 0xb2, 0xb4, 0xd1, 0xf7, 0xb0, 0x99, 0x34, 0x46, 0x16, 0x28, 0xb6, 0xdf, 0x6b, 0x99, 0x73,
+    0xea, 0xad, 0xe2, 0xe4, 0x7c, 0xa2, 0xd9, 0x10, 0xc3, 0xf0, 0x87, 0x70, 0x5f, 0xde, 0x9b, 0x6b,
+    0x34, 0x20, 0xc6, 0x49, 0x72, 0xde, 0xc3, 0x18, 0xd1, 0xc5, 0x6a, 0x53, 0xc6, 0x8a, 0xd6, 0x63,
+    0x2e, 0x80, 0xb0, 0x80, 0x85, 0x53, 0xae, 0xfa, 0xec, 0x1d, 0xa4, 0x17, 0xcc, 0xf2, 0x3b, 0x3d,
+    0x33, 0xce, 0x81, 0x19, 0x94, 0xcc, 0x03, 0x6b, 0x76, 0x5c, 0x30, 0xe9, 0x5b, 0x9a, 0x8a, 0xc9,
+    0x46, 0x8c, 0xb1, 0xc7, 0x2e, 0x0e, 0x79, 0x86, 0xfb, 0x5c, 0x41, 0xe1, 0x13, 0x92, 0x52, 0xda,
+    0xe3, 0xe5, 0x38, 0x83, 0xbc, 0xd3, 0x80, 0xe6, 0xbf, 0x01, 0x85, 0x96, 0xd6, 0xb4, 0x4f, 0xf6,
+    0xc8, 0x4e, 0xe4, 0x44, 0x53, 0x03, 0x77, 0xe3, 0x1b, 0x65, 0x95, 0xc0, 0xa4, 0x2a, 0x50, 0x55,
+    0x96, 0xa0, 0x08, 0xd6, 0x0f, 0x16, 0x7a, 0xa6, 0x1c, 0x51, 0x1d, 0xe6, 0x07, 0xce, 0x2b, 0x18,
+    0x61, 0x46, 0x36, 0x99, 0xb4, 0xfd, 0x79, 0x03, 0x7e, 0xb9, 0x1a, 0x94, 0xc9, 0x9c, 0xa6, 0x93,
+    0x1a, 0x35, 0x0e, 0xfa, 0x5b, 0x02, 0x5f, 0x29, 0xeb, 0x29, 0x75, 0x6f, 0xbd, 0xa0, 0xe9, 0x92,
+    0xa1, 0x5c, 0x97, 0x39, 0xfe, 0x44, 0x59, 0x2e, 0xc9, 0xfb, 0x2c, 0xc8, 0xd3, 0x33, 0xbb, 0x5e,
+    0x1c, 0xe3, 0xb8, 0x0e, 0x41, 0xd0, 0x70, 0x51, 0x56, 0xe6, 0x3f, 0xf3, 0x59, 0xc2, 0x4f, 0x97,
+    0xf8, 0xaf, 0xed, 0x68, 0xa1, 0xc4, 0x5a, 0xdf, 0x6c, 0x0c, 0x93, 0x45, 0x51, 0x15, 0x19, 0xa8,
+    0x5f, 0x5b, 0x0d, 0x39, 0x10, 0x53, 0x77, 0x72, 0x0f, 0x83, 0xe0, 0xed, 0x59, 0x96, 0x67, 0xec,
+    0x28, 0x7a, 0x16, 0x21, 0xa3, 0x24, 0x26, 0xc7, 0x85, 0x7a, 0x8d, 0xaa, 0x71, 0x18, 0x54, 0xcf,
+    0x7f, 0x3b, 0xa4, 0x87, 0x78, 0xef, 0xb3, 0xbc, 0x5a, 0x99, 0x9a, 0xeb, 0x98, 0xc1, 0xdc, 0x76,
+    0x20, 0x56, 0xfe, 0xc5, 0x01, 0x83, 0x30, 0xeb, 0x30, 0xde, 0x53, 0xb8, 0x6c, 0x57, 0x87, 0xc3,
+    0x11, 0x00, 0x7b, 0xc1, 0xdb, 0x76, 0x75, 0x3c, 0x24, 0x19, 0x8e, 0x3c, 0x17, 0xec, 0xa6, 0xa7,
+    0x65, 0xda, 0x88, 0xad, 0x1a, 0xda, 0xfa, 0xe3, 0x9c, 0x5f, 0x04, 0x72, 0xd2, 0x7c, 0x61, 0xcc,
+    0x58, 0xe5, 0xbf, 0x28, 0x0c, 0x02, 0x77, 0xcd, 0x28, 0x98, 0xf5, 0x7b, 0x63, 0x14, 0x12, 0xe6,
+    0xea, 0x93, 0x2b, 0xcf, 0xe9, 0x1a, 0x3e, 0x40, 0x6c, 0x3c, 0x33, 0x6d, 0x23, 0x76, 0x62, 0x67,
+    0x86, 0x9b, 0xdd, 0x48, 0x52, 0x5f, 0x6b, 0x68, 0x77, 0xc3, 0x4a, 0xd8, 0xdd, 0xe6, 0xfd, 0x11,
+    0x13, 0xba, 0xd0, 0x03, 0x8c, 0x91, 0x30, 0x38, 0x7e, 0xd7, 0x3b, 0x13, 0x81, 0x0d, 0xfb, 0x9d,
+    0xf6, 0x87, 0x24, 0x48, 0x9a, 0x1d, 0x93, 0xd2, 0x58, 0x97, 0x1b, 0x11, 0x44, 0x2c, 0xd3, 0xa0,
+    0xe6, 0xfe, 0x30, 0x6b, 0xa8, 0x51, 0x7d, 0x13, 0xd7, 0x34, 0x02, 0x7f, 0x4c, 0x42, 0x9e, 0x3a,
+    0x51, 0x17, 0x59, 0x1f, 0x87, 0xef, 0xe0, 0xbc, 0xee, 0xfe, 0x7c, 0x5c, 0xf0, 0xca, 0xce, 0x1a,
+    0x03, 0x1b, 0xf3, 0xd0, 0x0e, 0x2c, 0x87, 0x7b, 0xda, 0x46, 0xd9, 0x9a, 0x88, 0x1e, 0x62, 0x75,
+    0xeb, 0xfe, 0x4d, 0xe1, 0x12, 0xb9, 0x5b, 0x1b, 0x8d, 0x87, 0xeb, 0xb1, 0x1a, 0xda, 0xfc, 0x28,
+    0x10, 0xa9, 0xb0, 0xe1, 0x52, 0x20, 0x21, 0x05, 0x4c, 0x2a, 0xeb, 0x45, 0x13, 0x73, 0xdf, 0xcf,
+    0xe6, 0x42, 0x74, 0x3e, 0x05, 0xd9, 0x79, 0x81, 0xdc, 0x21, 0x34, 0x2e, 0x9c, 0x58, 0xfd, 0xb6,
+    0x61, 0xfb, 0x00, 0xd0, 0x55, 0x7e, 0x58, 0x6a, 0x27, 0x30, 0xe1, 0x21, 0x3c, 0x91, 0xee, 0xfd,
+    0x4e, 0x41, 0x66, 0xc9, 0xaf, 0x7b, 0xa2, 0x5b, 0xcb, 0x9c, 0xcf, 0x94, 0x15, 0x1c, 0x13, 0xdb,
+    0x61, 0x93, 0x0f, 0x16, 0x60, 0x49, 0x10, 0x9f, 0xa3, 0xde, 0x5e, 0x1f, 0xde, 0x71, 0x51, 0x9c,
+    0xa6, 0xee, 0xe6, 0x5b, 0xaa, 0xec, 0x8a, 0x01, 0xdf, 0x32, 0x52, 0x15, 0x42, 0x23, 0x05, 0x25,
+    0x60, 0xb3, 0x76, 0xbb, 0xf9, 0x8c, 0x9b, 0x6d, 0xc1, 0x85, 0x1d, 0x73, 0xeb, 0xc8, 0x0d, 0xb8,
+    0x6d, 0xc8, 0xd4, 0x66, 0x93, 0x5e, 0x2c, 0x99, 0xe1, 0x8b, 0x7a, 0xc6, 0xd6, 0xa2, 0xab, 0xac,
+    0xe0, 0xd6, 0x5c, 0xb2, 0xca, 0xb6, 0xaf, 0x98, 0xa6, 0x79, 0xc4, 0x70, 0x08, 0xbe, 0x6c, 0x47,
+    0x6f, 0x54, 0xf0, 0xae, 0x12, 0xdf, 0x1a, 0x08, 0xa9, 0x94, 0xb6, 0x58, 0xa5, 0xe4, 0x73, 0x71,
+    0xba, 0xe2, 0x2d, 0x84, 0xd5, 0xb1, 0xd4, 0x07, 0xb7, 0x54, 0x89, 0xe8, 0x7c, 0xde, 0x27, 0x8d,
+    0xc1, 0x59, 0x0e, 0x7d, 0xef, 0x3b, 0x7a, 0x72, 0x5c, 0x6a, 0x40, 0xc3, 0x43, 0x3a, 0x72, 0xc2,
+    0xf9, 0xe4, 0x9b, 0x8d, 0xf1, 0x64, 0x61, 0x8a, 0xef, 0x74, 0xc9, 0x85, 0x3b, 0x43, 0xf4, 0xa9,
+    0x8e, 0x06, 0x22, 0x8b, 0xdd, 0x35, 0xe4, 0xed, 0xf2, 0x78, 0x99, 0x96, 0x73, 0x52, 0x6c, 0x0c,
+    0x5d, 0x38, 0x89, 0x63, 0xef, 0xda, 0x59, 0x48, 0xfb, 0x8c, 0x05, 0x2f, 0x3a, 0x59, 0xbb, 0x0d,
+    0xbd, 0x50, 0x7b, 0x9d, 0x71, 0x7a, 0x56, 0x0f, 0x5c, 0x38, 0xf6, 0x97, 0x54, 0x9a, 0x5a, 0x4a,
+    0x0c, 0x27, 0x38, 0xef, 0xfb, 0xbe, 0xe0, 0x94, 0xe6, 0xd0, 0xfc, 0xf1, 0x0e, 0x9f, 0x4c, 0xe1,
+    0x02, 0xb4, 0xe7, 0xd0, 0xea, 0xe0, 0xad, 0x7e, 0x0e, 0x4e, 0x25, 0x8d, 0xd5, 0xd1, 0x3a, 0xb0,
+    0x2e, 0xbc, 0x69, 0x1c, 0x2d, 0xaf, 0xef, 0xe2, 0x43, 0xf7, 0xd6, 0x66, 0x6f, 0x7f, 0x57, 0xba,
+    0x5e, 0xf2, 0x80, 0xde, 0x8b, 0x16, 0xce, 0x0f, 0xa3, 0x12, 0xd1, 0x04, 0x28, 0xc5, 0x0b, 0xb6,
+    0x67, 0xad, 0xf2, 0x40, 0xb2, 0xc1, 0x91, 0xc2, 0xfd, 0xfe, 0x18, 0x25, 0xc3, 0x76, 0x3b, 0x9b,
+    0xaa, 0x3d, 0xbc, 0x09, 0x3b, 0xc7, 0x60, 0xee, 0xc3, 0xf4, 0xf8, 0x80, 0xf3, 0xfb, 0x8f, 0xd9,
+    0x9e, 0x8c, 0xa0, 0x8e, 0x51, 0x48, 0x2c, 0xd4, 0x4a, 0x13, 0x2c, 0xfe, 0x06, 0x5d, 0xe5, 0x46,
+    0xd7, 0x63, 0xa9, 0xb5, 0xe7, 0x03, 0x01, 0xc6, 0x0e, 0xd0, 0xf7, 0xfa, 0xcb, 0xa3, 0x5f, 0x3b,
+    0x71, 0xfa, 0x44, 0x4f, 0x0b, 0x79, 0x7e, 0x79, 0x9e, 0x99, 0xa9, 0xfc, 0xb1, 0xd5, 0x82, 0x7c,
+    0x21, 0x66, 0x11, 0xa3, 0xb3, 0x64, 0x86, 0x53, 0x56, 0xff, 0x99, 0xa7, 0x8d, 0x92, 0x76, 0x94,
+    0xcc, 0x26, 0xcc, 0xf0, 0x76, 0xa7, 0xb4, 0xe6, 0xf5, 0xcc, 0xd6, 0x73, 0x89, 0x0d, 0x52, 0x4e,
+    0x5a, 0xcd, 0xff, 0x54, 0x80, 0x84, 0xac, 0x5a, 0x0b, 0x00, 0x00,
+};
+
+// style-dark.css: 3139 bytes, 2960 minified, 1116 gzipped
+static const uint8_t WEB_ASSET_1[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x56, 0xdb, 0x8e, 0xa3, 0x38,
+    0x10, 0xfd, 0x15, 0xa4, 0xa8, 0x35, 0x89, 0x14, 0x22, 0x2e, 0x21, 0x21, 0x46, 0x2b, 0xcd, 0x3c,
+    0xee, 0xeb, 0xae, 0xf6, 0x69, 0x35, 0x0f, 0x06, 0x17, 0x60, 0x35, 0xd8, 0xc8, 0x36, 0x9d, 0xf4,
+    0x20, 0xfe, 0x7d, 0x6d, 0x2e, 0xe1, 0x12, 0x66, 0x5b, 0x96, 0x10, 0xb1, 0xe3, 0xaa, 0x3a, 0xa7,
+    0x4e, 0x55, 0x11, 0x73, 0xf2, 0xd9, 0xa4, 0x9c, 0x29, 0x3b, 0xc5, 0x25, 0x2d, 0x3e, 0xd1, 0xb7,
+    0xbf, 0x21, 0xe3, 0x60, 0xfd, 0xf3, 0xe7, 0xb7, 0xe3, 0x0f, 0x41, 0x71, 0x71, 0x94, 0x98, 0x49,
+    0x5b, 0x82, 0xa0, 0x69, 0x54, 0x62, 0x91, 0x51, 0x86, 0x9c, 0xa8, 0xc2, 0x84, 0x50, 0x96, 0x21,
+    0xcf, 0xa9, 0x1e, 0x51, 0x8c, 0x93, 0xf7, 0x4c, 0xf0, 0x9a, 0x11, 0xb4, 0x73, 0xb1, 0x59, 0x51,
+    0xc2, 0x0b, 0x2e, 0xd0, 0x0e, 0x1c, 0xb3, 0xda, 0x53, 0xa2, 0xed, 0x63, 0xca, 0x40, 0x34, 0x25,
+    0x7e, 0xd8, 0x77, 0x4a, 0x54, 0x8e, 0x6e, 0x8e, 0xb9, 0x3b, 0x5a, 0xb4, 0x70, 0xad, 0xf8, 0xc2,
+    0x92, 0x47, 0xcc, 0x7a, 0x7a, 0xf2, 0x3b, 0x4f, 0x5c, 0x10, 0x10, 0xb6, 0xc0, 0x84, 0xd6, 0x12,
+    0xb9, 0xfd, 0xd6, 0xc3, 0x96, 0x39, 0x26, 0xfc, 0xae, 0x8d, 0x78, 0xd5, 0xc3, 0x32, 0xbb, 0x96,
+    0xc8, 0x62, 0xbc, 0x77, 0x8e, 0xdd, 0x3a, 0x05, 0x87, 0x36, 0x77, 0x9b, 0x45, 0x48, 0x83, 0x5f,
+    0x5b, 0xf1, 0x4a, 0xa3, 0x19, 0xcc, 0xc6, 0x5c, 0x29, 0x5e, 0x22, 0x5f, 0xdf, 0x97, 0xbc, 0xa0,
+    0xc4, 0xda, 0xf9, 0xe7, 0x5b, 0x48, 0xe2, 0x31, 0x86, 0xf1, 0x0f, 0x6e, 0x50, 0x3d, 0xda, 0xdc,
+    0x1b, 0x2d, 0x12, 0xc7, 0x2c, 0x0d, 0x12, 0x0b, 0xd2, 0xcc, 0x11, 0xf8, 0xa1, 0x59, 0x4b, 0xae,
+    0x06, 0xbc, 0xc6, 0x84, 0xe5, 0xac, 0xf0, 0x84, 0x13, 0xc2, 0x02, 0x52, 0x85, 0xce, 0x2f, 0x81,
+    0xac, 0x68, 0xa5, 0x2c, 0xe5, 0x36, 0x55, 0x50, 0xfe, 0x9f, 0x5b, 0xe3, 0x6a, 0xe5, 0x68, 0xda,
+    0x41, 0xee, 0xe4, 0x23, 0x08, 0x82, 0xc1, 0x64, 0x81, 0x63, 0x28, 0x7a, 0x51, 0x48, 0xfa, 0x0b,
+    0x90, 0xab, 0x79, 0x1d, 0x7d, 0x63, 0x8c, 0x23, 0x05, 0x0f, 0x65, 0x2b, 0xa1, 0x75, 0x91, 0x72,
+    0x51, 0xa2, 0xba, 0xaa, 0x40, 0x24, 0x58, 0xc2, 0xc8, 0xea, 0xc0, 0x93, 0xa1, 0xa9, 0x37, 0xf8,
+    0x81, 0x8b, 0x1a, 0x66, 0x06, 0x3d, 0x0d, 0x2d, 0xea, 0x7e, 0xde, 0x81, 0x66, 0xb9, 0x42, 0x31,
+    0x2f, 0xc8, 0x0a, 0x9d, 0x31, 0xfd, 0x25, 0x9d, 0xaf, 0x04, 0x0e, 0x04, 0x9b, 0x53, 0xcb, 0x69,
+    0x7b, 0x24, 0x84, 0xca, 0xaa, 0xc0, 0x9f, 0x28, 0x2e, 0x78, 0xf2, 0xbe, 0x0a, 0x32, 0x9c, 0xa0,
+    0x0d, 0xd2, 0x98, 0xc7, 0x75, 0x71, 0x9c, 0x96, 0xb2, 0xaa, 0x56, 0xff, 0xaa, 0xcf, 0x0a, 0xfe,
+    0x30, 0xc0, 0x7f, 0x1e, 0x67, 0x1b, 0x15, 0x96, 0xf2, 0xae, 0x63, 0x58, 0x6c, 0xb2, 0xba, 0x8c,
+    0x41, 0xfc, 0x3c, 0x4a, 0x28, 0x20, 0x51, 0x4d, 0x2f, 0x77, 0xd7, 0x71, 0xde, 0xa6, 0x9c, 0x4c,
+    0xb1, 0x23, 0x6f, 0x91, 0x81, 0x8d, 0x4c, 0xcd, 0xf2, 0x70, 0x19, 0x05, 0x4f, 0x7f, 0x19, 0x33,
+    0x4f, 0xdd, 0x3e, 0x56, 0xa0, 0xfa, 0x9c, 0xbf, 0x16, 0xd3, 0x92, 0x61, 0x95, 0xcf, 0xf9, 0x2d,
+    0x74, 0x7d, 0x62, 0x61, 0x67, 0xc6, 0x33, 0x30, 0xb5, 0x77, 0xfd, 0x80, 0x40, 0x76, 0xdc, 0x5d,
+    0x2e, 0x57, 0x00, 0x6c, 0x39, 0x6f, 0xc7, 0xdd, 0xf5, 0x72, 0x8e, 0xb1, 0x67, 0x19, 0x28, 0x87,
+    0xc1, 0xd6, 0x3d, 0xd7, 0xfa, 0x9b, 0x70, 0x19, 0xa1, 0x74, 0xea, 0xc0, 0x05, 0xcd, 0x18, 0x32,
+    0x32, 0x7e, 0xe1, 0x53, 0xe9, 0x2a, 0xd9, 0x12, 0xdf, 0x8a, 0x9d, 0xd7, 0xcc, 0xaf, 0xa2, 0x17,
+    0x88, 0xa9, 0xdc, 0x4e, 0x72, 0x5a, 0x90, 0x3d, 0x7c, 0x00, 0x3b, 0x58, 0x6a, 0x59, 0x7f, 0x3d,
+    0xe8, 0xf6, 0x34, 0x53, 0xdf, 0xef, 0xe5, 0x76, 0xba, 0x63, 0xc1, 0xb4, 0xf7, 0xa5, 0xe4, 0x88,
+    0x1f, 0xb8, 0xb7, 0x8d, 0x5a, 0x49, 0xd3, 0xc4, 0x75, 0xae, 0x5f, 0xd5, 0xd8, 0x42, 0x8b, 0xa3,
+    0x3f, 0x7d, 0x15, 0x7b, 0x61, 0x7b, 0x4a, 0x39, 0x57, 0xba, 0x21, 0xce, 0xd8, 0x4a, 0x34, 0xed,
+    0x20, 0xe6, 0xad, 0xa9, 0x6b, 0x7a, 0xc3, 0xbd, 0x30, 0x0c, 0xe7, 0x52, 0x38, 0x9b, 0xe2, 0x62,
+    0xf8, 0x63, 0x19, 0xef, 0xa2, 0x5f, 0xf5, 0x61, 0x0d, 0x41, 0xd8, 0xc6, 0x96, 0xd5, 0x3f, 0xa7,
+    0xd7, 0x8d, 0x8e, 0xda, 0x37, 0x50, 0x47, 0x07, 0x3c, 0x96, 0x4d, 0x5a, 0xc0, 0x23, 0xea, 0x42,
+    0xec, 0x9a, 0x8d, 0x1c, 0x03, 0x35, 0xfb, 0xf6, 0x5d, 0xe0, 0x0a, 0x99, 0x47, 0x17, 0x8d, 0x85,
+    0x9b, 0xb9, 0x2e, 0x3a, 0x70, 0x04, 0x12, 0x2e, 0xb0, 0xa2, 0x9c, 0x21, 0xc6, 0x19, 0x2c, 0xd2,
+    0x6c, 0x79, 0x8b, 0x21, 0xf0, 0x22, 0xdb, 0x5b, 0xe8, 0xc4, 0xb7, 0x0d, 0x66, 0xc7, 0xd0, 0x28,
+    0x33, 0xb2, 0xb5, 0xbb, 0xc2, 0x1e, 0x02, 0x40, 0x39, 0xff, 0xd0, 0xbc, 0x2e, 0xcc, 0xb8, 0x17,
+    0x37, 0x4c, 0xfa, 0xf3, 0x93, 0x80, 0x58, 0x33, 0xdf, 0x0c, 0x2c, 0x77, 0x8d, 0xf6, 0x65, 0xf6,
+    0xc0, 0xf5, 0x9c, 0xf8, 0xcb, 0x0b, 0x1b, 0x66, 0x13, 0xc7, 0xbf, 0x79, 0x71, 0xdf, 0xe2, 0x9e,
+    0x3d, 0x26, 0x13, 0x94, 0x44, 0xe6, 0x61, 0x6b, 0xaa, 0xf4, 0x8e, 0x02, 0x5b, 0x33, 0x52, 0x97,
+    0x4c, 0x22, 0x01, 0x15, 0x60, 0xb5, 0x37, 0xde, 0xec, 0x94, 0xaa, 0x63, 0x49, 0x99, 0x1e, 0x87,
+    0x7b, 0xcf, 0x0c, 0xc2, 0xa3, 0x9b, 0x8a, 0xc3, 0x21, 0xca, 0x34, 0x99, 0xee, 0x8b, 0x74, 0xe6,
+    0x2d, 0x48, 0xd6, 0x71, 0x49, 0x75, 0x13, 0x8a, 0x6b, 0x5d, 0xe9, 0x6c, 0x09, 0xf3, 0x8a, 0xe1,
+    0xe2, 0xfc, 0xb6, 0x30, 0xad, 0x59, 0xc2, 0xfb, 0x4c, 0x7c, 0xd9, 0x6b, 0x92, 0x5a, 0x48, 0x6d,
+    0xab, 0xe2, 0x74, 0xad, 0x4c, 0x93, 0xbc, 0x8d, 0xb0, 0x7a, 0x96, 0x86, 0xe0, 0xb6, 0x32, 0xe1,
+    0xdd, 0x6e, 0xc1, 0xb9, 0x55, 0x38, 0x2e, 0x60, 0xe8, 0x02, 0x86, 0x9e, 0x02, 0x57, 0x12, 0xd0,
+    0xf8, 0x12, 0xcd, 0x3a, 0xe6, 0x7a, 0x5e, 0xae, 0x86, 0xfd, 0x79, 0x3d, 0xeb, 0xdd, 0x43, 0x7b,
+    0x92, 0x15, 0x65, 0xe6, 0x5b, 0x63, 0x80, 0x3a, 0x1b, 0xa3, 0xa9, 0x6f, 0xd6, 0x88, 0xdb, 0xe0,
+    0x78, 0x9d, 0xb1, 0x2b, 0x52, 0x74, 0x0c, 0x7d, 0x38, 0x67, 0xc3, 0x5e, 0xde, 0xf7, 0x8f, 0xee,
+    0x1d, 0x33, 0x5a, 0xf6, 0xb2, 0x36, 0x0e, 0x2d, 0x57, 0x5a, 0x7d, 0x0b, 0xb5, 0xb4, 0x1e, 0x28,
+    0x33, 0xec, 0x6f, 0xa9, 0x34, 0xd2, 0x94, 0x28, 0x9a, 0xe0, 0x62, 0x28, 0xfa, 0x92, 0x12, 0x52,
+    0x40, 0xfb, 0xfd, 0x1d, 0x3e, 0x53, 0x81, 0x4b, 0x90, 0x96, 0xb1, 0xd6, 0x38, 0x6f, 0xcd, 0x34,
+    0x60, 0x05, 0x57, 0x5a, 0x47, 0x7b, 0x47, 0xf7, 0xe3, 0x43, 0x6b, 0x68, 0x79, 0x3d, 0xf3, 0x2f,
+    0xfd, 0xa9, 0x46, 0xaf, 0x7f, 0xd7, 0xb2, 0xd9, 0xea, 0x01, 0x43, 0x23, 0xda, 0xf8, 0xea, 0x98,
+    0xa5, 0x88, 0x9c, 0x81, 0x10, 0xbc, 0xd1, 0xf3, 0x12, 0x1f, 0x2e, 0xc9, 0xf3, 0x1b, 0xc4, 0x0d,
+    0x82, 0xab, 0x77, 0x1e, 0xdd, 0x9d, 0x34, 0x54, 0xfd, 0x91, 0xc7, 0xf4, 0xbc, 0x83, 0x65, 0x13,
+    0x4e, 0x43, 0x72, 0x7d, 0x9a, 0xb3, 0xc7, 0x1e, 0x18, 0x24, 0x33, 0x53, 0x57, 0xcf, 0x4d, 0xb4,
+    0xa9, 0x9d, 0x4c, 0x30, 0xfb, 0x0b, 0x64, 0x5d, 0x28, 0xd9, 0xcc, 0xa5, 0xd6, 0x7d, 0x47, 0x30,
+    0x50, 0x7a, 0xd0, 0xbe, 0xcf, 0x6d, 0x6f, 0xcc, 0x9e, 0x01, 0x68, 0xb8, 0x81, 0x73, 0xfb, 0xa3,
+    0x87, 0x10, 0xb2, 0x52, 0xf9, 0xd3, 0xd5, 0x86, 0x7c, 0xc1, 0x4f, 0xbd, 0x94, 0xac, 0xc0, 0xf4,
+    0xba, 0x79, 0x5e, 0xb3, 0xa4, 0x12, 0x5c, 0xcf, 0x91, 0xe1, 0xd4, 0xd3, 0xb4, 0x05, 0xce, 0x74,
+    0x7a, 0x12, 0x52, 0xd2, 0xf1, 0xf0, 0x9a, 0x86, 0x49, 0x48, 0x74, 0x23, 0xe5, 0x58, 0x21, 0x61,
+    0xa4, 0xd5, 0xfe, 0x07, 0x5d, 0xc2, 0x8f, 0x71, 0x90, 0x0b, 0x00, 0x00,
+};
+
+// app.js: 5326 bytes, 4785 minified, 1522 gzipped
+static const uint8_t WEB_ASSET_2[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xc5, 0x57, 0xdb, 0x6e, 0xdb, 0x38,
+    0x10, 0x7d, 0xf7, 0x57, 0x30, 0x29, 0x76, 0x29, 0xad, 0x53, 0xd9, 0x69, 0xd1, 0x2c, 0x10, 0x47,
+    0x36, 0xd2, 0xb4, 0x41, 0x03, 0xb4, 0x45, 0x11, 0xf7, 0xf2, 0x52, 0xa0, 0xa0, 0x25, 0xca, 0xe6,
+    0x46, 0xa6, 0x04, 0x8a, 0xb2, 0x13, 0xa4, 0xf9, 0xf7, 0xce, 0x90, 0x94, 0x25, 0x39, 0x76, 0xea,
+    0xa4, 0x0f, 0xfb, 0x10, 0xc4, 0x22, 0x87, 0x9c, 0x99, 0x33, 0x67, 0x2e, 0x4c, 0x4a, 0x19, 0x69,
+    0x91, 0x49, 0x52, 0xb0, 0x05, 0x3f, 0x2d, 0x75, 0x76, 0x21, 0x0b, 0xcd, 0xd2, 0xd4, 0xf3, 0xc9,
+    0x6d, 0x67, 0xc1, 0x14, 0xe1, 0x92, 0x4d, 0x52, 0x1e, 0x93, 0x90, 0xc4, 0x59, 0x54, 0xce, 0xb9,
+    0xd4, 0xc1, 0x94, 0xeb, 0xb7, 0x29, 0xc7, 0x9f, 0xaf, 0x6f, 0x2e, 0x62, 0x8f, 0xb2, 0xfa, 0x18,
+    0xf5, 0x83, 0x68, 0xc6, 0xa3, 0x2b, 0x38, 0x30, 0x22, 0xf4, 0x90, 0x92, 0x63, 0x42, 0xfb, 0x74,
+    0xd0, 0x49, 0xb8, 0x8e, 0x66, 0x1e, 0xed, 0x65, 0x9a, 0xf5, 0x50, 0xfc, 0xb9, 0xb0, 0xf2, 0x23,
+    0x77, 0x7d, 0x48, 0x49, 0xb7, 0x52, 0xe5, 0x07, 0x7a, 0xc6, 0xa5, 0x97, 0x38, 0xcb, 0x3c, 0xe5,
+    0xdf, 0x12, 0xc5, 0x75, 0xa9, 0x24, 0x51, 0xc1, 0x7f, 0x05, 0xac, 0xf8, 0x03, 0x72, 0xb7, 0x2e,
+    0x15, 0x33, 0xcd, 0xfc, 0xdb, 0x4e, 0x94, 0xc9, 0x22, 0x4b, 0x79, 0x90, 0x66, 0x53, 0x8f, 0x9e,
+    0x36, 0x34, 0x19, 0x07, 0xe3, 0x63, 0x7a, 0x40, 0x8c, 0xe4, 0xa0, 0x73, 0x87, 0x7f, 0x9d, 0x64,
+    0xe5, 0x7f, 0x39, 0x99, 0x0b, 0x3d, 0x3e, 0x3f, 0xfa, 0xca, 0xd2, 0x92, 0x17, 0x2b, 0xff, 0xd1,
+    0xf3, 0x9c, 0xa9, 0x82, 0x9f, 0xa7, 0x19, 0xd3, 0xde, 0x56, 0x10, 0x62, 0x2e, 0x0b, 0xa1, 0x6f,
+    0x40, 0x5d, 0x5e, 0x6a, 0x80, 0x61, 0x81, 0xd7, 0x80, 0x0a, 0xbc, 0x23, 0xdf, 0xf1, 0x8e, 0x5c,
+    0xf1, 0xa2, 0x28, 0x15, 0xdf, 0x78, 0x89, 0xde, 0xf1, 0x12, 0xcd, 0xe7, 0x39, 0x57, 0x4c, 0x6f,
+    0xba, 0xa7, 0x0a, 0x43, 0x91, 0x1c, 0xf5, 0xca, 0x1c, 0x80, 0xe0, 0x23, 0x67, 0xb7, 0x09, 0xc0,
+    0x07, 0xa6, 0x67, 0x81, 0xca, 0x4a, 0x19, 0x7b, 0x31, 0xf9, 0x87, 0x1c, 0xf6, 0xfb, 0x3e, 0xac,
+    0xd2, 0xbf, 0x2b, 0xbb, 0xd6, 0x85, 0x72, 0x23, 0x64, 0x65, 0x1a, 0x6a, 0xd7, 0xc5, 0xb4, 0x15,
+    0x03, 0xfd, 0x2c, 0xe5, 0x4a, 0x7b, 0xd4, 0x42, 0x4c, 0xac, 0x05, 0xf1, 0x1e, 0x85, 0x1d, 0x17,
+    0xe0, 0x84, 0xa5, 0x05, 0x6f, 0xc5, 0x05, 0x54, 0xf3, 0xb5, 0xb0, 0x88, 0x84, 0x78, 0x7b, 0x10,
+    0xe8, 0x44, 0xa8, 0xb9, 0x47, 0x2f, 0x51, 0x80, 0x80, 0x04, 0x31, 0x5e, 0x16, 0x23, 0xea, 0xfb,
+    0x8e, 0x2f, 0x6d, 0x87, 0xcd, 0x4d, 0xf4, 0x9e, 0x15, 0x66, 0xd9, 0xd8, 0x00, 0xff, 0x3f, 0x8b,
+    0x39, 0xcf, 0x4a, 0x5d, 0xd3, 0x0a, 0xf4, 0x91, 0x34, 0x8b, 0x18, 0x7e, 0x04, 0x8a, 0x03, 0xf4,
+    0xb1, 0xa1, 0xdf, 0x01, 0xa2, 0xd3, 0x6f, 0x53, 0x48, 0x67, 0xd3, 0x69, 0xca, 0x3f, 0xa9, 0x2c,
+    0x11, 0x29, 0xf7, 0x44, 0x7c, 0x0d, 0xc4, 0xad, 0x0c, 0x48, 0x33, 0xc5, 0x96, 0x4c, 0xf6, 0x72,
+    0xbb, 0xdb, 0xb3, 0xb2, 0x23, 0x21, 0x63, 0x7e, 0x1d, 0xd2, 0x2e, 0x0a, 0x5b, 0x42, 0x7b, 0x7e,
+    0x38, 0xbc, 0xa7, 0x10, 0x35, 0xd6, 0x7a, 0x18, 0xfc, 0x5b, 0x00, 0x72, 0x6d, 0x4d, 0x22, 0xf1,
+    0x56, 0x98, 0x8c, 0x97, 0x02, 0xd4, 0x12, 0xa7, 0x6c, 0x44, 0xde, 0xf0, 0x85, 0x88, 0x38, 0x59,
+    0x0a, 0xc8, 0x03, 0xf0, 0x57, 0x33, 0xa5, 0x03, 0x84, 0x69, 0x9b, 0x75, 0x95, 0x86, 0x2d, 0xf6,
+    0xdd, 0x12, 0x07, 0xe1, 0xa5, 0xbd, 0x4b, 0xc8, 0x69, 0x10, 0xc0, 0x85, 0x03, 0xd2, 0x80, 0xb0,
+    0xe5, 0xc8, 0x4c, 0xf1, 0x24, 0xa4, 0x3d, 0x7a, 0x80, 0xa8, 0xf5, 0x4d, 0xfe, 0xb6, 0x5c, 0xb2,
+    0x70, 0x60, 0xbe, 0x5e, 0x42, 0x89, 0xd0, 0xdc, 0xe3, 0x1b, 0xb0, 0x33, 0x85, 0x43, 0x99, 0xfd,
+    0xba, 0x6e, 0x74, 0x3d, 0x3e, 0x82, 0x42, 0x73, 0x0c, 0x65, 0xc6, 0xdf, 0x1d, 0xc2, 0x22, 0x62,
+    0xf2, 0x23, 0xd7, 0xcb, 0x4c, 0x5d, 0x01, 0xa7, 0x6e, 0x3b, 0x5b, 0xb3, 0x09, 0x05, 0x5f, 0x6b,
+    0x09, 0x39, 0x14, 0x8b, 0xc2, 0xaa, 0xd4, 0xaa, 0x04, 0x8a, 0xee, 0x70, 0x42, 0x48, 0xc9, 0xd5,
+    0xbb, 0xcf, 0x1f, 0xde, 0x87, 0xf4, 0xa4, 0xc8, 0x99, 0x24, 0x51, 0xca, 0x8a, 0x22, 0xdc, 0x2f,
+    0x72, 0xb3, 0xb3, 0x4f, 0x0a, 0x7d, 0x93, 0xf2, 0x70, 0x7f, 0x29, 0x62, 0x3d, 0x3b, 0x7e, 0xd1,
+    0xcf, 0xaf, 0x07, 0x33, 0x2e, 0xa6, 0x33, 0x6d, 0x7f, 0x4f, 0x32, 0x15, 0x73, 0xf5, 0xdc, 0xee,
+    0xbe, 0x84, 0x85, 0xfd, 0xe1, 0x49, 0x0f, 0xef, 0x19, 0x92, 0x31, 0xe8, 0x90, 0x0e, 0xf5, 0x9a,
+    0xe4, 0x4b, 0x91, 0x88, 0x1e, 0xaa, 0xa7, 0x0e, 0x08, 0x15, 0x0e, 0xab, 0x8a, 0xe9, 0x56, 0xb0,
+    0xf6, 0x41, 0xfc, 0x3a, 0x29, 0xa4, 0xcc, 0x4c, 0xcf, 0xd3, 0x90, 0xc2, 0x79, 0x5c, 0x0c, 0xa4,
+    0x43, 0x23, 0x48, 0x32, 0xf5, 0x96, 0xc1, 0x7d, 0x12, 0xe5, 0x50, 0xa6, 0x0b, 0xe6, 0xc7, 0x62,
+    0x51, 0x59, 0xef, 0x04, 0xf7, 0x49, 0x26, 0xa3, 0x54, 0x44, 0x57, 0xe0, 0x0f, 0x4f, 0x79, 0xa4,
+    0x1d, 0x9c, 0xde, 0x77, 0x4a, 0xbb, 0x32, 0x28, 0x0a, 0x11, 0x77, 0xe9, 0x77, 0xea, 0x83, 0xd1,
+    0x85, 0x56, 0x99, 0x9c, 0x0e, 0xeb, 0x65, 0x70, 0xc3, 0x2e, 0xb5, 0x60, 0x51, 0xb0, 0xb9, 0x6f,
+    0xa4, 0xf0, 0x57, 0x97, 0x92, 0xf8, 0xf5, 0xdc, 0x39, 0x7c, 0xd2, 0x03, 0x03, 0x86, 0xd4, 0x16,
+    0xed, 0x07, 0x91, 0x07, 0x46, 0x96, 0xa9, 0x2e, 0x5a, 0xe8, 0xa3, 0x13, 0x83, 0x47, 0x85, 0xd8,
+    0x95, 0xa1, 0xc7, 0xc5, 0x18, 0x83, 0x42, 0x00, 0x3d, 0x52, 0x11, 0xcb, 0xd8, 0x1b, 0x00, 0x0f,
+    0x01, 0x4d, 0x8e, 0x68, 0x3e, 0xda, 0x72, 0x7a, 0x92, 0x57, 0x24, 0x89, 0x32, 0x48, 0x83, 0x63,
+    0xc5, 0x63, 0xa0, 0x81, 0xd5, 0xc4, 0x20, 0x53, 0xe3, 0x93, 0x5e, 0x8e, 0xb8, 0xfc, 0x4f, 0xce,
+    0xb5, 0x3b, 0x68, 0x8b, 0x06, 0x18, 0xe9, 0x07, 0x13, 0x0b, 0xf6, 0xab, 0xce, 0x14, 0xe2, 0xc7,
+    0x5a, 0xd5, 0x4f, 0xa0, 0x4e, 0xcd, 0xc6, 0x90, 0xeb, 0xa5, 0x49, 0xd0, 0x36, 0xc7, 0xcd, 0xf2,
+    0x6e, 0x2c, 0xb7, 0xb2, 0xef, 0x2a, 0xae, 0x43, 0x95, 0x34, 0x74, 0x07, 0xea, 0x82, 0x29, 0x3f,
+    0xa0, 0x62, 0x4a, 0x30, 0x9a, 0xa3, 0xa9, 0x4d, 0xc9, 0x26, 0xe1, 0xed, 0x7a, 0xcd, 0xe3, 0xb3,
+    0xea, 0x0c, 0x54, 0x2d, 0xf2, 0x4d, 0x9c, 0x8b, 0x9a, 0xce, 0x13, 0x35, 0x1c, 0x8f, 0x2f, 0xde,
+    0xc0, 0xd0, 0xd3, 0x6d, 0x6a, 0x71, 0xac, 0x87, 0xdd, 0x8b, 0x4f, 0xe4, 0x34, 0x8e, 0xb1, 0x9d,
+    0xae, 0xcb, 0x88, 0xdc, 0x4a, 0x8c, 0xc5, 0x54, 0xb2, 0x74, 0x7d, 0xb7, 0x99, 0x11, 0x55, 0x2a,
+    0x70, 0x08, 0x23, 0xa9, 0xfc, 0x31, 0xd3, 0xcd, 0x0f, 0x07, 0xfa, 0xc3, 0x9e, 0x10, 0x60, 0xc2,
+    0xca, 0xef, 0xda, 0xad, 0x8f, 0x99, 0x26, 0x2b, 0xd7, 0xda, 0x2e, 0xe1, 0xdd, 0xc4, 0xe5, 0xfd,
+    0xca, 0xb2, 0x5a, 0xa3, 0x35, 0xfc, 0x1b, 0x36, 0x17, 0xad, 0x6e, 0x10, 0x15, 0x77, 0x3d, 0x94,
+    0x08, 0x38, 0x76, 0xad, 0xc9, 0x24, 0xcb, 0x74, 0xdb, 0xf0, 0x27, 0x1b, 0x69, 0x10, 0x47, 0x43,
+    0x13, 0x31, 0x85, 0x59, 0xa3, 0x6d, 0xe9, 0x17, 0x40, 0x04, 0x18, 0x80, 0x44, 0x9d, 0x93, 0x09,
+    0x54, 0xfe, 0x65, 0xd3, 0x1a, 0xf8, 0xc9, 0xec, 0x71, 0xe7, 0x4b, 0x6d, 0xd2, 0x03, 0x3c, 0x35,
+    0xe6, 0x9c, 0x2a, 0xce, 0x5a, 0x09, 0x51, 0x5b, 0x7f, 0x2f, 0x0f, 0xcc, 0x00, 0x7c, 0x9e, 0xa9,
+    0x2f, 0x66, 0xbc, 0x31, 0xec, 0xc5, 0xf9, 0x6d, 0xa2, 0xe5, 0x43, 0x43, 0xb4, 0x39, 0x65, 0xd2,
+    0xce, 0x8e, 0x7b, 0x0e, 0x86, 0x07, 0x4e, 0xd8, 0xf1, 0x69, 0xec, 0x72, 0x61, 0xd0, 0x01, 0x05,
+    0xeb, 0x4d, 0x0a, 0x97, 0x1a, 0x49, 0x7c, 0x86, 0x3a, 0xee, 0xb5, 0x0d, 0x9c, 0xc9, 0x8d, 0x76,
+    0xba, 0x61, 0xf2, 0x5e, 0x1f, 0xbc, 0xb7, 0xcd, 0xdd, 0x2d, 0xe5, 0xae, 0xc2, 0x6c, 0xd2, 0x6e,
+    0x6a, 0x88, 0x43, 0xa6, 0x91, 0x8e, 0x5c, 0xa9, 0x4c, 0xf9, 0xce, 0xe9, 0x56, 0x01, 0x6c, 0x30,
+    0x63, 0xc9, 0x14, 0x36, 0x3d, 0xec, 0x11, 0xf5, 0x21, 0xec, 0x26, 0x2e, 0x8a, 0xad, 0x84, 0xb0,
+    0xe8, 0x9c, 0x2e, 0xa0, 0x4a, 0xa2, 0x51, 0xbf, 0xbb, 0x3b, 0x62, 0x2a, 0x5e, 0x35, 0xe4, 0x09,
+    0x8b, 0xae, 0xa6, 0x66, 0x76, 0x3d, 0x7e, 0x76, 0xc8, 0x5f, 0x1d, 0xbd, 0x3c, 0xac, 0x9a, 0xb1,
+    0xad, 0xc2, 0xcf, 0x5e, 0xfc, 0xcb, 0xf8, 0x51, 0x7f, 0xe0, 0xbe, 0x92, 0x24, 0x19, 0xd4, 0x14,
+    0xb5, 0xce, 0x11, 0x56, 0x69, 0xde, 0x6b, 0x31, 0xf4, 0xac, 0x54, 0x0a, 0x22, 0x58, 0xe7, 0xb7,
+    0xfd, 0xfe, 0xca, 0x55, 0x01, 0x68, 0xda, 0x4c, 0x7a, 0x8f, 0xe0, 0xd4, 0x22, 0xa9, 0xf9, 0x6c,
+    0x49, 0xd8, 0xbf, 0x52, 0x6b, 0xa0, 0x5b, 0xdd, 0x86, 0x71, 0x14, 0xb3, 0xda, 0x3d, 0x68, 0xbb,
+    0xee, 0x45, 0xe6, 0xc0, 0x3e, 0xe9, 0x59, 0xf1, 0x61, 0x1b, 0xad, 0x1d, 0x40, 0x01, 0x87, 0x30,
+    0x73, 0xf0, 0x92, 0xed, 0x56, 0xd7, 0xfd, 0xd9, 0xf5, 0xbb, 0x15, 0x3f, 0x70, 0x90, 0xdb, 0x40,
+    0x0e, 0xf2, 0x7b, 0x72, 0x90, 0xf5, 0xfe, 0xd2, 0xf4, 0x0f, 0x5f, 0x01, 0x8d, 0x47, 0xc0, 0x18,
+    0xf7, 0x08, 0xfe, 0x06, 0x92, 0x70, 0xf7, 0xb2, 0xc0, 0x97, 0x40, 0xf5, 0x10, 0x78, 0x5a, 0x4a,
+    0xed, 0x06, 0x0f, 0x9c, 0xb1, 0x49, 0xd5, 0x2a, 0x63, 0x6e, 0xc8, 0x73, 0x80, 0xaf, 0x10, 0x6a,
+    0x66, 0x9d, 0xf1, 0xe8, 0x4f, 0xb2, 0x6e, 0x55, 0xfd, 0xf1, 0x22, 0x68, 0x62, 0x38, 0x7f, 0x5f,
+    0x48, 0xcd, 0x15, 0xb4, 0x55, 0xcf, 0xe4, 0x34, 0xbc, 0x11, 0xa6, 0xd8, 0x6e, 0x0e, 0xdc, 0x73,
+    0x65, 0x87, 0xa8, 0x37, 0xd2, 0xac, 0x91, 0x9c, 0x3f, 0x7f, 0xd2, 0x73, 0x33, 0x71, 0x50, 0xbf,
+    0x15, 0xef, 0xfb, 0xa5, 0xaf, 0x52, 0xd9, 0x6c, 0xdb, 0xce, 0xdb, 0x46, 0xd7, 0x7e, 0x8a, 0xbb,
+    0x4f, 0x0b, 0x62, 0x03, 0x24, 0x58, 0x09, 0xc3, 0x90, 0x16, 0x65, 0x14, 0x81, 0x81, 0x14, 0xa8,
+    0xf9, 0x67, 0x55, 0xa1, 0x55, 0x00, 0x5c, 0xe2, 0x47, 0xd9, 0x3c, 0x87, 0xc1, 0x83, 0xef, 0x91,
+    0x4b, 0x8e, 0x7d, 0xcf, 0x51, 0xc3, 0x21, 0x46, 0x36, 0x3e, 0x32, 0x6f, 0xef, 0x3f, 0x31, 0xef,
+    0x0e, 0x0e, 0x5f, 0xb9, 0xa7, 0x52, 0xbb, 0xb0, 0xd5, 0x6e, 0x24, 0x2e, 0x1e, 0xbb, 0xc6, 0xd3,
+    0xc6, 0x6f, 0x95, 0xc4, 0x73, 0x80, 0x80, 0x4d, 0xf9, 0x7a, 0x01, 0xdd, 0x85, 0xf3, 0x55, 0x88,
+    0x57, 0x77, 0xe5, 0x6e, 0xa1, 0x4b, 0xff, 0xc2, 0xda, 0xb4, 0x55, 0x83, 0xe5, 0x0b, 0x3e, 0xe0,
+    0x77, 0x6a, 0xb8, 0xfe, 0xfa, 0x20, 0x38, 0xe8, 0xfc, 0x02, 0xd6, 0x44, 0x3e, 0x77, 0xb1, 0x12,
+    0x00, 0x00,
+};
+
+static const WebAsset WEB_ASSETS[] = {
+    { "style-light.css", "text/css", WEB_ASSET_0, sizeof(WEB_ASSET_0), "\"c7f181a56ac7\"", "c7f181a56ac7" },
+    { "style-dark.css", "text/css", WEB_ASSET_1, sizeof(WEB_ASSET_1), "\"f325f9ce8959\"", "f325f9ce8959" },
+    { "app.js", "application/javascript", WEB_ASSET_2, sizeof(WEB_ASSET_2), "\"02b54cb3a0ae\"", "02b54cb3a0ae" },
+};
+
+static const size_t WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);
+
+#endif // WEB_ASSETS_H
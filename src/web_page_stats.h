@@ -0,0 +1,25 @@
+#ifndef WEB_PAGE_STATS_H
+#define WEB_PAGE_STATS_H
+
+#include <stdint.h>
+
+// ============================================================================
+// WEB PAGE RENDERING STATISTICS
+// ============================================================================
+// Kept by HtmlStream (html_stream.h), shown on /stats and /api/v1/stats.
+// Separate from the stream so the JSON serializers build on the host.
+
+struct WebPageStats {
+    uint32_t pages;              // Pages rendered since boot
+    uint32_t last_heap;          // Bytes of heap taken while rendering (free at start - lowest free)
+    uint32_t max_heap;
+    uint32_t last_first_byte_us; // Handler start to first byte handed to the server
+    uint32_t max_first_byte_us;
+    uint32_t last_total_us;      // Handler start to end()
+    uint32_t last_bytes;
+    uint32_t max_bytes;
+    uint16_t last_chunks;
+    char last_uri[32];
+};
+
+#endif // WEB_PAGE_STATS_H
@@ -1,8 +1,14 @@
 #include "web_server.h"
 #include "web_pages.h"
+#include "web_assets.h"
 #include "config.h"
+#include "boot_timeline.h"
+#include "power_manager.h"
+#include "logger.h"
+#include "api_json.h"
 #include <Preferences.h>
 #include <esp_tls.h>
+#include <esp_heap_caps.h>
 
 // Global instance
 WebServerManager webServer;
@@ -47,7 +53,8 @@ void WebServerManager::begin() {
     Serial.printf("Key starts: %.30s\n", server_key_pem);
     
     // Configure server settings
-    config.httpd.max_uri_handlers = 30;
+    config.httpd.max_uri_handlers = 48;
+    config.httpd.uri_match_fn = httpd_uri_match_wildcard;  // /static/*
     config.httpd.stack_size = 16384;  // Large stack for SSL
     config.httpd.server_port = 443;
     config.port_secure = 443;
@@ -60,6 +67,7 @@ void WebServerManager::begin() {
     }
     
     Serial.println("HTTPS server started on port 443");
+    bootTimeline.mark(BOOT_HTTPS_STARTED, millis());
     
     // Setup routes
     setupRoutes();
@@ -96,10 +104,14 @@ void WebServerManager::setupRoutes() {
     httpd_uri_t uri_registers = { .uri = "/registers", .method = HTTP_GET, .handler = handleRegisters, .user_ctx = nullptr };
     httpd_uri_t uri_lorawan = { .uri = "/lorawan", .method = HTTP_GET, .handler = handleLoRaWAN, .user_ctx = nullptr };
     httpd_uri_t uri_lorawan_profiles = { .uri = "/lorawan/profiles", .method = HTTP_GET, .handler = handleLoRaWANProfiles, .user_ctx = nullptr };
+    httpd_uri_t uri_lorawan_frames = { .uri = "/lorawan/frames", .method = HTTP_GET, .handler = handleLoRaWANFrames, .user_ctx = nullptr };
+    httpd_uri_t uri_lorawan_payload = { .uri = "/lorawan/payload", .method = HTTP_GET, .handler = handleLoRaWANPayload, .user_ctx = nullptr };
+    httpd_uri_t uri_payload_decoder = { .uri = "/lorawan/payload/decoder.js", .method = HTTP_GET, .handler = handleLoRaWANPayloadDecoder, .user_ctx = nullptr };
     httpd_uri_t uri_wifi = { .uri = "/wifi", .method = HTTP_GET, .handler = handleWiFi, .user_ctx = nullptr };
     httpd_uri_t uri_wifi_scan = { .uri = "/wifi/scan", .method = HTTP_GET, .handler = handleWiFiScan, .user_ctx = nullptr };
     httpd_uri_t uri_wifi_status = { .uri = "/wifi/status", .method = HTTP_GET, .handler = handleWiFiStatus, .user_ctx = nullptr };
     httpd_uri_t uri_security = { .uri = "/security", .method = HTTP_GET, .handler = handleSecurity, .user_ctx = nullptr };
+    httpd_uri_t uri_logs = { .uri = "/logs", .method = HTTP_GET, .handler = handleLogs, .user_ctx = nullptr };
     httpd_uri_t uri_ota = { .uri = "/ota", .method = HTTP_GET, .handler = handleOTA, .user_ctx = nullptr };
     httpd_uri_t uri_ota_check = { .uri = "/ota/check", .method = HTTP_GET, .handler = handleOTACheck, .user_ctx = nullptr };
     httpd_uri_t uri_ota_start = { .uri = "/ota/start", .method = HTTP_GET, .handler = handleOTAStart, .user_ctx = nullptr };
@@ -115,14 +127,21 @@ void WebServerManager::setupRoutes() {
     httpd_uri_t uri_auto_rotate = { .uri = "/lorawan/auto-rotate", .method = HTTP_GET, .handler = handleLoRaWANAutoRotate, .user_ctx = nullptr };
     httpd_uri_t uri_darkmode = { .uri = "/darkmode", .method = HTTP_GET, .handler = handleDarkMode, .user_ctx = nullptr };
     httpd_uri_t uri_enable_auth = { .uri = "/security/enable", .method = HTTP_GET, .handler = handleEnableAuth, .user_ctx = nullptr };
+    httpd_uri_t uri_static = { .uri = "/static/*", .method = HTTP_GET, .handler = handleStatic, .user_ctx = nullptr };
+    httpd_uri_t uri_api_registers = { .uri = "/api/v1/registers", .method = HTTP_GET, .handler = handleApiRegisters, .user_ctx = nullptr };
+    httpd_uri_t uri_api_stats = { .uri = "/api/v1/stats", .method = HTTP_GET, .handler = handleApiStats, .user_ctx = nullptr };
+    httpd_uri_t uri_api_lorawan = { .uri = "/api/v1/lorawan", .method = HTTP_GET, .handler = handleApiLoRaWAN, .user_ctx = nullptr };
+    httpd_uri_t uri_api_profiles = { .uri = "/api/v1/profiles", .method = HTTP_GET, .handler = handleApiProfiles, .user_ctx = nullptr };
 
     // POST routes
     httpd_uri_t uri_config = { .uri = "/config", .method = HTTP_POST, .handler = handleConfig, .user_ctx = nullptr };
     httpd_uri_t uri_lorawan_config = { .uri = "/lorawan/config", .method = HTTP_POST, .handler = handleLoRaWANConfig, .user_ctx = nullptr };
     httpd_uri_t uri_profile_update = { .uri = "/lorawan/profile/update", .method = HTTP_POST, .handler = handleLoRaWANProfileUpdate, .user_ctx = nullptr };
+    httpd_uri_t uri_payload_update = { .uri = "/lorawan/payload/update", .method = HTTP_POST, .handler = handleLoRaWANPayloadUpdate, .user_ctx = nullptr };
     httpd_uri_t uri_wifi_connect = { .uri = "/wifi/connect", .method = HTTP_POST, .handler = handleWiFiConnect, .user_ctx = nullptr };
     httpd_uri_t uri_security_update = { .uri = "/security/update", .method = HTTP_POST, .handler = handleSecurityUpdate, .user_ctx = nullptr };
     httpd_uri_t uri_debug_update = { .uri = "/security/debug", .method = HTTP_POST, .handler = handleDebugUpdate, .user_ctx = nullptr };
+    httpd_uri_t uri_log_levels = { .uri = "/logs/levels", .method = HTTP_POST, .handler = handleLogLevels, .user_ctx = nullptr };
     httpd_uri_t uri_ota_config = { .uri = "/ota/config", .method = HTTP_POST, .handler = handleOTAConfig, .user_ctx = nullptr };
 
     // Register all handlers
@@ -131,10 +150,14 @@ void WebServerManager::setupRoutes() {
     httpd_register_uri_handler(httpsServer, &uri_registers);
     httpd_register_uri_handler(httpsServer, &uri_lorawan);
     httpd_register_uri_handler(httpsServer, &uri_lorawan_profiles);
+    httpd_register_uri_handler(httpsServer, &uri_lorawan_frames);
+    httpd_register_uri_handler(httpsServer, &uri_lorawan_payload);
+    httpd_register_uri_handler(httpsServer, &uri_payload_decoder);
     httpd_register_uri_handler(httpsServer, &uri_wifi);
     httpd_register_uri_handler(httpsServer, &uri_wifi_scan);
     httpd_register_uri_handler(httpsServer, &uri_wifi_status);
     httpd_register_uri_handler(httpsServer, &uri_security);
+    httpd_register_uri_handler(httpsServer, &uri_logs);
     httpd_register_uri_handler(httpsServer, &uri_ota);
     httpd_register_uri_handler(httpsServer, &uri_ota_check);
     httpd_register_uri_handler(httpsServer, &uri_ota_start);
@@ -150,12 +173,19 @@ void WebServerManager::setupRoutes() {
     httpd_register_uri_handler(httpsServer, &uri_auto_rotate);
     httpd_register_uri_handler(httpsServer, &uri_darkmode);
     httpd_register_uri_handler(httpsServer, &uri_enable_auth);
+    httpd_register_uri_handler(httpsServer, &uri_static);
+    httpd_register_uri_handler(httpsServer, &uri_api_registers);
+    httpd_register_uri_handler(httpsServer, &uri_api_stats);
+    httpd_register_uri_handler(httpsServer, &uri_api_lorawan);
+    httpd_register_uri_handler(httpsServer, &uri_api_profiles);
     httpd_register_uri_handler(httpsServer, &uri_config);
     httpd_register_uri_handler(httpsServer, &uri_lorawan_config);
     httpd_register_uri_handler(httpsServer, &uri_profile_update);
+    httpd_register_uri_handler(httpsServer, &uri_payload_update);
     httpd_register_uri_handler(httpsServer, &uri_wifi_connect);
     httpd_register_uri_handler(httpsServer, &uri_security_update);
     httpd_register_uri_handler(httpsServer, &uri_debug_update);
+    httpd_register_uri_handler(httpsServer, &uri_log_levels);
     httpd_register_uri_handler(httpsServer, &uri_ota_config);
 }
 
@@ -181,7 +211,7 @@ void WebServerManager::sendUnauthorized(httpd_req_t *req) {
 
 String WebServerManager::getPostBody(httpd_req_t *req) {
     int total_len = req->content_len;
-    if (total_len > 1024) total_len = 1024;  // Limit to 1KB
+    if (total_len > 2048) total_len = 2048;  // Limit to 2KB (payload mapping text)
     
     char* buf = (char*)malloc(total_len + 1);
     if (!buf) return "";
@@ -211,6 +241,9 @@ bool WebServerManager::getPostParameter(const String& body, const char* name, St
 
     // URL decode
     value.replace("+", " ");
+    value.replace("%0D", "");
+    value.replace("%0A", "\n");
+    value.replace("%09", " ");
     value.replace("%20", " ");
     value.replace("%21", "!");
     value.replace("%22", "\"");
@@ -268,69 +301,31 @@ void WebServerManager::sendRedirectPage(httpd_req_t *req, const char* title, con
     httpd_resp_send(req, buffer, strlen(buffer));
 }
 
+const WebAsset* WebServerManager::findAsset(const char* name, size_t len) {
+    if (len == 0) len = strlen(name);
+    for (size_t i = 0; i < WEB_ASSET_COUNT; i++) {
+        if (strlen(WEB_ASSETS[i].name) == len && strncmp(WEB_ASSETS[i].name, name, len) == 0) {
+            return &WEB_ASSETS[i];
+        }
+    }
+    return nullptr;
+}
+
 bool WebServerManager::getDarkMode() {
     return WEB_DARK_MODE;
 }
 
-String WebServerManager::buildHTMLHeader() {
-    String html;
+void WebServerManager::sendHTMLHeader(HtmlStream& html) {
     bool darkMode = getDarkMode();
     
     html += "<!DOCTYPE html><html><head><meta charset='UTF-8'><title>Vision Master E290</title>";
     html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
-    html += "<style>";
-    
-    if (darkMode) {
-        html += "body{font-family:'Segoe UI',Arial,sans-serif;margin:0;padding:20px;background:#1a1a1a;color:#e0e0e0;}";
-        html += ".container{max-width:900px;margin:0 auto;background:#2d2d2d;padding:30px;border-radius:10px;box-shadow:0 2px 10px rgba(0,0,0,0.5);}";
-        html += "h1{color:#e0e0e0;margin-top:0;border-bottom:3px solid #3498db;padding-bottom:15px;}";
-        html += "h2{color:#d0d0d0;}";
-        html += ".card{background:#383838;padding:20px;margin:15px 0;border-radius:8px;border-left:4px solid #3498db;color:#e0e0e0;}";
-        html += ".info-item{background:#383838;padding:15px;border-radius:5px;border:1px solid #555;}";
-        html += ".info-label{font-size:12px;color:#aaa;text-transform:uppercase;margin-bottom:5px;}";
-        html += ".info-value{font-size:24px;font-weight:bold;color:#e0e0e0;}";
-        html += "form{background:#383838;padding:20px;border-radius:8px;margin:20px 0;}";
-        html += "label{display:block;margin-bottom:8px;color:#e0e0e0;font-weight:600;}";
-        html += "input[type=text],input[type=password],input[type=number],select{width:100%;padding:10px;border:2px solid #555;border-radius:5px;font-size:16px;box-sizing:border-box;margin-bottom:15px;background:#2d2d2d;color:#e0e0e0;}";
-        html += "th{background:linear-gradient(135deg,#667eea 0%,#764ba2 100%);color:white;padding:12px;text-align:left;font-weight:600;}";
-        html += "td{border:1px solid #555;padding:10px;background:#383838;color:#e0e0e0;}";
-        html += "tr:nth-child(even) td{background:#2d2d2d;}";
-        html += ".value{font-weight:bold;color:#e0e0e0;}";
-        html += ".warning{background:#3d3519;border:1px solid#ffc107;padding:15px;border-radius:5px;margin:20px 0;color:#ffca28;}";
-        html += ".footer{text-align:center;margin-top:30px;color:#888;font-size:14px;}";
-    } else {
-        html += "body{font-family:'Segoe UI',Arial,sans-serif;margin:0;padding:20px;background:#f5f5f5;}";
-        html += ".container{max-width:900px;margin:0 auto;background:white;padding:30px;border-radius:10px;box-shadow:0 2px 10px rgba(0,0,0,0.1);}";
-        html += "h1{color:#2c3e50;margin-top:0;border-bottom:3px solid #3498db;padding-bottom:15px;}";
-        html += "h2{color:#34495e;margin-top:30px;}";
-        html += ".card{background:#ecf0f1;padding:20px;margin:15px 0;border-radius:8px;border-left:4px solid #3498db;}";
-        html += ".info-item{background:#fff;padding:15px;border-radius:5px;border:1px solid #ddd;}";
-        html += ".info-label{font-size:12px;color:#7f8c8d;text-transform:uppercase;margin-bottom:5px;}";
-        html += ".info-value{font-size:24px;font-weight:bold;color:#2c3e50;}";
-        html += "form{background:#ecf0f1;padding:20px;border-radius:8px;margin:20px 0;}";
-        html += "label{display:block;margin-bottom:8px;color:#2c3e50;font-weight:600;}";
-        html += "input[type=text],input[type=password],input[type=number],select{width:100%;padding:10px;border:2px solid #bdc3c7;border-radius:5px;font-size:16px;box-sizing:border-box;margin-bottom:15px;}";
-        html += "th{background:linear-gradient(135deg,#667eea 0%,#764ba2 100%);color:white;padding:12px;text-align:left;font-weight:600;}";
-        html += "td{border:1px solid #e0e0e0;padding:10px;background:white;}";
-        html += "tr:nth-child(even) td{background:#f8f9fa;}";
-        html += ".value{font-weight:bold;color:#2c3e50;}";
-        html += ".warning{background:#fff3cd;border:1px solid #ffc107;padding:15px;border-radius:5px;margin:20px 0;color:#856404;}";
-        html += ".footer{text-align:center;margin-top:30px;color:#7f8c8d;font-size:14px;}";
-    }
-    
-    // Common styles
-    html += ".nav{background:#3498db;padding:15px;margin:-30px -30px 30px -30px;border-radius:10px 10px 0 0;display:flex;align-items:center;flex-wrap:wrap;}";
-    html += ".nav a{color:white;text-decoration:none;padding:10px 20px;margin:0 5px;background:#2980b9;border-radius:5px;display:inline-block;}";
-    html += ".nav a:hover{background:#21618c;}";
-    html += ".nav .reboot{margin-left:auto;background:#e74c3c;}";
-    html += ".nav .reboot:hover{background:#c0392b;}";
-    html += ".info{display:grid;grid-template-columns:repeat(auto-fit,minmax(200px,1fr));gap:15px;margin:20px 0;}";
-    html += "input[type=submit],button{background:#27ae60;color:white;padding:12px 30px;border:none;border-radius:5px;font-size:16px;cursor:pointer;margin-top:10px;}";
-    html += "input[type=submit]:hover,button:hover{background:#229954;}";
-    html += "table{border-collapse:collapse;width:100%;margin:15px 0;box-shadow:0 2px 4px rgba(0,0,0,0.1);}";
-    html += ".spinner{border:4px solid #f3f3f3;border-top:4px solid #3498db;border-radius:50%;width:40px;height:40px;animation:spin 1s linear infinite;display:inline-block;vertical-align:middle;}";
-    html += "@keyframes spin{0%{transform:rotate(0deg)}100%{transform:rotate(360deg)}}";
-    html += "</style></head><body><div class='container'>";
+    // Stylesheet and scripts are cached by the browser (/static/, web_assets.h)
+    const WebAsset* style = findAsset(darkMode ? "style-dark.css" : "style-light.css");
+    const WebAsset* script = findAsset("app.js");
+    html.printf("<link rel='stylesheet' href='/static/%s?v=%s'>", style->name, style->version);
+    html.printf("<script src='/static/%s?v=%s' defer></script>", script->name, script->version);
+    html += "</head><body><div class='container'>";
     
     // Navigation
     html += "<div class='nav'>";
@@ -341,15 +336,55 @@ String WebServerManager::buildHTMLHeader() {
     html += "<a href='/lorawan/profiles'>Profiles</a>";
     html += "<a href='/wifi'>WiFi</a>";
     html += "<a href='/security'>Security</a>";
+    html += "<a href='/logs'>Logs</a>";
     html += "<a href='/ota'>Update</a>";
     html += "<a href='/reboot' class='reboot' onclick='return confirm(\"Are you sure you want to reboot the device?\");'>Reboot</a>";
     html += "</div>";
-    
-    return html;
 }
 
-String WebServerManager::buildHTMLFooter() {
-    return String(FPSTR(HTML_FOOTER));
+void WebServerManager::sendHTMLFooter(HtmlStream& html) {
+    html += HTML_FOOTER;
+}
+
+void WebServerManager::sendProfilePager(HtmlStream& html, int page, int page_count) {
+    html.printf("<p>Page %d of %d: ", page + 1, page_count);
+    for (int p = 0; p < page_count; p++) {
+        if (p == page) html.printf("<strong>%d</strong> ", p + 1);
+        else html.printf("<a href='/lorawan/profiles?page=%d'>%d</a> ", p, p + 1);
+    }
+    html += "</p>";
+}
+
+// ============================================================================
+// STATIC ASSETS
+// ============================================================================
+
+esp_err_t WebServerManager::handleStatic(httpd_req_t *req) {
+    // No authentication: stylesheet and scripts only, the same for every device
+    const char* name = req->uri + strlen("/static/");
+    const WebAsset* asset = findAsset(name, strcspn(name, "?"));
+    if (!asset) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Not found");
+        return ESP_OK;
+    }
+
+    // Links carry ?v=<version>, so a cached copy never goes stale
+    httpd_resp_set_hdr(req, "Cache-Control", "public, max-age=31536000, immutable");
+    httpd_resp_set_hdr(req, "ETag", asset->etag);
+
+    char match[64];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", match, sizeof(match)) == ESP_OK &&
+        strstr(match, asset->etag) != nullptr) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        httpd_resp_send(req, NULL, 0);
+        return ESP_OK;
+    }
+
+    // Stored gzipped only; every browser accepts gzip
+    httpd_resp_set_type(req, asset->type);
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    httpd_resp_send(req, (const char*)asset->data, asset->len);
+    return ESP_OK;
 }
 
 // ============================================================================
@@ -359,36 +394,38 @@ String WebServerManager::buildHTMLFooter() {
 esp_err_t WebServerManager::handleRoot(httpd_req_t *req) {
     if (!checkAuth(req)) return ESP_OK;
 
-    String html = buildHTMLHeader();
+    HtmlStream html(req);
+    sendHTMLHeader(html);
     
     html += "<h1>Vision Master E290</h1>";
-    html += "<div class='card'><strong>Status:</strong> System Running | <strong>Uptime:</strong> " + String(millis() / 1000) + " seconds</div>";
+    html.printf("<div class='card'><strong>Status:</strong> System Running | <strong>Uptime:</strong> %lu seconds</div>", (unsigned long)(millis() / 1000));
 
     html += "<div class='info'>";
-    html += "<div class='info-item'><div class='info-label'>Modbus Slave ID</div><div class='info-value'>" + String(modbusHandler.getSlaveId()) + "</div></div>";
+    html.printf("<div class='info-item'><div class='info-label'>Modbus Slave ID</div><div class='info-value'>%u</div></div>", modbusHandler.getSlaveId());
     
     ModbusStats& modbus_stats = modbusHandler.getStats();
-    html += "<div class='info-item'><div class='info-label'>Modbus RTU Requests</div><div class='info-value'>" + String(modbus_stats.request_count) + "</div></div>";
+    html.printf("<div class='info-item'><div class='info-label'>Modbus RTU Requests</div><div class='info-value'>%lu</div></div>", (unsigned long)modbus_stats.request_count);
     html += "<div class='info-item'><div class='info-label'>Modbus TCP</div><div class='info-value'>Configured</div></div>";
 
     // WiFi status
     if (wifiManager.isClientConnected()) {
-        html += "<div class='info-item'><div class='info-label'>WiFi Mode</div><div class='info-value' style='font-size:16px;'>Client<br><small style='font-size:12px;color:#7f8c8d;'>" + wifiManager.getClientSSID() + "<br>" + wifiManager.getClientIP().toString() + "</small></div></div>";
+        html.printf("<div class='info-item'><div class='info-label'>WiFi Mode</div><div class='info-value' style='font-size:16px;'>Client<br><small style='font-size:12px;color:#7f8c8d;'>%s<br>%s</small></div></div>",
+            wifiManager.getClientSSID().c_str(), wifiManager.getClientIP().toString().c_str());
     } else if (wifiManager.isAPActive()) {
-        html += "<div class='info-item'><div class='info-label'>WiFi Mode</div><div class='info-value' style='font-size:16px;'>AP Mode<br><small style='font-size:12px;color:#7f8c8d;'>" + String(wifiManager.getAPClients()) + " clients</small></div></div>";
+        html.printf("<div class='info-item'><div class='info-label'>WiFi Mode</div><div class='info-value' style='font-size:16px;'>AP Mode<br><small style='font-size:12px;color:#7f8c8d;'>%u clients</small></div></div>", wifiManager.getAPClients());
     } else {
         html += "<div class='info-item'><div class='info-label'>WiFi Mode</div><div class='info-value'>OFF</div></div>";
     }
 
-    html += "<div class='info-item'><div class='info-label'>LoRaWAN Status</div><div class='info-value'>" + String(lorawanHandler.isJoined() ? "JOINED" : "NOT JOINED") + "</div></div>";
-    html += "<div class='info-item'><div class='info-label'>LoRa Uplinks</div><div class='info-value'>" + String(lorawanHandler.getUplinkCount()) + "</div></div>";
+    html.printf("<div class='info-item'><div class='info-label'>LoRaWAN Status</div><div class='info-value'>%s</div></div>", lorawanHandler.isJoined() ? "JOINED" : "NOT JOINED");
+    html.printf("<div class='info-item'><div class='info-label'>LoRa Uplinks</div><div class='info-value'>%lu</div></div>", (unsigned long)lorawanHandler.getUplinkCount());
     html += "</div>";
 
     // Configuration Form
     html += "<h2>Configuration</h2>";
     html += "<form action='/config' method='POST'>";
     html += "<label>Modbus Slave ID:</label>";
-    html += "<input type='number' name='slave_id' min='1' max='247' value='" + String(modbusHandler.getSlaveId()) + "' required>";
+    html.printf("<input type='number' name='slave_id' min='1' max='247' value='%u' required>", modbusHandler.getSlaveId());
     html += "<p style='font-size:12px;color:#7f8c8d;margin:5px 0 15px 0;'>Valid range: 1-247</p>";
     
     Preferences prefs;
@@ -400,54 +437,67 @@ esp_err_t WebServerManager::handleRoot(httpd_req_t *req) {
     
     html += "<div style='text-align:left;margin:20px 0;'>";
     html += "<label style='display:flex;align-items:center;cursor:pointer;'>";
-    html += "<input type='checkbox' name='tcp_enabled' value='1' " + String(tcp_enabled ? "checked" : "") + " style='width:20px;height:20px;margin-right:10px;'>";
+    html.printf("<input type='checkbox' name='tcp_enabled' value='1' %s style='width:20px;height:20px;margin-right:10px;'>", tcp_enabled ? "checked" : "");
     html += "<span>Enable Modbus TCP (port 502)</span>";
     html += "</label></div>";
 
     html += "<input type='submit' value='Save Configuration'>";
     html += "</form>";
 
-    html += buildHTMLFooter();
-
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, html.c_str(), html.length());
-    return ESP_OK;
+    sendHTMLFooter(html);
+    return html.end();
 }
 
 esp_err_t WebServerManager::handleStats(httpd_req_t *req) {
     if (!checkAuth(req)) return ESP_OK;
 
-    String html = buildHTMLHeader();
+    HtmlStream html(req);
+    sendHTMLHeader(html);
     
     // Auto-refresh every 30 seconds
-    html += "<script>\n";
-    html += "setTimeout(function(){ window.location.reload(); }, 30000);\n";
-    html += "function saveAutoInstall() {\n";
-    html += "  var enabled = document.getElementById('autoInstall').checked ? '1' : '0';\n";
-    html += "  fetch('/ota/auto-install?enabled=' + enabled).then(function(r){ return r.json(); }).then(function(data){\n";
-    html += "    console.log('Auto-install saved:', data);\n";
-    html += "  });\n";
-    html += "}\n";
-    html += "</script>\n";
+    html += "<script>setTimeout(function(){ window.location.reload(); }, 30000);</script>";
     
     html += "<h1>System Statistics</h1>";
     
     ModbusStats& stats = modbusHandler.getStats();
     html += "<h2>Modbus Communication</h2>";
     html += "<table><tr><th>Metric</th><th>Value</th><th>Description</th></tr>";
-    html += "<tr><td>Total Requests</td><td class='value'>" + String(stats.request_count) + "</td><td>Total Modbus RTU requests received</td></tr>";
-    html += "<tr><td>Read Operations</td><td class='value'>" + String(stats.read_count) + "</td><td>Number of read operations</td></tr>";
-    html += "<tr><td>Write Operations</td><td class='value'>" + String(stats.write_count) + "</td><td>Number of write operations</td></tr>";
-    html += "<tr><td>Error Count</td><td class='value'>" + String(stats.error_count) + "</td><td>Communication errors</td></tr>";
+    html.printf("<tr><td>Total Requests</td><td class='value'>%lu</td><td>Total Modbus RTU requests received</td></tr>", (unsigned long)stats.request_count);
+    html.printf("<tr><td>Read Operations</td><td class='value'>%lu</td><td>Number of read operations</td></tr>", (unsigned long)stats.read_count);
+    html.printf("<tr><td>Write Operations</td><td class='value'>%lu</td><td>Number of write operations</td></tr>", (unsigned long)stats.write_count);
+    html.printf("<tr><td>Error Count</td><td class='value'>%lu</td><td>Communication errors</td></tr>", (unsigned long)stats.error_count);
     html += "</table>";
 
     html += "<h2>System Information</h2>";
     html += "<table><tr><th>Metric</th><th>Value</th><th>Description</th></tr>";
-    html += "<tr><td>Uptime</td><td class='value'>" + String(millis() / 1000) + " seconds</td><td>System uptime since last boot</td></tr>";
-    html += "<tr><td>Free Heap</td><td class='value'>" + String(ESP.getFreeHeap() / 1024) + " KB</td><td>Available RAM memory</td></tr>";
-    html += "<tr><td>Min Free Heap</td><td class='value'>" + String(ESP.getMinFreeHeap() / 1024) + " KB</td><td>Minimum free heap since boot</td></tr>";
-    html += "<tr><td>Temperature</td><td class='value'>" + String(temperatureRead(), 1) + " C</td><td>Internal CPU temperature</td></tr>";
-    html += "<tr><td>WiFi Clients</td><td class='value'>" + String(wifiManager.getAPClients()) + "</td><td>Connected WiFi clients</td></tr>";
+    html.printf("<tr><td>Uptime</td><td class='value'>%lu seconds</td><td>System uptime since last boot</td></tr>", (unsigned long)(millis() / 1000));
+    html.printf("<tr><td>Free Heap</td><td class='value'>%lu KB</td><td>Available RAM memory</td></tr>", (unsigned long)(ESP.getFreeHeap() / 1024));
+    html.printf("<tr><td>Min Free Heap</td><td class='value'>%lu KB</td><td>Minimum free heap since boot</td></tr>", (unsigned long)(ESP.getMinFreeHeap() / 1024));
+    html.printf("<tr><td>Temperature</td><td class='value'>%.1f C</td><td>Internal CPU temperature</td></tr>", temperatureRead());
+    html.printf("<tr><td>WiFi Clients</td><td class='value'>%u</td><td>Connected WiFi clients</td></tr>", wifiManager.getAPClients());
+
+    html += "</table>";
+
+    // Page rendering cost (html_stream.h); this page is counted once it has been sent
+    const WebPageStats& web = HtmlStream::getStats();
+    html += "<h2>Web Server</h2>";
+    html += "<table><tr><th>Metric</th><th>Value</th><th>Description</th></tr>";
+    if (WEB_STREAM_PAGES) {
+        html.printf("<tr><td>Page Output</td><td class='value'>Chunked</td><td>%u-byte chunks (WEB_STREAM_PAGES in config.h)</td></tr>", (unsigned)WEB_CHUNK_SIZE);
+    } else {
+        html += "<tr><td>Page Output</td><td class='value'>Whole page</td><td>One String per page (WEB_STREAM_PAGES in config.h)</td></tr>";
+    }
+    html.printf("<tr><td>Pages Served</td><td class='value'>%lu</td><td>Last: %s</td></tr>", (unsigned long)web.pages, web.pages ? web.last_uri : "-");
+    html.printf("<tr><td>Page Size</td><td class='value'>%lu bytes</td><td>Last page in %u chunk(s); largest %lu bytes</td></tr>",
+        (unsigned long)web.last_bytes, (unsigned)web.last_chunks, (unsigned long)web.max_bytes);
+    html.printf("<tr><td>Heap per Page</td><td class='value'>%lu bytes</td><td>Taken while rendering the last page; most %lu bytes</td></tr>",
+        (unsigned long)web.last_heap, (unsigned long)web.max_heap);
+    html.printf("<tr><td>First Byte</td><td class='value'>%.1f ms</td><td>Handler start to first byte sent, last page; slowest %.1f ms</td></tr>",
+        web.last_first_byte_us / 1000.0, web.max_first_byte_us / 1000.0);
+    html.printf("<tr><td>Render Time</td><td class='value'>%.1f ms</td><td>Handler start to last byte sent, last page</td></tr>",
+        web.last_total_us / 1000.0);
+    html.printf("<tr><td>Largest Free Block</td><td class='value'>%lu KB</td><td>Biggest internal RAM allocation possible now</td></tr>",
+        (unsigned long)(heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL) / 1024));
     html += "</table>";
 
     // Firmware Updates section
@@ -457,8 +507,8 @@ esp_err_t WebServerManager::handleStats(httpd_req_t *req) {
     OTAResult otaStatus = otaManager.getStatus();
     uint8_t checkInterval = otaManager.getUpdateCheckInterval();
     
-    html += "<tr><td>Current Version</td><td class='value'>" + otaStatus.currentVersion + "</td><td>Currently installed firmware version</td></tr>";
-    html += "<tr><td>Check Interval</td><td class='value'>" + String(checkInterval) + " minutes</td><td>How often to check for updates when WiFi connected</td></tr>";
+    html.printf("<tr><td>Current Version</td><td class='value'>%s</td><td>Currently installed firmware version</td></tr>", otaStatus.currentVersion.c_str());
+    html.printf("<tr><td>Check Interval</td><td class='value'>%u minutes</td><td>How often to check for updates when WiFi connected</td></tr>", checkInterval);
     
     if (wifiManager.isClientConnected()) {
         // Calculate approximate time until next check
@@ -467,16 +517,15 @@ esp_err_t WebServerManager::handleStats(httpd_req_t *req) {
         unsigned long timeSinceLastPossibleCheck = uptimeSeconds % intervalSeconds;
         unsigned long nextCheckIn = intervalSeconds - timeSinceLastPossibleCheck;
         
-        String timeUntilNext;
+        html += "<tr><td>Next Check In</td><td class='value'>";
         if (nextCheckIn >= 3600) {
-            timeUntilNext = String(nextCheckIn / 3600) + "h " + String((nextCheckIn % 3600) / 60) + "m";
+            html.printf("%luh %lum", nextCheckIn / 3600, (nextCheckIn % 3600) / 60);
         } else if (nextCheckIn >= 60) {
-            timeUntilNext = String(nextCheckIn / 60) + " minutes";
+            html.printf("%lu minutes", nextCheckIn / 60);
         } else {
-            timeUntilNext = String(nextCheckIn) + " seconds";
+            html.printf("%lu seconds", nextCheckIn);
         }
-        
-        html += "<tr><td>Next Check In</td><td class='value'>" + timeUntilNext + "</td><td>Estimated time until next automatic check</td></tr>";
+        html += "</td><td>Estimated time until next automatic check</td></tr>";
         html += "<tr><td>Update Status</td><td class='value'>";
         
         if (otaStatus.updateAvailable) {
@@ -495,17 +544,18 @@ esp_err_t WebServerManager::handleStats(httpd_req_t *req) {
         html += "</td><td>Current update status</td></tr>";
         
         if (otaStatus.updateAvailable && !otaStatus.latestVersion.isEmpty()) {
-            html += "<tr><td>Latest Version</td><td class='value' style='color: #e74c3c; font-weight: bold;'>" + otaStatus.latestVersion + "</td><td>Available firmware update</td></tr>";
+            html.printf("<tr><td>Latest Version</td><td class='value' style='color: #e74c3c; font-weight: bold;'>%s</td><td>Available firmware update</td></tr>", otaStatus.latestVersion.c_str());
         }
         
         if (!otaStatus.message.isEmpty()) {
-            String messageStyle = "";
+            const char* messageStyle = "";
             if (otaStatus.status == OTA_FAILED) {
                 messageStyle = "style='color: #e74c3c;'";
             } else if (otaStatus.updateAvailable) {
                 messageStyle = "style='color: #f39c12;'";
             }
-            html += "<tr><td>Last Check Result</td><td class='value' " + messageStyle + ">" + otaStatus.message + "</td><td>Result of most recent update check</td></tr>";
+            html.printf("<tr><td>Last Check Result</td><td class='value' %s>%s</td><td>Result of most recent update check</td></tr>", messageStyle, otaStatus.message.c_str());
+
         }
     } else {
         html += "<tr><td>WiFi Status</td><td class='value' style='color: #f39c12;'>Disconnected</td><td>Connect to WiFi to enable automatic update checks</td></tr>";
@@ -525,44 +575,25 @@ esp_err_t WebServerManager::handleStats(httpd_req_t *req) {
     html += "<span><strong>Auto-install updates</strong> - Automatically install new firmware when detected</span>";
     html += "</label></form></div>";
 
-    html += buildHTMLFooter();
-
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, html.c_str(), html.length());
-    return ESP_OK;
+    sendHTMLFooter(html);
+    return html.end();
 }
 
 esp_err_t WebServerManager::handleRegisters(httpd_req_t *req) {
     if (!checkAuth(req)) return ESP_OK;
 
-    String html = buildHTMLHeader();
+    HtmlStream html(req);
+    sendHTMLHeader(html);
     
-    html += R"(<script>
-    function submitSF6Values() {
-      var d = parseFloat(document.getElementById('density-input').value);
-      var p = parseFloat(document.getElementById('pressure-input').value);
-      var t = parseFloat(document.getElementById('temperature-input').value);
-      fetch('/sf6/update?density=' + Math.round(d * 100) + '&pressure=' + Math.round(p * 10) + '&temperature=' + Math.round(t * 10));
-      alert('Values updated!');
-      return false;
-    }
-    function resetSF6Values() {
-      if (!confirm('Reset SF6 values?')) return;
-      fetch('/sf6/reset');
-      alert('Values reset!');
-      setTimeout(function() { location.reload(); }, 1000);
-    }
-    </script>)";
-
     html += "<h1>Modbus Registers</h1>";
     
     // SF6 Control Panel
     html += "<div class='card'>";
     html += "<h3>SF6 Manual Control</h3>";
     html += "<form onsubmit='return submitSF6Values();'>";
-    html += "<label>Density (kg/m&sup3;):</label><input type='number' id='density-input' step='0.01' value='" + String(sf6Emulator.getDensity(), 2) + "'>";
-    html += "<label>Pressure (kPa):</label><input type='number' id='pressure-input' step='0.1' value='" + String(sf6Emulator.getPressure(), 1) + "'>";
-    html += "<label>Temperature (K):</label><input type='number' id='temperature-input' step='0.1' value='" + String(sf6Emulator.getTemperature(), 1) + "'>";
+    html.printf("<label>Density (kg/m&sup3;):</label><input type='number' id='density-input' step='0.01' value='%.2f'>", sf6Emulator.getDensity());
+    html.printf("<label>Pressure (kPa):</label><input type='number' id='pressure-input' step='0.1' value='%.1f'>", sf6Emulator.getPressure());
+    html.printf("<label>Temperature (K):</label><input type='number' id='temperature-input' step='0.1' value='%.1f'>", sf6Emulator.getTemperature());
     html += "<button type='submit'>Update</button> <button type='button' onclick='resetSF6Values()'>Reset</button>";
     html += "</form></div>";
 
@@ -570,69 +601,280 @@ esp_err_t WebServerManager::handleRegisters(httpd_req_t *req) {
     HoldingRegisters& holding = modbusHandler.getHoldingRegisters();
     html += "<h2>Holding Registers (0-12) - Read/Write</h2>";
     html += "<table><tr><th>Address</th><th>Value</th><th>Hex</th><th>Description</th></tr>";
-    html += "<tr><td>0</td><td class='value'>" + String(holding.sequential_counter) + "</td><td>0x" + String(holding.sequential_counter, HEX) + "</td><td>Sequential Counter</td></tr>";
-    html += "<tr><td>1</td><td class='value'>" + String(holding.random_number) + "</td><td>0x" + String(holding.random_number, HEX) + "</td><td>Random Number</td></tr>";
+    html.printf("<tr><td>0</td><td class='value'>%u</td><td>0x%x</td><td>Sequential Counter</td></tr>", holding.sequential_counter, holding.sequential_counter);
+    html.printf("<tr><td>1</td><td class='value'>%u</td><td>0x%x</td><td>Random Number</td></tr>", holding.random_number, holding.random_number);
     
     uint16_t uptime_low = (uint16_t)(holding.uptime_seconds & 0xFFFF);
     uint16_t uptime_high = (uint16_t)(holding.uptime_seconds >> 16);
-    html += "<tr><td>2</td><td class='value'>" + String(uptime_low) + "</td><td>0x" + String(uptime_low, HEX) + "</td><td>Uptime (low word)</td></tr>";
-    html += "<tr><td>3</td><td class='value'>" + String(uptime_high) + "</td><td>0x" + String(uptime_high, HEX) + "</td><td>Uptime (high word) = <strong>" + String(holding.uptime_seconds) + " seconds</strong></td></tr>";
+    html.printf("<tr><td>2</td><td class='value'>%u</td><td>0x%x</td><td>Uptime (low word)</td></tr>", uptime_low, uptime_low);
+    html.printf("<tr><td>3</td><td class='value'>%u</td><td>0x%x</td><td>Uptime (high word) = <strong>%lu seconds</strong></td></tr>",
+        uptime_high, uptime_high, (unsigned long)holding.uptime_seconds);
 
     uint32_t total_heap = ((uint32_t)holding.free_heap_kb_high << 16) | holding.free_heap_kb_low;
-    html += "<tr><td>4</td><td class='value'>" + String(holding.free_heap_kb_low) + "</td><td>0x" + String(holding.free_heap_kb_low, HEX) + "</td><td>Free Heap (low word)</td></tr>";
-    html += "<tr><td>5</td><td class='value'>" + String(holding.free_heap_kb_high) + "</td><td>0x" + String(holding.free_heap_kb_high, HEX) + "</td><td>Free Heap (high word) = <strong>" + String(total_heap) + " KB total</strong></td></tr>";
-    html += "<tr><td>6</td><td class='value'>" + String(holding.min_heap_kb) + "</td><td>0x" + String(holding.min_heap_kb, HEX) + "</td><td>Min Free Heap (KB)</td></tr>";
-    html += "<tr><td>7</td><td class='value'>" + String(holding.cpu_freq_mhz) + "</td><td>0x" + String(holding.cpu_freq_mhz, HEX) + "</td><td>CPU Frequency (MHz)</td></tr>";
-    html += "<tr><td>8</td><td class='value'>" + String(holding.task_count) + "</td><td>0x" + String(holding.task_count, HEX) + "</td><td>FreeRTOS Tasks</td></tr>";
-    html += "<tr><td>9</td><td class='value'>" + String(holding.temperature_x10) + "</td><td>0x" + String(holding.temperature_x10, HEX) + "</td><td>Temperature = <strong>" + String(holding.temperature_x10 / 10.0, 1) + " C</strong></td></tr>";
-    html += "<tr><td>10</td><td class='value'>" + String(holding.cpu_cores) + "</td><td>0x" + String(holding.cpu_cores, HEX) + "</td><td>CPU Cores</td></tr>";
-    html += "<tr><td>11</td><td class='value'>" + String(holding.wifi_enabled) + "</td><td>0x" + String(holding.wifi_enabled, HEX) + "</td><td>WiFi AP Enabled</td></tr>";
-    html += "<tr><td>12</td><td class='value'>" + String(holding.wifi_clients) + "</td><td>0x" + String(holding.wifi_clients, HEX) + "</td><td>WiFi Clients</td></tr>";
+    html.printf("<tr><td>4</td><td class='value'>%u</td><td>0x%x</td><td>Free Heap (low word)</td></tr>", holding.free_heap_kb_low, holding.free_heap_kb_low);
+    html.printf("<tr><td>5</td><td class='value'>%u</td><td>0x%x</td><td>Free Heap (high word) = <strong>%lu KB total</strong></td></tr>",
+        holding.free_heap_kb_high, holding.free_heap_kb_high, (unsigned long)total_heap);
+    html.printf("<tr><td>6</td><td class='value'>%u</td><td>0x%x</td><td>Min Free Heap (KB)</td></tr>", holding.min_heap_kb, holding.min_heap_kb);
+    html.printf("<tr><td>7</td><td class='value'>%u</td><td>0x%x</td><td>CPU Frequency (MHz)</td></tr>", holding.cpu_freq_mhz, holding.cpu_freq_mhz);
+    html.printf("<tr><td>8</td><td class='value'>%u</td><td>0x%x</td><td>FreeRTOS Tasks</td></tr>", holding.task_count, holding.task_count);
+    html.printf("<tr><td>9</td><td class='value'>%u</td><td>0x%x</td><td>Temperature = <strong>%.1f C</strong></td></tr>",
+        holding.temperature_x10, holding.temperature_x10, holding.temperature_x10 / 10.0);
+    html.printf("<tr><td>10</td><td class='value'>%u</td><td>0x%x</td><td>CPU Cores</td></tr>", holding.cpu_cores, holding.cpu_cores);
+    html.printf("<tr><td>11</td><td class='value'>%u</td><td>0x%x</td><td>WiFi AP Enabled</td></tr>", holding.wifi_enabled, holding.wifi_enabled);
+    html.printf("<tr><td>12</td><td class='value'>%u</td><td>0x%x</td><td>WiFi Clients</td></tr>", holding.wifi_clients, holding.wifi_clients);
     html += "</table>";
 
     // Input Registers
     InputRegisters& input = modbusHandler.getInputRegisters();
     html += "<h2>Input Registers (0-8) - Read Only (SF6 Sensor)</h2>";
     html += "<table><tr><th>Address</th><th>Raw Value</th><th>Scaled Value</th><th>Description</th></tr>";
-    html += "<tr><td>0</td><td class='value'>" + String(input.sf6_density) + "</td><td>" + String(input.sf6_density / 100.0, 2) + " kg/m&sup3;</td><td>SF6 Density</td></tr>";
-    html += "<tr><td>1</td><td class='value'>" + String(input.sf6_pressure_20c) + "</td><td>" + String(input.sf6_pressure_20c / 10.0, 1) + " kPa</td><td>SF6 Pressure @20C</td></tr>";
-    html += "<tr><td>2</td><td class='value'>" + String(input.sf6_temperature) + "</td><td>" + String(input.sf6_temperature / 10.0, 1) + " K (" + String(input.sf6_temperature / 10.0 - 273.15, 1) + "C)</td><td>SF6 Temperature</td></tr>";
-    html += "<tr><td>3</td><td class='value'>" + String(input.sf6_pressure_var) + "</td><td>" + String(input.sf6_pressure_var / 10.0, 1) + " kPa</td><td>SF6 Pressure Variance</td></tr>";
-    html += "<tr><td>4</td><td class='value'>" + String(input.slave_id) + "</td><td>-</td><td>Slave ID</td></tr>";
+    html.printf("<tr><td>0</td><td class='value'>%u</td><td>%.2f kg/m&sup3;</td><td>SF6 Density</td></tr>", input.sf6_density, input.sf6_density / 100.0);
+    html.printf("<tr><td>1</td><td class='value'>%u</td><td>%.1f kPa</td><td>SF6 Pressure @20C</td></tr>", input.sf6_pressure_20c, input.sf6_pressure_20c / 10.0);
+    html.printf("<tr><td>2</td><td class='value'>%u</td><td>%.1f K (%.1fC)</td><td>SF6 Temperature</td></tr>",
+        input.sf6_temperature, input.sf6_temperature / 10.0, input.sf6_temperature / 10.0 - 273.15);
+    html.printf("<tr><td>3</td><td class='value'>%u</td><td>%.1f kPa</td><td>SF6 Pressure Variance</td></tr>", input.sf6_pressure_var, input.sf6_pressure_var / 10.0);
+    html.printf("<tr><td>4</td><td class='value'>%u</td><td>-</td><td>Slave ID</td></tr>", input.slave_id);
 
     uint32_t serial = ((uint32_t)input.serial_hi << 16) | input.serial_lo;
-    html += "<tr><td>5</td><td class='value'>" + String(input.serial_hi) + "</td><td>0x" + String(input.serial_hi, HEX) + "</td><td>Serial Number (high)</td></tr>";
-    html += "<tr><td>6</td><td class='value'>" + String(input.serial_lo) + "</td><td>0x" + String(input.serial_lo, HEX) + "</td><td>Serial Number (low) = <strong>0x" + String(serial, HEX) + "</strong></td></tr>";
-    char version_buf[10];
-    snprintf(version_buf, sizeof(version_buf), "v%d.%02d", input.sw_release / 100, input.sw_release % 100);
-    html += "<tr><td>7</td><td class='value'>" + String(input.sw_release) + "</td><td>" + String(version_buf) + "</td><td>Software Version</td></tr>";
-    html += "<tr><td>8</td><td class='value'>" + String(input.quartz_freq) + "</td><td>" + String(input.quartz_freq / 100.0, 2) + " Hz</td><td>Quartz Frequency</td></tr>";
-    html += "</table>";
+    html.printf("<tr><td>5</td><td class='value'>%u</td><td>0x%x</td><td>Serial Number (high)</td></tr>", input.serial_hi, input.serial_hi);
+    html.printf("<tr><td>6</td><td class='value'>%u</td><td>0x%x</td><td>Serial Number (low) = <strong>0x%lx</strong></td></tr>",
+        input.serial_lo, input.serial_lo, (unsigned long)serial);
+    html.printf("<tr><td>7</td><td class='value'>%u</td><td>v%d.%02d</td><td>Software Version</td></tr>",
+        input.sw_release, input.sw_release / 100, input.sw_release % 100);
+    html.printf("<tr><td>8</td><td class='value'>%u</td><td>%.2f Hz</td><td>Quartz Frequency</td></tr>", input.quartz_freq, input.quartz_freq / 100.0);
 
-    html += buildHTMLFooter();
+    html += "</table>";
 
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, html.c_str(), html.length());
-    return ESP_OK;
+    sendHTMLFooter(html);
+    return html.end();
 }
 
 esp_err_t WebServerManager::handleLoRaWAN(httpd_req_t *req) {
     if (!checkAuth(req)) return ESP_OK;
 
-    String html = buildHTMLHeader();
+    HtmlStream html(req);
+    sendHTMLHeader(html);
 
     html += "<h1>LoRaWAN Configuration</h1>";
 
     // Network status
     html += "<h2>Network Status</h2>";
     html += "<table><tr><th>Parameter</th><th>Value</th></tr>";
-    html += "<tr><td>Connection Status</td><td style='background:" + String(lorawanHandler.isJoined() ? "#1e5631" : "#5c2626") + ";color:#fff;font-weight:bold;'>" + String(lorawanHandler.isJoined() ? "JOINED" : "NOT JOINED") + "</td></tr>";
-    if (lorawanHandler.isJoined()) {
-        html += "<tr><td>DevAddr</td><td>0x" + String(lorawanHandler.getDevAddr(), HEX) + "</td></tr>";
+    bool joined = lorawanHandler.isJoined();
+    html.printf("<tr><td>Connection Status</td><td style='background:%s;color:#fff;font-weight:bold;'>%s</td></tr>",
+                joined ? "#1e5631" : "#5c2626", joined ? "JOINED" : "NOT JOINED");
+    if (joined) {
+        html.printf("<tr><td>DevAddr</td><td>0x%lx</td></tr>", (unsigned long)lorawanHandler.getDevAddr());
+    }
+    html.printf("<tr><td>Total Uplinks</td><td>%lu</td></tr>", (unsigned long)lorawanHandler.getUplinkCount());
+    html.printf("<tr><td>Total Downlinks</td><td>%lu</td></tr>", (unsigned long)lorawanHandler.getDownlinkCount());
+    if (LORAWAN_CLASS_C) {
+        html.printf("<tr><td>Device Class</td><td>C (%lu downlinks between uplinks)</td></tr>", (unsigned long)lorawanHandler.getClassCDownlinkCount());
+    }
+    if (LORAWAN_REPORT_ON_CHANGE) {
+        html.printf("<tr><td>Report on Change</td><td>%lu extra uplinks (heartbeat %lu min)</td></tr>",
+                    (unsigned long)lorawanHandler.getChangeReporter().getTotalReports(), LORAWAN_REPORT_MAX_INTERVAL_MS / 60000UL);
+    }
+    html.printf("<tr><td>Last RSSI</td><td>%d dBm</td></tr>", lorawanHandler.getLastRSSI());
+    const SampleBatcher& batches = lorawanHandler.getBatcher();
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        LoRaProfile* prof = lorawanHandler.getProfile(i);
+        if (!prof || !prof->enabled || prof->payload_type != PAYLOAD_BATCHED_DELTA) continue;
+        html.printf("<tr><td>Batched Samples (%d)</td><td>%lu pending, %lu dropped</td></tr>",
+                    i, (unsigned long)batches.getPendingCount(i), (unsigned long)batches.getDroppedCount(i));
+    }
+    html += "</table>";
+
+    // Duty-cycle usage (sliding one-hour window, all profiles share the radio)
+    const AirtimeLedger& airtime = lorawanHandler.getAirtime();
+    unsigned long now = millis();
+    html += "<h2>Airtime (last hour)</h2>";
+    html += "<table><tr><th>Sub-band (MHz)</th><th>Used</th><th>Budget</th><th>Usage</th></tr>";
+    for (int b = 0; b < DUTY_CYCLE_BAND_COUNT; b++) {
+        if (!airtime.isSubBandInUse(b)) continue;
+        uint32_t used = airtime.getSubBandUsedMs(now, b);
+        uint32_t budget = airtime.getSubBandBudgetMs(b);
+        if (budget == 0) {
+            html.printf("<tr><td>%s</td><td>%lu ms</td><td>No limit</td><td>-</td></tr>", DUTY_CYCLE_BANDS[b].name, (unsigned long)used);
+            continue;
+        }
+        html.printf("<tr><td>%s</td><td>%lu ms</td><td>%lu ms</td><td>%.1f%%</td></tr>",
+                    DUTY_CYCLE_BANDS[b].name, (unsigned long)used, (unsigned long)budget, 100.0 * used / budget);
+    }
+    html += "</table>";
+    html += "<table><tr><th>Profile</th><th>Next Frame</th><th>Last Hour</th><th>Total</th><th>Frames</th></tr>";
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        LoRaProfile* prof = lorawanHandler.getProfile(i);
+        if (!prof || !prof->enabled) continue;
+        html.printf("<tr><td>%d - %s</td><td>%lu ms</td><td>%lu ms</td><td>%lu ms</td><td>%lu</td></tr>",
+                    i, prof->name, (unsigned long)lorawanHandler.estimateUplinkAirtime(i), (unsigned long)airtime.getProfileUsedMs(now, i),
+                    (unsigned long)airtime.getProfileTotalMs(i), (unsigned long)airtime.getProfileFrames(i));
+    }
+    html += "</table>";
+
+    // Uplink schedule (earliest deadline first) with lateness and observed intervals
+    UplinkScheduler& scheduler = lorawanHandler.getScheduler();
+    html += "<h2>Uplink Schedule</h2>";
+    html += "<table><tr><th>Profile</th><th>Period</th><th>Next Deadline</th><th>Sent</th><th>Lateness (last / max / avg)</th><th>Interval (min / max)</th><th>Missed</th></tr>";
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        if (!scheduler.isScheduled(i)) continue;
+        const ScheduleStats& st = scheduler.getStats(i);
+        long next_in = (long)(scheduler.getDeadline(i) - now) / 1000;
+        unsigned long avg_late = st.sent ? st.total_lateness / st.sent : 0;
+        html.printf("<tr><td>%d%s</td><td>%u s</td><td>", i, lorawanHandler.hasPendingAck(i) ? " (ack pending)" : "", lorawanHandler.getUplinkInterval(i));
+        if (next_in >= 0) {
+            html.printf("in %ld s</td>", next_in);
+        } else {
+            html.printf("%ld s overdue</td>", -next_in);
+        }
+        html.printf("<td>%lu</td><td>%lu / %lu / %lu s</td>",
+                    (unsigned long)st.sent, st.last_lateness / 1000, st.max_lateness / 1000, avg_late / 1000);
+        html.printf("<td>%lu / %lu s</td><td>%lu</td></tr>", st.min_interval / 1000, st.max_interval / 1000, (unsigned long)st.missed);
+    }
+    html += "</table>";
+
+    // Link quality per profile (last LINK_HISTORY_SIZE uplinks) and current data rate
+    const LinkQualityHistory& links = lorawanHandler.getLinkHistory();
+    html += "<h2>Link Quality</h2>";
+    html += "<table><tr><th>Profile</th><th>Data Rate</th><th>Downlinks</th><th>Avg RSSI</th><th>Avg / Min SNR</th><th>Gateway Margin</th><th>Silent Uplinks</th></tr>";
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        LoRaProfile* prof = lorawanHandler.getProfile(i);
+        if (!prof || !prof->enabled) continue;
+        LinkSummary ls = links.summarize(i);
+        html.printf("<tr><td>%d - %s</td><td>DR%u</td>", i, prof->name, lorawanHandler.getProfileDatarate(i));
+        html.printf("<td>%u / %u</td>", ls.downlinks, ls.samples);
+        if (ls.downlinks > 0) {
+            html.printf("<td>%d dBm</td><td>%.1f / %d dB</td>", ls.avg_rssi, ls.avg_snr, ls.min_snr);
+        } else {
+            html += "<td>-</td><td>-</td>";
+        }
+        if (ls.last_margin != LINK_MARGIN_NONE) {
+            html.printf("<td>%u dB (%u GW)</td>", ls.last_margin, ls.last_gateways);
+        } else {
+            html += "<td>-</td>";
+        }
+        html.printf("<td>%u</td></tr>", links.getUplinksSinceDownlink(i));
+    }
+    html += "</table>";
+
+    // Join attempts, failures and latency per profile, with the running retry backoff
+    const JoinBackoff& joins = lorawanHandler.getJoinBackoff();
+    html += "<h2>Joins</h2>";
+    html += "<table><tr><th>Profile</th><th>Attempts</th><th>Failed (in a row)</th><th>Latency (last / max / avg)</th><th>Next Attempt</th></tr>";
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        const JoinStats& js = joins.getStats(i);
+        if (js.attempts == 0) continue;
+        unsigned long avg_latency = js.successes ? (unsigned long)(js.total_latency_ms / js.successes) : 0;
+        html.printf("<tr><td>%d</td><td>%lu</td><td>%lu (%u)</td>",
+                    i, (unsigned long)js.attempts, (unsigned long)js.failures, js.consecutive_failures);
+        if (js.successes > 0) {
+            html.printf("<td>%lu / %lu / %lu s</td>",
+                        (unsigned long)(js.last_latency_ms / 1000), (unsigned long)(js.max_latency_ms / 1000), avg_latency / 1000);
+        } else {
+            html += "<td>-</td>";
+        }
+        long retry_in = (long)(js.next_attempt - now) / 1000;
+        if (js.consecutive_failures > 0 && retry_in > 0) {
+            html.printf("<td>in %ld s</td></tr>", retry_in);
+        } else {
+            html += "<td>-</td></tr>";
+        }
+    }
+    html += "</table>";
+
+    // Confirmed uplinks: delivery ratio over completed messages, retransmissions and ACK latency
+    const DeliveryTracker& delivery = lorawanHandler.getDelivery();
+    html += "<h2>Confirmed Uplinks</h2>";
+    html += "<table><tr><th>Profile</th><th>Mode</th><th>Messages</th><th>Delivered (1st try)</th><th>Lost</th><th>Ratio</th><th>Retries</th><th>ACK Latency (last / max / avg)</th><th>Outstanding</th></tr>";
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        const DeliveryStats& ds = delivery.getStats(i);
+        if (ds.messages == 0) continue;
+        LoRaProfile* prof = lorawanHandler.getProfile(i);
+        int ratio = delivery.deliveryRatio(i);
+        unsigned long avg_ack = ds.delivered ? (unsigned long)(ds.total_ack_ms / ds.delivered) : 0;
+        html.printf("<tr><td>%d</td><td>%s</td><td>%lu</td>", i, prof ? CONFIRM_MODE_NAMES[prof->confirm] : "-", (unsigned long)ds.messages);
+        html.printf("<td>%lu (%lu)</td><td>%lu</td>", (unsigned long)ds.delivered, (unsigned long)ds.first_try, (unsigned long)ds.lost);
+        if (ratio >= 0) {
+            html.printf("<td>%d%%</td>", ratio);
+        } else {
+            html += "<td>-</td>";
+        }
+        html.printf("<td>%lu</td>", (unsigned long)ds.retries);
+        if (ds.delivered > 0) {
+            html.printf("<td>%.1f / %.1f / %.1f s</td>", ds.last_ack_ms / 1000.0, ds.max_ack_ms / 1000.0, avg_ack / 1000.0);
+        } else {
+            html += "<td>-</td>";
+        }
+        if (delivery.isPending(i)) {
+            long retry_in = (long)(delivery.getRetryAt(i) - now) / 1000;
+            html.printf("<td>%u sent", delivery.getTransmissions(i));
+            if (retry_in > 0) html.printf(", retry in %ld s", retry_in);
+            html += "</td></tr>";
+        } else {
+            html += "<td>-</td></tr>";
+        }
+    }
+    html += "</table>";
+
+    // Energy estimate from time per state and the configured currents (energy_meter.h)
+    const EnergyMeter& energy = powerManager.getEnergy();
+    const EnergyStats& es = energy.getStats();
+    html += "<h2>Power (estimate)</h2>";
+    html += "<table><tr><th>Parameter</th><th>Value</th></tr>";
+    html.printf("<tr><td>Power Mode</td><td>%s%s</td></tr>", POWER_MODE_NAMES[powerManager.getMode()],
+                POWER_MODE != POWER_ALWAYS_ON && !powerManager.isSleepEnabled() ? " (service window)" : "");
+    if (POWER_MODE != POWER_ALWAYS_ON) {
+        html.printf("<tr><td>Sleeps</td><td>%lu (%.1f%% of the time asleep)</td></tr>",
+                    (unsigned long)powerManager.getSleepCount(), energy.sleepPermille() / 10.0);
+    }
+    if (es.uplinks > 0) {
+        html.printf("<tr><td>Energy per Uplink (last / avg)</td><td>%.1f / %.1f mJ</td></tr>",
+                    energy.lastUplinkUj() / 1000.0, energy.averageUplinkUj() / 1000.0);
+    }
+    html.printf("<tr><td>Average Current</td><td>%.2f mA</td></tr>", energy.averageCurrentUa() / 1000.0);
+    uint32_t life_h = energy.batteryLifeHours();
+    html.printf("<tr><td>Battery Life (%d mAh)</td><td>", POWER_BATTERY_MAH);
+    if (life_h >= 48) {
+        html.printf("%lu days</td></tr>", (unsigned long)(life_h / 24));
+    } else if (life_h > 0) {
+        html.printf("%lu h</td></tr>", (unsigned long)life_h);
+    } else {
+        html += "-</td></tr>";
+    }
+    html += "<tr><td>Charge by State</td><td>";
+    for (int s = 0; s < ENERGY_STATE_COUNT; s++) {
+        if (es.time_ms[s] == 0) continue;
+        html.printf("%s %.1f mC, ", ENERGY_STATE_NAMES[s], (double)es.charge_nc[s] / 1e6);
+    }
+    html.printf("%.1f V</td></tr>", POWER_SUPPLY_MV / 1000.0);
+    html += "</table>";
+
+    // Most recent frames of all profiles; the full history is paged through /lorawan/frames
+    const FrameHistory& history = lorawanHandler.getFrameHistory();
+    html += "<h2>Recent Frames</h2>";
+    html.printf("<p>%u of %u records (%s), %lu since boot. ", history.getCount(), history.getCapacity(),
+                lorawanHandler.isFrameHistoryInPSRAM() ? "PSRAM" : "internal RAM", (unsigned long)history.getTotal());
+    html += "<a href='/lorawan/frames'>JSON</a> (<code>?profile=&amp;from=&amp;to=&amp;cursor=&amp;limit=</code>)</p>";
+    html += "<table><tr><th>Age</th><th>Profile</th><th>Frame</th><th>FCnt</th><th>FPort</th><th>DR</th><th>Bytes</th><th>Airtime</th><th>RSSI / SNR</th><th>Result</th></tr>";
+    FrameRecord recent[10];
+    FrameQuery recent_query;
+    memset(&recent_query, 0, sizeof(recent_query));
+    recent_query.profile = FRAME_PROFILE_ANY;
+    uint32_t more;
+    size_t recent_count = lorawanHandler.queryFrames(recent_query, recent, 10, &more);
+    for (size_t i = 0; i < recent_count; i++) {
+        const FrameRecord& f = recent[i];
+        html.printf("<tr><td>%lu s</td><td>%u</td><td>%s%s%s</td>", (now - f.time) / 1000, f.profile, FRAME_DIRECTION_NAMES[f.direction],
+                    f.flags & FRAME_FLAG_CLASS_C ? " (C)" : "",
+                    f.flags & FRAME_FLAG_CONFIRMED ? (f.flags & FRAME_FLAG_ACKED ? " (conf, ACK)" : " (conf)") : "");
+        html.printf("<td>%lu</td><td>%u</td><td>DR%u</td><td>%u</td><td>%u ms</td>", (unsigned long)f.fcnt, f.fport, f.datarate, f.len, f.toa_ms);
+        if (f.flags & FRAME_FLAG_RADIO) {
+            html.printf("<td>%d dBm / %d dB</td>", f.rssi, f.snr);
+        } else {
+            html += "<td>-</td>";
+        }
+        html.printf("<td>%d</td></tr>", f.result);
     }
-    html += "<tr><td>Total Uplinks</td><td>" + String(lorawanHandler.getUplinkCount()) + "</td></tr>";
-    html += "<tr><td>Total Downlinks</td><td>" + String(lorawanHandler.getDownlinkCount()) + "</td></tr>";
-    html += "<tr><td>Last RSSI</td><td>" + String(lorawanHandler.getLastRSSI()) + " dBm</td></tr>";
     html += "</table>";
 
     // Active profile
@@ -641,7 +883,7 @@ esp_err_t WebServerManager::handleLoRaWAN(httpd_req_t *req) {
     if (active_prof) {
         html += "<h2>Active Profile</h2>";
         html += "<table><tr><th>Parameter</th><th>Value</th></tr>";
-        html += "<tr><td>Profile</td><td>" + String(active_idx) + " - " + String(active_prof->name) + "</td></tr>";
+        html.printf("<tr><td>Profile</td><td>%u - %s</td></tr>", active_idx, active_prof->name);
         html += "</table>";
         html += "<p><a href='/lorawan/profiles' style='background:#3498db;color:white;padding:10px;text-decoration:none;border-radius:5px;'>Manage Profiles &raquo;</a></p>";
     }
@@ -650,21 +892,19 @@ esp_err_t WebServerManager::handleLoRaWAN(httpd_req_t *req) {
     html += "<h2>Current Credentials</h2>";
     html += "<table><tr><th>Parameter</th><th>Value</th></tr>";
     
-    char devEUIStr[17], joinEUIStr[17];
-    sprintf(devEUIStr, "%016llX", lorawanHandler.getDevEUI());
-    sprintf(joinEUIStr, "%016llX", lorawanHandler.getJoinEUI());
-    html += "<tr><td>DevEUI</td><td>0x" + String(devEUIStr) + "</td></tr>";
-    html += "<tr><td>JoinEUI</td><td>0x" + String(joinEUIStr) + "</td></tr>";
+    html.printf("<tr><td>DevEUI</td><td>0x%016llX</td></tr>", (unsigned long long)lorawanHandler.getDevEUI());
+    html.printf("<tr><td>JoinEUI</td><td>0x%016llX</td></tr>", (unsigned long long)lorawanHandler.getJoinEUI());
+
     
     uint8_t appKey[16], nwkKey[16];
     lorawanHandler.getAppKey(appKey);
     lorawanHandler.getNwkKey(nwkKey);
     
     html += "<tr><td>AppKey</td><td>";
-    for (int i = 0; i < 16; i++) { char buf[3]; sprintf(buf, "%02X", appKey[i]); html += buf; }
+    for (int i = 0; i < 16; i++) html.printf("%02X", appKey[i]);
     html += "</td></tr>";
     html += "<tr><td>NwkKey</td><td>";
-    for (int i = 0; i < 16; i++) { char buf[3]; sprintf(buf, "%02X", nwkKey[i]); html += buf; }
+    for (int i = 0; i < 16; i++) html.printf("%02X", nwkKey[i]);
     html += "</td></tr></table>";
 
     // DevNonce reset
@@ -674,24 +914,202 @@ esp_err_t WebServerManager::handleLoRaWAN(httpd_req_t *req) {
     html += "<button onclick='if(confirm(\"Reset DevNonce?\")) window.location.href=\"/lorawan/reset-nonces\"' style='background:#ffc107;color:#000;'>Reset DevNonce</button>";
     html += "</div>";
 
-    html += buildHTMLFooter();
+    sendHTMLFooter(html);
+    return html.end();
+}
 
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, html.c_str(), html.length());
+esp_err_t WebServerManager::handleLoRaWANFrames(httpd_req_t *req) {
+    if (!checkAuth(req)) return ESP_OK;
+
+    // Filters: profile index, millis() range; paging: cursor from the previous page
+    FrameQuery q;
+    memset(&q, 0, sizeof(q));
+    String profileStr = getQueryParameter(req, "profile");
+    String fromStr = getQueryParameter(req, "from");
+    String toStr = getQueryParameter(req, "to");
+    String cursorStr = getQueryParameter(req, "cursor");
+    String limitStr = getQueryParameter(req, "limit");
+    q.profile = profileStr.length() > 0 ? (uint8_t)profileStr.toInt() : FRAME_PROFILE_ANY;
+    q.has_range = fromStr.length() > 0 || toStr.length() > 0;
+    q.from = fromStr.length() > 0 ? strtoul(fromStr.c_str(), nullptr, 10) : 0;
+    q.to = toStr.length() > 0 ? strtoul(toStr.c_str(), nullptr, 10) : millis();
+    q.cursor = strtoul(cursorStr.c_str(), nullptr, 10);
+    int limit = limitStr.length() > 0 ? limitStr.toInt() : 20;
+    if (limit < 1) limit = 1;
+    if (limit > LORAWAN_FRAME_PAGE_MAX) limit = LORAWAN_FRAME_PAGE_MAX;
+
+    FrameRecord* page = (FrameRecord*)malloc(limit * sizeof(FrameRecord));
+    if (!page) {
+        httpd_resp_send_500(req);
+        return ESP_OK;
+    }
+    uint32_t next_cursor;
+    size_t count = lorawanHandler.queryFrames(q, page, limit, &next_cursor);
+
+    const FrameHistory& history = lorawanHandler.getFrameHistory();
+    String json = "{\"now\":" + String(millis()) + ",\"capacity\":" + String(history.getCapacity()) + ",\"total\":" + String(history.getTotal()) + ",\"frames\":[";
+    for (size_t i = 0; i < count; i++) {
+        const FrameRecord& f = page[i];
+        if (i > 0) json += ",";
+        json += "{\"seq\":" + String(f.seq) + ",\"time\":" + String(f.time) + ",\"profile\":" + String(f.profile);
+        json += ",\"dir\":\"" + String(FRAME_DIRECTION_NAMES[f.direction]) + "\",\"fcnt\":" + String(f.fcnt) + ",\"fport\":" + String(f.fport);
+        json += ",\"dr\":" + String(f.datarate) + ",\"toa_ms\":" + String(f.toa_ms) + ",\"result\":" + String(f.result);
+        if (f.flags & FRAME_FLAG_RADIO) {
+            json += ",\"rssi\":" + String(f.rssi) + ",\"snr\":" + String(f.snr);
+        }
+        if (f.flags & FRAME_FLAG_CLASS_C) {
+            json += ",\"class_c\":true";
+        }
+        if (f.flags & FRAME_FLAG_CONFIRMED) {
+            json += ",\"confirmed\":true,\"acked\":" + String(f.flags & FRAME_FLAG_ACKED ? "true" : "false");
+        }
+        json += ",\"len\":" + String(f.len) + ",\"payload\":\"";
+        size_t stored = f.len < LORAWAN_FRAME_PAYLOAD_MAX ? f.len : LORAWAN_FRAME_PAYLOAD_MAX;
+        for (size_t b = 0; b < stored; b++) {
+            char hex[3];
+            sprintf(hex, "%02X", f.payload[b]);
+            json += hex;
+        }
+        json += "\"}";
+    }
+    json += "],\"next_cursor\":" + (next_cursor ? String(next_cursor) : String("null")) + "}";
+    free(page);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json.c_str(), json.length());
+    return ESP_OK;
+}
+
+esp_err_t WebServerManager::handleLoRaWANPayload(httpd_req_t *req) {
+    if (!checkAuth(req)) return ESP_OK;
+
+    PayloadMap* map = new PayloadMap();
+    lorawanHandler.getPayloadMap(*map);
+
+    int users = 0;
+    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+        LoRaProfile* prof = lorawanHandler.getProfile(i);
+        if (prof && prof->payload_type == PAYLOAD_USER_MAP) users++;
+    }
+
+    HtmlStream html(req);
+    sendHTMLHeader(html);
+    html += "<h1>User Payload Mapping</h1>";
+    html.printf("<div class='card'>Profiles with payload format <strong>%s</strong> send this layout: ", PAYLOAD_TYPE_NAMES[PAYLOAD_USER_MAP]);
+    html.printf("%d profile(s), FPort %d, %u bytes. ", users, LORAWAN_MAP_FPORT, (unsigned)map->getSize());
+    html += "The text is compiled when saved; uplinks run the compiled fields.</div>";
+
+    // Layout text (comments kept)
+    String spec = map->getSpec();
+    spec.replace("&", "&amp;");
+    spec.replace("<", "&lt;");
+    html += "<form method='POST' action='/lorawan/payload/update'>";
+    html += "<label>Layout (one field per line: name source encoding [scale] [offset] [le]):</label>";
+    html.printf("<textarea name='spec' rows='14' maxlength='%d' style='width:100%%;box-sizing:border-box;font-family:monospace;font-size:14px;'>", PAYLOAD_MAP_SPEC_MAX - 1);
+    html += spec;
+    html += "</textarea>";
+    html += "<button type='submit'>Compile and Save</button>";
+    html += "</form>";
+
+    html += "<table><tr><th>Part</th><th>Values</th></tr>";
+    html += "<tr><td>Source</td><td><code>ir0</code>-<code>ir8</code> input registers, <code>hr0</code>-<code>hr12</code> holding registers, <code>count</code> uplink counter, <code>=N</code> constant (checked by the decoder)</td></tr>";
+    html += "<tr><td>Encoding</td><td><code>u8</code>, <code>u16</code>, <code>s16</code>, <code>u32</code>, <code>f16</code> (half float), <code>bits1</code>-<code>bits16</code> (packed, MSB first)</td></tr>";
+    html += "<tr><td>Scaling</td><td>Sent: source &times; scale + offset, rounded and clamped to the encoding</td></tr>";
+    html += "<tr><td><code>le</code></td><td>Little-endian (default big-endian)</td></tr>";
+    html += "</table>";
+
+    // Compiled layout with the frame the current registers give
+    uint8_t frame[PAYLOAD_MAP_MAX_BYTES];
+    HoldingRegisters& holding = modbusHandler.getHoldingRegisters();
+    uint16_t input[PAYLOAD_MAP_INPUT_REGS];
+    uint16_t holding_words[PAYLOAD_MAP_HOLDING_REGS];
+    memcpy(input, &modbusHandler.getInputRegisters(), sizeof(input));
+    memcpy(holding_words, &holding, sizeof(holding_words));
+    PayloadMapInputs in = { input, holding_words, lorawanHandler.getUplinkCount() };
+    size_t len = map->encode(frame, sizeof(frame), in);
+
+    html += "<h2>Compiled Layout</h2>";
+    html += "<table><tr><th>Field</th><th>Bits</th><th>Encoding</th><th>Source</th><th>Scale / Offset</th><th>Sent now</th><th>Decoded</th></tr>";
+    for (uint8_t i = 0; i < map->getFieldCount(); i++) {
+        const PayloadMapOp& op = map->getField(i);
+        html.printf("<tr><td>%s</td><td>%u-%u</td>", op.name, op.bit_pos, op.bit_pos + op.bits - 1);
+        html.printf("<td>%s", PAYLOAD_MAP_ENCODING_NAMES[op.encoding]);
+        if (op.encoding == MAP_BITS) html.printf("%u", op.bits);
+        if (op.little_endian) html += " le";
+        html += "</td><td>";
+        if (op.source == MAP_SRC_INPUT) html.printf("ir%u", op.index);
+        else if (op.source == MAP_SRC_HOLDING) html.printf("hr%u", op.index);
+        else if (op.source == MAP_SRC_COUNT) html += "count";
+        else html.printf("=%ld", (long)op.constant);
+        html += "</td>";
+        html.printf("<td>%.4f / %.2f</td>", op.scale, op.offset);
+        html.printf("<td>%lu</td><td>%.2f</td></tr>", (unsigned long)map->readStored(i, frame), map->decodeField(i, frame));
+    }
+    html += "</table>";
+
+    html += "<p>Frame from the current registers: <code>";
+    for (size_t b = 0; b < len; b++) {
+        html.printf("%02X", frame[b]);
+    }
+
+    html += "</code></p>";
+    html += "<p><a href='/lorawan/payload/decoder.js' style='background:#3498db;color:white;padding:10px;text-decoration:none;border-radius:5px;'>Download Decoder (TTN v3 / ChirpStack v4) &raquo;</a></p>";
+    html += "<p>The decoder returns every field in source units (register value as read over Modbus). Download it again after every change.</p>";
+    delete map;
+
+    sendHTMLFooter(html);
+    return html.end();
+}
+
+esp_err_t WebServerManager::handleLoRaWANPayloadUpdate(httpd_req_t *req) {
+    if (!checkAuth(req)) return ESP_OK;
+
+    String body = getPostBody(req);
+    String spec;
+    if (!getPostParameter(body, "spec", spec)) {
+        sendRedirectPage(req, "Error", "Missing layout", "/lorawan/payload");
+        return ESP_OK;
+    }
+
+    char error[80];
+    if (lorawanHandler.setPayloadMap(spec.c_str(), error, sizeof(error))) {
+        sendRedirectPage(req, "Mapping Saved", "Layout compiled and saved. Download the decoder again.", "/lorawan/payload");
+    } else {
+        String message = String(error);
+        message.replace("<", "&lt;");
+        sendRedirectPage(req, "Error", message.c_str(), "/lorawan/payload", 5);
+    }
+    return ESP_OK;
+}
+
+esp_err_t WebServerManager::handleLoRaWANPayloadDecoder(httpd_req_t *req) {
+    if (!checkAuth(req)) return ESP_OK;
+
+    PayloadMap* map = new PayloadMap();
+    lorawanHandler.getPayloadMap(*map);
+    const size_t max_len = 8192;
+    char* js = (char*)malloc(max_len);
+    if (!js) {
+        delete map;
+        httpd_resp_send_500(req);
+        return ESP_OK;
+    }
+    size_t len = map->generateDecoder(js, max_len);
+    delete map;
+
+    httpd_resp_set_type(req, "application/javascript");
+    httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"payload_map_decoder.js\"");
+    httpd_resp_send(req, js, len);
+    free(js);
     return ESP_OK;
 }
 
 esp_err_t WebServerManager::handleLoRaWANProfiles(httpd_req_t *req) {
     if (!checkAuth(req)) return ESP_OK;
 
-    String html = buildHTMLHeader();
+    HtmlStream html(req);
+    sendHTMLHeader(html);
     
-    html += R"(<script>
-    function toggleProfile(idx){ fetch('/lorawan/profile/toggle?index='+idx).then(()=>location.reload()); }
-    function activateProfile(idx){ if(confirm('Switch profile? Device will restart.')) fetch('/lorawan/profile/activate?index='+idx).then(()=>{ alert('Restarting...'); setTimeout(()=>location.href='/',10000); }); }
-    function toggleAutoRotate(e){ fetch('/lorawan/auto-rotate?enabled='+(e?'1':'0')).then(()=>location.reload()); }
-    </script>)";
-
     html += "<h1>LoRaWAN Profiles</h1>";
 
     // Auto-rotation
@@ -699,88 +1117,130 @@ esp_err_t WebServerManager::handleLoRaWANProfiles(httpd_req_t *req) {
     int enabled_count = lorawanHandler.getEnabledProfileCount();
     html += "<div class='card' style='background:#1e5631;border:2px solid #27ae60;color:#fff;'>";
     html += "<h3>Auto-Rotation</h3>";
-    html += "<p>Status: <strong>" + String(auto_rotate ? "ENABLED" : "DISABLED") + "</strong> | Enabled profiles: " + String(enabled_count) + "</p>";
-    html += "<label><input type='checkbox' " + String(auto_rotate ? "checked" : "") + " " + String(enabled_count < 2 ? "disabled" : "") + " onchange='toggleAutoRotate(this.checked)'> Enable Auto-Rotation</label>";
+    html.printf("<p>Status: <strong>%s</strong> | Enabled profiles: %d</p>", auto_rotate ? "ENABLED" : "DISABLED", enabled_count);
+    html.printf("<label><input type='checkbox' %s %s onchange='toggleAutoRotate(this.checked)'> Enable Auto-Rotation</label>",
+        auto_rotate ? "checked" : "", enabled_count < 2 ? "disabled" : "");
     html += "</div>";
 
+    // One page of profiles at a time - all edit forms at once would not fit in RAM
+    const int page_count = (MAX_LORA_PROFILES + LORAWAN_PROFILES_PER_PAGE - 1) / LORAWAN_PROFILES_PER_PAGE;
+    int page = getQueryParameter(req, "page").toInt();
+    String euiStr = getQueryParameter(req, "eui");
+    if (euiStr.length() > 0) {
+        uint64_t eui = strtoull(euiStr.c_str(), NULL, 16);
+        int found = lorawanHandler.findProfileByDevEUI(eui);
+        if (found >= 0) {
+            page = found / LORAWAN_PROFILES_PER_PAGE;
+        } else {
+            // The parsed value, not the query text: nothing from the URL ends up in the page
+            html.printf("<div class='warning'>No profile with DevEUI %016llX</div>", (unsigned long long)eui);
+        }
+    }
+    if (page < 0 || page >= page_count) page = 0;
+    int first = page * LORAWAN_PROFILES_PER_PAGE;
+    int last = min(first + LORAWAN_PROFILES_PER_PAGE, MAX_LORA_PROFILES);
+
     // Profile table
     html += "<h2>Profile Overview</h2>";
-    html += "<table><tr><th>Profile</th><th>Name</th><th>DevEUI</th><th>Status</th><th>Actions</th></tr>";
+    html += "<form method='GET' action='/lorawan/profiles'><label>Find DevEUI:</label><input type='text' name='eui' pattern='[0-9A-Fa-f]{16}' placeholder='16 hex characters'><button type='submit'>Find</button></form>";
+    sendProfilePager(html, page, page_count);
+    html += "<table><tr><th>Profile</th><th>Name</th><th>DevEUI</th><th>Mode</th><th>Region</th><th>Status</th><th>Actions</th></tr>";
     
     uint8_t active_idx = lorawanHandler.getActiveProfileIndex();
-    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+    for (int i = first; i < last; i++) {
         LoRaProfile* prof = lorawanHandler.getProfile(i);
         if (!prof) continue;
         
-        char devEUIStr[17];
-        sprintf(devEUIStr, "%016llX", prof->devEUI);
-        
-        html += "<tr><td><strong>" + String(i) + "</strong>";
-        if (i == active_idx) html += " <span style='background:#27ae60;color:white;padding:2px 6px;border-radius:3px;font-size:11px;'>ACTIVE</span>";
-        html += "</td>";
-        html += "<td>" + String(prof->name) + "</td>";
-        html += "<td style='font-family:monospace;font-size:11px;'>0x" + String(devEUIStr) + "</td>";
-        html += "<td style='color:" + String(prof->enabled ? "#27ae60" : "#95a5a6") + ";font-weight:bold;'>" + String(prof->enabled ? "ENABLED" : "DISABLED") + "</td>";
-        html += "<td>";
+        // Formatted straight into the chunk buffer: no temporary Strings per row
+        html.printf("<tr><td><strong>%d</strong>%s</td>", i,
+            i == active_idx ? " <span style='background:#27ae60;color:white;padding:2px 6px;border-radius:3px;font-size:11px;'>ACTIVE</span>" : "");
+        html.printf("<td>%s</td><td style='font-family:monospace;font-size:11px;'>0x%016llX</td><td>%s</td><td>%s</td>",
+            prof->name, (unsigned long long)prof->devEUI, prof->abp ? "ABP" : "OTAA", LoRaRegions::name(prof->region));
+        html.printf("<td style='color:%s;font-weight:bold;'>%s</td><td>",
+            prof->enabled ? "#27ae60" : "#95a5a6", prof->enabled ? "ENABLED" : "DISABLED");
         if (i != active_idx || !prof->enabled) {
-            html += "<button onclick='toggleProfile(" + String(i) + ")' style='padding:5px 10px;margin:2px;'>" + String(prof->enabled ? "Disable" : "Enable") + "</button>";
+            html.printf("<button onclick='toggleProfile(%d)' style='padding:5px 10px;margin:2px;'>%s</button>", i, prof->enabled ? "Disable" : "Enable");
         }
         if (prof->enabled && i != active_idx) {
-            html += "<button onclick='activateProfile(" + String(i) + ")' style='padding:5px 10px;margin:2px;background:#3498db;'>Activate</button>";
+            html.printf("<button onclick='activateProfile(%d)' style='padding:5px 10px;margin:2px;background:#3498db;'>Activate</button>", i);
         }
         html += "</td></tr>";
     }
     html += "</table>";
 
-    // Edit forms for each profile
-    for (int i = 0; i < MAX_LORA_PROFILES; i++) {
+    sendProfilePager(html, page, page_count);
+
+
+    // Edit forms for the profiles on this page
+    for (int i = first; i < last; i++) {
         LoRaProfile* prof = lorawanHandler.getProfile(i);
         if (!prof) continue;
         
-        html += "<div class='card' id='profile" + String(i) + "'>";
-        html += "<h3>Edit Profile " + String(i) + ": " + String(prof->name) + "</h3>";
+        html.printf("<div class='card' id='profile%d'><h3>Edit Profile %d: %s</h3>", i, i, prof->name);
         html += "<form method='POST' action='/lorawan/profile/update'>";
-        html += "<input type='hidden' name='index' value='" + String(i) + "'>";
+        html.printf("<input type='hidden' name='index' value='%d'>", i);
         
-        html += "<label>Name:</label><input type='text' name='name' value='" + String(prof->name) + "' maxlength='32'>";
+        html.printf("<label>Name:</label><input type='text' name='name' value='%s' maxlength='32'>", prof->name);
         
         html += "<label>Payload Format:</label><select name='payload_type'>";
-        for (int pt = 0; pt <= PAYLOAD_VISTRON_LORA_MOD_CON; pt++) {
-            html += "<option value='" + String(pt) + "'" + String(pt == prof->payload_type ? " selected" : "") + ">" + String(PAYLOAD_TYPE_NAMES[pt]) + "</option>";
+        for (int pt = 0; pt < PAYLOAD_TYPE_COUNT; pt++) {
+            html.printf("<option value='%d'%s>%s</option>", pt, pt == prof->payload_type ? " selected" : "", PAYLOAD_TYPE_NAMES[pt]);
+        }
+        html += "</select>";
+        if (prof->payload_type == PAYLOAD_USER_MAP) {
+            html += "<p style='margin-top:-10px;'><a href='/lorawan/payload'>Edit the user mapping &raquo;</a></p>";
+        }
+
+        // Changing the region drops the session; the profile joins again on the new channel plan
+        html += "<label>Region:</label><select name='region'>";
+        for (int r = 0; r < REGION_COUNT; r++) {
+            html.printf("<option value='%d'%s>%s</option>", r, r == prof->region ? " selected" : "", LORA_REGION_NAMES[r]);
+        }
+        html += "</select>";
+
+        // Alarm frames: a register below its low-alarm level, or an alarm raised/cleared
+        html += "<label>Confirmed Uplinks:</label><select name='confirm'>";
+        for (int c = 0; c < CONFIRM_MODE_COUNT; c++) {
+            html.printf("<option value='%d'%s>%s</option>", c, c == prof->confirm ? " selected" : "", CONFIRM_MODE_NAMES[c]);
         }
         html += "</select>";
         
-        char joinEUIStr[17], devEUIStr[17];
-        sprintf(joinEUIStr, "%016llX", prof->joinEUI);
-        sprintf(devEUIStr, "%016llX", prof->devEUI);
-        
-        html += "<label>JoinEUI:</label><input type='text' name='joinEUI' value='" + String(joinEUIStr) + "' pattern='[0-9A-Fa-f]{16}'>";
-        html += "<label>DevEUI:</label><input type='text' name='devEUI' value='" + String(devEUIStr) + "' pattern='[0-9A-Fa-f]{16}'>";
-        
-        html += "<label>AppKey:</label><input type='text' name='appKey' value='";
-        for (int j = 0; j < 16; j++) { char buf[3]; sprintf(buf, "%02X", prof->appKey[j]); html += buf; }
-        html += "' pattern='[0-9A-Fa-f]{32}'>";
+        html.printf("<label>JoinEUI:</label><input type='text' name='joinEUI' value='%016llX' pattern='[0-9A-Fa-f]{16}'>", (unsigned long long)prof->joinEUI);
+        html.printf("<label>DevEUI:</label><input type='text' name='devEUI' value='%016llX' pattern='[0-9A-Fa-f]{16}'>", (unsigned long long)prof->devEUI);
         
-        html += "<label>NwkKey:</label><input type='text' name='nwkKey' value='";
-        for (int j = 0; j < 16; j++) { char buf[3]; sprintf(buf, "%02X", prof->nwkKey[j]); html += buf; }
-        html += "' pattern='[0-9A-Fa-f]{32}'>";
+        char appKeyStr[33], nwkKeyStr[33];
+        for (int j = 0; j < 16; j++) {
+            sprintf(appKeyStr + 2 * j, "%02X", prof->appKey[j]);
+            sprintf(nwkKeyStr + 2 * j, "%02X", prof->nwkKey[j]);
+        }
+        html.printf("<label>AppKey:</label><input type='text' name='appKey' value='%s' pattern='[0-9A-Fa-f]{32}'>", appKeyStr);
+        html.printf("<label>NwkKey:</label><input type='text' name='nwkKey' value='%s' pattern='[0-9A-Fa-f]{32}'>", nwkKeyStr);
+
+        // ABP: session keys are entered here instead of being derived by a join
+        char nwkSKeyStr[33], appSKeyStr[33];
+        for (int j = 0; j < 16; j++) {
+            sprintf(nwkSKeyStr + 2 * j, "%02X", prof->nwkSKey[j]);
+            sprintf(appSKeyStr + 2 * j, "%02X", prof->appSKey[j]);
+        }
+        html.printf("<label>Activation:</label><select name='activation'><option value='otaa'%s>OTAA (join)</option><option value='abp'%s>ABP (no join)</option></select>",
+            prof->abp ? "" : " selected", prof->abp ? " selected" : "");
+        html.printf("<label>DevAddr (ABP):</label><input type='text' name='devAddr' value='%08lX' pattern='[0-9A-Fa-f]{8}'>", (unsigned long)prof->devAddr);
+        html.printf("<label>NwkSKey (ABP):</label><input type='text' name='nwkSKey' value='%s' pattern='[0-9A-Fa-f]{32}'>", nwkSKeyStr);
+        html.printf("<label>AppSKey (ABP):</label><input type='text' name='appSKey' value='%s' pattern='[0-9A-Fa-f]{32}'>", appSKeyStr);
         
         html += "<button type='submit'>Save Profile</button>";
         html += "</form></div>";
     }
     
-    html += buildHTMLFooter();
-
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, html.c_str(), html.length());
-    return ESP_OK;
+    sendHTMLFooter(html);
+    return html.end();
 }
 
 esp_err_t WebServerManager::handleWiFi(httpd_req_t *req) {
     if (!checkAuth(req)) return ESP_OK;
 
-    String html = buildHTMLHeader();
-    html += String(FPSTR(WIFI_PAGE_ASSETS));
+    HtmlStream html(req);
+    sendHTMLHeader(html);
 
     html += "<h1>WiFi Configuration</h1>";
     html += "<div id='statusArea'><div class='status'><div class='spinner'></div> Loading...</div></div>";
@@ -797,17 +1257,15 @@ esp_err_t WebServerManager::handleWiFi(httpd_req_t *req) {
     html += "<input type='submit' value='Connect'>";
     html += "</form>";
 
-    html += buildHTMLFooter();
-
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, html.c_str(), html.length());
-    return ESP_OK;
+    sendHTMLFooter(html);
+    return html.end();
 }
 
 esp_err_t WebServerManager::handleSecurity(httpd_req_t *req) {
     if (!checkAuth(req)) return ESP_OK;
 
-    String html = buildHTMLHeader();
+    HtmlStream html(req);
+    sendHTMLHeader(html);
 
     html += "<h1>Security Settings</h1>";
 
@@ -815,22 +1273,23 @@ esp_err_t WebServerManager::handleSecurity(httpd_req_t *req) {
 
     html += "<div class='card'>";
     html += "<p><strong>Status:</strong></p>";
-    html += "<p>Authentication: <strong>" + String(authManager.isEnabled() ? "ENABLED" : "DISABLED") + "</strong></p>";
-    html += "<p>Username: <strong>" + authManager.getUsername() + "</strong></p>";
+    String username = authManager.getUsername();
+    html.printf("<p>Authentication: <strong>%s</strong></p>", authManager.isEnabled() ? "ENABLED" : "DISABLED");
+    html.printf("<p>Username: <strong>%s</strong></p>", username.c_str());
     html += "</div>";
 
     html += "<h2>Update Authentication</h2>";
     html += "<form action='/security/update' method='POST'>";
-    html += "<label><input type='checkbox' name='auth_enabled' value='1'" + String(authManager.isEnabled() ? " checked" : "") + "> Enable Authentication</label>";
-    html += "<label>Username:</label><input type='text' name='username' value='" + authManager.getUsername() + "' maxlength='32'>";
+    html.printf("<label><input type='checkbox' name='auth_enabled' value='1'%s> Enable Authentication</label>", authManager.isEnabled() ? " checked" : "");
+    html.printf("<label>Username:</label><input type='text' name='username' value='%s' maxlength='32'>", username.c_str());
     html += "<label>New Password:</label><input type='password' name='password' placeholder='Leave empty to keep current' maxlength='32'>";
     html += "<input type='submit' value='Save'>";
     html += "</form>";
 
     html += "<h2>Debug Settings</h2>";
     html += "<form action='/security/debug' method='POST'>";
-    html += "<label><input type='checkbox' name='debug_https' value='1'" + String(authManager.getDebugHTTPS() ? " checked" : "") + "> HTTPS Debug</label>";
-    html += "<label><input type='checkbox' name='debug_auth' value='1'" + String(authManager.getDebugAuth() ? " checked" : "") + "> Auth Debug</label>";
+    html.printf("<label><input type='checkbox' name='debug_https' value='1'%s> HTTPS Debug</label>", authManager.getDebugHTTPS() ? " checked" : "");
+    html.printf("<label><input type='checkbox' name='debug_auth' value='1'%s> Auth Debug</label>", authManager.getDebugAuth() ? " checked" : "");
     html += "<input type='submit' value='Save Debug Settings'>";
     html += "</form>";
 
@@ -839,56 +1298,73 @@ esp_err_t WebServerManager::handleSecurity(httpd_req_t *req) {
     html += "<button onclick='if(confirm(\"Erase ALL settings?\")) window.location.href=\"/factory-reset\"' style='background:#e74c3c;'>Factory Reset</button>";
     html += "</div>";
 
-    html += buildHTMLFooter();
+    sendHTMLFooter(html);
+    return html.end();
+}
 
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, html.c_str(), html.length());
-    return ESP_OK;
+esp_err_t WebServerManager::handleLogs(httpd_req_t *req) {
+    if (!checkAuth(req)) return ESP_OK;
+
+    HtmlStream html(req);
+    sendHTMLHeader(html);
+
+    html += "<h1>Logs</h1>";
+
+    html += "<div class='card'>";
+    html.printf("<p>Records written: <strong>%lu</strong>", (unsigned long)logger.getWritten());
+    html.printf(", dropped (ring full): <strong>%lu</strong></p>", (unsigned long)logger.getDropped());
+    html.printf("<p>Compile-time level: <strong>%s</strong> (LOG_COMPILE_LEVEL in config.h)</p>", LOG_LEVEL_NAMES[LOG_COMPILE_LEVEL]);
+    html += "</div>";
+
+    html += "<h2>Log Levels</h2>";
+    html += "<form action='/logs/levels' method='POST'>";
+    html += "<table><tr><th>Module</th><th>Level</th></tr>";
+    for (uint8_t m = 0; m < LOG_MODULE_COUNT; m++) {
+        html.printf("<tr><td>%s</td><td><select name='m%u'>", LOG_MODULE_NAMES[m], m);
+        for (uint8_t l = 0; l <= LOG_COMPILE_LEVEL; l++) {
+            html.printf("<option value='%u'%s>%s</option>", l, logger.getLevel(m) == l ? " selected" : "", LOG_LEVEL_NAMES[l]);
+        }
+        html += "</select></td></tr>";
+    }
+    html += "</table>";
+    html += "<input type='submit' value='Save Log Levels'>";
+    html += "</form>";
+
+    // Newest last, as on the serial console
+    html += "<h2>Recent Lines</h2>";
+    char* text = (char*)malloc(LOG_WEB_BUFFER + 1);
+    if (text) {
+        size_t len = logger.copyRecent(text, LOG_WEB_BUFFER + 1);
+        html += "<pre style='font-size:12px;overflow-x:auto;'>";
+        for (size_t i = 0; i < len; i++) {
+            char c = text[i];
+            if (c == '<') html += "&lt;";
+            else if (c == '>') html += "&gt;";
+            else if (c == '&') html += "&amp;";
+            else html += c;
+        }
+        html += "</pre>";
+        free(text);
+    }
+    html += "<p><a href='/logs'>Refresh</a></p>";
+
+    sendHTMLFooter(html);
+    return html.end();
 }
 
 esp_err_t WebServerManager::handleOTA(httpd_req_t *req) {
     if (!checkAuth(req)) return ESP_OK;
 
-    String html = buildHTMLHeader();
-    
-    html += "<script>\n";
-    html += "function checkForUpdates(){\n";
-    html += "  var btn = document.getElementById('checkBtn');\n";
-    html += "  var status = document.getElementById('updateStatus');\n";
-    html += "  btn.disabled=true;\n";
-    html += "  btn.innerHTML='Checking...';\n";
-    html += "  fetch('/ota/check').then(function(r){return r.json();}).then(function(data){\n";
-    html += "    btn.disabled=false;\n";
-    html += "    btn.innerHTML='Check for Updates';\n";
-    html += "    if(data.error) status.innerHTML='<div class=\"warning\">'+data.error+'</div>';\n";
-    html += "    else if(data.updateAvailable) status.innerHTML='<div class=\"card\" style=\"background:#1e5631;border-color:#27ae60;color:#fff;\"><strong>Update available!</strong><br>Current: '+data.currentVersion+'<br>Latest: '+data.latestVersion+'<br><br><button onclick=\"startUpdate()\">Install Update</button></div>';\n";
-    html += "    else status.innerHTML='<div class=\"card\">Up to date: '+data.currentVersion+'</div>';\n";
-    html += "  }).catch(function(e){ btn.disabled=false; btn.innerHTML='Check for Updates'; });\n";
-    html += "}\n";
-    html += "function startUpdate(){\n";
-    html += "  if(!confirm('Start firmware update?'))return;\n";
-    html += "  var status = document.getElementById('updateStatus');\n";
-    html += "  status.innerHTML='<div class=\"card\">Updating...<div class=\"spinner\"></div></div>';\n";
-    html += "  fetch('/ota/start').then(function(r){return r.json();}).then(function(data){\n";
-    html += "    if(data.started) setInterval(checkProgress,1000);\n";
-    html += "    else status.innerHTML='<div class=\"warning\">'+(data.error||'Failed')+'</div>';\n";
-    html += "  });\n";
-    html += "}\n";
-    html += "function checkProgress(){\n";
-    html += "  fetch('/ota/status').then(function(r){return r.json();}).then(function(data){\n";
-    html += "    var status = document.getElementById('updateStatus');\n";
-    html += "    if(data.status==='success'){ status.innerHTML='<div class=\"card\" style=\"background:#1e5631;color:#fff;\">Update complete! Rebooting...</div>'; setTimeout(function(){location.reload();},15000); }\n";
-    html += "    else if(data.status==='failed') status.innerHTML='<div class=\"warning\">Failed: '+data.message+'</div>';\n";
-    html += "    else status.innerHTML='<div class=\"card\">Progress: '+data.progress+'%<br>'+data.message+'</div>';\n";
-    html += "  });\n";
-    html += "}\n";
-    html += "</script>\n";
+    HtmlStream html(req);
+    sendHTMLHeader(html);
+    
 
     html += "<h1>Firmware Update (OTA)</h1>";
 
     html += "<div class='card'>";
     html += "<h3>Current Firmware</h3>";
-    html += "<p><strong>Version:</strong> " + otaManager.getCurrentVersion() + "</p>";
+    html.printf("<p><strong>Version:</strong> %s</p>", otaManager.getCurrentVersion().c_str());
+
     html += "</div>";
 
     html += "<div class='card'>";
@@ -901,11 +1377,8 @@ esp_err_t WebServerManager::handleOTA(httpd_req_t *req) {
     html += "<div id='updateStatus'></div>";
     html += "</div>";
 
-    html += buildHTMLFooter();
-
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, html.c_str(), html.length());
-    return ESP_OK;
+    sendHTMLFooter(html);
+    return html.end();
 }
 
 // ============================================================================
@@ -956,17 +1429,19 @@ esp_err_t WebServerManager::handleLoRaWANConfig(httpd_req_t *req) {
         LoRaProfile* prof = lorawanHandler.getProfile(active_idx);
         
         if (prof) {
-            prof->joinEUI = strtoull(joinEUIStr.c_str(), NULL, 16);
-            prof->devEUI = strtoull(devEUIStr.c_str(), NULL, 16);
+            // Edit a copy so updateProfile() can detect credential changes
+            LoRaProfile updated = *prof;
+            updated.joinEUI = strtoull(joinEUIStr.c_str(), NULL, 16);
+            updated.devEUI = strtoull(devEUIStr.c_str(), NULL, 16);
             
             for (int i = 0; i < 16; i++) {
                 char buf[3] = {appKeyStr[i*2], appKeyStr[i*2+1], 0};
-                prof->appKey[i] = strtol(buf, NULL, 16);
+                updated.appKey[i] = strtol(buf, NULL, 16);
                 char buf2[3] = {nwkKeyStr[i*2], nwkKeyStr[i*2+1], 0};
-                prof->nwkKey[i] = strtol(buf2, NULL, 16);
+                updated.nwkKey[i] = strtol(buf2, NULL, 16);
             }
             
-            lorawanHandler.updateProfile(active_idx, *prof);
+            lorawanHandler.updateProfile(active_idx, updated);
             
             sendRedirectPage(req, "Credentials Updated", "Device restarting...", "/", 10);
             delay(1000);
@@ -984,6 +1459,7 @@ esp_err_t WebServerManager::handleLoRaWANProfileUpdate(httpd_req_t *req) {
 
     String body = getPostBody(req);
     String indexStr, name, joinEUIStr, devEUIStr, appKeyStr, nwkKeyStr, payloadTypeStr;
+    String activationStr, devAddrStr, nwkSKeyStr, appSKeyStr, regionStr, confirmStr;
     
     if (getPostParameter(body, "index", indexStr)) {
         int index = indexStr.toInt();
@@ -994,6 +1470,8 @@ esp_err_t WebServerManager::handleLoRaWANProfileUpdate(httpd_req_t *req) {
         LoRaProfile* existing = lorawanHandler.getProfile(index);
         if (existing) {
             profile.enabled = existing->enabled;
+            profile.region = existing->region;
+            profile.confirm = existing->confirm;
         }
 
         if (getPostParameter(body, "name", name)) {
@@ -1002,15 +1480,48 @@ esp_err_t WebServerManager::handleLoRaWANProfileUpdate(httpd_req_t *req) {
 
         if (getPostParameter(body, "payload_type", payloadTypeStr)) {
             int pt = payloadTypeStr.toInt();
-            profile.payload_type = (pt >= 0 && pt <= PAYLOAD_VISTRON_LORA_MOD_CON) ? (PayloadType)pt : PAYLOAD_ADEUNIS_MODBUS_SF6;
+            profile.payload_type = (pt >= 0 && pt < PAYLOAD_TYPE_COUNT) ? (PayloadType)pt : PAYLOAD_ADEUNIS_MODBUS_SF6;
+        }
+
+        if (getPostParameter(body, "region", regionStr)) {
+            int region = regionStr.toInt();
+            if (region >= 0 && region < REGION_COUNT) profile.region = (LoRaRegion)region;
+        }
+
+        if (getPostParameter(body, "confirm", confirmStr)) {
+            int confirm = confirmStr.toInt();
+            if (confirm >= 0 && confirm < CONFIRM_MODE_COUNT) profile.confirm = (ConfirmMode)confirm;
         }
 
         getPostParameter(body, "joinEUI", joinEUIStr);
         getPostParameter(body, "devEUI", devEUIStr);
         getPostParameter(body, "appKey", appKeyStr);
         getPostParameter(body, "nwkKey", nwkKeyStr);
+        getPostParameter(body, "activation", activationStr);
+        getPostParameter(body, "devAddr", devAddrStr);
+        getPostParameter(body, "nwkSKey", nwkSKeyStr);
+        getPostParameter(body, "appSKey", appSKeyStr);
+
+        // ABP fields are stored with the profile only while ABP is selected
+        profile.abp = (activationStr == "abp");
+        bool abp_valid = devAddrStr.length() == 8 && nwkSKeyStr.length() == 32 && appSKeyStr.length() == 32;
+        if (abp_valid) {
+            profile.devAddr = strtoul(devAddrStr.c_str(), NULL, 16);
+            for (int i = 0; i < 16; i++) {
+                char buf[3] = {nwkSKeyStr[i*2], nwkSKeyStr[i*2+1], 0};
+                profile.nwkSKey[i] = strtol(buf, NULL, 16);
+                char buf2[3] = {appSKeyStr[i*2], appSKeyStr[i*2+1], 0};
+                profile.appSKey[i] = strtol(buf2, NULL, 16);
+            }
+        } else if (existing) {
+            profile.devAddr = existing->devAddr;
+            memcpy(profile.nwkSKey, existing->nwkSKey, 16);
+            memcpy(profile.appSKey, existing->appSKey, 16);
+        }
 
-        if (joinEUIStr.length() == 16 && devEUIStr.length() == 16 &&
+        if (profile.abp && (!abp_valid || profile.devAddr == 0)) {
+            sendRedirectPage(req, "Error", "ABP needs a DevAddr and both session keys", "/lorawan/profiles");
+        } else if (joinEUIStr.length() == 16 && devEUIStr.length() == 16 &&
             appKeyStr.length() == 32 && nwkKeyStr.length() == 32) {
             
             profile.joinEUI = strtoull(joinEUIStr.c_str(), NULL, 16);
@@ -1023,8 +1534,15 @@ esp_err_t WebServerManager::handleLoRaWANProfileUpdate(httpd_req_t *req) {
                 profile.nwkKey[i] = strtol(buf2, NULL, 16);
             }
             
-            lorawanHandler.updateProfile(index, profile);
-            sendRedirectPage(req, "Profile Updated", "Profile saved.", "/lorawan/profiles");
+            String back = "/lorawan/profiles?page=" + String(index / LORAWAN_PROFILES_PER_PAGE);
+            int other = lorawanHandler.findProfileByDevEUI(profile.devEUI);
+            if (other >= 0 && other != index) {
+                sendRedirectPage(req, "Error", ("DevEUI already used by profile " + String(other)).c_str(), back.c_str());
+            } else if (lorawanHandler.updateProfile(index, profile)) {
+                sendRedirectPage(req, "Profile Updated", "Profile saved.", back.c_str());
+            } else {
+                sendRedirectPage(req, "Error", "Profile not saved", back.c_str());
+            }
         } else {
             sendRedirectPage(req, "Error", "Invalid credentials format", "/lorawan/profiles");
         }
@@ -1176,6 +1694,24 @@ esp_err_t WebServerManager::handleDebugUpdate(httpd_req_t *req) {
     return ESP_OK;
 }
 
+esp_err_t WebServerManager::handleLogLevels(httpd_req_t *req) {
+    if (!checkAuth(req)) return ESP_OK;
+
+    String body = getPostBody(req);
+    for (uint8_t m = 0; m < LOG_MODULE_COUNT; m++) {
+        char name[8];
+        snprintf(name, sizeof(name), "m%u", m);
+        String value;
+        if (getPostParameter(body, name, value)) {
+            logger.setLevel(m, (uint8_t)value.toInt());
+        }
+    }
+    logger.saveLevels();
+
+    sendRedirectPage(req, "Log Levels Updated", "Settings saved.", "/logs");
+    return ESP_OK;
+}
+
 esp_err_t WebServerManager::handleSF6Update(httpd_req_t *req) {
     if (!checkAuth(req)) return ESP_OK;
     
@@ -1244,6 +1780,10 @@ esp_err_t WebServerManager::handleFactoryReset(httpd_req_t *req) {
     prefs.begin("sf6", false); prefs.clear(); prefs.end();
     prefs.begin("lorawan", false); prefs.clear(); prefs.end();
     prefs.begin("lorawan_prof", false); prefs.clear(); prefs.end();
+    // Profiles, nonces and sessions on the LoRaWAN partition (same as above without one)
+    profileStore.open(prefs, "lorawan"); prefs.clear(); prefs.end();
+    profileStore.open(prefs, "lorawan_prof"); prefs.clear(); prefs.end();
+    nonceLog.clear();
     
     sendRedirectPage(req, "Factory Reset", "Reset complete. Rebooting...", "/", 10);
     delay(1000);
@@ -1371,3 +1911,142 @@ esp_err_t WebServerManager::handleOTAAutoInstall(httpd_req_t *req) {
     }
     return ESP_OK;
 }
+
+// ============================================================================
+// JSON API HANDLERS (/api/v1)
+// ============================================================================
+// Serialized by api_json.cpp straight into the chunked response. The arena is
+// shared: the httpd task runs one handler at a time.
+
+// serializeJson() output into the response chunks
+class StreamApiWriter : public ApiWriter {
+public:
+    explicit StreamApiWriter(HtmlStream& stream) : stream(stream) {}
+
+    size_t write(uint8_t c) override {
+        stream += (char)c;
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t len) override {
+        stream.write((const char*)data, len);
+        return len;
+    }
+
+private:
+    HtmlStream& stream;
+};
+
+alignas(8) static uint8_t api_arena_buffer[API_ARENA_SIZE];
+static ApiArena apiArena(api_arena_buffer, sizeof(api_arena_buffer));
+
+static esp_err_t finishApiResponse(HtmlStream& stream, ApiJsonOutput& json) {
+    if (!json.end()) {
+        LOG_W(LOG_WEB, "API response truncated (arena %u bytes, peak %u)",
+              (unsigned)API_ARENA_SIZE, (unsigned)apiArena.getPeak());
+    }
+    return stream.end();
+}
+
+esp_err_t WebServerManager::handleApiRegisters(httpd_req_t *req) {
+    if (!checkAuth(req)) return ESP_OK;
+
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    HtmlStream stream(req, "application/json");
+    StreamApiWriter writer(stream);
+    ApiJsonOutput json(writer, apiArena);
+
+    apiRegisters(json.head(), modbusHandler.getHoldingRegisters(), modbusHandler.getInputRegisters());
+    return finishApiResponse(stream, json);
+}
+
+esp_err_t WebServerManager::handleApiStats(httpd_req_t *req) {
+    if (!checkAuth(req)) return ESP_OK;
+
+    ApiSystemStats system;
+    system.uptime_s = millis() / 1000;
+    system.free_heap = ESP.getFreeHeap();
+    system.min_free_heap = ESP.getMinFreeHeap();
+    system.largest_free_block = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+    system.temperature_c = temperatureRead();
+    system.wifi_ap_clients = wifiManager.getAPClients();
+    system.wifi_client_connected = wifiManager.isClientConnected();
+    system.log_written = logger.getWritten();
+    system.log_dropped = logger.getDropped();
+    system.api_arena_peak = apiArena.getPeak();
+    system.api_arena_failures = apiArena.getFailures();
+
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    HtmlStream stream(req, "application/json");
+    StreamApiWriter writer(stream);
+    ApiJsonOutput json(writer, apiArena);
+
+    apiStats(json.head(), system, modbusHandler.getStats(), HtmlStream::getStats());
+    return finishApiResponse(stream, json);
+}
+
+esp_err_t WebServerManager::handleApiLoRaWAN(httpd_req_t *req) {
+    if (!checkAuth(req)) return ESP_OK;
+
+    ApiLoRaWANStatus status;
+    status.joined = lorawanHandler.isJoined();
+    status.dev_addr = lorawanHandler.getDevAddr();
+    status.uplinks = lorawanHandler.getUplinkCount();
+    status.downlinks = lorawanHandler.getDownlinkCount();
+    status.class_c_downlinks = lorawanHandler.getClassCDownlinkCount();
+    status.last_rssi = lorawanHandler.getLastRSSI();
+    status.active_profile = lorawanHandler.getActiveProfileIndex();
+    status.auto_rotation = lorawanHandler.getAutoRotation();
+    status.enabled_profiles = lorawanHandler.getEnabledProfileCount();
+
+    ApiLoRaWANSources sources = {
+        lorawanHandler.getAirtime(),
+        lorawanHandler.getScheduler(),
+        lorawanHandler.getLinkHistory(),
+        lorawanHandler.getJoinBackoff(),
+        lorawanHandler.getDelivery()
+    };
+    unsigned long now = millis();
+
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    HtmlStream stream(req, "application/json");
+    StreamApiWriter writer(stream);
+    ApiJsonOutput json(writer, apiArena);
+
+    apiLoRaWANStatus(json.head(), status, sources.airtime, now);
+    json.openArray("profiles");
+    for (uint8_t i = 0; i < MAX_LORA_PROFILES; i++) {
+        LoRaProfile* prof = lorawanHandler.getProfile(i);
+        if (!prof || !prof->enabled) continue;
+
+        ApiProfileRuntime runtime;
+        runtime.profile = prof;
+        runtime.datarate = lorawanHandler.getProfileDatarate(i);
+        runtime.interval_s = lorawanHandler.getUplinkInterval(i);
+        runtime.next_airtime_ms = lorawanHandler.estimateUplinkAirtime(i);
+        runtime.ack_pending = lorawanHandler.hasPendingAck(i);
+        apiLoRaWANProfile(json.item(), i, runtime, sources, now);
+    }
+    return finishApiResponse(stream, json);
+}
+
+esp_err_t WebServerManager::handleApiProfiles(httpd_req_t *req) {
+    if (!checkAuth(req)) return ESP_OK;
+
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    HtmlStream stream(req, "application/json");
+    StreamApiWriter writer(stream);
+    ApiJsonOutput json(writer, apiArena);
+
+    uint8_t active = lorawanHandler.getActiveProfileIndex();
+    JsonObject head = json.head();
+    head["active_profile"] = active;
+    head["max_profiles"] = MAX_LORA_PROFILES;
+    json.openArray("profiles");
+    for (uint8_t i = 0; i < MAX_LORA_PROFILES; i++) {
+        LoRaProfile* prof = lorawanHandler.getProfile(i);
+        if (!prof) continue;
+        apiProfile(json.item(), i, *prof, i == active);
+    }
+    return finishApiResponse(stream, json);
+}
@@ -11,6 +11,9 @@
 #include "sf6_emulator.h"
 #include "ota_manager.h"
 #include "web_pages.h"
+#include "html_stream.h"
+
+struct WebAsset;  // web_assets.h (generated; included by web_server.cpp only)
 
 class WebServerManager {
 public:
@@ -31,9 +34,11 @@ private:
 
     // Helper functions
     void setupRoutes();
-    static String buildHTMLHeader();
-    static String buildHTMLFooter();
+    static void sendHTMLHeader(HtmlStream& html);
+    static void sendHTMLFooter(HtmlStream& html);
+    static void sendProfilePager(HtmlStream& html, int page, int page_count);
     static bool getDarkMode();
+    static const WebAsset* findAsset(const char* name, size_t len = 0);
     
     // Static request handlers for esp_https_server
     static esp_err_t handleRoot(httpd_req_t *req);
@@ -41,13 +46,19 @@ private:
     static esp_err_t handleRegisters(httpd_req_t *req);
     static esp_err_t handleLoRaWAN(httpd_req_t *req);
     static esp_err_t handleLoRaWANProfiles(httpd_req_t *req);
+    static esp_err_t handleLoRaWANFrames(httpd_req_t *req);
+    static esp_err_t handleLoRaWANPayload(httpd_req_t *req);
+    static esp_err_t handleLoRaWANPayloadDecoder(httpd_req_t *req);
     static esp_err_t handleWiFi(httpd_req_t *req);
     static esp_err_t handleSecurity(httpd_req_t *req);
+    static esp_err_t handleLogs(httpd_req_t *req);
+    static esp_err_t handleStatic(httpd_req_t *req);
     
     // Action Handlers
     static esp_err_t handleConfig(httpd_req_t *req);
     static esp_err_t handleLoRaWANConfig(httpd_req_t *req);
     static esp_err_t handleLoRaWANProfileUpdate(httpd_req_t *req);
+    static esp_err_t handleLoRaWANPayloadUpdate(httpd_req_t *req);
     static esp_err_t handleLoRaWANProfileToggle(httpd_req_t *req);
     static esp_err_t handleLoRaWANProfileActivate(httpd_req_t *req);
     static esp_err_t handleLoRaWANAutoRotate(httpd_req_t *req);
@@ -56,6 +67,7 @@ private:
     static esp_err_t handleWiFiStatus(httpd_req_t *req);
     static esp_err_t handleSecurityUpdate(httpd_req_t *req);
     static esp_err_t handleDebugUpdate(httpd_req_t *req);
+    static esp_err_t handleLogLevels(httpd_req_t *req);
     static esp_err_t handleSF6Update(httpd_req_t *req);
     static esp_err_t handleSF6Reset(httpd_req_t *req);
     static esp_err_t handleEnableAuth(httpd_req_t *req);
@@ -71,6 +83,12 @@ private:
     static esp_err_t handleOTAStart(httpd_req_t *req);
     static esp_err_t handleOTAStatus(httpd_req_t *req);
     static esp_err_t handleOTAAutoInstall(httpd_req_t *req);
+
+    // JSON API (/api/v1)
+    static esp_err_t handleApiRegisters(httpd_req_t *req);
+    static esp_err_t handleApiStats(httpd_req_t *req);
+    static esp_err_t handleApiLoRaWAN(httpd_req_t *req);
+    static esp_err_t handleApiProfiles(httpd_req_t *req);
     
     // Helper for authentication check
     static bool checkAuth(httpd_req_t *req);
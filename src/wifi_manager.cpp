@@ -1,5 +1,6 @@
 #include "wifi_manager.h"
 #include "config.h"
+#include "boot_timeline.h"
 
 // Global instance
 WiFiManager wifiManager;
@@ -11,7 +12,9 @@ WiFiManager wifiManager;
 WiFiManager::WiFiManager() :
     ap_active(false),
     ap_start_time(0),
-    client_connected(false) {
+    client_connected(false),
+    client_connecting(false),
+    connect_start(0) {
 
     memset(ap_password, 0, sizeof(ap_password));
     memset(client_ssid, 0, sizeof(client_ssid));
@@ -33,20 +36,38 @@ void WiFiManager::begin() {
     // Load client credentials if available
     loadClientCredentials();
 
-    // Try client mode first
+    // Try client mode first; the connection is awaited in process() so setup()
+    // can bring up Modbus, HTTPS and LoRaWAN meanwhile
     if (strlen(client_ssid) > 0) {
-        if (connectClient(client_ssid, client_password)) {
-            Serial.println(">>> WiFi client connected - AP mode disabled");
-            return;
-        } else {
-            Serial.println(">>> WiFi client connection failed - starting AP mode");
-        }
+        startClient(client_ssid, client_password);
+        client_connecting = true;
+        connect_start = millis();
+        return;
     }
 
-    // Fall back to AP mode
+    // No client configured: AP mode
     startAP();
 }
 
+void WiFiManager::process() {
+    if (!client_connecting) return;
+
+    if (WiFi.status() == WL_CONNECTED) {
+        client_connecting = false;
+        clientConnected();
+        Serial.println(">>> WiFi client connected - AP mode disabled");
+        return;
+    }
+
+    if (millis() - connect_start >= WIFI_CONNECT_TIMEOUT_MS) {
+        client_connecting = false;
+        printConnectionFailure(WiFi.status());
+        WiFi.mode(WIFI_OFF);
+        Serial.println(">>> WiFi client connection failed - starting AP mode");
+        startAP();
+    }
+}
+
 // ============================================================================
 // AP MODE
 // ============================================================================
@@ -78,6 +99,7 @@ bool WiFiManager::startAP() {
 
     ap_active = true;
     ap_start_time = millis();
+    bootTimeline.mark(BOOT_NETWORK_UP, ap_start_time);
 
     // Initialize mDNS
     startMDNS("stationsdata");
@@ -115,12 +137,7 @@ uint8_t WiFiManager::getAPClients() {
 // CLIENT MODE
 // ============================================================================
 
-bool WiFiManager::connectClient(const char* ssid, const char* password) {
-    if (strlen(ssid) == 0) {
-        Serial.println("No WiFi client credentials configured");
-        return false;
-    }
-
+void WiFiManager::startClient(const char* ssid, const char* password) {
     Serial.println("\n========================================");
     Serial.println("Attempting WiFi Client Connection");
     Serial.println("========================================");
@@ -129,6 +146,26 @@ bool WiFiManager::connectClient(const char* ssid, const char* password) {
 
     WiFi.mode(WIFI_STA);
     WiFi.begin(ssid, password);
+}
+
+void WiFiManager::clientConnected() {
+    client_connected = true;
+    bootTimeline.mark(BOOT_NETWORK_UP, millis());
+
+    // Initialize mDNS
+    startMDNS("stationsdata");
+
+    printClientInfo();
+}
+
+bool WiFiManager::connectClient(const char* ssid, const char* password) {
+    if (strlen(ssid) == 0) {
+        Serial.println("No WiFi client credentials configured");
+        return false;
+    }
+
+    // Blocking variant: waits for the result
+    startClient(ssid, password);
 
     int attempts = 0;
     while (WiFi.status() != WL_CONNECTED && attempts < 20) {  // 10 seconds timeout
@@ -139,14 +176,9 @@ bool WiFiManager::connectClient(const char* ssid, const char* password) {
     Serial.println();
 
     if (WiFi.status() == WL_CONNECTED) {
-        client_connected = true;
         strncpy(client_ssid, ssid, sizeof(client_ssid) - 1);
         strncpy(client_password, password, sizeof(client_password) - 1);
-
-        // Initialize mDNS
-        startMDNS("stationsdata");
-
-        printClientInfo();
+        clientConnected();
         return true;
     } else {
         printConnectionFailure(WiFi.status());
@@ -263,6 +295,21 @@ bool WiFiManager::isTimeoutReached() {
            (millis() - ap_start_time >= WIFI_TIMEOUT_MS);
 }
 
+void WiFiManager::stop() {
+    if (!isOn()) return;
+
+    Serial.println("WiFi off (low-power operation)");
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    ap_active = false;
+    client_connected = false;
+    client_connecting = false;
+}
+
+bool WiFiManager::isOn() const {
+    return ap_active || client_connected || client_connecting;
+}
+
 // ============================================================================
 // mDNS
 // ============================================================================
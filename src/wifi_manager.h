@@ -14,8 +14,9 @@ class WiFiManager {
 public:
     WiFiManager();
 
-    // Initialization
+    // Initialization (returns at once; a saved client connection completes in process())
     void begin();
+    void process();  // Call from loop()
 
     // WiFi AP Mode
     bool startAP();
@@ -41,6 +42,10 @@ public:
     void handleTimeout();
     bool isTimeoutReached();
 
+    // Low-power operation: AP and client off at the end of the service window
+    void stop();
+    bool isOn() const;
+
     // mDNS
     bool startMDNS(const char* hostname);
 
@@ -65,10 +70,14 @@ private:
 
     // Client Mode state
     bool client_connected;
+    bool client_connecting;       // Boot-time connection in progress
+    unsigned long connect_start;
     char client_ssid[33];      // 32 chars + null
     char client_password[64];  // 63 chars + null
 
     // Helper functions
+    void startClient(const char* ssid, const char* password);
+    void clientConnected();
     void printAPInfo();
     void printClientInfo();
     void printConnectionFailure(wl_status_t status);
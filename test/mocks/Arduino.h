@@ -0,0 +1,32 @@
+// Host stand-in for the parts of Arduino.h used by the modules built in the
+// native env (platformio.ini). Serial output goes to stdout.
+#ifndef MOCK_ARDUINO_H
+#define MOCK_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+class MockSerial {
+public:
+    bool quiet = true;   // Tests set false to see the log's messages
+
+    int printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        if (quiet) return 0;
+        va_list args;
+        va_start(args, fmt);
+        int n = vprintf(fmt, args);
+        va_end(args);
+        return n;
+    }
+    void println(const char* text) {
+        if (!quiet) puts(text);
+    }
+};
+
+inline MockSerial Serial;
+
+#endif // MOCK_ARDUINO_H
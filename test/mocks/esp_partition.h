@@ -0,0 +1,105 @@
+// Host stand-in for esp_partition.h: one partition backed by a RAM image that
+// behaves like NOR flash (writes only clear bits, erase sets them), with a
+// power cut after a given number of programmed or erased bytes.
+#ifndef MOCK_ESP_PARTITION_H
+#define MOCK_ESP_PARTITION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+typedef int esp_err_t;
+#define ESP_OK   0
+#define ESP_FAIL -1
+
+typedef enum { ESP_PARTITION_TYPE_APP = 0, ESP_PARTITION_TYPE_DATA = 1 } esp_partition_type_t;
+typedef int esp_partition_subtype_t;
+
+typedef struct {
+    esp_partition_type_t type;
+    esp_partition_subtype_t subtype;
+    uint32_t address;
+    uint32_t size;
+    char label[17];
+} esp_partition_t;
+
+namespace mock_flash {
+
+inline std::vector<uint8_t> image;
+inline esp_partition_t partition;
+inline bool present = false;
+inline long budget = -1;     // Bytes left before the power cut, -1: no cut
+inline bool powered = true;
+inline uint32_t writes = 0;
+inline uint32_t erases = 0;
+inline uint64_t bytes = 0;   // Programmed and erased so far
+
+// Blank partition of `size` bytes
+inline void install(uint32_t size) {
+    image.assign(size, 0xFF);
+    memset(&partition, 0, sizeof(partition));
+    partition.type = ESP_PARTITION_TYPE_DATA;
+    partition.size = size;
+    present = true;
+    budget = -1;
+    powered = true;
+    writes = 0;
+    erases = 0;
+    bytes = 0;
+}
+
+// Power fails after `count` more bytes are programmed or erased
+inline void cutPowerAfter(long count) {
+    budget = count;
+}
+
+// Next boot: the image stays as the cut left it
+inline void restorePower() {
+    budget = -1;
+    powered = true;
+}
+
+// Bytes of this operation that reach the flash before the cut
+inline size_t allowance(size_t len) {
+    if (!powered) return 0;
+    size_t done = len;
+    if (budget >= 0 && (long)len > budget) {
+        done = (size_t)budget;
+        powered = false;
+    }
+    if (budget >= 0) budget -= done;
+    bytes += done;
+    return done;
+}
+
+}  // namespace mock_flash
+
+inline const esp_partition_t* esp_partition_find_first(esp_partition_type_t, esp_partition_subtype_t, const char*) {
+    return mock_flash::present ? &mock_flash::partition : nullptr;
+}
+
+inline esp_err_t esp_partition_read(const esp_partition_t* part, size_t offset, void* dst, size_t len) {
+    if (offset + len > part->size) return ESP_FAIL;
+    memcpy(dst, &mock_flash::image[offset], len);
+    return ESP_OK;
+}
+
+inline esp_err_t esp_partition_write(const esp_partition_t* part, size_t offset, const void* src, size_t len) {
+    if (offset + len > part->size) return ESP_FAIL;
+    size_t done = mock_flash::allowance(len);
+    const uint8_t* data = (const uint8_t*)src;
+    for (size_t i = 0; i < done; i++) mock_flash::image[offset + i] &= data[i];
+    mock_flash::writes++;
+    return done == len ? ESP_OK : ESP_FAIL;
+}
+
+inline esp_err_t esp_partition_erase_range(const esp_partition_t* part, size_t offset, size_t len) {
+    if (offset + len > part->size || offset % 4096 || len % 4096) return ESP_FAIL;
+    size_t done = mock_flash::allowance(len);
+    memset(&mock_flash::image[offset], 0xFF, done);
+    mock_flash::erases++;
+    return done == len ? ESP_OK : ESP_FAIL;
+}
+
+#endif // MOCK_ESP_PARTITION_H
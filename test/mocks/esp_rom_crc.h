@@ -0,0 +1,16 @@
+// Host stand-in for the ESP32 ROM CRC32 (little-endian, chainable)
+#ifndef MOCK_ESP_ROM_CRC_H
+#define MOCK_ESP_ROM_CRC_H
+
+#include <stdint.h>
+
+inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int i = 0; i < 8; i++) crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+#endif // MOCK_ESP_ROM_CRC_H
@@ -0,0 +1,206 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "api_json.h"
+
+// ============================================================================
+// JSON API SERIALIZERS AND THE ARENA OUTPUT
+// ============================================================================
+// The serializers and ApiJsonOutput as the /api/v1 handlers use them, with
+// the response collected in a string instead of the HTTP chunk stream.
+
+class StringWriter : public ApiWriter {
+public:
+    char text[65536];
+    size_t len = 0;
+
+    size_t write(uint8_t c) override {
+        return write(&c, 1);
+    }
+
+    size_t write(const uint8_t* data, size_t n) override {
+        if (n > sizeof(text) - 1 - len) n = sizeof(text) - 1 - len;
+        memcpy(text + len, data, n);
+        len += n;
+        text[len] = '\0';
+        return n;
+    }
+};
+
+static size_t countOf(const char* text, const char* needle) {
+    size_t count = 0;
+    for (const char* p = strstr(text, needle); p; p = strstr(p + 1, needle)) count++;
+    return count;
+}
+
+static bool endsWith(const char* text, const char* tail) {
+    size_t n = strlen(text), m = strlen(tail);
+    return n >= m && strcmp(text + n - m, tail) == 0;
+}
+
+static void makeProfile(LoRaProfile& profile, uint8_t index) {
+    memset(&profile, 0, sizeof(profile));
+    snprintf(profile.name, sizeof(profile.name), "Device %u", index);
+    profile.devEUI = 0x70B3D57ED0000000ULL | index;
+    profile.enabled = true;
+    profile.abp = true;
+    profile.region = REGION_EU868;
+    profile.confirm = CONFIRM_NONE;
+    profile.devAddr = 0x26011000UL | index;
+}
+
+alignas(8) static uint8_t arena_buffer[API_ARENA_SIZE];
+static StringWriter writer;
+
+void setUp(void) {
+    writer.len = 0;
+    writer.text[0] = '\0';
+}
+
+void tearDown(void) {
+}
+
+static void test_arena_reset_refused_while_block_live() {
+    ApiArena arena(arena_buffer, sizeof(arena_buffer));
+    void* block = arena.allocate(100);
+    TEST_ASSERT_NOT_NULL(block);
+    TEST_ASSERT_TRUE(arena.getUsed() >= 100);
+    TEST_ASSERT_FALSE(arena.reset());
+
+    arena.deallocate(block);
+    TEST_ASSERT_TRUE(arena.reset());
+    TEST_ASSERT_EQUAL(0, arena.getUsed());
+    TEST_ASSERT_TRUE(arena.getPeak() >= 100);
+
+    // Bigger than the buffer: refused and counted
+    TEST_ASSERT_NULL(arena.allocate(sizeof(arena_buffer)));
+    TEST_ASSERT_EQUAL_UINT32(1, arena.getFailures());
+}
+
+static void test_head_and_items_stream_one_object() {
+    ApiArena arena(arena_buffer, sizeof(arena_buffer));
+    ApiJsonOutput json(writer, arena);
+
+    JsonObject head = json.head();
+    head["active_profile"] = 3;
+    head["max_profiles"] = MAX_LORA_PROFILES;
+    json.openArray("profiles");
+
+    LoRaProfile profile;
+    makeProfile(profile, 3);
+    apiProfile(json.item(), 3, profile, false);
+    profile.abp = false;
+    apiProfile(json.item(), 4, profile, true);
+
+    TEST_ASSERT_TRUE(json.end());
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"active_profile\":3,\"max_profiles\":64,\"profiles\":["
+        "{\"index\":3,\"name\":\"Device 3\",\"enabled\":true,\"active\":false,\"activation\":\"ABP\","
+        "\"dev_eui\":\"70B3D57ED0000003\",\"join_eui\":\"0000000000000000\",\"dev_addr\":\"26011003\","
+        "\"region\":\"EU868\",\"payload_type\":0,\"payload_format\":\"Adeunis Modbus SF6\",\"confirm\":\"Unconfirmed\"},"
+        "{\"index\":4,\"name\":\"Device 3\",\"enabled\":true,\"active\":true,\"activation\":\"OTAA\","
+        "\"dev_eui\":\"70B3D57ED0000003\",\"join_eui\":\"0000000000000000\","
+        "\"region\":\"EU868\",\"payload_type\":0,\"payload_format\":\"Adeunis Modbus SF6\",\"confirm\":\"Unconfirmed\"}]}",
+        writer.text);
+    TEST_ASSERT_EQUAL(writer.len, json.getBytes());
+
+    // Every part was released, nothing is left in the arena
+    TEST_ASSERT_EQUAL(0, arena.getUsed());
+    TEST_ASSERT_TRUE(arena.reset());
+    TEST_ASSERT_EQUAL_UINT32(0, arena.getFailures());
+}
+
+static void test_registers_decoded_and_raw() {
+    HoldingRegisters holding = { 1, 2, (4UL << 16) | 3, 5, 6, 7, 8, 9, 455, 11, 12, 13 };
+    InputRegisters input = { 2550, 1005, 2931, 5, 1, 1, 2, 202, 3276 };
+
+    ApiArena arena(arena_buffer, sizeof(arena_buffer));
+    ApiJsonOutput json(writer, arena);
+    apiRegisters(json.head(), holding, input);
+    TEST_ASSERT_TRUE(json.end());
+
+    const char* text = writer.text;
+    TEST_ASSERT_EQUAL('{', text[0]);
+    TEST_ASSERT_NOT_NULL(strstr(text, "\"uptime_s\":262147,"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "\"free_heap_kb\":393221,"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "\"temperature_c\":45.5,"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "\"wifi_enabled\":true,"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "\"sf6_density_kg_m3\":25.5,"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "\"sf6_pressure_20c_kpa\":100.5,"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "\"serial\":65538,"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "\"sw_release\":\"2.02\","));
+
+    // Register words in address order, 32-bit values low word first
+    TEST_ASSERT_NOT_NULL(strstr(text, "\"holding_raw\":[1,2,3,4,5,6,7,8,9,455,11,12,13]"));
+    TEST_ASSERT_TRUE(endsWith(text, "\"input_raw\":[2550,1005,2931,5,1,1,2,202,3276]}"));
+    TEST_ASSERT_EQUAL(0, arena.getUsed());
+}
+
+static void test_small_arena_truncates_and_closes_object() {
+    HoldingRegisters holding;
+    InputRegisters input;
+    memset(&holding, 0, sizeof(holding));
+    memset(&input, 0, sizeof(input));
+
+    static uint8_t small[128];
+    ApiArena arena(small, sizeof(small));
+    ApiJsonOutput json(writer, arena);
+    apiRegisters(json.head(), holding, input);
+
+    TEST_ASSERT_FALSE(json.end());
+    TEST_ASSERT_EQUAL('{', writer.text[0]);
+    TEST_ASSERT_TRUE(endsWith(writer.text, "\"truncated\":true}"));
+    TEST_ASSERT_TRUE(arena.getFailures() > 0);
+    TEST_ASSERT_EQUAL(0, arena.getUsed());
+}
+
+static void test_all_profiles_fit_one_arena() {
+    static AirtimeLedger airtime;
+    static UplinkScheduler scheduler;
+    static LinkQualityHistory links;
+    static JoinBackoff joins;
+    static DeliveryTracker delivery;
+    static LoRaProfile profiles[MAX_LORA_PROFILES];
+    const unsigned long now = 3600000UL;
+
+    for (uint8_t i = 0; i < MAX_LORA_PROFILES; i++) {
+        makeProfile(profiles[i], i);
+        airtime.record(now - 1000, i, REGION_EU868, 868100, 62);
+        scheduler.setPeriod(i, 300000UL);
+        scheduler.setScheduled(i, true, now);
+    }
+    ApiLoRaWANSources sources = { airtime, scheduler, links, joins, delivery };
+
+    ApiArena arena(arena_buffer, sizeof(arena_buffer));
+    ApiJsonOutput json(writer, arena);
+    ApiLoRaWANStatus status;
+    memset(&status, 0, sizeof(status));
+    status.enabled_profiles = MAX_LORA_PROFILES;
+    apiLoRaWANStatus(json.head(), status, airtime, now);
+    TEST_ASSERT_TRUE(arena.getUsed() > 0);
+
+    json.openArray("profiles");
+    TEST_ASSERT_EQUAL(0, arena.getUsed());
+    for (uint8_t i = 0; i < MAX_LORA_PROFILES; i++) {
+        ApiProfileRuntime runtime = { &profiles[i], 5, 300, 62, false };
+        apiLoRaWANProfile(json.item(), i, runtime, sources, now);
+    }
+
+    TEST_ASSERT_TRUE(json.end());
+    TEST_ASSERT_EQUAL_UINT32(0, arena.getFailures());
+    TEST_ASSERT_EQUAL(0, arena.getUsed());
+    TEST_ASSERT_EQUAL(MAX_LORA_PROFILES, countOf(writer.text, "{\"index\":"));
+    TEST_ASSERT_NOT_NULL(strstr(writer.text, "\"airtime\":[{\"band\":"));
+    TEST_ASSERT_TRUE(endsWith(writer.text, "}]}"));
+    TEST_ASSERT_EQUAL(writer.len, json.getBytes());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_arena_reset_refused_while_block_live);
+    RUN_TEST(test_head_and_items_stream_one_object);
+    RUN_TEST(test_registers_decoded_and_raw);
+    RUN_TEST(test_small_arena_truncates_and_closes_object);
+    RUN_TEST(test_all_profiles_fit_one_arena);
+    return UNITY_END();
+}
@@ -0,0 +1,322 @@
+#include <unity.h>
+#include <esp_partition.h>
+#include "nonce_log.h"
+
+// ============================================================================
+// NONCE LOG COMPACTION AND POWER LOSS ON A SIMULATED PARTITION
+// ============================================================================
+// The log runs on a RAM image that behaves like NOR flash (test/mocks). A
+// "reboot" is a new NonceLog on the same image; a power cut stops all flash
+// programming and erasing after a given number of bytes, in the middle of
+// whatever operation is running.
+
+static const uint32_t PARTITION_SIZE = 0x20000;   // partitions.csv: 128 KB
+static const uint16_t NONCES_LEN = 20;
+static const uint16_t SESSION_LEN = 440;
+static const int KEYS = MAX_LORA_PROFILES * NONCE_LOG_TYPE_COUNT;
+
+static uint32_t rng_state;
+
+static uint32_t rnd() {
+    rng_state = rng_state * 1103515245UL + 12345UL;
+    return rng_state >> 8;
+}
+
+static uint16_t lengthOf(int type) {
+    return type == NONCE_LOG_NONCES ? NONCES_LEN : SESSION_LEN;
+}
+
+// Payload of one version of a profile's record
+static void fill(uint8_t* buf, int profile, int type, uint32_t version) {
+    uint32_t x = (profile * 31 + type) * 2654435761UL + version * 40503UL + 1;
+    for (uint16_t i = 0; i < lengthOf(type); i++) {
+        x = x * 1664525UL + 1013904223UL;
+        buf[i] = x >> 24;
+    }
+}
+
+// Version of every record the log must return; 0 = none
+struct Model {
+    uint32_t version[MAX_LORA_PROFILES][NONCE_LOG_TYPE_COUNT];
+};
+
+static bool write(NonceLog& log, int profile, int type, uint32_t version) {
+    uint8_t buf[NONCE_LOG_MAX_PAYLOAD];
+    fill(buf, profile, type, version);
+    return log.write(profile, (NonceLogRecordType)type, buf, lengthOf(type));
+}
+
+static bool holds(const NonceLog& log, int profile, int type, uint32_t version) {
+    uint8_t expected[NONCE_LOG_MAX_PAYLOAD];
+    uint8_t actual[NONCE_LOG_MAX_PAYLOAD];
+    if (version == 0) return !log.has(profile, (NonceLogRecordType)type);
+    fill(expected, profile, type, version);
+    return log.read(profile, (NonceLogRecordType)type, actual, lengthOf(type)) &&
+           memcmp(expected, actual, lengthOf(type)) == 0;
+}
+
+static int countMismatches(const NonceLog& log, const Model& model) {
+    int wrong = 0;
+    for (int p = 0; p < MAX_LORA_PROFILES; p++) {
+        for (int t = 0; t < NONCE_LOG_TYPE_COUNT; t++) {
+            if (!holds(log, p, t, model.version[p][t])) wrong++;
+        }
+    }
+    return wrong;
+}
+
+// Every profile joined once, then uplinks: sessions of a few busy profiles
+// change all the time while the rest stay put and move forward whole sectors
+// at a time during compaction
+static void fillAll(NonceLog& log, Model& model) {
+    for (int p = 0; p < MAX_LORA_PROFILES; p++) {
+        for (int t = 0; t < NONCE_LOG_TYPE_COUNT; t++) {
+            model.version[p][t] = 1;
+            TEST_ASSERT_TRUE(write(log, p, t, 1));
+        }
+    }
+}
+
+static void pickKey(int& profile, int& type) {
+    uint32_t r = rnd();
+    profile = (r % 4 == 0) ? (int)(rnd() % MAX_LORA_PROFILES) : (int)(rnd() % 8);
+    type = (rnd() % 16 == 0) ? NONCE_LOG_NONCES : NONCE_LOG_SESSION;
+}
+
+void setUp(void) {
+    rng_state = 1;
+    mock_flash::install(PARTITION_SIZE);
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+static void test_partition_below_minimum_is_not_used() {
+    TEST_ASSERT_LESS_OR_EQUAL(PARTITION_SIZE / NONCE_LOG_SECTOR_SIZE, NONCE_LOG_MIN_SECTORS);
+
+    mock_flash::install((NONCE_LOG_MIN_SECTORS - 1) * NONCE_LOG_SECTOR_SIZE);
+    NonceLog small;
+    TEST_ASSERT_FALSE(small.begin());
+    TEST_ASSERT_FALSE(small.isActive());
+
+    mock_flash::install(NONCE_LOG_MIN_SECTORS * NONCE_LOG_SECTOR_SIZE);
+    NonceLog enough;
+    TEST_ASSERT_TRUE(enough.begin());
+}
+
+static void test_compaction_keeps_every_record() {
+    static NonceLog log;
+    static Model model;
+    memset(&model, 0, sizeof(model));
+    log = NonceLog();
+    TEST_ASSERT_TRUE(log.begin());
+    fillAll(log, model);
+
+    for (int n = 0; n < 5000; n++) {
+        int profile, type;
+        pickKey(profile, type);
+        model.version[profile][type]++;
+        TEST_ASSERT_TRUE(write(log, profile, type, model.version[profile][type]));
+    }
+    TEST_ASSERT_GREATER_THAN(20, log.getCompactionCount());
+    TEST_ASSERT_EQUAL(0, countMismatches(log, model));
+
+    static NonceLog rebooted;
+    rebooted = NonceLog();
+    TEST_ASSERT_TRUE(rebooted.begin());
+    TEST_ASSERT_EQUAL(0, countMismatches(rebooted, model));
+}
+
+static void test_smallest_partition_keeps_every_record() {
+    mock_flash::install(NONCE_LOG_MIN_SECTORS * NONCE_LOG_SECTOR_SIZE);
+    static NonceLog log;
+    static Model model;
+    memset(&model, 0, sizeof(model));
+    log = NonceLog();
+    TEST_ASSERT_TRUE(log.begin());
+    fillAll(log, model);
+
+    // Session buffers at the maximum size: the sizing bound is tight here
+    for (int n = 0; n < 3000; n++) {
+        int profile = rnd() % MAX_LORA_PROFILES;
+        int type = rnd() % NONCE_LOG_TYPE_COUNT;
+        model.version[profile][type]++;
+        TEST_ASSERT_TRUE(write(log, profile, type, model.version[profile][type]));
+    }
+    TEST_ASSERT_EQUAL(0, countMismatches(log, model));
+
+    static NonceLog rebooted;
+    rebooted = NonceLog();
+    TEST_ASSERT_TRUE(rebooted.begin());
+    TEST_ASSERT_EQUAL(0, countMismatches(rebooted, model));
+}
+
+static void test_removed_record_stays_removed() {
+    static NonceLog log;
+    static Model model;
+    memset(&model, 0, sizeof(model));
+    log = NonceLog();
+    TEST_ASSERT_TRUE(log.begin());
+    fillAll(log, model);
+
+    // The deletion is the newest record of its key: it moves with compaction
+    log.remove(40, NONCE_LOG_SESSION);
+    model.version[40][NONCE_LOG_SESSION] = 0;
+    for (int n = 0; n < 3000; n++) {
+        int profile, type;
+        pickKey(profile, type);
+        if (profile == 40) continue;
+        model.version[profile][type]++;
+        TEST_ASSERT_TRUE(write(log, profile, type, model.version[profile][type]));
+    }
+    TEST_ASSERT_GREATER_THAN(20, log.getCompactionCount());
+    TEST_ASSERT_FALSE(log.has(40, NONCE_LOG_SESSION));
+
+    static NonceLog rebooted;
+    rebooted = NonceLog();
+    TEST_ASSERT_TRUE(rebooted.begin());
+    TEST_ASSERT_FALSE(rebooted.has(40, NONCE_LOG_SESSION));
+    TEST_ASSERT_EQUAL(0, countMismatches(rebooted, model));
+}
+
+static void test_power_cut_keeps_last_written_records() {
+    static NonceLog log;
+    static NonceLog rebooted;
+    static Model model;
+
+    int cuts_in_compaction = 0;
+    for (int trial = 0; trial < 100; trial++) {
+        mock_flash::install(PARTITION_SIZE);
+        memset(&model, 0, sizeof(model));
+        log = NonceLog();
+        TEST_ASSERT_TRUE(log.begin());
+        fillAll(log, model);
+
+        // Cut anywhere in the next ~3000 writes, compaction included
+        mock_flash::cutPowerAfter(rnd() % 1500000);
+        int cut_profile = -1;
+        int cut_type = 0;
+        for (int n = 0; n < 3000 && mock_flash::powered; n++) {
+            int profile, type;
+            pickKey(profile, type);
+            uint64_t start = mock_flash::bytes;
+            bool ok = write(log, profile, type, model.version[profile][type] + 1);
+            if (!mock_flash::powered) {
+                // The record being written may or may not have made it
+                cut_profile = profile;
+                cut_type = type;
+                if (mock_flash::bytes - start > NONCE_LOG_MAX_RECORD) cuts_in_compaction++;
+                break;
+            }
+            TEST_ASSERT_TRUE(ok);
+            model.version[profile][type]++;
+        }
+
+        mock_flash::restorePower();
+        rebooted = NonceLog();
+        TEST_ASSERT_TRUE(rebooted.begin());
+        if (cut_profile >= 0 && holds(rebooted, cut_profile, cut_type, model.version[cut_profile][cut_type] + 1)) {
+            model.version[cut_profile][cut_type]++;
+        }
+        char message[64];
+        snprintf(message, sizeof(message), "trial %d", trial);
+        TEST_ASSERT_EQUAL_MESSAGE(0, countMismatches(rebooted, model), message);
+
+        // The log keeps working after the reboot
+        for (int n = 0; n < 1000; n++) {
+            int profile, type;
+            pickKey(profile, type);
+            model.version[profile][type]++;
+            TEST_ASSERT_TRUE_MESSAGE(write(rebooted, profile, type, model.version[profile][type]), message);
+        }
+        TEST_ASSERT_EQUAL_MESSAGE(0, countMismatches(rebooted, model), message);
+    }
+    TEST_ASSERT_GREATER_THAN(0, cuts_in_compaction);
+}
+
+// Sessions of the busy profiles only: the other profiles' records from
+// fillAll() stay live and their sectors move forward whole
+static void pickBusyKey(int& profile, int& type) {
+    profile = rnd() % 8;
+    type = NONCE_LOG_SESSION;
+}
+
+// Same workload from a blank partition, up to `appends` writes after fillAll()
+static void replay(NonceLog& log, Model& model, int appends) {
+    mock_flash::install(PARTITION_SIZE);
+    rng_state = 7;
+    memset(&model, 0, sizeof(model));
+    log = NonceLog();
+    TEST_ASSERT_TRUE(log.begin());
+    fillAll(log, model);
+    for (int n = 0; n < appends; n++) {
+        int profile, type;
+        pickBusyKey(profile, type);
+        model.version[profile][type]++;
+        TEST_ASSERT_TRUE(write(log, profile, type, model.version[profile][type]));
+    }
+}
+
+// Cut at every point of an append whose compaction moves a sector full of
+// live records: the new write sector fills up with them, the record does not
+// fit and the next sector is compacted in the same append
+static void test_power_cut_at_every_point_of_a_compaction() {
+    static NonceLog log;
+    static NonceLog rebooted;
+    static Model model;
+
+    // Find such an append and how many bytes it programs and erases
+    replay(log, model, 0);
+    int appends = 0;
+    int profile = 0, type = 0;
+    uint64_t span = 0;
+    for (; appends < 5000; appends++) {
+        pickBusyKey(profile, type);
+        uint64_t start = mock_flash::bytes;
+        model.version[profile][type]++;
+        TEST_ASSERT_TRUE(write(log, profile, type, model.version[profile][type]));
+        span = mock_flash::bytes - start;
+        if (span > 2 * NONCE_LOG_SECTOR_SIZE) break;
+    }
+    TEST_ASSERT_GREATER_THAN(2 * NONCE_LOG_SECTOR_SIZE, span);
+
+    for (uint64_t cut = 0; cut < span; cut += 127) {
+        replay(log, model, appends);
+        int p, t;
+        pickBusyKey(p, t);
+        TEST_ASSERT_TRUE(p == profile && t == type);
+
+        mock_flash::cutPowerAfter((long)cut);
+        write(log, profile, type, model.version[profile][type] + 1);
+        TEST_ASSERT_FALSE(mock_flash::powered);
+
+        mock_flash::restorePower();
+        rebooted = NonceLog();
+        TEST_ASSERT_TRUE(rebooted.begin());
+        if (holds(rebooted, profile, type, model.version[profile][type] + 1)) {
+            model.version[profile][type]++;
+        }
+        char message[64];
+        snprintf(message, sizeof(message), "cut %lu bytes into the compaction", (unsigned long)cut);
+        TEST_ASSERT_EQUAL_MESSAGE(0, countMismatches(rebooted, model), message);
+
+        model.version[profile][type]++;
+        TEST_ASSERT_TRUE_MESSAGE(write(rebooted, profile, type, model.version[profile][type]), message);
+        TEST_ASSERT_TRUE_MESSAGE(holds(rebooted, profile, type, model.version[profile][type]), message);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_partition_below_minimum_is_not_used);
+    RUN_TEST(test_compaction_keeps_every_record);
+    RUN_TEST(test_smallest_partition_keeps_every_record);
+    RUN_TEST(test_removed_record_stays_removed);
+    RUN_TEST(test_power_cut_keeps_last_written_records);
+    RUN_TEST(test_power_cut_at_every_point_of_a_compaction);
+    return UNITY_END();
+}
@@ -0,0 +1,154 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "payload_codec.h"
+#include "payload_golden.h"
+#include "payload_map.h"
+#include "modbus_registers.h"
+#include "sample_batch.h"
+
+// ============================================================================
+// PAYLOAD ENCODERS AGAINST THE GOLDEN VECTORS
+// ============================================================================
+// The frames come from test/golden_vectors.json through payload_golden.h, the
+// same vectors lorawan_decoder.py --self-test and lorawan_decoder.js decode,
+// so encoder and decoders are checked against one set of bytes.
+
+static void toHex(const uint8_t* frame, size_t len, char* out) {
+    for (size_t i = 0; i < len; i++) sprintf(out + 2 * i, "%02X", frame[i]);
+    out[2 * len] = '\0';
+}
+
+static void loadRegisters(const GoldenVector& g, InputRegisters& input) {
+    memset(&input, 0, sizeof(input));
+    input.sf6_density = g.density;
+    input.sf6_pressure_20c = g.pressure_20c;
+    input.sf6_temperature = g.temperature;
+    input.sf6_pressure_var = g.pressure_var;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static void test_fixed_formats_match_golden_frames() {
+    uint8_t frame[64];
+    char hex[2 * sizeof(frame) + 1];
+    char message[64];
+
+    for (size_t v = 0; v < GOLDEN_VECTOR_COUNT; v++) {
+        const GoldenVector& g = GOLDEN_VECTORS[v];
+        InputRegisters input;
+        loadRegisters(g, input);
+
+        PayloadContext ctx;
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.input = &input;
+        ctx.uplink_count = g.uplink_count;
+
+        for (int type = 0; type < PAYLOAD_BATCHED_DELTA; type++) {
+            const PayloadCodec& codec = PayloadCodecs::get((PayloadType)type);
+            size_t len = codec.encode(frame, sizeof(frame), ctx);
+            toHex(frame, len, hex);
+            snprintf(message, sizeof(message), "vector %u, %s", (unsigned)v, PAYLOAD_TYPE_NAMES[type]);
+            TEST_ASSERT_EQUAL_STRING_MESSAGE(g.frames[type], hex, message);
+
+            // Size-only call and a frame one byte short
+            TEST_ASSERT_EQUAL_MESSAGE(len, codec.encode(nullptr, sizeof(frame), ctx), message);
+            TEST_ASSERT_EQUAL_MESSAGE(0, codec.encode(frame, len - 1, ctx), message);
+        }
+    }
+}
+
+static void test_default_user_map_matches_raw_modbus() {
+    static PayloadMap map;
+    char error[80] = "";
+    TEST_ASSERT_TRUE_MESSAGE(map.compile(PAYLOAD_MAP_DEFAULT_SPEC, error, sizeof(error)), error);
+
+    uint8_t frame[64];
+    char hex[2 * sizeof(frame) + 1];
+    for (size_t v = 0; v < GOLDEN_VECTOR_COUNT; v++) {
+        const GoldenVector& g = GOLDEN_VECTORS[v];
+        InputRegisters input;
+        loadRegisters(g, input);
+
+        PayloadContext ctx;
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.input = &input;
+        ctx.map = &map;
+        ctx.uplink_count = g.uplink_count;
+
+        size_t len = PayloadCodecs::get(PAYLOAD_USER_MAP).encode(frame, sizeof(frame), ctx);
+        toHex(frame, len, hex);
+        TEST_ASSERT_EQUAL_STRING(g.frames[PAYLOAD_RAW_MODBUS], hex);
+    }
+}
+
+static void test_batched_frame_matches_golden_frame() {
+    static SampleBatcher batcher;
+    for (size_t i = 0; i < GOLDEN_BATCH_SAMPLE_COUNT; i++) {
+        batcher.addSample(i * GOLDEN_BATCH_INTERVAL_MS, GOLDEN_BATCH_SAMPLES[i]);
+    }
+
+    PayloadContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.batcher = &batcher;
+    ctx.now = (GOLDEN_BATCH_SAMPLE_COUNT - 1) * GOLDEN_BATCH_INTERVAL_MS + GOLDEN_BATCH_AGE_MS;
+
+    uint8_t frame[64];
+    char hex[2 * sizeof(frame) + 1];
+    size_t len = PayloadCodecs::get(PAYLOAD_BATCHED_DELTA).encode(frame, sizeof(frame), ctx);
+    toHex(frame, len, hex);
+    TEST_ASSERT_EQUAL_STRING(GOLDEN_BATCH_FRAME, hex);
+    TEST_ASSERT_TRUE(ctx.batch_used);
+    TEST_ASSERT_EQUAL_UINT32(0, ctx.batch_first);
+    TEST_ASSERT_EQUAL_UINT32(GOLDEN_BATCH_SAMPLE_COUNT - 1, ctx.batch_seq);
+}
+
+static void test_golden_frames_decode_to_registers() {
+    uint8_t frame[64];
+    double values[16];
+    for (size_t v = 0; v < GOLDEN_VECTOR_COUNT; v++) {
+        const GoldenVector& g = GOLDEN_VECTORS[v];
+        InputRegisters input;
+        loadRegisters(g, input);
+        PayloadContext ctx;
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.input = &input;
+        ctx.uplink_count = g.uplink_count;
+
+        for (int type = 0; type < PAYLOAD_BATCHED_DELTA; type++) {
+            const PayloadCodec& codec = PayloadCodecs::get((PayloadType)type);
+            const char* hex = g.frames[type];
+            size_t len = strlen(hex) / 2;
+            for (size_t i = 0; i < len; i++) {
+                unsigned byte;
+                sscanf(hex + 2 * i, "%2X", &byte);
+                frame[i] = (uint8_t)byte;
+            }
+
+            // Every integer field reads back as its source value (counter modulo its width)
+            TEST_ASSERT_EQUAL(codec.field_count, PayloadCodecs::decode((PayloadType)type, frame, len, values, 16));
+            for (uint8_t f = 0; f < codec.field_count; f++) {
+                const PayloadField& field = codec.fields[f];
+                if (field.source == SRC_CONSTANT || field.kind == FIELD_FLOAT) continue;
+                uint32_t mask = (field.width == 4) ? 0xFFFFFFFFUL : ((1UL << (8 * field.width)) - 1);
+                TEST_ASSERT_EQUAL_UINT32((uint32_t)PayloadCodecs::sourceValue(field.source, ctx) & mask,
+                                         PayloadCodecs::readRaw(field, frame));
+            }
+
+            TEST_ASSERT_EQUAL(0, PayloadCodecs::decode((PayloadType)type, frame, len - 1, values, 16));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed_formats_match_golden_frames);
+    RUN_TEST(test_default_user_map_matches_raw_modbus);
+    RUN_TEST(test_batched_frame_matches_golden_frame);
+    RUN_TEST(test_golden_frames_decode_to_registers);
+    return UNITY_END();
+}
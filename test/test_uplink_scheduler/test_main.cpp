@@ -0,0 +1,279 @@
+#include <unity.h>
+#include "uplink_scheduler.h"
+
+// ============================================================================
+// VIRTUAL-CLOCK SIMULATION OF THE EDF UPLINK SCHEDULER
+// ============================================================================
+// Runs the scheduler the way LoRaWANHandler::process() does - poll, send the
+// due profile, complete() - on a simulated millis() for days at a time.
+// The clock starts one hour before millis() wraps, so every run crosses it.
+
+static const unsigned long PERIOD = 300000UL;    // 5 minutes
+static const unsigned long GAP = 60000UL;        // 1-minute stagger
+static const unsigned long POLL_MAX = 1250;      // loop() iteration, jittered
+static const unsigned long TOA = 1500;           // Transmission keeps the loop busy
+static const unsigned long DAY = 86400000UL;
+static const unsigned long START = (unsigned long)-1 - 3600000UL;
+
+// Longest an eligible uplink waits for the loop: one poll plus one transmission
+static const unsigned long LATE_BOUND = POLL_MAX + TOA;
+
+// With profiles staggered exactly one gap apart, a late uplink pushes the
+// next profile's slot back as well, so poll latency adds up along the queue
+// (the spare time in the period absorbs it before the next round)
+static unsigned long chainBound(int profiles) {
+    return profiles * POLL_MAX + TOA;
+}
+
+struct SimLog {
+    unsigned long last_any;
+    bool has_any;
+    unsigned long min_spacing;   // Between any two uplinks
+    uint32_t total;
+};
+
+static uint32_t rng_state;
+
+static unsigned long jitter(unsigned long max) {
+    rng_state = rng_state * 1103515245UL + 12345UL;
+    return (rng_state >> 16) % (max + 1);
+}
+
+// Advance the clock by `duration`, sending whatever is due
+static void run(UplinkScheduler& sched, unsigned long& now, unsigned long duration, SimLog& log) {
+    unsigned long end = now + duration;
+    while ((long)(now - end) < 0) {
+        int p = sched.nextDue(now);
+        if (p >= 0) {
+            if (log.has_any) {
+                unsigned long spacing = now - log.last_any;
+                if (spacing < log.min_spacing) log.min_spacing = spacing;
+            }
+            log.last_any = now;
+            log.has_any = true;
+            log.total++;
+            sched.complete(p, now);
+            now += TOA;
+        }
+        now += 1 + jitter(POLL_MAX - 1);
+    }
+}
+
+static void startLog(SimLog& log) {
+    log.has_any = false;
+    log.last_any = 0;
+    log.min_spacing = (unsigned long)-1;
+    log.total = 0;
+}
+
+void setUp(void) {
+    rng_state = 1;
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+void test_periods_hold_over_three_days(void) {
+    UplinkScheduler sched;
+    sched.setMinGap(GAP);
+    unsigned long now = START;
+    const int profiles = 4;   // 4 x 1 min stagger within a 5 min period
+
+    unsigned long first_deadline[profiles];
+    for (int p = 0; p < profiles; p++) {
+        sched.setPeriod(p, PERIOD);
+        sched.setScheduled(p, true, now);
+        first_deadline[p] = sched.getDeadline(p);
+    }
+    TEST_ASSERT_EQUAL_UINT32(GAP, first_deadline[1] - first_deadline[0]);
+
+    SimLog log;
+    startLog(log);
+    run(sched, now, 3 * DAY, log);
+
+    for (int p = 0; p < profiles; p++) {
+        const ScheduleStats& s = sched.getStats(p);
+        TEST_ASSERT_EQUAL_UINT32(0, s.missed);
+        TEST_ASSERT_UINT32_WITHIN(1, 3 * DAY / PERIOD, s.sent);
+        TEST_ASSERT_LESS_OR_EQUAL(chainBound(profiles), s.max_lateness);
+        TEST_ASSERT_GREATER_OR_EQUAL(PERIOD - chainBound(profiles), s.min_interval);
+        TEST_ASSERT_LESS_OR_EQUAL(PERIOD + chainBound(profiles), s.max_interval);
+        // No drift: the deadline is still on the grid of the first one
+        TEST_ASSERT_EQUAL_UINT32(first_deadline[p] + s.sent * PERIOD, sched.getDeadline(p));
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(GAP, log.min_spacing);
+}
+
+void test_disabled_profile_leaves_others_on_period(void) {
+    UplinkScheduler sched;
+    sched.setMinGap(GAP);
+    unsigned long now = START;
+    for (int p = 0; p < 4; p++) {
+        sched.setScheduled(p, true, now);
+    }
+
+    SimLog log;
+    startLog(log);
+    run(sched, now, DAY, log);
+    sched.setScheduled(1, false, now);
+    TEST_ASSERT_FALSE(sched.isScheduled(1));
+    run(sched, now, DAY, log);
+    sched.setScheduled(1, true, now);
+    run(sched, now, DAY, log);
+
+    for (int p = 0; p < 4; p++) {
+        const ScheduleStats& s = sched.getStats(p);
+        TEST_ASSERT_EQUAL_UINT32(0, s.missed);
+        TEST_ASSERT_LESS_OR_EQUAL(chainBound(4), s.max_lateness);
+        if (p != 1) {
+            TEST_ASSERT_LESS_OR_EQUAL(PERIOD + chainBound(4), s.max_interval);
+        }
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(GAP, log.min_spacing);
+}
+
+void test_hold_counts_as_lateness_and_keeps_phase(void) {
+    UplinkScheduler sched;
+    sched.setMinGap(GAP);
+    unsigned long now = START;
+    sched.setScheduled(0, true, now);
+    unsigned long d0 = sched.getDeadline(0);
+
+    TEST_ASSERT_EQUAL_INT(0, sched.nextDue(now));
+    sched.complete(0, now);
+    TEST_ASSERT_EQUAL_UINT32(d0 + PERIOD, sched.getDeadline(0));
+
+    // Failed join: held 90 s past the deadline
+    sched.hold(0, d0 + PERIOD + 90000);
+    now = d0 + PERIOD + 89999;
+    TEST_ASSERT_EQUAL_INT(-1, sched.nextDue(now));
+    now++;
+    TEST_ASSERT_EQUAL_INT(0, sched.nextDue(now));
+    sched.complete(0, now);
+
+    const ScheduleStats& s = sched.getStats(0);
+    TEST_ASSERT_EQUAL_UINT32(90000, s.last_lateness);
+    TEST_ASSERT_EQUAL_UINT32(0, s.missed);
+    TEST_ASSERT_EQUAL_UINT32(d0 + 2 * PERIOD, sched.getDeadline(0));
+}
+
+void test_long_hold_skips_periods_without_burst(void) {
+    UplinkScheduler sched;
+    sched.setMinGap(GAP);
+    unsigned long now = START;
+    sched.setScheduled(0, true, now);
+    unsigned long d0 = sched.getDeadline(0);
+
+    sched.hold(0, d0 + 2 * PERIOD + PERIOD / 2);
+    SimLog log;
+    startLog(log);
+    run(sched, now, 4 * PERIOD, log);
+
+    const ScheduleStats& s = sched.getStats(0);
+    TEST_ASSERT_EQUAL_UINT32(2, s.missed);
+    TEST_ASSERT_EQUAL_UINT32(2, s.sent);   // After the hold, then on the grid at d0 + 3 periods
+    TEST_ASSERT_GREATER_OR_EQUAL(PERIOD / 2 - LATE_BOUND, s.min_interval);
+    TEST_ASSERT_EQUAL_UINT32(d0 + 4 * PERIOD, sched.getDeadline(0));
+}
+
+void test_gap_shrinks_to_fit_all_profiles(void) {
+    UplinkScheduler sched;
+    sched.setMinGap(GAP);
+    unsigned long now = START;
+    const int profiles = MAX_LORA_PROFILES;   // 64 x 1 min would need 64 minutes per 5-minute period
+    for (int p = 0; p < profiles; p++) {
+        sched.setScheduled(p, true, now);
+    }
+    unsigned long gap = sched.getMinGap();
+    TEST_ASSERT_EQUAL_UINT32(PERIOD / 100 * LORAWAN_STAGGER_FILL_PCT / profiles, gap);
+
+    SimLog log;
+    startLog(log);
+    run(sched, now, DAY, log);
+
+    for (int p = 0; p < profiles; p++) {
+        const ScheduleStats& s = sched.getStats(p);
+        TEST_ASSERT_EQUAL_UINT32(0, s.missed);
+        TEST_ASSERT_UINT32_WITHIN(1, DAY / PERIOD, s.sent);
+        TEST_ASSERT_LESS_OR_EQUAL(chainBound(profiles), s.max_lateness);
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(gap, log.min_spacing);
+
+    // Fewer profiles: back to the configured gap once they fit
+    for (int p = 4; p < profiles; p++) {
+        sched.setScheduled(p, false, now);
+    }
+    TEST_ASSERT_EQUAL_UINT32(GAP, sched.getMinGap());
+}
+
+void test_overload_serves_profiles_in_turn(void) {
+    UplinkScheduler sched;
+    sched.setMinGap(GAP);
+    unsigned long now = START;
+    const int profiles = 16;   // 8-second periods: the transmissions alone take 24 s
+    for (int p = 0; p < profiles; p++) {
+        sched.setPeriod(p, 8000UL);
+        sched.setScheduled(p, true, now);
+    }
+    unsigned long gap = sched.getMinGap();
+
+    SimLog log;
+    startLog(log);
+    run(sched, now, DAY, log);
+
+    uint32_t lo = 0xFFFFFFFF, hi = 0;
+    for (int p = 0; p < profiles; p++) {
+        uint32_t sent = sched.getStats(p).sent;
+        if (sent < lo) lo = sent;
+        if (sent > hi) hi = sent;
+        TEST_ASSERT_GREATER_THAN(0, sched.getStats(p).missed);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(1, hi - lo);
+    TEST_ASSERT_GREATER_OR_EQUAL(gap, log.min_spacing);
+    // The radio is never idle longer than one stagger gap plus loop latency
+    TEST_ASSERT_GREATER_OR_EQUAL(DAY / (gap + LATE_BOUND), log.total);
+}
+
+void test_retain_resume_across_sleep(void) {
+    UplinkScheduler sched;
+    sched.setMinGap(GAP);
+    unsigned long now = START;
+    for (int p = 0; p < 3; p++) {
+        sched.setScheduled(p, true, now);
+    }
+    SimLog log;
+    startLog(log);
+    run(sched, now, 2 * PERIOD, log);
+
+    unsigned long deadline_in[3];
+    for (int p = 0; p < 3; p++) deadline_in[p] = sched.getDeadline(p) - now;
+
+    ScheduleRetained kept;
+    sched.retain(now, kept);
+
+    // Deep sleep restarts millis(); 40 s asleep
+    UplinkScheduler woken;
+    woken.setMinGap(GAP);
+    unsigned long wake = 500;
+    woken.resume(kept, wake - 40000);
+    for (int p = 0; p < 3; p++) {
+        TEST_ASSERT_TRUE(woken.isScheduled(p));
+        TEST_ASSERT_EQUAL_UINT32(deadline_in[p] - 40000, woken.getDeadline(p) - wake);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_periods_hold_over_three_days);
+    RUN_TEST(test_disabled_profile_leaves_others_on_period);
+    RUN_TEST(test_hold_counts_as_lateness_and_keeps_phase);
+    RUN_TEST(test_long_hold_skips_periods_without_burst);
+    RUN_TEST(test_gap_shrinks_to_fit_all_profiles);
+    RUN_TEST(test_overload_serves_profiles_in_turn);
+    RUN_TEST(test_retain_resume_across_sleep);
+    return UNITY_END();
+}
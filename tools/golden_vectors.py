@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""
+Golden vector pipeline for the payload codecs.
+
+test/golden_vectors.json is the single source of the frames the firmware
+encoders must produce for fixed register sets. This script writes them into
+the three places that check them:
+
+    src/payload_golden.h   - device self-test (LORAWAN_CODEC_SELFTEST) and
+                             the host test test/test_payload_codec
+    lorawan_decoder.py     - python3 lorawan_decoder.py --self-test
+    lorawan_decoder.js     - node lorawan_decoder.js
+
+The decoders stay self-contained (they are pasted into network servers);
+only the block between the GOLDEN VECTORS markers is rewritten.
+
+Runs before every PlatformIO build (extra_scripts in platformio.ini) and
+only rewrites files whose vectors changed. Can also be run by hand:
+
+    python3 tools/golden_vectors.py           # regenerate
+    python3 tools/golden_vectors.py --check   # exit 1 if a copy is stale
+"""
+
+import json
+import os
+import sys
+
+# Frame keys in PayloadType order (config.h), fixed formats only
+FIXED_FORMATS = ["adeunis_modbus_sf6", "cayenne_lpp", "raw_modbus", "custom", "vistron_lora_mod_con"]
+
+# The decoders check one frame per distinct layout (Raw Modbus = Adeunis)
+DECODER_FORMATS = ["adeunis_modbus_sf6", "cayenne_lpp", "custom", "vistron_lora_mod_con"]
+
+BEGIN = "BEGIN GOLDEN VECTORS (generated by tools/golden_vectors.py from test/golden_vectors.json - do not edit)"
+END = "END GOLDEN VECTORS"
+
+
+def load(project_dir):
+    with open(os.path.join(project_dir, "test", "golden_vectors.json"), encoding="utf-8") as f:
+        data = json.load(f)
+    for v in data["vectors"]:
+        if len(v["registers"]) != 4 or sorted(v["frames"]) != sorted(FIXED_FORMATS):
+            raise ValueError("golden vector %r: 4 registers and one frame per fixed format" % v)
+    return data
+
+
+def header(data):
+    out = []
+    out.append("// Generated by tools/golden_vectors.py from test/golden_vectors.json - do not edit\n")
+    out.append("#ifndef PAYLOAD_GOLDEN_H\n#define PAYLOAD_GOLDEN_H\n\n")
+    out.append("#include <stdint.h>\n#include <stddef.h>\n#include \"config.h\"\n#include \"sample_batch.h\"\n\n")
+    out.append("struct GoldenVector {\n")
+    out.append("    uint16_t density, pressure_20c, temperature, pressure_var;\n")
+    out.append("    uint32_t uplink_count;\n")
+    out.append("    const char* frames[PAYLOAD_BATCHED_DELTA];  // Hex per fixed PayloadType\n")
+    out.append("};\n\n")
+    out.append("static const GoldenVector GOLDEN_VECTORS[] = {\n")
+    for v in data["vectors"]:
+        frames = ['"%s"' % v["frames"][name] for name in FIXED_FORMATS]
+        out.append("    { %s, %d,\n" % (", ".join(str(r) for r in v["registers"]), v["uplink_count"]))
+        out.append("      { %s,\n        %s } },\n" % (", ".join(frames[:3]), ", ".join(frames[3:])))
+    out.append("};\n\n")
+    out.append("static const size_t GOLDEN_VECTOR_COUNT = sizeof(GOLDEN_VECTORS) / sizeof(GOLDEN_VECTORS[0]);\n\n")
+
+    b = data["batched"]
+    out.append("// Batched frame: samples GOLDEN_BATCH_INTERVAL_MS apart, encoded GOLDEN_BATCH_AGE_MS after the newest\n")
+    out.append("#define GOLDEN_BATCH_INTERVAL_MS %dUL\n" % b["sample_interval_ms"])
+    out.append("#define GOLDEN_BATCH_AGE_MS      %dUL\n\n" % b["age_ms"])
+    out.append("static_assert(GOLDEN_BATCH_INTERVAL_MS == LORAWAN_BATCH_SAMPLE_MS,\n")
+    out.append("              \"Batched golden frame was encoded with another sample interval\");\n\n")
+    out.append("static const uint16_t GOLDEN_BATCH_SAMPLES[][BATCH_FIELD_COUNT] = {\n")
+    for s in b["samples"]:
+        out.append("    { %s },\n" % ", ".join(str(x) for x in s))
+    out.append("};\n\n")
+    out.append("static const size_t GOLDEN_BATCH_SAMPLE_COUNT = sizeof(GOLDEN_BATCH_SAMPLES) / sizeof(GOLDEN_BATCH_SAMPLES[0]);\n")
+    out.append("static const char* const GOLDEN_BATCH_FRAME = \"%s\";\n\n" % b["frame"])
+    out.append("#endif // PAYLOAD_GOLDEN_H\n")
+    return "".join(out)
+
+
+def python_block(data):
+    out = ["GOLDEN_VECTORS = [\n"]
+    for v in data["vectors"]:
+        out.append("    ((%s, %d),\n" % (", ".join(str(r) for r in v["registers"]), v["uplink_count"]))
+        out.append("     %s),\n" % ", ".join('"%s"' % v["frames"][name] for name in DECODER_FORMATS))
+    out.append("]\n\n")
+    b = data["batched"]
+    samples = [("(%s)" % ", ".join(str(x) for x in s)) for s in b["samples"]]
+    samples = ",\n                   ".join(", ".join(samples[i:i + 3]) for i in range(0, len(samples), 3))
+    out.append("# Batched frame (FPort 3): samples %d s apart, newest %d s old\n"
+               % (b["sample_interval_ms"] // 1000, b["age_ms"] // 1000))
+    out.append('GOLDEN_BATCHED = ("%s",\n                  [%s])\n' % (b["frame"], samples))
+    return "".join(out)
+
+
+def js_block(data):
+    out = ["var GOLDEN_VECTORS = [\n"]
+    rows = []
+    for v in data["vectors"]:
+        rows.append("  [[%s, %d],\n   %s]" % (", ".join(str(r) for r in v["registers"]), v["uplink_count"],
+                                            ", ".join('"%s"' % v["frames"][name] for name in DECODER_FORMATS)))
+    out.append(",\n".join(rows) + "\n];\n\n")
+    b = data["batched"]
+    samples = ", ".join("[%s]" % ", ".join(str(x) for x in s) for s in b["samples"])
+    out.append("// Batched frame (FPort 3): samples %d s apart, newest %d s old\n"
+               % (b["sample_interval_ms"] // 1000, b["age_ms"] // 1000))
+    out.append('var GOLDEN_BATCHED = ["%s",\n  [%s]];\n' % (b["frame"], samples))
+    return "".join(out)
+
+
+def replace_block(text, comment, block, path):
+    begin = text.find(comment + " " + BEGIN)
+    end = text.find(comment + " " + END)
+    if begin < 0 or end < begin:
+        raise ValueError("%s: golden vector markers not found" % path)
+    begin = text.index("\n", begin) + 1
+    return text[:begin] + block + text[end:]
+
+
+def build(project_dir, check=False):
+    data = load(project_dir)
+
+    outputs = [(os.path.join(project_dir, "src", "payload_golden.h"), lambda old: header(data))]
+    for name, comment, block in (("lorawan_decoder.py", "#", python_block(data)),
+                                 ("lorawan_decoder.js", "//", js_block(data))):
+        path = os.path.join(project_dir, name)
+        outputs.append((path, lambda old, c=comment, b=block, p=path: replace_block(old, c, b, p)))
+
+    stale = []
+    for path, render in outputs:
+        old = ""
+        if os.path.exists(path):
+            with open(path, encoding="utf-8") as f:
+                old = f.read()
+        content = render(old)
+        if content == old:
+            continue
+        stale.append(os.path.relpath(path, project_dir))
+        if not check:
+            with open(path, "w", encoding="utf-8", newline="\n") as f:
+                f.write(content)
+
+    if stale:
+        print("Golden vectors: %s %s" % ("out of date in" if check else "updated", ", ".join(stale)))
+    return not stale
+
+
+try:
+    Import("env")  # noqa: F821 - defined when run by PlatformIO (SCons)
+    build(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+        check = len(sys.argv) > 1 and sys.argv[1] == "--check"
+        sys.exit(0 if build(root, check) or not check else 1)
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""
+Static asset pipeline for the web interface.
+
+Minifies and gzips the CSS and JavaScript in web/ into src/web_assets.h,
+served from /static/<name> with Content-Encoding: gzip and an ETag.
+
+Runs before every PlatformIO build (extra_scripts in platformio.ini) and
+only rewrites the header when an asset changed. Can also be run by hand:
+
+    python3 tools/web_assets.py
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+# Served name -> (content type, source files in web/, concatenated in order)
+ASSETS = [
+    ("style-light.css", "text/css", ["theme-light.css", "common.css"]),
+    ("style-dark.css", "text/css", ["theme-dark.css", "common.css"]),
+    ("app.js", "application/javascript", ["app.js"]),
+]
+
+
+def minify_css(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"\s+", " ", text)
+    text = re.sub(r"\s*([{};,])\s*", r"\1", text)
+    return text.replace(";}", "}").strip()
+
+
+def minify_js(text):
+    # Conservative: comment lines, indentation and blank lines only. Line
+    # breaks are kept so automatic semicolon insertion still applies.
+    lines = []
+    for line in text.splitlines():
+        line = line.strip()
+        if line and not line.startswith("//"):
+            lines.append(line)
+    return "\n".join(lines) + "\n"
+
+
+def build(project_dir):
+    web_dir = os.path.join(project_dir, "web")
+    out_path = os.path.join(project_dir, "src", "web_assets.h")
+
+    out = []
+    out.append("// Generated by tools/web_assets.py from web/ - do not edit\n")
+    out.append("#ifndef WEB_ASSETS_H\n#define WEB_ASSETS_H\n\n#include <Arduino.h>\n\n")
+    out.append("struct WebAsset {\n")
+    out.append("    const char* name;       // Path under /static/\n")
+    out.append("    const char* type;\n")
+    out.append("    const uint8_t* data;    // gzip\n")
+    out.append("    size_t len;\n")
+    out.append("    const char* etag;       // Quoted, as sent in ETag\n")
+    out.append("    const char* version;    // Appended to links (?v=) so a new firmware is fetched again\n")
+    out.append("};\n\n")
+
+    entries = []
+    summary = []
+    for i, (name, content_type, sources) in enumerate(ASSETS):
+        text = ""
+        for source in sources:
+            with open(os.path.join(web_dir, source), encoding="utf-8") as f:
+                text += f.read()
+        minified = minify_css(text) if name.endswith(".css") else minify_js(text)
+        raw = minified.encode("utf-8")
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        version = hashlib.sha1(packed).hexdigest()[:12]
+
+        out.append("// %s: %d bytes, %d minified, %d gzipped\n" % (name, len(text.encode("utf-8")), len(raw), len(packed)))
+        out.append("static const uint8_t WEB_ASSET_%d[] PROGMEM = {\n" % i)
+        for pos in range(0, len(packed), 16):
+            out.append("    " + ", ".join("0x%02x" % b for b in packed[pos:pos + 16]) + ",\n")
+        out.append("};\n\n")
+        entries.append('    { "%s", "%s", WEB_ASSET_%d, sizeof(WEB_ASSET_%d), "\\"%s\\"", "%s" },\n'
+                       % (name, content_type, i, i, version, version))
+        summary.append("%s %d -> %d bytes" % (name, len(text.encode("utf-8")), len(packed)))
+
+    out.append("static const WebAsset WEB_ASSETS[] = {\n")
+    out.extend(entries)
+    out.append("};\n\n")
+    out.append("static const size_t WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);\n\n")
+    out.append("#endif // WEB_ASSETS_H\n")
+    content = "".join(out)
+
+    old = None
+    if os.path.exists(out_path):
+        with open(out_path, encoding="utf-8") as f:
+            old = f.read()
+    if content != old:
+        with open(out_path, "w", encoding="utf-8", newline="\n") as f:
+            f.write(content)
+        print("Web assets: " + ", ".join(summary))
+
+
+try:
+    Import("env")  # noqa: F821 - defined when run by PlatformIO (SCons)
+    build(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        build(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
@@ -0,0 +1,101 @@
+// Page scripts for the web interface, loaded on every page from /static/app.js
+// (minified and gzipped into src/web_assets.h by tools/web_assets.py)
+
+// ---- Statistics ----
+function saveAutoInstall() {
+  var enabled = document.getElementById('autoInstall').checked ? '1' : '0';
+  fetch('/ota/auto-install?enabled=' + enabled).then(function(r){ return r.json(); }).then(function(data){
+    console.log('Auto-install saved:', data);
+  });
+}
+
+// ---- Registers ----
+function submitSF6Values() {
+  var d = parseFloat(document.getElementById('density-input').value);
+  var p = parseFloat(document.getElementById('pressure-input').value);
+  var t = parseFloat(document.getElementById('temperature-input').value);
+  fetch('/sf6/update?density=' + Math.round(d * 100) + '&pressure=' + Math.round(p * 10) + '&temperature=' + Math.round(t * 10));
+  alert('Values updated!');
+  return false;
+}
+function resetSF6Values() {
+  if (!confirm('Reset SF6 values?')) return;
+  fetch('/sf6/reset');
+  alert('Values reset!');
+  setTimeout(function() { location.reload(); }, 1000);
+}
+
+// ---- Profiles ----
+function toggleProfile(idx){ fetch('/lorawan/profile/toggle?index='+idx).then(()=>location.reload()); }
+function activateProfile(idx){ if(confirm('Switch profile? Device will restart.')) fetch('/lorawan/profile/activate?index='+idx).then(()=>{ alert('Restarting...'); setTimeout(()=>location.href='/',10000); }); }
+function toggleAutoRotate(e){ fetch('/lorawan/auto-rotate?enabled='+(e?'1':'0')).then(()=>location.reload()); }
+
+// ---- WiFi ----
+function scanNetworks(){
+  document.getElementById('scanBtn').disabled=true;
+  document.getElementById('scanBtn').innerHTML='<span class="spinner" style="width:20px;height:20px;border-width:3px;"></span> Scanning...';
+  fetch('/wifi/scan').then(r=>r.json()).then(data=>{
+    let html='';
+    data.networks.forEach(n=>{
+      html+='<div class="network" onclick="selectNetwork(\''+n.ssid+'\')"><strong>'+n.ssid+'</strong><span class="rssi">'+n.rssi+' dBm</span></div>';
+    });
+    document.getElementById('scanResults').innerHTML=html;
+    document.getElementById('scanBtn').disabled=false;
+    document.getElementById('scanBtn').innerHTML='Scan for Networks';
+  }).catch(e=>{
+    document.getElementById('scanResults').innerHTML='<p style="color:red;">Scan failed</p>';
+    document.getElementById('scanBtn').disabled=false;
+    document.getElementById('scanBtn').innerHTML='Scan for Networks';
+  });
+}
+function selectNetwork(ssid){
+  document.getElementById('ssid').value=ssid;
+}
+function refreshStatus(){
+  fetch('/wifi/status').then(r=>r.json()).then(data=>{
+    let statusHtml='';
+    if(data.client_connected){
+      statusHtml='<div class="status"><strong>Connected to WiFi</strong><br>SSID: '+data.client_ssid+'<br>IP Address: '+data.client_ip+'<br>Signal: '+data.client_rssi+' dBm</div>';
+    }else if(data.saved_ssid){
+      statusHtml='<div class="status disconnected"><strong>Not Connected</strong><br>Saved network: '+data.saved_ssid+'<br>Will try to connect on next boot</div>';
+    }else{
+      statusHtml='<div class="status disconnected"><strong>No WiFi Configured</strong><br>Use the form below to connect to a WiFi network</div>';
+    }
+    document.getElementById('statusArea').innerHTML=statusHtml;
+  });
+}
+
+// ---- Firmware update ----
+function checkForUpdates(){
+  var btn = document.getElementById('checkBtn');
+  var status = document.getElementById('updateStatus');
+  btn.disabled=true;
+  btn.innerHTML='Checking...';
+  fetch('/ota/check').then(function(r){return r.json();}).then(function(data){
+    btn.disabled=false;
+    btn.innerHTML='Check for Updates';
+    if(data.error) status.innerHTML='<div class="warning">'+data.error+'</div>';
+    else if(data.updateAvailable) status.innerHTML='<div class="card" style="background:#1e5631;border-color:#27ae60;color:#fff;"><strong>Update available!</strong><br>Current: '+data.currentVersion+'<br>Latest: '+data.latestVersion+'<br><br><button onclick="startUpdate()">Install Update</button></div>';
+    else status.innerHTML='<div class="card">Up to date: '+data.currentVersion+'</div>';
+  }).catch(function(e){ btn.disabled=false; btn.innerHTML='Check for Updates'; });
+}
+function startUpdate(){
+  if(!confirm('Start firmware update?'))return;
+  var status = document.getElementById('updateStatus');
+  status.innerHTML='<div class="card">Updating...<div class="spinner"></div></div>';
+  fetch('/ota/start').then(function(r){return r.json();}).then(function(data){
+    if(data.started) setInterval(checkProgress,1000);
+    else status.innerHTML='<div class="warning">'+(data.error||'Failed')+'</div>';
+  });
+}
+function checkProgress(){
+  fetch('/ota/status').then(function(r){return r.json();}).then(function(data){
+    var status = document.getElementById('updateStatus');
+    if(data.status==='success'){ status.innerHTML='<div class="card" style="background:#1e5631;color:#fff;">Update complete! Rebooting...</div>'; setTimeout(function(){location.reload();},15000); }
+    else if(data.status==='failed') status.innerHTML='<div class="warning">Failed: '+data.message+'</div>';
+    else status.innerHTML='<div class="card">Progress: '+data.progress+'%<br>'+data.message+'</div>';
+  });
+}
+
+// The script is deferred: the page's elements exist when this runs
+if (document.getElementById('statusArea')) refreshStatus();